@@ -955,6 +955,15 @@ bool CApplicationPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned
     return false;
 }
 
+bool CApplicationPlayer::RenderCaptureGetLatestPixels(unsigned int captureId, uint8_t *buffer, unsigned int size, unsigned int &frameId)
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    return player->RenderCaptureGetLatestPixels(captureId, buffer, size, frameId);
+  else
+    return false;
+}
+
 bool CApplicationPlayer::IsExternalPlaying()
 {
   std::shared_ptr<IPlayer> player = GetInternal();
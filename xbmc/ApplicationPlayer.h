@@ -74,6 +74,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags = 0);
   void RenderCaptureRelease(unsigned int captureId);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
+  bool RenderCaptureGetLatestPixels(unsigned int captureId, uint8_t *buffer, unsigned int size, unsigned int &frameId);
   bool IsExternalPlaying();
 
   // proxy calls
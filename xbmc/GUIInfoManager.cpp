@@ -73,6 +73,8 @@
 #include <iterator>
 #include <memory>
 #include <math.h>
+#include "cores/AudioEngine/Interfaces/AE.h"
+#include "cores/AudioEngine/Utils/AESpectrumAnalyzer.h"
 #include "cores/DataCacheCore.h"
 #include "cores/RetroPlayer/RetroPlayerUtils.h"
 #include "guiinfo/GUIInfoLabels.h"
@@ -1708,6 +1710,14 @@ const infomap musicpartymode[] = {{ "enabled",           MUSICPM_ENABLED },
 ///                  _string_,
 ///     Channel group of of the radio programme that's currently playing (PVR).
 ///   }
+///   \table_row3{   <b>`MusicPlayer.Spectrum(bin)`</b>,
+///                  \anchor MusicPlayer_Spectrum
+///                  _integer_,
+///     Level of the frequency bin (0 to 127) of the playing audio on a scale
+///     from 0 to 100\, averaged over both channels. The audio engine analyzes
+///     the audio while the label is in use\, so it is empty for a moment after
+///     it became visible.
+///   }
 /// \table_end
 ///
 /// -----------------------------------------------------------------------------
@@ -5585,6 +5595,8 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool
       }
       if (prop.name == "content" && prop.num_params())
         return AddMultiInfo(GUIInfo(MUSICPLAYER_CONTENT, ConditionalStringParameter(prop.param()), 0));
+      else if (prop.name == "spectrum" && prop.num_params())
+        return AddMultiInfo(GUIInfo(MUSICPLAYER_SPECTRUM, atoi(prop.param().c_str())));
       else if (prop.name == "property")
       {
         // properties are stored case sensitive in m_listItemProperties, but lookup is insensitive in CGUIListItem::GetProperty
@@ -7983,10 +7995,27 @@ bool CGUIInfoManager::GetMultiInfoInt(int &value, const GUIInfo &info, int conte
     if (item) // If we got a valid item, do the lookup
       return GetItemInt(value, item.get(), info.m_info);
   }
+  else if (info.m_info == MUSICPLAYER_SPECTRUM)
+    return GetSpectrumLevel(value, info.GetData1());
 
   return 0;
 }
 
+bool CGUIInfoManager::GetSpectrumLevel(int &value, int bin) const
+{
+  if (bin < 0 || bin >= static_cast<int>(AESpectrum::BINS) || !g_application.GetAppPlayer().IsPlayingAudio())
+    return false;
+
+  // polling keeps the engine analyzing, the first call only starts it
+  AESpectrum spectrum;
+  if (!CServiceBroker::GetActiveAE().GetSpectrum(spectrum))
+    return false;
+
+  float level = (spectrum.magnitudes[2 * bin] + spectrum.magnitudes[2 * bin + 1]) * 50.0f;
+  value = std::min(100, static_cast<int>(level + 0.5f));
+  return true;
+}
+
 /// \brief Returns the currently chosen container (view control for MediaWindows, currently focused container for non-MediaWindows)
 CGUIControl* CGUIInfoManager::GetActiveContainer(int containerId, int contextWindow) const
 {
@@ -8035,6 +8064,12 @@ std::string CGUIInfoManager::GetMultiInfoLabel(const GUIInfo &info, int contextW
     if (item) // If we got a valid item, do the lookup
       return GetItemImage(item.get(), info.m_info, fallback); // Image prioritizes images over labels (in the case of music item ratings for instance)
   }
+  else if (info.m_info == MUSICPLAYER_SPECTRUM)
+  {
+    int value;
+    if (GetSpectrumLevel(value, info.GetData1()))
+      return StringUtils::Format("%i", value);
+  }
   else if (info.m_info == PLAYER_TIME)
   {
     return GetCurrentPlayTime((TIME_FORMAT)info.GetData1());
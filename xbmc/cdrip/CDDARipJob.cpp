@@ -19,6 +19,7 @@
  */
 
 #include "CDDARipJob.h"
+#include "CDDARipPipeline.h"
 #include "Encoder.h"
 #include "EncoderFFmpeg.h"
 #include "FileItem.h"
@@ -38,6 +39,8 @@
 #include "addons/AddonManager.h"
 #include "addons/AudioEncoder.h"
 
+#include <algorithm>
+
 #if defined(TARGET_WINDOWS)
 #include "platform/win32/CharsetConverter.h"
 #endif
@@ -53,96 +56,118 @@ CCDDARipJob::CCDDARipJob(const std::string& input,
                          bool eject,
                          unsigned int rate,
                          unsigned int channels, unsigned int bps) : 
-  m_rate(rate), m_channels(channels), m_bps(bps), m_tag(tag),
-  m_input(input), m_output(CUtil::MakeLegalPath(output)), m_eject(eject),
-  m_encoder(encoder)
+  m_rate(rate), m_channels(channels), m_bps(bps),
+  m_eject(eject), m_encoder(encoder)
 {
+  AddTrack(input, output, tag);
 }
 
 CCDDARipJob::~CCDDARipJob() = default;
 
+void CCDDARipJob::AddTrack(const std::string& input, const std::string& output,
+                           const CMusicInfoTag& tag)
+{
+  RipTrack track;
+  track.input = input;
+  track.output = CUtil::MakeLegalPath(output);
+  track.tag = tag;
+  m_tracks.push_back(track);
+}
+
 bool CCDDARipJob::DoWork()
 {
-  CLog::Log(LOGINFO, "Start ripping track %s to %s", m_input.c_str(),
-                                                     m_output.c_str());
+  CLog::Log(LOGINFO, "Start ripping %u tracks, first %s to %s", static_cast<unsigned int>(m_tracks.size()),
+                                                               m_tracks[0].input.c_str(),
+                                                               m_tracks[0].output.c_str());
 
   // if we are ripping to a samba share, rip it to hd first and then copy it it the share
-  CFileItem file(m_output, false);
-  if (file.IsRemote())
-    m_output = SetupTempFile();
-  
-  if (m_output.empty())
+  for (auto& track : m_tracks)
   {
-    CLog::Log(LOGERROR, "CCDDARipper: Error opening file");
-    return false;
+    track.file = track.output;
+    if (CFileItem(track.output, false).IsRemote())
+      track.file = SetupTempFile();
+
+    if (track.file.empty())
+    {
+      CLog::Log(LOGERROR, "CCDDARipper: Error opening file");
+      return false;
+    }
   }
 
   // init ripper
-  CFile reader;
-  CEncoder* encoder;
-  if (!reader.Open(m_input,READ_CACHED) || !(encoder=SetupEncoder(reader)))
+  CCDDARipFileSource source;
+  CCDDARipPipeline pipeline(source, [this](unsigned int track, int64_t length)
   {
-    CLog::Log(LOGERROR, "Error: CCDDARipper::Init failed");
-    return false;
-  }
+    return SetupEncoder(m_tracks[track], length);
+  });
+  for (const auto& track : m_tracks)
+    pipeline.AddTrack(track.input);
 
   // setup the progress dialog
   CGUIDialogExtendedProgressBar* pDlgProgress = 
       g_windowManager.GetWindow<CGUIDialogExtendedProgressBar>(WINDOW_DIALOG_EXT_PROGRESS);
   CGUIDialogProgressBarHandle* handle = pDlgProgress->GetHandle(g_localizeStrings.Get(605));
 
-  int iTrack = atoi(m_input.substr(13, m_input.size() - 13 - 5).c_str());
-  std::string strLine0 = StringUtils::Format("%02i. %s - %s", iTrack,
-                                            m_tag.GetArtistString().c_str(),
-                                            m_tag.GetTitle().c_str());
-  handle->SetText(strLine0);
-
-  // start ripping
-  int percent=0;
-  int oldpercent=0;
+  // start ripping, the dialog shows the track that is read from the disc
+  int oldpercent = 0;
+  unsigned int shownTrack = static_cast<unsigned int>(m_tracks.size());
   bool cancelled(false);
-  int result;
-  while (!cancelled && (result=RipChunk(reader, encoder, percent)) == 0)
+  bool result = pipeline.Run([&](const CDDARipProgress& progress)
   {
-    cancelled = ShouldCancel(percent,100);
+    unsigned int reading = std::min(progress.tracksRead, static_cast<unsigned int>(m_tracks.size() - 1));
+    if (reading != shownTrack)
+    {
+      shownTrack = reading;
+      const RipTrack& track = m_tracks[reading];
+      handle->SetText(StringUtils::Format("%02i. %s - %s", GetTrackNumber(track.input),
+                                          track.tag.GetArtistString().c_str(),
+                                          track.tag.GetTitle().c_str()));
+    }
+
+    int percent = static_cast<int>(progress.percent);
+    cancelled = ShouldCancel(percent, 100);
     if (percent > oldpercent)
     {
       oldpercent = percent;
       handle->SetPercentage(static_cast<float>(percent));
     }
-  }
+    return cancelled;
+  });
 
-  // close encoder ripper
-  encoder->CloseEncode();
-  delete encoder;
-  reader.Close();
+  CDDARipProgress progress = pipeline.GetProgress();
+  CLog::Log(LOGDEBUG, "CDDARipper: read %.1f KiB/s, encoded %.1f KiB/s", progress.readRate / 1024,
+                                                                       progress.encodeRate / 1024);
 
-  if (file.IsRemote() && !cancelled && result == 2)
+  for (unsigned int i = 0; i < m_tracks.size(); i++)
   {
-    // copy the ripped track to the share
-    if (!CFile::Copy(m_output, file.GetPath()))
+    const RipTrack& track = m_tracks[i];
+    if (!pipeline.IsTrackRipped(i))
     {
-      CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s", 
-                m_output.c_str(), file.GetPath().c_str());
-      CFile::Delete(m_output);
-      return false;
+      if (!cancelled)
+        CLog::Log(LOGERROR, "CDDARipper: Error ripping %s", track.input.c_str());
+      CFile::Delete(track.file);
+      continue;
+    }
+
+    if (track.file != track.output)
+    {
+      // copy the ripped track to the share
+      if (!CFile::Copy(track.file, track.output))
+      {
+        CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s", 
+                  track.file.c_str(), track.output.c_str());
+        result = false;
+      }
+      // delete cached file
+      CFile::Delete(track.file);
     }
-    // delete cached file
-    CFile::Delete(m_output);
   }
 
   if (cancelled)
-  {
     CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
-    CFile::Delete(m_output);
-  }
-  else if (result == 1)
-    CLog::Log(LOGERROR, "CDDARipper: Error ripping %s", m_input.c_str());
-  else if (result < 0)
-    CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
-  else
+  else if (result)
   {
-    CLog::Log(LOGINFO, "Finished ripping %s", m_input.c_str());
+    CLog::Log(LOGINFO, "Finished ripping %u tracks", static_cast<unsigned int>(m_tracks.size()));
     if (m_eject)
     {
       CLog::Log(LOGINFO, "Ejecting CD");
@@ -152,35 +177,15 @@ bool CCDDARipJob::DoWork()
 
   handle->MarkFinished();
 
-  return !cancelled && result == 2;
+  return !cancelled && result;
 }
 
-int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
+int CCDDARipJob::GetTrackNumber(const std::string& input)
 {
-  percent = 0;
-
-  uint8_t stream[1024];
-
-  // get data
-  int result = reader.Read(stream, 1024);
-
-  // return if rip is done or on some kind of error
-  if (result <= 0)
-    return 1;
-
-  // encode data
-  int encres=encoder->Encode(result, stream);
-
-  // Get progress indication
-  percent = static_cast<int>(reader.GetPosition()*100/reader.GetLength());
-
-  if (reader.GetPosition() == reader.GetLength())
-    return 2;
-
-  return -(1-encres);
+  return atoi(input.substr(13, input.size() - 13 - 5).c_str());
 }
 
-CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
+CEncoder* CCDDARipJob::SetupEncoder(const RipTrack& track, int64_t length)
 {
   CEncoder* encoder = NULL;
   if (CServiceBroker::GetSettings().GetString(CSettings::SETTING_AUDIOCDS_ENCODER) == "audioencoder.kodi.builtin.aac" ||
@@ -202,23 +207,23 @@ CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
     return NULL;
 
   // we have to set the tags before we init the Encoder
-  std::string strTrack = StringUtils::Format("%li", strtol(m_input.substr(13, m_input.size() - 13 - 5).c_str(),NULL,10));
+  std::string strTrack = StringUtils::Format("%i", GetTrackNumber(track.input));
 
   encoder->SetComment(std::string("Ripped with ") + CSysInfo::GetAppName());
-  encoder->SetArtist(StringUtils::Join(m_tag.GetArtist(),
+  encoder->SetArtist(StringUtils::Join(track.tag.GetArtist(),
                                       g_advancedSettings.m_musicItemSeparator));
-  encoder->SetTitle(m_tag.GetTitle());
-  encoder->SetAlbum(m_tag.GetAlbum());
-  encoder->SetAlbumArtist(StringUtils::Join(m_tag.GetAlbumArtist(),
+  encoder->SetTitle(track.tag.GetTitle());
+  encoder->SetAlbum(track.tag.GetAlbum());
+  encoder->SetAlbumArtist(StringUtils::Join(track.tag.GetAlbumArtist(),
                                       g_advancedSettings.m_musicItemSeparator));
-  encoder->SetGenre(StringUtils::Join(m_tag.GetGenre(),
+  encoder->SetGenre(StringUtils::Join(track.tag.GetGenre(),
                                       g_advancedSettings.m_musicItemSeparator));
   encoder->SetTrack(strTrack);
-  encoder->SetTrackLength(static_cast<int>(reader.GetLength()));
-  encoder->SetYear(m_tag.GetYearString());
+  encoder->SetTrackLength(static_cast<int>(length));
+  encoder->SetYear(track.tag.GetYearString());
 
   // init encoder
-  if (!encoder->Init(m_output.c_str(), m_channels, m_rate, m_bps))
+  if (!encoder->Init(track.file.c_str(), m_channels, m_rate, m_bps))
     delete encoder, encoder = NULL;
 
   return encoder;
@@ -251,8 +256,15 @@ bool CCDDARipJob::operator==(const CJob* job) const
     const CCDDARipJob* rjob = dynamic_cast<const CCDDARipJob*>(job);
     if (rjob)
     {
-      return m_input  == rjob->m_input &&
-             m_output == rjob->m_output;
+      if (m_tracks.size() != rjob->m_tracks.size())
+        return false;
+      for (size_t i = 0; i < m_tracks.size(); i++)
+      {
+        if (m_tracks[i].input != rjob->m_tracks[i].input ||
+            m_tracks[i].output != rjob->m_tracks[i].output)
+          return false;
+      }
+      return true;
     }
   }
   return false;
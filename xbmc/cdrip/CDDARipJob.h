@@ -22,12 +22,9 @@
 #include "utils/Job.h"
 #include "music/tags/MusicInfoTag.h"
 
-class CEncoder;
+#include <vector>
 
-namespace XFILE
-{
-class CFile;
-}
+class CEncoder;
 
 class CCDDARipJob : public CJob
 {
@@ -48,34 +45,41 @@ public:
 
   ~CCDDARipJob() override;
 
+  //! \brief Add another track to the job
+  //! \details The tracks of a job are read one after the other and encoded
+  //!          in parallel. See CCDDARipPipeline
+  void AddTrack(const std::string& input, const std::string& output,
+                const MUSIC_INFO::CMusicInfoTag& tag);
+
   const char* GetType() const override { return "cdrip"; };
   bool operator==(const CJob *job) const override;
   bool DoWork() override;
-  std::string GetOutput() const { return m_output; }
+  //! \brief The output url of the last track
+  std::string GetOutput() const { return m_tracks.back().output; }
 protected:
+  struct RipTrack
+  {
+    std::string input; //< The input url
+    std::string output; //< The output url
+    std::string file; //< The file the encoder writes, a temp file for remote outputs
+    MUSIC_INFO::CMusicInfoTag tag; //< Music tag to attach to output file
+  };
+
   //! \brief Setup the audio encoder
-  CEncoder* SetupEncoder(XFILE::CFile& reader);
+  //! \param track The track to encode
+  //! \param length The length of the input in bytes
+  CEncoder* SetupEncoder(const RipTrack& track, int64_t length);
 
   //! \brief Helper used if output is a remote url
   std::string SetupTempFile();
 
-  //! \brief Rip a chunk of audio
-  //! \param reader The input reader
-  //! \param encoder The audio encoder
-  //! \param percent The percentage completed on return
-  //! \return 0 (CDDARIP_OK) if everything went okay, or
-  //!         a positive error code from the reader, or
-  //!         -1 if the encoder failed
-  //! \sa CCDDARipper::GetData, CEncoder::Encode
-  int RipChunk(XFILE::CFile& reader, CEncoder* encoder, int& percent);
+  //! \brief Get the track number from a cdda url like cdda://local/01.cdda
+  static int GetTrackNumber(const std::string& input);
 
   unsigned int m_rate; //< The sample rate of the input file 
   unsigned int m_channels; //< The number of channels in input file
   unsigned int m_bps; //< The bits per sample of input
-  MUSIC_INFO::CMusicInfoTag m_tag; //< Music tag to attach to output file
-  std::string m_input; //< The input url
-  std::string m_output; //< The output url
+  std::vector<RipTrack> m_tracks; //< The tracks to rip
   bool m_eject; //< Should we eject tray when we are finished?
   int m_encoder; //< The audio encoder
 };
-
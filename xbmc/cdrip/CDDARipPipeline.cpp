@@ -0,0 +1,371 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "CDDARipPipeline.h"
+#include "Encoder.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+
+CCDDARipFileSource::CCDDARipFileSource() = default;
+
+CCDDARipFileSource::~CCDDARipFileSource()
+{
+  Close();
+}
+
+bool CCDDARipFileSource::Open(const std::string& input)
+{
+  m_file.reset(new CFile);
+  if (!m_file->Open(input, READ_CACHED))
+  {
+    m_file.reset();
+    return false;
+  }
+  return true;
+}
+
+ssize_t CCDDARipFileSource::Read(void* buffer, size_t size)
+{
+  if (!m_file)
+    return -1;
+  return m_file->Read(buffer, size);
+}
+
+int64_t CCDDARipFileSource::GetLength()
+{
+  return m_file ? m_file->GetLength() : 0;
+}
+
+void CCDDARipFileSource::Close()
+{
+  if (m_file)
+  {
+    m_file->Close();
+    m_file.reset();
+  }
+}
+
+class CCDDARipPipeline::CEncodeWorker : public IRunnable
+{
+public:
+  explicit CEncodeWorker(CCDDARipPipeline& pipeline) : m_pipeline(pipeline) { }
+  void Run() override { m_pipeline.EncodeTracks(); }
+
+private:
+  CCDDARipPipeline& m_pipeline;
+};
+
+CCDDARipPipeline::CCDDARipPipeline(ICDDARipSource& source, const EncoderFactory& factory,
+                                   unsigned int encoders, size_t bufferSize)
+  : m_source(source),
+    m_factory(factory),
+    m_encoders(encoders),
+    m_bufferSize(std::max(bufferSize, CHUNK_SIZE)),
+    m_cancel(false)
+{
+}
+
+CCDDARipPipeline::~CCDDARipPipeline() = default;
+
+unsigned int CCDDARipPipeline::AddTrack(const std::string& input)
+{
+  CSingleLock lock(m_section);
+  m_tracks.emplace_back();
+  m_tracks.back().input = input;
+  return static_cast<unsigned int>(m_tracks.size() - 1);
+}
+
+void CCDDARipPipeline::Cancel()
+{
+  CSingleLock lock(m_section);
+  m_cancel = true;
+  m_dataCond.notifyAll();
+  m_spaceCond.notifyAll();
+}
+
+bool CCDDARipPipeline::Run(const ProgressCallback& progress)
+{
+  unsigned int tracks = static_cast<unsigned int>(m_tracks.size());
+  if (tracks == 0)
+    return true;
+
+  unsigned int encoders = m_encoders;
+  if (encoders == 0)
+    encoders = std::max(g_cpuInfo.getCPUCount(), 1);
+  encoders = std::min(encoders, tracks);
+
+  m_startTime = XbmcThreads::SystemClockMillis();
+
+  CEncodeWorker worker(*this);
+  std::vector<std::unique_ptr<CThread>> threads;
+  for (unsigned int i = 0; i < encoders; i++)
+  {
+    threads.emplace_back(new CThread(&worker, "CDDARipEncoder"));
+    threads.back()->Create();
+  }
+
+  CLog::Log(LOGDEBUG, "CCDDARipPipeline::Run - ripping %u tracks with %u encoders", tracks, encoders);
+
+  for (unsigned int i = 0; i < tracks && !m_cancel; i++)
+  {
+    ReadTrack(i);
+    while (!m_cancel)
+    {
+      // read the next chunk unless the buffer is full
+      std::vector<uint8_t> chunk;
+      {
+        CSingleLock lock(m_section);
+        Track& track = m_tracks[i];
+        if (track.failed)
+          break;
+        if (m_buffered + CHUNK_SIZE > m_bufferSize)
+        {
+          m_spaceCond.wait(lock, 100);
+          lock.Leave();
+          if (ReportProgress(progress))
+            Cancel();
+          continue;
+        }
+        if (!m_freeChunks.empty())
+        {
+          chunk.swap(m_freeChunks.back());
+          m_freeChunks.pop_back();
+        }
+      }
+
+      chunk.resize(CHUNK_SIZE);
+      ssize_t read = m_source.Read(chunk.data(), chunk.size());
+      if (read <= 0)
+      {
+        CSingleLock lock(m_section);
+        if (read < 0)
+        {
+          CLog::Log(LOGERROR, "CCDDARipPipeline::Run - error reading %s", m_tracks[i].input.c_str());
+          m_tracks[i].failed = true;
+        }
+        break;
+      }
+      chunk.resize(read);
+
+      {
+        CSingleLock lock(m_section);
+        Track& track = m_tracks[i];
+        track.read += read;
+        m_buffered += read;
+        track.chunks.emplace_back(std::move(chunk));
+        m_dataCond.notifyAll();
+      }
+
+      if (ReportProgress(progress))
+        Cancel();
+    }
+
+    m_source.Close();
+    CSingleLock lock(m_section);
+    m_tracks[i].readDone = true;
+    m_tracksRead++;
+    m_dataCond.notifyAll();
+  }
+
+  // wait for the encoders to catch up
+  while (!m_cancel)
+  {
+    {
+      CSingleLock lock(m_section);
+      if (m_tracksEncoded == tracks)
+        break;
+      m_spaceCond.wait(lock, 100);
+    }
+    if (ReportProgress(progress))
+      Cancel();
+  }
+
+  for (auto& thread : threads)
+    thread->StopThread(true);
+  ReportProgress(progress);
+
+  CSingleLock lock(m_section);
+  for (auto& track : m_tracks)
+    track.chunks.clear();
+  m_freeChunks.clear();
+  m_buffered = 0;
+
+  if (m_cancel)
+    return false;
+  for (const auto& track : m_tracks)
+  {
+    if (track.failed)
+      return false;
+  }
+  return true;
+}
+
+void CCDDARipPipeline::ReadTrack(unsigned int index)
+{
+  bool opened = m_source.Open(m_tracks[index].input);
+  int64_t length = opened ? m_source.GetLength() : 0;
+  if (!opened)
+    CLog::Log(LOGERROR, "CCDDARipPipeline::ReadTrack - unable to open %s", m_tracks[index].input.c_str());
+
+  CSingleLock lock(m_section);
+  Track& track = m_tracks[index];
+  track.opened = true;
+  track.length = length;
+  track.failed = !opened;
+  m_dataCond.notifyAll();
+}
+
+void CCDDARipPipeline::EncodeTracks()
+{
+  CSingleLock lock(m_section);
+  while (!m_cancel && m_nextEncode < m_tracks.size())
+  {
+    // tracks are encoded in order, as soon as reading them started
+    unsigned int index = m_nextEncode;
+    if (!m_tracks[index].opened)
+    {
+      m_dataCond.wait(lock);
+      continue;
+    }
+    m_nextEncode++;
+
+    lock.Leave();
+    EncodeTrack(index);
+    lock.Enter();
+  }
+}
+
+void CCDDARipPipeline::EncodeTrack(unsigned int index)
+{
+  std::unique_ptr<CEncoder> encoder;
+  bool ok;
+  {
+    // the encoder setup reads the settings and initializes shared codec state, one thread at a time
+    CSingleLock lock(m_section);
+    ok = !m_tracks[index].failed;
+    if (ok)
+      encoder.reset(m_factory(index, m_tracks[index].length));
+  }
+
+  if (ok)
+  {
+    if (!encoder)
+    {
+      CLog::Log(LOGERROR, "CCDDARipPipeline::EncodeTrack - unable to create encoder for %s", m_tracks[index].input.c_str());
+      ok = false;
+    }
+  }
+
+  std::vector<uint8_t> chunk;
+  while (true)
+  {
+    {
+      CSingleLock lock(m_section);
+      Track& track = m_tracks[index];
+      if (!chunk.empty())
+      {
+        track.encoded += chunk.size();
+        m_buffered -= chunk.size();
+        m_freeChunks.emplace_back(std::move(chunk));
+        chunk.clear();
+        m_spaceCond.notifyAll();
+      }
+      // stop the reader on errors, chunks that are already queued are dropped
+      if (!ok)
+        track.failed = true;
+
+      while (!m_cancel && track.chunks.empty() && !track.readDone)
+        m_dataCond.wait(lock);
+      if (m_cancel || track.chunks.empty())
+        break;
+      chunk.swap(track.chunks.front());
+      track.chunks.pop_front();
+    }
+
+    if (ok && !encoder->Encode(static_cast<int>(chunk.size()), chunk.data()))
+    {
+      CLog::Log(LOGERROR, "CCDDARipPipeline::EncodeTrack - error encoding %s", m_tracks[index].input.c_str());
+      ok = false;
+    }
+  }
+
+  if (encoder && !encoder->CloseEncode())
+    ok = false;
+
+  CSingleLock lock(m_section);
+  Track& track = m_tracks[index];
+  track.failed |= !ok || m_cancel;
+  track.done = true;
+  m_tracksEncoded++;
+  m_spaceCond.notifyAll();
+}
+
+bool CCDDARipPipeline::ReportProgress(const ProgressCallback& progress)
+{
+  if (!progress)
+    return false;
+  return progress(GetProgress());
+}
+
+CDDARipProgress CCDDARipPipeline::GetProgress() const
+{
+  CDDARipProgress progress;
+  CSingleLock lock(m_section);
+  progress.tracks = static_cast<unsigned int>(m_tracks.size());
+  progress.tracksRead = m_tracksRead;
+  progress.tracksEncoded = m_tracksEncoded;
+  progress.bytesBuffered = m_buffered;
+
+  float percent = 0.0f;
+  for (const auto& track : m_tracks)
+  {
+    progress.bytesRead += track.read;
+    progress.bytesEncoded += track.encoded;
+    if (track.done)
+      percent += 100.0f;
+    else if (track.length > 0)
+      percent += std::min(100.0f, 100.0f * track.encoded / track.length);
+  }
+  if (!m_tracks.empty())
+    progress.percent = percent / m_tracks.size();
+
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_startTime;
+  if (m_startTime && elapsed > 0)
+  {
+    progress.readRate = progress.bytesRead * 1000.0f / elapsed;
+    progress.encodeRate = progress.bytesEncoded * 1000.0f / elapsed;
+  }
+  return progress;
+}
+
+bool CCDDARipPipeline::IsTrackRipped(unsigned int track) const
+{
+  CSingleLock lock(m_section);
+  return track < m_tracks.size() && m_tracks[track].done && !m_tracks[track].failed;
+}
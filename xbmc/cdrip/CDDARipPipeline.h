@@ -0,0 +1,170 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include "PlatformDefs.h" // for ssize_t
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CEncoder;
+
+namespace XFILE
+{
+class CFile;
+}
+
+/*! \brief Source of raw PCM for the ripper, read one track at a time */
+class ICDDARipSource
+{
+public:
+  virtual ~ICDDARipSource() = default;
+  virtual bool Open(const std::string& input) = 0;
+  //! \return number of bytes read, 0 at the end of the track or negative on error
+  virtual ssize_t Read(void* buffer, size_t size) = 0;
+  virtual int64_t GetLength() = 0;
+  virtual void Close() = 0;
+};
+
+/*! \brief Reads tracks through the VFS, cdda:// urls or any other file */
+class CCDDARipFileSource : public ICDDARipSource
+{
+public:
+  CCDDARipFileSource();
+  ~CCDDARipFileSource() override;
+
+  bool Open(const std::string& input) override;
+  ssize_t Read(void* buffer, size_t size) override;
+  int64_t GetLength() override;
+  void Close() override;
+
+private:
+  std::unique_ptr<XFILE::CFile> m_file;
+};
+
+struct CDDARipProgress
+{
+  unsigned int tracks = 0;
+  unsigned int tracksRead = 0; //< tracks read from the source, including failed ones
+  unsigned int tracksEncoded = 0; //< tracks finished by the encoders, including failed ones
+  int64_t bytesRead = 0;
+  int64_t bytesEncoded = 0;
+  int64_t bytesBuffered = 0; //< read but not yet encoded
+  float readRate = 0.0f; //< bytes per second since the start
+  float encodeRate = 0.0f; //< bytes per second since the start
+  float percent = 0.0f; //< encoded share of all tracks
+};
+
+/*! \brief Streaming rip of a list of tracks
+
+ The source is read sequentially on the thread calling Run(), one track after the
+ other, into a bounded buffer of chunks. Tracks are handed to a pool of encoder
+ threads as soon as reading them starts, so reading runs ahead while several
+ tracks encode in parallel, and the rip runs at drive speed unless all encoders
+ are busy and the buffer is full.
+ */
+class CCDDARipPipeline
+{
+public:
+  //! \brief Create and initialize the encoder of a track
+  //! \param track Index of the track as returned by AddTrack
+  //! \param length Length of the track in bytes as reported by the source
+  //! \return The encoder, owned by the pipeline, or nullptr on failure
+  //! \note Called from the encoder threads, one call at a time. The pipeline is locked
+  //!       during the call, so the factory must not call back into it
+  typedef std::function<CEncoder*(unsigned int track, int64_t length)> EncoderFactory;
+
+  //! \brief Called on the reading thread, return true to cancel the rip
+  typedef std::function<bool(const CDDARipProgress& progress)> ProgressCallback;
+
+  //! \brief 32 CD sectors, a multiple of the sample frame size
+  static const size_t CHUNK_SIZE = 32 * 2352;
+  //! \brief About six minutes of CD audio
+  static const size_t DEFAULT_BUFFER_SIZE = 64 * 1024 * 1024;
+
+  //! \param source The source to read from
+  //! \param factory Creates the encoder of every track
+  //! \param encoders Number of encoder threads, 0 for one per CPU
+  //! \param bufferSize Maximum number of bytes read ahead of the encoders
+  CCDDARipPipeline(ICDDARipSource& source, const EncoderFactory& factory,
+                   unsigned int encoders = 0, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+  ~CCDDARipPipeline();
+
+  //! \return Index of the track
+  unsigned int AddTrack(const std::string& input);
+
+  //! \brief Rip all tracks, blocks until every track is encoded or the rip is cancelled
+  //! \return true if every track was ripped
+  bool Run(const ProgressCallback& progress = nullptr);
+
+  //! \brief Abort a running rip, may be called from any thread
+  void Cancel();
+
+  CDDARipProgress GetProgress() const;
+  bool IsTrackRipped(unsigned int track) const;
+
+private:
+  class CEncodeWorker;
+
+  struct Track
+  {
+    std::string input;
+    int64_t length = 0;
+    int64_t read = 0;
+    int64_t encoded = 0;
+    std::deque<std::vector<uint8_t>> chunks;
+    bool opened = false;
+    bool readDone = false;
+    bool failed = false;
+    bool done = false;
+  };
+
+  void ReadTrack(unsigned int index);
+  void EncodeTrack(unsigned int index);
+  void EncodeTracks();
+  bool ReportProgress(const ProgressCallback& progress);
+
+  ICDDARipSource& m_source;
+  EncoderFactory m_factory;
+  unsigned int m_encoders;
+  size_t m_bufferSize;
+
+  std::vector<Track> m_tracks;
+  std::vector<std::vector<uint8_t>> m_freeChunks;
+  size_t m_buffered = 0;
+  unsigned int m_nextEncode = 0;
+  unsigned int m_tracksRead = 0;
+  unsigned int m_tracksEncoded = 0;
+  unsigned int m_startTime = 0;
+  std::atomic_bool m_cancel;
+
+  mutable CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_dataCond; //< new chunks, tracks or end of input
+  XbmcThreads::ConditionVariable m_spaceCond; //< chunks were consumed or tracks finished
+};
@@ -124,7 +124,8 @@ bool CCDDARipper::RipCD()
   if (!CreateAlbumDir(*vecItems[0]->GetMusicInfoTag(), strDirectory, legalType))
     return false;
 
-  // rip all tracks one by one
+  // rip all tracks in one job, the disc is read once while the tracks are encoded in parallel
+  CCDDARipJob* job = nullptr;
   for (int i = 0; i < vecItems.Size(); i++)
   {
     CFileItemPtr item = vecItems[i];
@@ -136,12 +137,18 @@ bool CCDDARipper::RipCD()
     if (item->GetPath().find(".cdda") == std::string::npos)
       continue;
 
-    bool eject = CServiceBroker::GetSettings().GetBool(CSettings::SETTING_AUDIOCDS_EJECTONRIP) && 
-                 i == vecItems.Size()-1;
-    AddJob(new CCDDARipJob(item->GetPath(),strFile,
-                           *item->GetMusicInfoTag(),
-                           CServiceBroker::GetSettings().GetInt(CSettings::SETTING_AUDIOCDS_ENCODER), eject));
+    if (job)
+      job->AddTrack(item->GetPath(), strFile, *item->GetMusicInfoTag());
+    else
+    {
+      bool eject = CServiceBroker::GetSettings().GetBool(CSettings::SETTING_AUDIOCDS_EJECTONRIP);
+      job = new CCDDARipJob(item->GetPath(), strFile,
+                            *item->GetMusicInfoTag(),
+                            CServiceBroker::GetSettings().GetInt(CSettings::SETTING_AUDIOCDS_ENCODER), eject);
+    }
   }
+  if (job)
+    AddJob(job);
 
   return true;
 }
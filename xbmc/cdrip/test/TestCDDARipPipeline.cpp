@@ -0,0 +1,225 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cdrip/CDDARipPipeline.h"
+#include "cdrip/Encoder.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// stands in for the drive, every track is a temp file
+class CFakeCDDASource : public CCDDARipFileSource
+{
+public:
+  bool Open(const std::string& input) override
+  {
+    m_opened.push_back(input);
+    return CCDDARipFileSource::Open(input);
+  }
+
+  std::vector<std::string> m_opened;
+};
+
+class CFakeEncoder : public CEncoder
+{
+public:
+  CFakeEncoder(std::vector<uint8_t>& output, std::atomic_int& active, std::atomic_int& maxActive, int delay)
+    : CEncoder(nullptr), m_output(output), m_active(active), m_maxActive(maxActive), m_delay(delay)
+  { }
+
+  int Encode(int nNumBytesRead, uint8_t* pbtStream) override
+  {
+    int active = ++m_active;
+    int max = m_maxActive;
+    while (active > max && !m_maxActive.compare_exchange_weak(max, active))
+      ;
+    if (m_delay)
+      std::this_thread::sleep_for(std::chrono::milliseconds(m_delay));
+    m_output.insert(m_output.end(), pbtStream, pbtStream + nNumBytesRead);
+    m_active--;
+    return 1;
+  }
+
+  bool CloseEncode() override { return true; }
+
+private:
+  std::vector<uint8_t>& m_output;
+  std::atomic_int& m_active;
+  std::atomic_int& m_maxActive;
+  int m_delay;
+};
+
+class TestCDDARipPipeline : public ::testing::Test
+{
+protected:
+  ~TestCDDARipPipeline() override
+  {
+    for (auto file : m_files)
+      XBMC_DELETETEMPFILE(file);
+  }
+
+  std::string CreateTrack(size_t size)
+  {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++)
+      data[i] = static_cast<uint8_t>(i * 7 + m_files.size());
+
+    XFILE::CFile* file = XBMC_CREATETEMPFILE(".cdda");
+    file->Close();
+    std::string path = XBMC_TEMPFILEPATH(file);
+    file->OpenForWrite(path, true);
+    file->Write(data.data(), data.size());
+    file->Close();
+
+    m_files.push_back(file);
+    m_data.push_back(data);
+    m_output.emplace_back();
+    return path;
+  }
+
+  CCDDARipPipeline::EncoderFactory Factory(int delay)
+  {
+    return [this, delay](unsigned int track, int64_t length) -> CEncoder*
+    {
+      EXPECT_EQ(static_cast<int64_t>(m_data[track].size()), length);
+      return new CFakeEncoder(m_output[track], m_active, m_maxActive, delay);
+    };
+  }
+
+  std::vector<XFILE::CFile*> m_files;
+  std::vector<std::vector<uint8_t>> m_data;
+  std::vector<std::vector<uint8_t>> m_output;
+  std::atomic_int m_active{0};
+  std::atomic_int m_maxActive{0};
+};
+}
+
+TEST_F(TestCDDARipPipeline, ParallelEncode)
+{
+  CFakeCDDASource source;
+  CCDDARipPipeline pipeline(source, Factory(5), 3);
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE * 4 + 100));
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE * 3));
+  pipeline.AddTrack(CreateTrack(1000));
+
+  EXPECT_TRUE(pipeline.Run());
+  EXPECT_EQ(3U, source.m_opened.size());
+  for (unsigned int i = 0; i < m_data.size(); i++)
+  {
+    EXPECT_TRUE(pipeline.IsTrackRipped(i));
+    EXPECT_EQ(m_data[i], m_output[i]);
+  }
+  // reading ran ahead and the tracks were encoded side by side
+  EXPECT_GT(m_maxActive, 1);
+
+  CDDARipProgress progress = pipeline.GetProgress();
+  EXPECT_EQ(3U, progress.tracksRead);
+  EXPECT_EQ(3U, progress.tracksEncoded);
+  EXPECT_EQ(progress.bytesRead, progress.bytesEncoded);
+  EXPECT_EQ(0, progress.bytesBuffered);
+  EXPECT_FLOAT_EQ(100.0f, progress.percent);
+}
+
+TEST_F(TestCDDARipPipeline, BoundedBuffer)
+{
+  const size_t bufferSize = CCDDARipPipeline::CHUNK_SIZE * 2;
+  CFakeCDDASource source;
+  CCDDARipPipeline pipeline(source, Factory(2), 2, bufferSize);
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE * 6));
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE * 5 + 4));
+
+  int64_t maxBuffered = 0;
+  EXPECT_TRUE(pipeline.Run([&maxBuffered](const CDDARipProgress& progress)
+  {
+    maxBuffered = std::max(maxBuffered, progress.bytesBuffered);
+    return false;
+  }));
+  EXPECT_LE(maxBuffered, static_cast<int64_t>(bufferSize));
+  EXPECT_EQ(m_data[0], m_output[0]);
+  EXPECT_EQ(m_data[1], m_output[1]);
+}
+
+TEST_F(TestCDDARipPipeline, Failures)
+{
+  CFakeCDDASource source;
+  CCDDARipPipeline::EncoderFactory factory = Factory(0);
+  CCDDARipPipeline pipeline(source, [&factory](unsigned int track, int64_t length) -> CEncoder*
+  {
+    return track == 1 ? nullptr : factory(track, length);
+  }, 2);
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE * 2));
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE * 2));
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE));
+  pipeline.AddTrack(XBMC_TEMPFILEPATH(m_files[0]) + ".missing");
+
+  EXPECT_FALSE(pipeline.Run());
+  EXPECT_TRUE(pipeline.IsTrackRipped(0));
+  EXPECT_FALSE(pipeline.IsTrackRipped(1));
+  EXPECT_TRUE(pipeline.IsTrackRipped(2));
+  EXPECT_FALSE(pipeline.IsTrackRipped(3));
+  EXPECT_EQ(m_data[2], m_output[2]);
+}
+
+TEST_F(TestCDDARipPipeline, Cancel)
+{
+  CFakeCDDASource source;
+  CCDDARipPipeline pipeline(source, Factory(0), 2);
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE * 4));
+  pipeline.AddTrack(CreateTrack(CCDDARipPipeline::CHUNK_SIZE * 4));
+
+  EXPECT_FALSE(pipeline.Run([](const CDDARipProgress& progress) { return true; }));
+  EXPECT_EQ(1U, source.m_opened.size());
+  EXPECT_FALSE(pipeline.IsTrackRipped(1));
+}
+
+TEST_F(TestCDDARipPipeline, SerialEncoderSetup)
+{
+  CFakeCDDASource source;
+  CCDDARipPipeline::EncoderFactory factory = Factory(0);
+  std::atomic_int setups{0};
+  std::atomic_int maxSetups{0};
+  CCDDARipPipeline pipeline(source, [&](unsigned int track, int64_t length) -> CEncoder*
+  {
+    int active = ++setups;
+    int max = maxSetups;
+    while (active > max && !maxSetups.compare_exchange_weak(max, active))
+      ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    setups--;
+    return factory(track, length);
+  }, 3);
+  pipeline.AddTrack(CreateTrack(1000));
+  pipeline.AddTrack(CreateTrack(1000));
+  pipeline.AddTrack(CreateTrack(1000));
+
+  EXPECT_TRUE(pipeline.Run());
+  // the encoders share codec and settings state while they are set up
+  EXPECT_EQ(1, maxSetups);
+  for (unsigned int i = 0; i < m_data.size(); i++)
+    EXPECT_EQ(m_data[i], m_output[i]);
+}
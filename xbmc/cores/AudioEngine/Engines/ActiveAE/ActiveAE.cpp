@@ -28,18 +28,24 @@ using namespace ActiveAE;
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSP.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSPProcess.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "cores/AudioEngine/Utils/AESinkTelemetry.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
 
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "windowing/WinSystem.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
+#define PIPELINE_STATS_INTERVAL 10000 // ms between buffer pipeline reports
+#define SPECTRUM_READ_TIMEOUT 2000    // ms the spectrum is analyzed after it was polled last
 
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
@@ -289,10 +295,13 @@ CActiveAE::CActiveAE() :
   m_mode = MODE_PCM;
   m_encoder = NULL;
   m_vizInitialized = false;
+  m_spectrumReadTime = 0;
   m_sinkHasVolume = false;
   m_aeGUISoundForce = false;
   m_stats.Reset(44100, true);
   m_streamIdGen = 0;
+  // starting a gui sound should not allocate
+  m_sounds_playing.reserve(MAX_SOUNDS_PLAYING);
 
   m_settingsHandler.reset(new CActiveAESettings(*this));
 }
@@ -428,12 +437,6 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
-          CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
-          if (buffer)
-          {
-            (*buffer)->Return();
-          }
           return;
         default:
           break;
@@ -724,6 +727,10 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
                 !m_aeGUISoundForce)
               return;
 
+            // stay within the reserved capacity, the oldest sound gives way
+            if (m_sounds_playing.size() >= MAX_SOUNDS_PLAYING)
+              m_sounds_playing.erase(m_sounds_playing.begin());
+
             SoundState st = {sound, 0};
             m_sounds_playing.push_back(st);
             m_extTimeout = 0;
@@ -805,12 +812,6 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
-          CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
-          if (buffer)
-          {
-            (*buffer)->Return();
-          }
           m_extTimeout = 0;
           m_state = AE_TOP_CONFIGURED_PLAY;
           return;
@@ -864,12 +865,6 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CSinkDataProtocol::RETURNSAMPLE:
-          CSampleBuffer **buffer;
-          buffer = (CSampleBuffer**)msg->data;
-          if (buffer)
-          {
-            (*buffer)->Return();
-          }
           return;
         default:
           break;
@@ -1355,7 +1350,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         m_discardBufferPools.push_back(m_vizBuffersInput);
         m_vizBuffersInput = NULL;
       }
-      if (!m_vizBuffers && !m_audioCallback.empty())
+      if (!m_vizBuffers && HasVizConsumers())
       {
         AEAudioFormat vizFormat = m_internalFormat;
         vizFormat.m_channelLayout = AE_CH_LAYOUT_2_0;
@@ -1401,10 +1396,13 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
        (m_settings.guisoundmode == AE_SOUND_IDLE && m_streams.empty()) ||
        m_aeGUISoundForce)
     {
+      // pick up conversions to this format from the cache, the remaining
+      // sounds are converted while the engine is idle
       std::vector<CActiveAESound*>::iterator it;
       for (it = m_sounds.begin(); it != m_sounds.end(); ++it)
       {
         (*it)->SetConverted(false);
+        ResampleSound(*it, true);
       }
     }
     m_sounds_playing.clear();
@@ -1566,7 +1564,7 @@ void CActiveAE::ClearDiscardedBuffers()
       rbuf->Flush();
     }
     // if all buffers have returned, we can delete the buffer pool
-    if ((*it)->m_allSamples.size() == (*it)->m_freeSamples.size())
+    if ((*it)->AllBuffersFree())
     {
       delete (*it);
       CLog::Log(LOGDEBUG, "CActiveAE::ClearDiscardedBuffers - buffer pool deleted");
@@ -1577,9 +1575,48 @@ void CActiveAE::ClearDiscardedBuffers()
   }
 }
 
+void CActiveAE::LogPipelineStats()
+{
+  if (!g_advancedSettings.CanLogComponent(LOGAUDIO))
+    return;
+
+  // latency is the time a buffer spends between leaving and re-entering its
+  // pool, queued counts buffers waiting inside the engine for the next stage
+  auto log = [](const std::string& stage, CActiveAEBufferPool* pool, size_t queued)
+  {
+    SBufferPoolStats stats;
+    pool->GetStats(stats, true);
+    CLog::Log(LOGDEBUG, "CActiveAE::LogPipelineStats - %s: buffers %u, in use %u (peak %u), queued %u, "
+              "latency avg %.1f ms max %.1f ms over %u buffers",
+              stage.c_str(), stats.buffers, stats.inUse, stats.maxInUse, static_cast<unsigned int>(queued),
+              stats.avgLatency, stats.maxLatency, stats.returned);
+  };
+
+  for (auto stream : m_streams)
+  {
+    size_t queued = 0;
+    if (stream->m_processingBuffers)
+      queued += stream->m_processingBuffers->m_inputSamples.size() + stream->m_processingBuffers->m_outputSamples.size();
+    if (stream->m_inputBuffers)
+      log(StringUtils::Format("stream %u", stream->m_id), stream->m_inputBuffers, queued);
+  }
+
+  if (m_sinkBuffers)
+    log("sink", m_sinkBuffers, m_sinkBuffers->m_inputSamples.size() + m_sinkBuffers->m_outputSamples.size());
+
+  CAESinkTelemetry &telemetry = CAESinkTelemetry::GetInstance();
+  CLog::Log(LOGDEBUG, "CActiveAE::LogPipelineStats - device: %u writes, %u underruns, "
+            "delay jitter p50 %.1f ms p99 %.1f ms, wakeup lateness p50 %.1f ms p99 %.1f ms",
+            telemetry.GetWrites(), telemetry.GetUnderruns(),
+            telemetry.GetDelayJitter().GetPercentile(50.0) / 1000.0,
+            telemetry.GetDelayJitter().GetPercentile(99.0) / 1000.0,
+            telemetry.GetWakeupLateness().GetPercentile(50.0) / 1000.0,
+            telemetry.GetWakeupLateness().GetPercentile(99.0) / 1000.0);
+}
+
 void CActiveAE::SStopSound(CActiveAESound *sound)
 {
-  std::list<SoundState>::iterator it;
+  std::vector<SoundState>::iterator it;
   for (it=m_sounds_playing.begin(); it!=m_sounds_playing.end(); ++it)
   {
     if (it->sound == sound)
@@ -1603,6 +1640,7 @@ void CActiveAE::DiscardSound(CActiveAESound *sound)
     {
       m_sounds.erase(it);
       delete sound;
+      m_soundCache.Purge();
       return;
     }
   }
@@ -1891,7 +1929,7 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
+      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && (*it)->m_inputBuffers->HasFreeBuffers())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
@@ -1931,7 +1969,7 @@ bool CActiveAE::RunStages()
   }
 
   if (m_stats.GetWaterLevel() < MAX_WATER_LEVEL &&
-     (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
+     (m_mode != MODE_TRANSCODE || (m_encoderBuffers && m_encoderBuffers->HasFreeBuffers())))
   {
     // calculate sync error
     for (it = m_streams.begin(); it != m_streams.end(); ++it)
@@ -1972,7 +2010,7 @@ bool CActiveAE::RunStages()
       CSampleBuffer *out = NULL;
       if (!m_sounds_playing.empty() && m_streams.empty())
       {
-        if (m_silenceBuffers && !m_silenceBuffers->m_freeSamples.empty())
+        if (m_silenceBuffers && m_silenceBuffers->HasFreeBuffers())
         {
           out = m_silenceBuffers->GetFreeBuffer();
           for (int i=0; i<out->pkt->planes; i++)
@@ -2080,15 +2118,7 @@ bool CActiveAE::RunStages()
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                CAEKernels::Mul((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2149,24 +2179,9 @@ bool CActiveAE::RunStages()
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                CAEKernels::MulAdd(dst, src, volume, nb_floats);
+                if (!needClamp)
+                  needClamp = CAEKernels::NeedsClamp(dst, nb_floats);
               }
             }
             mix->Return();
@@ -2181,7 +2196,7 @@ bool CActiveAE::RunStages()
         int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
         for(int i=0; i<out->pkt->planes; i++)
         {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
+          CAEKernels::Clamp((float*)out->pkt->data[i], nb_floats);
         }
       }
 
@@ -2191,17 +2206,18 @@ bool CActiveAE::RunStages()
         // viz
         {
           CSingleLock lock(m_vizLock);
-          if (!m_audioCallback.empty() && !m_streams.empty())
+          if (HasVizConsumers() && !m_streams.empty())
           {
             if (!m_vizInitialized || !m_vizBuffers)
             {
               Configure();
+              m_spectrumAnalyzer.Start();
               for (auto& it : m_audioCallback)
                 it->OnInitialize(2, m_vizBuffers->m_format.m_sampleRate, 32);
               m_vizInitialized = true;
             }
 
-            if (!m_vizBuffersInput->m_freeSamples.empty())
+            if (m_vizBuffersInput->HasFreeBuffers())
             {
               // copy the samples into the viz input buffer
               CSampleBuffer *viz = m_vizBuffersInput->GetFreeBuffer();
@@ -2220,7 +2236,21 @@ bool CActiveAE::RunStages()
             m_stats.GetDelay(status);
             int64_t now = XbmcThreads::SystemClockMillis();
             int64_t timestamp = now + status.GetDelay() * 1000;
+            // the viz buffers were flushed or replaced since the last packet
+            size_t queued = m_vizBuffers->m_outputSamples.size();
+            if (m_vizPackets.size() != queued)
+            {
+              m_spectrumAnalyzer.Flush();
+              m_vizPackets.assign(queued, CAESpectrumAnalyzer::NO_PACKET);
+            }
             busy |= m_vizBuffers->ResampleBuffers(timestamp);
+            // analyze the packets while they wait for their playback time
+            for (size_t i = queued; i < m_vizBuffers->m_outputSamples.size(); i++)
+            {
+              CSampleBuffer *buf = m_vizBuffers->m_outputSamples[i];
+              unsigned int samples = static_cast<unsigned int>(buf->pkt->nb_samples);
+              m_vizPackets.push_back(m_spectrumAnalyzer.AddSamples((float*)(buf->pkt->data[0]), samples, m_vizBuffers->m_format.m_sampleRate));
+            }
             while(!m_vizBuffers->m_outputSamples.empty())
             {
               CSampleBuffer *buf = m_vizBuffers->m_outputSamples.front();
@@ -2229,6 +2259,8 @@ bool CActiveAE::RunStages()
               else
               {
                 unsigned int samples = static_cast<unsigned int>(buf->pkt->nb_samples);
+                m_spectrumAnalyzer.Publish(m_vizPackets.front());
+                m_vizPackets.pop_front();
                 for (auto& it : m_audioCallback)
                   it->OnAudioData((float*)(buf->pkt->data[0]), samples);
                 buf->Return();
@@ -2236,8 +2268,17 @@ bool CActiveAE::RunStages()
               }
             }
           }
-          else if (m_vizBuffers)
-            m_vizBuffers->Flush();
+          else
+          {
+            if (m_vizBuffers)
+              m_vizBuffers->Flush();
+            // the last reader stopped polling the spectrum
+            if (m_vizInitialized && !HasVizConsumers())
+            {
+              m_spectrumAnalyzer.Stop();
+              m_vizInitialized = false;
+            }
+          }
         }
 
         // mix gui sounds
@@ -2305,6 +2346,12 @@ bool CActiveAE::RunStages()
     busy = true;
   }
 
+  if (m_pipelineStatsTimer.IsTimePast())
+  {
+    LogPipelineStats();
+    m_pipelineStatsTimer.Set(PIPELINE_STATS_INTERVAL);
+  }
+
   return busy;
 }
 
@@ -2527,7 +2574,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
   float *sample_buffer;
   int max_samples = dstSample.nb_samples;
 
-  std::list<SoundState>::iterator it;
+  std::vector<SoundState>::iterator it;
   for (it = m_sounds_playing.begin(); it != m_sounds_playing.end(); )
   {
     if (!it->sound->IsConverted())
@@ -2545,12 +2592,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEKernels::MulAdd(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2575,13 +2617,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEKernels::Mul(buffer, volume, nb_floats);
     }
   }
 }
@@ -2993,6 +3029,16 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
   SampleConfig config;
 
   sound = new CActiveAESound(file, this);
+
+  // sounds of the same file share the decoded data
+  std::shared_ptr<CSoundPacket> cached = m_soundCache.GetDecoded(file);
+  if (cached)
+  {
+    sound->SetSound(true, cached);
+    m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
+    return sound;
+  }
+
   if (!sound->Prepare())
   {
     delete sound;
@@ -3114,6 +3160,12 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
 
   sound->Finish();
 
+  if (sound->GetSound(true))
+  {
+    sound->SetSound(true, m_soundCache.AddDecoded(file, sound->GetSound(true)));
+    m_soundCache.Purge();
+  }
+
   // register sound
   m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
 
@@ -3152,6 +3204,8 @@ void CActiveAE::ResampleSounds()
   {
     if (!(*it)->IsConverted())
     {
+      if (ResampleSound(*it, true))
+        continue;
       ResampleSound(*it);
       // only do one sound, then yield to main loop
       break;
@@ -3159,7 +3213,7 @@ void CActiveAE::ResampleSounds()
   }
 }
 
-bool CActiveAE::ResampleSound(CActiveAESound *sound)
+bool CActiveAE::ResampleSound(CActiveAESound *sound, bool cachedOnly /* = false */)
 {
   SampleConfig orig_config, dst_config;
   uint8_t **dst_buffer;
@@ -3181,6 +3235,21 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
   dst_config.dither_bits = CAEUtil::DataFormatToDitherBits(m_internalFormat.m_dataFormat);
 
   AEChannel testChannel = sound->GetChannel();
+
+  SoundFormat format;
+  format.config = dst_config;
+  format.channel = sound->GetSound(true)->config.channels == 1 ? testChannel : AE_CH_NULL;
+  format.quality = m_settings.resampleQuality;
+
+  std::shared_ptr<CSoundPacket> cached = m_soundCache.GetConverted(sound->GetSound(true), format);
+  if (cached)
+  {
+    sound->SetSound(false, cached);
+    return true;
+  }
+  if (cachedOnly)
+    return false;
+
   CAEChannelInfo outChannels;
   if (sound->GetSound(true)->config.channels == 1 && testChannel != AE_CH_NULL)
   {
@@ -3233,6 +3302,7 @@ bool CActiveAE::ResampleSound(CActiveAESound *sound)
 
   delete resampler;
   sound->SetConverted(true);
+  m_soundCache.AddConverted(sound->GetSound(true), format, sound->GetSound(false));
   return true;
 }
 
@@ -3404,6 +3474,7 @@ void CActiveAE::RegisterAudioCallback(IAudioCallback* pCallback)
   CSingleLock lock(m_vizLock);
   m_audioCallback.push_back(pCallback);
   m_vizInitialized = false;
+  m_spectrumAnalyzer.Start();
 }
 
 void CActiveAE::UnregisterAudioCallback(IAudioCallback* pCallback)
@@ -3412,4 +3483,22 @@ void CActiveAE::UnregisterAudioCallback(IAudioCallback* pCallback)
   auto it = std::find(m_audioCallback.begin(), m_audioCallback.end(), pCallback);
   if (it != m_audioCallback.end())
     m_audioCallback.erase(it);
+  if (!HasVizConsumers())
+    m_spectrumAnalyzer.Stop();
+}
+
+bool CActiveAE::GetSpectrum(AESpectrum& spectrum)
+{
+  // polling keeps the analysis running, the engine starts it with the next packet
+  m_spectrumReadTime = XbmcThreads::SystemClockMillis();
+  return m_spectrumAnalyzer.GetSpectrum(spectrum);
+}
+
+bool CActiveAE::HasVizConsumers() const
+{
+  if (!m_audioCallback.empty())
+    return true;
+
+  unsigned int readTime = m_spectrumReadTime;
+  return readTime && XbmcThreads::SystemClockMillis() - readTime < SPECTRUM_READ_TIMEOUT;
 }
@@ -19,6 +19,8 @@
  *
  */
 
+#include <atomic>
+#include <deque>
 #include <list>
 #include <string>
 #include <vector>
@@ -30,6 +32,8 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESoundCache.h"
+#include "cores/AudioEngine/Utils/AESpectrumAnalyzer.h"
 
 #include "guilib/DispResource.h"
 #include <queue>
@@ -273,6 +277,7 @@ public:
 
   void RegisterAudioCallback(IAudioCallback* pCallback) override;
   void UnregisterAudioCallback(IAudioCallback* pCallback) override;
+  bool GetSpectrum(AESpectrum& spectrum) override;
 
   void OnLostDisplay() override;
   void OnResetDisplay() override;
@@ -317,6 +322,7 @@ protected:
   void SFlushStream(CActiveAEStream *stream);
   void FlushEngine();
   void ClearDiscardedBuffers();
+  void LogPipelineStats();
   void SStopSound(CActiveAESound *sound);
   void DiscardSound(CActiveAESound *sound);
   void ChangeResamplers();
@@ -326,7 +332,7 @@ protected:
   CSampleBuffer* SyncStream(CActiveAEStream *stream);
 
   void ResampleSounds();
-  bool ResampleSound(CActiveAESound *sound);
+  bool ResampleSound(CActiveAESound *sound, bool cachedOnly = false);
   void MixSounds(CSoundPacket &dstSample);
   void Deamplify(CSoundPacket &dstSample);
 
@@ -342,6 +348,7 @@ protected:
   bool m_extError;
   bool m_extDrain;
   XbmcThreads::EndTime m_extDrainTimer;
+  XbmcThreads::EndTime m_pipelineStatsTimer;
   unsigned int m_extKeepConfig;
   bool m_extDeferData;
   std::queue<time_t> m_extLastDeviceChange;
@@ -378,13 +385,15 @@ protected:
   unsigned int m_streamIdGen;
 
   // gui sounds
+  static const size_t MAX_SOUNDS_PLAYING = 16;
   struct SoundState
   {
     CActiveAESound *sound;
     int samples_played;
   };
-  std::list<SoundState> m_sounds_playing;
+  std::vector<SoundState> m_sounds_playing;
   std::vector<CActiveAESound*> m_sounds;
+  CActiveAESoundCache m_soundCache;
 
   float m_volume; // volume on a 0..1 scale corresponding to a proportion along the dB scale
   float m_volumeScaled; // multiplier to scale samples in order to achieve the volume specified in m_volume
@@ -392,9 +401,13 @@ protected:
   bool m_sinkHasVolume;
 
   // viz
+  bool HasVizConsumers() const;
   std::vector<IAudioCallback*> m_audioCallback;
   bool m_vizInitialized;
   CCriticalSection m_vizLock;
+  CAESpectrumAnalyzer m_spectrumAnalyzer;
+  std::deque<uint64_t> m_vizPackets; // spectrum packets of the viz output samples
+  std::atomic<unsigned int> m_spectrumReadTime; // last time the spectrum was polled via GetSpectrum, 0 if never
 
   // polled via the interface
   float m_aeVolume;
@@ -25,6 +25,9 @@
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
 
 using namespace ActiveAE;
 
@@ -47,6 +50,8 @@ CSampleBuffer::CSampleBuffer() : pkt(NULL), pool(NULL)
   refCount = 0;
   timestamp = 0;
   pkt_start_offset = 0;
+  next = nullptr;
+  acquired = 0;
 }
 
 CSampleBuffer::~CSampleBuffer()
@@ -62,13 +67,19 @@ CSampleBuffer* CSampleBuffer::Acquire()
 
 void CSampleBuffer::Return()
 {
-  refCount--;
-  if (pool && refCount <= 0)
+  // only the thread dropping the last reference may recycle the buffer
+  if (--refCount == 0 && pool)
     pool->ReturnBuffer(this);
 }
 
 CActiveAEBufferPool::CActiveAEBufferPool(const AEAudioFormat& format)
 {
+  m_freeHead = nullptr;
+  m_freeCount = 0;
+  m_maxInUse = 0;
+  m_returned = 0;
+  m_latencySum = 0;
+  m_latencyMax = 0;
   m_format = format;
   if (m_format.m_dataFormat == AE_FMT_RAW)
   {
@@ -92,13 +103,21 @@ CActiveAEBufferPool::~CActiveAEBufferPool()
 
 CSampleBuffer* CActiveAEBufferPool::GetFreeBuffer()
 {
-  CSampleBuffer* buf = NULL;
+  // single consumer: nobody else can pop the head, so reading its link is
+  // safe and the head cannot come back as ABA while we hold it
+  CSampleBuffer* buf = m_freeHead.load(std::memory_order_acquire);
+  while (buf && !m_freeHead.compare_exchange_weak(buf, buf->next, std::memory_order_acquire))
+    ;
 
-  if (!m_freeSamples.empty())
+  if (buf)
   {
-    buf = m_freeSamples.front();
-    m_freeSamples.pop_front();
+    int inUse = static_cast<int>(m_allSamples.size()) - --m_freeCount;
+    if (inUse > static_cast<int>(m_maxInUse))
+      m_maxInUse = std::min(inUse, static_cast<int>(m_allSamples.size()));
+
+    buf->next = nullptr;
     buf->refCount = 1;
+    buf->acquired = CurrentHostCounter();
   }
   return buf;
 }
@@ -107,7 +126,38 @@ void CActiveAEBufferPool::ReturnBuffer(CSampleBuffer *buffer)
 {
   buffer->pkt->nb_samples = 0;
   buffer->pkt->pause_burst_ms = 0;
-  m_freeSamples.push_back(buffer);
+
+  int64_t latency = CurrentHostCounter() - buffer->acquired;
+  m_latencySum += latency;
+  int64_t max = m_latencyMax;
+  while (latency > max && !m_latencyMax.compare_exchange_weak(max, latency))
+    ;
+  m_returned++;
+
+  CSampleBuffer* head = m_freeHead.load(std::memory_order_relaxed);
+  do
+  {
+    buffer->next = head;
+  } while (!m_freeHead.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+  m_freeCount++;
+}
+
+void CActiveAEBufferPool::GetStats(SBufferPoolStats& stats, bool reset)
+{
+  unsigned int returned = reset ? m_returned.exchange(0) : m_returned.load();
+  int64_t sum = reset ? m_latencySum.exchange(0) : m_latencySum.load();
+  int64_t max = reset ? m_latencyMax.exchange(0) : m_latencyMax.load();
+  double msPerTick = 1000.0 / CurrentHostFrequency();
+
+  stats.buffers = m_allSamples.size();
+  stats.inUse = stats.buffers - std::max(0, std::min(static_cast<int>(stats.buffers), m_freeCount.load()));
+  stats.maxInUse = m_maxInUse;
+  stats.returned = returned;
+  stats.avgLatency = returned ? static_cast<float>(sum * msPerTick / returned) : 0.0f;
+  stats.maxLatency = static_cast<float>(max * msPerTick);
+
+  if (reset)
+    m_maxInUse = stats.inUse;
 }
 
 bool CActiveAEBufferPool::Create(unsigned int totaltime)
@@ -135,7 +185,9 @@ bool CActiveAEBufferPool::Create(unsigned int totaltime)
     buffer->pkt = new CSoundPacket(config, m_format.m_frames);
 
     m_allSamples.push_back(buffer);
-    m_freeSamples.push_back(buffer);
+    buffer->next = m_freeHead;
+    m_freeHead = buffer;
+    m_freeCount++;
     time += buffertime;
     n++;
   }
@@ -278,7 +330,7 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
       busy = true;
     }
   }
-  else if (m_procSample || !m_freeSamples.empty())
+  else if (m_procSample || HasFreeBuffers())
   {
     int free_samples;
     if (m_procSample)
@@ -551,7 +603,7 @@ bool CActiveAEBufferPoolAtempo::ProcessBuffers()
       busy = true;
     }
   }
-  else if (m_procSample || !m_freeSamples.empty())
+  else if (m_procSample || HasFreeBuffers())
   {
     bool skipInput = false;
 
@@ -22,6 +22,7 @@
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Engines/ActiveAE/AudioDSPAddons/ActiveAEDSP.h"
+#include <atomic>
 #include <deque>
 #include <memory>
 
@@ -63,6 +64,10 @@ public:
 
 class CActiveAEBufferPool;
 
+/**
+ * Reference counted sample buffer. Acquire and Return may be called from any
+ * thread, the last Return hands the buffer back to its pool.
+ */
 class CSampleBuffer
 {
 public:
@@ -74,9 +79,25 @@ public:
   CActiveAEBufferPool *pool;
   int64_t timestamp;
   int pkt_start_offset;
-  int refCount;
+  std::atomic<int> refCount;
+  CSampleBuffer *next;                   // link in the free list of the pool
+  int64_t acquired;                      // host counter when taken from the pool
+};
+
+struct SBufferPoolStats
+{
+  unsigned int buffers;                  // buffers owned by the pool
+  unsigned int inUse;                    // buffers currently taken from the pool
+  unsigned int maxInUse;                 // peak of inUse since the last reset
+  unsigned int returned;                 // buffers returned since the last reset
+  float avgLatency;                      // ms a buffer stayed out of the pool
+  float maxLatency;
 };
 
+/**
+ * Buffers are kept on an intrusive lock-free free list. Any thread may return
+ * a buffer, GetFreeBuffer must only be called from the engine thread.
+ */
 class CActiveAEBufferPool
 {
 public:
@@ -85,9 +106,19 @@ public:
   virtual bool Create(unsigned int totaltime);
   CSampleBuffer *GetFreeBuffer();
   void ReturnBuffer(CSampleBuffer *buffer);
+  bool HasFreeBuffers() const { return m_freeCount > 0; }
+  bool AllBuffersFree() const { return m_freeCount == static_cast<int>(m_allSamples.size()); }
+  void GetStats(SBufferPoolStats& stats, bool reset);
   AEAudioFormat m_format;
   std::deque<CSampleBuffer*> m_allSamples;
-  std::deque<CSampleBuffer*> m_freeSamples;
+
+protected:
+  std::atomic<CSampleBuffer*> m_freeHead;
+  std::atomic<int> m_freeCount;        // may briefly lag behind the list
+  unsigned int m_maxInUse;
+  std::atomic<unsigned int> m_returned;
+  std::atomic<int64_t> m_latencySum;
+  std::atomic<int64_t> m_latencyMax;
 };
 
 class IAEResample;
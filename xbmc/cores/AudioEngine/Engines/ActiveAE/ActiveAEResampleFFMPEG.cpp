@@ -18,10 +18,17 @@
  *
  */
 
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "ActiveAEResampleFFMPEG.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <list>
+#include <string.h>
+
 extern "C" {
 #include "libavutil/channel_layout.h"
 #include "libavutil/opt.h"
@@ -30,19 +37,108 @@ extern "C" {
 
 using namespace ActiveAE;
 
+// initialised contexts kept for reuse, the filter bank of a context for high
+// quality resampling takes about 1MB
+#define RESAMPLE_CACHE_SIZE 4
+
+namespace
+{
+class CContextCache
+{
+public:
+  ~CContextCache()
+  {
+    for (auto& entry : m_contexts)
+      swr_free(&entry.second);
+  }
+
+  SwrContext* Acquire(const CActiveAEResampleFFMPEG::ContextKey& key)
+  {
+    SwrContext* context = nullptr;
+    {
+      CSingleLock lock(m_section);
+      auto it = std::find_if(m_contexts.begin(), m_contexts.end(),
+                             [&key](const std::pair<CActiveAEResampleFFMPEG::ContextKey, SwrContext*>& entry)
+                             {
+                               return entry.first == key;
+                             });
+      if (it == m_contexts.end())
+        return nullptr;
+      context = it->second;
+      m_contexts.erase(it);
+    }
+
+    // resets the state of the previous user, the filter bank is kept because
+    // the parameters did not change
+    if (swr_init(context) < 0)
+    {
+      swr_free(&context);
+      return nullptr;
+    }
+    return context;
+  }
+
+  void Release(const CActiveAEResampleFFMPEG::ContextKey& key, SwrContext* context)
+  {
+    CSingleLock lock(m_section);
+    m_contexts.emplace_front(key, context);
+    while (m_contexts.size() > RESAMPLE_CACHE_SIZE)
+    {
+      swr_free(&m_contexts.back().second);
+      m_contexts.pop_back();
+    }
+  }
+
+private:
+  CCriticalSection m_section;
+  std::list<std::pair<CActiveAEResampleFFMPEG::ContextKey, SwrContext*>> m_contexts; // most recently released first
+};
+
+CContextCache& GetContextCache()
+{
+  static CContextCache cache;
+  return cache;
+}
+}
+
+bool CActiveAEResampleFFMPEG::ContextKey::operator==(const ContextKey& other) const
+{
+  return dst_chan_layout == other.dst_chan_layout && src_chan_layout == other.src_chan_layout &&
+         dst_channels == other.dst_channels && src_channels == other.src_channels &&
+         dst_rate == other.dst_rate && src_rate == other.src_rate &&
+         dst_fmt == other.dst_fmt && src_fmt == other.src_fmt &&
+         dst_bits == other.dst_bits && src_bits == other.src_bits &&
+         upmix == other.upmix && normalize == other.normalize && force_resample == other.force_resample &&
+         quality == other.quality && remap == other.remap && remapLayout == other.remapLayout;
+}
+
 CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
   m_doesResample = false;
+  m_cacheContext = false;
 }
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
 {
-  swr_free(&m_pContext);
+  if (m_pContext && m_cacheContext)
+    GetContextCache().Release(m_key, m_pContext);
+  else
+    swr_free(&m_pContext);
 }
 
 bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
 {
+  if (m_pContext)
+  {
+    if (m_cacheContext)
+      GetContextCache().Release(m_key, m_pContext);
+    else
+      swr_free(&m_pContext);
+    m_pContext = NULL;
+  }
+  m_cacheContext = false;
+
   m_dst_chan_layout = dst_chan_layout;
   m_dst_channels = dst_channels;
   m_dst_rate = dst_rate;
@@ -64,6 +160,69 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
   if (m_src_chan_layout == 0)
     m_src_chan_layout = av_get_default_channel_layout(m_src_channels);
 
+  m_key.dst_chan_layout = m_dst_chan_layout;
+  m_key.src_chan_layout = m_src_chan_layout;
+  m_key.dst_channels = m_dst_channels;
+  m_key.src_channels = m_src_channels;
+  m_key.dst_rate = m_dst_rate;
+  m_key.src_rate = m_src_rate;
+  m_key.dst_fmt = m_dst_fmt;
+  m_key.src_fmt = m_src_fmt;
+  m_key.dst_bits = m_dst_bits;
+  m_key.src_bits = m_src_bits;
+  m_key.upmix = upmix;
+  m_key.normalize = normalize;
+  m_key.force_resample = force_resample;
+  m_key.quality = quality;
+  m_key.remap = remapLayout != nullptr;
+  m_key.remapLayout.clear();
+  if (remapLayout)
+  {
+    for (unsigned int i = 0; i < remapLayout->Count(); i++)
+      m_key.remapLayout.push_back((*remapLayout)[i]);
+  }
+
+  m_remap.clear();
+  if (!force_resample && !m_doesResample)
+    InitRemap(remapLayout);
+
+  m_pContext = GetContextCache().Acquire(m_key);
+  if (!m_pContext && !CreateContext(upmix, normalize, remapLayout, quality))
+    return false;
+
+  m_cacheContext = true;
+  return true;
+}
+
+bool CActiveAEResampleFFMPEG::InitRemap(CAEChannelInfo *remapLayout)
+{
+  // pure channel reorders of float samples skip the resampler
+  if (m_src_fmt != m_dst_fmt || (m_src_fmt != AV_SAMPLE_FMT_FLT && m_src_fmt != AV_SAMPLE_FMT_FLTP))
+    return false;
+
+  if (remapLayout)
+  {
+    m_remap.assign(m_dst_channels, -1);
+    for (unsigned int out = 0; out < remapLayout->Count() && out < static_cast<unsigned int>(m_dst_channels); out++)
+    {
+      int idx = CAEUtil::GetAVChannelIndex((*remapLayout)[out], m_src_chan_layout);
+      if (idx < m_src_channels)
+        m_remap[out] = idx;
+    }
+    return true;
+  }
+
+  if (m_src_chan_layout == m_dst_chan_layout && m_src_channels == m_dst_channels)
+  {
+    for (int i = 0; i < m_dst_channels; i++)
+      m_remap.push_back(i);
+    return true;
+  }
+  return false;
+}
+
+bool CActiveAEResampleFFMPEG::CreateContext(bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality)
+{
   m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
                                                         m_src_chan_layout, m_src_fmt, m_src_rate,
                                                         0, NULL);
@@ -189,6 +348,26 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     m_doesResample = true;
   }
 
+  // pure channel reorder, as long as the resampler holds no samples
+  if (!m_remap.empty() && !m_doesResample && src_buffer && src_samples <= dst_samples &&
+      swr_get_delay(m_pContext, m_src_rate) == 0)
+  {
+    if (m_src_fmt == AV_SAMPLE_FMT_FLTP)
+    {
+      for (int i = 0; i < m_dst_channels; i++)
+      {
+        if (m_remap[i] < 0)
+          memset(dst_buffer[i], 0, src_samples * sizeof(float));
+        else
+          memcpy(dst_buffer[i], src_buffer[m_remap[i]], src_samples * sizeof(float));
+      }
+    }
+    else
+      CAEKernels::Remap((float*)dst_buffer[0], (const float*)src_buffer[0], m_remap.data(),
+                        m_dst_channels, m_src_channels, src_samples);
+    return src_samples;
+  }
+
   if (m_doesResample)
   {
     if (swr_set_compensation(m_pContext, delta, distance) < 0)
@@ -24,6 +24,8 @@
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Interfaces/AEResample.h"
 
+#include <vector>
+
 extern "C" {
 #include "libavutil/samplefmt.h"
 }
@@ -48,7 +50,28 @@ public:
   int GetSrcBufferSize(int samples) override;
   int GetDstBufferSize(int samples) override;
 
+  /*!
+   * \brief Parameters of an initialised SwrContext, contexts with equal keys are interchangeable
+   */
+  struct ContextKey
+  {
+    uint64_t dst_chan_layout, src_chan_layout;
+    int dst_channels, src_channels;
+    int dst_rate, src_rate;
+    AVSampleFormat dst_fmt, src_fmt;
+    int dst_bits, src_bits;
+    bool upmix, normalize, force_resample;
+    AEQuality quality;
+    std::vector<AEChannel> remapLayout;
+    bool remap;
+
+    bool operator==(const ContextKey& other) const;
+  };
+
 protected:
+  bool CreateContext(bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality);
+  bool InitRemap(CAEChannelInfo *remapLayout);
+
   bool m_loaded;
   bool m_doesResample;
   uint64_t m_src_chan_layout, m_dst_chan_layout;
@@ -59,6 +82,11 @@ protected:
   int m_src_dither_bits, m_dst_dither_bits;
   SwrContext *m_pContext;
   double m_rematrix[AE_CH_MAX][AE_CH_MAX];
+  ContextKey m_key;
+  bool m_cacheContext;
+  // source channel of every destination channel if the conversion is a pure
+  // channel reorder of float samples, empty otherwise
+  std::vector<int> m_remap;
 };
 
 }
@@ -24,9 +24,11 @@
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
+#include "cores/AudioEngine/Utils/AESinkTelemetry.h"
 #include "utils/EndianSwap.h"
 #include "ActiveAE.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 
 #include <new> // for std::bad_alloc
@@ -71,7 +73,7 @@ void CActiveAESink::Dispose()
 
   if (m_sink)
   {
-    m_sink->Drain();
+    DrainSink();
     m_sink->Deinitialize();
     delete m_sink;
     m_sink = nullptr;
@@ -298,7 +300,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           ReturnBuffers();
           if (m_sink)
           {
-            m_sink->Drain();
+            DrainSink();
             m_sink->Deinitialize();
             delete m_sink;
             m_sink = nullptr;
@@ -375,7 +377,8 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           samples = *((CSampleBuffer**)msg->data);
           timeout = 1000*samples->pkt->nb_samples/samples->pkt->config.sample_rate;
           Sleep(timeout);
-          msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+          samples->Return();
+          msg->Reply(CSinkDataProtocol::RETURNSAMPLE);
           m_extTimeout = 0;
           return;
         default:
@@ -422,7 +425,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CSinkDataProtocol::DRAIN:
-          m_sink->Drain();
+          DrainSink();
           msg->Reply(CSinkDataProtocol::ACC);
           m_state = S_TOP_CONFIGURED_IDLE;
           m_extTimeout = 10000;
@@ -432,7 +435,8 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           unsigned int delay;
           samples = *((CSampleBuffer**)msg->data);
           delay = OutputSamples(samples);
-          msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+          samples->Return();
+          msg->Reply(CSinkDataProtocol::RETURNSAMPLE);
           if (m_extError)
           {
             m_sink->Deinitialize();
@@ -548,7 +552,7 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           }
           else
           {
-            m_sink->Drain();
+            DrainSink();
             m_state = S_TOP_CONFIGURED_IDLE;
             if (m_extAppFocused)
               m_extTimeout = 10000;
@@ -785,7 +789,7 @@ void CActiveAESink::OpenSink()
 
   if (m_sink)
   {
-    m_sink->Drain();
+    DrainSink();
     m_sink->Deinitialize();
     delete m_sink;
     m_sink = nullptr;
@@ -798,6 +802,11 @@ void CActiveAESink::OpenSink()
   if (!driver.empty())
     device = driver + ":" + device;
 
+  // judge the previous session before the sink asks for its buffer size
+  CAESinkTelemetry &telemetry = CAESinkTelemetry::GetInstance();
+  telemetry.SetAdaptive(g_advancedSettings.m_audioAdaptiveSinkBuffer);
+  telemetry.EndSession();
+
   // WARNING: this changes format and does not use passthrough
   m_sinkFormat = m_requestedFormat;
   CLog::Log(LOGDEBUG, "CActiveAESink::OpenSink - trying to open device %s", device.c_str());
@@ -824,6 +833,7 @@ void CActiveAESink::OpenSink()
   }
 
   m_sink->SetVolume(m_volume);
+  telemetry.StartSession(device, m_sink->GetCacheTotal());
 
 #ifdef WORDS_BIGENDIAN
   if (m_sinkFormat.m_dataFormat == AE_FMT_S16BE)
@@ -879,14 +889,23 @@ void CActiveAESink::ReturnBuffers()
     if (msg->signal == CSinkDataProtocol::SAMPLE)
     {
       samples = *((CSampleBuffer**)msg->data);
-      msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
+      samples->Return();
+      msg->Reply(CSinkDataProtocol::RETURNSAMPLE);
     }
     msg->Release();
   }
 }
 
+void CActiveAESink::DrainSink()
+{
+  // the device runs dry on purpose, don't take it for an underrun
+  CAESinkTelemetry::GetInstance().Interrupt();
+  m_sink->Drain();
+}
+
 unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
 {
+  int64_t start = CAESinkTelemetry::Now();
   uint8_t **buffer = samples->pkt->data;
   uint8_t *packBuffer;
   unsigned int frames = samples->pkt->nb_samples;
@@ -1039,6 +1058,9 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
   if (m_requestedFormat.m_dataFormat == AE_FMT_RAW)
     m_stats->UpdateSinkDelay(status, samples->pool ? 1 : 0);
 
+  CAESinkTelemetry::GetInstance().AddWrite(start, CAESinkTelemetry::Now(), status.delay,
+                                           static_cast<double>(totalFrames) / m_sinkFormat.m_sampleRate);
+
   return status.delay * 1000;
 }
 
@@ -111,6 +111,7 @@ protected:
   void GetDeviceFriendlyName(std::string &device);
   void OpenSink();
   void ReturnBuffers();
+  void DrainSink();
   void SetSilenceTimer();
   bool NeedIECPacking();
 
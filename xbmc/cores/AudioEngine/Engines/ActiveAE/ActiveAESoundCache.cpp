@@ -0,0 +1,162 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ActiveAESoundCache.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+using namespace ActiveAE;
+
+CActiveAESoundCache::CActiveAESoundCache() : m_useCounter(0)
+{
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::GetDecoded(const std::string &file)
+{
+  CSingleLock lock(m_lock);
+  auto it = m_entries.find(file);
+  if (it == m_entries.end())
+    return nullptr;
+
+  it->second.lastUse = ++m_useCounter;
+  return it->second.packet;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::AddDecoded(const std::string &file, std::shared_ptr<CSoundPacket> packet)
+{
+  CSingleLock lock(m_lock);
+  Entry &entry = m_entries[file];
+  if (!entry.packet)
+    entry.packet = std::move(packet);
+  entry.lastUse = ++m_useCounter;
+  return entry.packet;
+}
+
+std::shared_ptr<CSoundPacket> CActiveAESoundCache::GetConverted(const std::shared_ptr<CSoundPacket> &orig, const SoundFormat &format)
+{
+  CSingleLock lock(m_lock);
+  Entry *entry = Find(orig.get());
+  if (!entry)
+    return nullptr;
+
+  for (auto &conversion : entry->conversions)
+  {
+    if (CompareFormat(conversion.format, format))
+    {
+      conversion.lastUse = ++m_useCounter;
+      return conversion.packet;
+    }
+  }
+  return nullptr;
+}
+
+void CActiveAESoundCache::AddConverted(const std::shared_ptr<CSoundPacket> &orig, const SoundFormat &format,
+                                       std::shared_ptr<CSoundPacket> packet)
+{
+  CSingleLock lock(m_lock);
+  Entry *entry = Find(orig.get());
+  if (!entry)
+    return;
+
+  // sounds still playing an evicted conversion keep their reference
+  if (entry->conversions.size() >= MAX_CONVERSIONS)
+  {
+    auto oldest = entry->conversions.begin();
+    for (auto it = entry->conversions.begin(); it != entry->conversions.end(); ++it)
+    {
+      if (it->lastUse < oldest->lastUse)
+        oldest = it;
+    }
+    entry->conversions.erase(oldest);
+  }
+
+  Conversion conversion;
+  conversion.format = format;
+  conversion.packet = std::move(packet);
+  conversion.lastUse = ++m_useCounter;
+  entry->conversions.push_back(std::move(conversion));
+}
+
+void CActiveAESoundCache::Purge()
+{
+  CSingleLock lock(m_lock);
+
+  // every sound holds a reference to its decoded packet, so an entry whose
+  // packet is only referenced by the cache is unused
+  size_t unusedSize = 0;
+  for (auto &entry : m_entries)
+  {
+    if (entry.second.packet.use_count() > 1)
+      continue;
+    unusedSize += GetSize(*entry.second.packet);
+    for (auto &conversion : entry.second.conversions)
+      unusedSize += GetSize(*conversion.packet);
+  }
+
+  while (unusedSize > MAX_UNUSED_SIZE)
+  {
+    auto oldest = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (it->second.packet.use_count() > 1)
+        continue;
+      if (oldest == m_entries.end() || it->second.lastUse < oldest->second.lastUse)
+        oldest = it;
+    }
+    if (oldest == m_entries.end())
+      break;
+
+    unusedSize -= GetSize(*oldest->second.packet);
+    for (auto &conversion : oldest->second.conversions)
+      unusedSize -= GetSize(*conversion.packet);
+
+    CLog::Log(LOGDEBUG, "CActiveAESoundCache::Purge - dropped %s", oldest->first.c_str());
+    m_entries.erase(oldest);
+  }
+}
+
+bool CActiveAESoundCache::CompareFormat(const SoundFormat &lhs, const SoundFormat &rhs)
+{
+  return lhs.config.fmt == rhs.config.fmt &&
+         lhs.config.channel_layout == rhs.config.channel_layout &&
+         lhs.config.channels == rhs.config.channels &&
+         lhs.config.sample_rate == rhs.config.sample_rate &&
+         lhs.config.bits_per_sample == rhs.config.bits_per_sample &&
+         lhs.config.dither_bits == rhs.config.dither_bits &&
+         lhs.channel == rhs.channel &&
+         lhs.quality == rhs.quality;
+}
+
+size_t CActiveAESoundCache::GetSize(const CSoundPacket &packet)
+{
+  return static_cast<size_t>(packet.max_nb_samples) * packet.bytes_per_sample * packet.config.channels;
+}
+
+CActiveAESoundCache::Entry* CActiveAESoundCache::Find(const CSoundPacket *orig)
+{
+  // only a handful of files, a linear search is fine
+  for (auto &entry : m_entries)
+  {
+    if (entry.second.packet.get() == orig)
+      return &entry.second;
+  }
+  return nullptr;
+}
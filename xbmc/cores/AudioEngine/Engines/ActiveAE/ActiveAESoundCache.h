@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Utils/AEChannelData.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ActiveAE
+{
+
+/**
+ * Format a GUI sound is converted to for mixing
+ */
+struct SoundFormat
+{
+  SampleConfig config;
+  AEChannel channel;            // speaker a mono test sound is routed to
+  AEQuality quality;
+};
+
+/**
+ * Decoded and converted PCM of GUI sounds, shared by all sounds that were
+ * made from the same file.
+ *
+ * Decoded data is keyed by file name. Each decoded sound keeps the last few
+ * conversions, so switching back and forth between the formats of the idle
+ * sink and of a playing stream does not resample again.
+ * Packets are handed out as shared pointers and never modified once they are
+ * in the cache. Entries no sound refers to any more are kept up to a size
+ * budget, which survives skin reloads.
+ */
+class CActiveAESoundCache
+{
+public:
+  CActiveAESoundCache();
+
+  std::shared_ptr<CSoundPacket> GetDecoded(const std::string &file);
+  /**
+   * Add a decoded sound
+   * @return the cached packet, which differs from the given one if another
+   * thread added the same file meanwhile
+   */
+  std::shared_ptr<CSoundPacket> AddDecoded(const std::string &file, std::shared_ptr<CSoundPacket> packet);
+
+  std::shared_ptr<CSoundPacket> GetConverted(const std::shared_ptr<CSoundPacket> &orig, const SoundFormat &format);
+  void AddConverted(const std::shared_ptr<CSoundPacket> &orig, const SoundFormat &format,
+                    std::shared_ptr<CSoundPacket> packet);
+
+  /**
+   * Drop least recently used entries no sound refers to until the budget is met
+   */
+  void Purge();
+
+  static bool CompareFormat(const SoundFormat &lhs, const SoundFormat &rhs);
+  static size_t GetSize(const CSoundPacket &packet);
+
+protected:
+  static const size_t MAX_UNUSED_SIZE = 8 * 1024 * 1024;
+  static const size_t MAX_CONVERSIONS = 3;
+
+  struct Conversion
+  {
+    SoundFormat format;
+    std::shared_ptr<CSoundPacket> packet;
+    unsigned int lastUse;
+  };
+
+  struct Entry
+  {
+    std::shared_ptr<CSoundPacket> packet;
+    std::vector<Conversion> conversions;
+    unsigned int lastUse;
+  };
+
+  Entry* Find(const CSoundPacket *orig);
+
+  CCriticalSection m_lock;
+  std::map<std::string, Entry> m_entries;
+  unsigned int m_useCounter;
+};
+
+}
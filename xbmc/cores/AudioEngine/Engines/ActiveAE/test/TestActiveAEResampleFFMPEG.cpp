@@ -0,0 +1,163 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+using namespace ActiveAE;
+
+namespace
+{
+class CTestResample : public CActiveAEResampleFFMPEG
+{
+public:
+  SwrContext* GetContext() const { return m_pContext; }
+};
+
+std::vector<float> MakeSamples(unsigned int count)
+{
+  std::vector<float> samples(count);
+  for (unsigned int i = 0; i < count; i++)
+    samples[i] = static_cast<float>(i % 97) / 97.0f - 0.5f;
+  return samples;
+}
+
+bool InitDownmix(CTestResample& resample, AEQuality quality)
+{
+  return resample.Init(AV_CH_LAYOUT_STEREO, 2, 48000, AV_SAMPLE_FMT_FLT, 32, 0,
+                       AV_CH_LAYOUT_5POINT1, 6, 44100, AV_SAMPLE_FMT_FLTP, 32, 0,
+                       false, true, nullptr, quality, false);
+}
+
+bool InitUpsample(CTestResample& resample)
+{
+  return resample.Init(AV_CH_LAYOUT_MONO, 1, 48000, AV_SAMPLE_FMT_FLT, 32, 0,
+                       AV_CH_LAYOUT_MONO, 1, 22050, AV_SAMPLE_FMT_FLT, 32, 0,
+                       false, true, nullptr, AE_QUALITY_MID, false);
+}
+
+std::vector<float> Upsample(CTestResample& resample, std::vector<float> src)
+{
+  std::vector<float> dst(src.size() * 4);
+  uint8_t* srcPlanes[] = { reinterpret_cast<uint8_t*>(src.data()) };
+  uint8_t* dstPlanes[] = { reinterpret_cast<uint8_t*>(dst.data()) };
+  int samples = resample.Resample(dstPlanes, dst.size(), srcPlanes, src.size(), 1.0);
+  dst.resize(samples < 0 ? 0 : samples);
+  return dst;
+}
+}
+
+TEST(TestActiveAEResampleFFMPEG, ReusesContext)
+{
+  SwrContext* context;
+  {
+    CTestResample resample;
+    ASSERT_TRUE(InitDownmix(resample, AE_QUALITY_HIGH));
+    context = resample.GetContext();
+    ASSERT_NE(nullptr, context);
+  }
+
+  // same parameters get the context of the destroyed resampler
+  CTestResample same;
+  ASSERT_TRUE(InitDownmix(same, AE_QUALITY_HIGH));
+  EXPECT_EQ(context, same.GetContext());
+
+  // different quality is a different filter bank
+  CTestResample other;
+  ASSERT_TRUE(InitDownmix(other, AE_QUALITY_LOW));
+  EXPECT_NE(context, other.GetContext());
+}
+
+TEST(TestActiveAEResampleFFMPEG, ReusedContextStartsClean)
+{
+  std::vector<float> src = MakeSamples(1024);
+
+  std::vector<float> fresh;
+  SwrContext* context;
+  {
+    CTestResample resample;
+    ASSERT_TRUE(InitUpsample(resample));
+    context = resample.GetContext();
+    fresh = Upsample(resample, src);
+    // leave samples buffered in the context
+    Upsample(resample, src);
+  }
+  ASSERT_FALSE(fresh.empty());
+
+  CTestResample reused;
+  ASSERT_TRUE(InitUpsample(reused));
+  ASSERT_EQ(context, reused.GetContext());
+  EXPECT_EQ(fresh, Upsample(reused, src));
+}
+
+TEST(TestActiveAEResampleFFMPEG, ChannelReorder)
+{
+  // sink layout with swapped fronts and a center the source does not have
+  CAEChannelInfo remapLayout;
+  remapLayout += AE_CH_FR;
+  remapLayout += AE_CH_FL;
+  remapLayout += AE_CH_FC;
+
+  CTestResample resample;
+  ASSERT_TRUE(resample.Init(0, 3, 48000, AV_SAMPLE_FMT_FLT, 32, 0,
+                            AV_CH_LAYOUT_STEREO, 2, 48000, AV_SAMPLE_FMT_FLT, 32, 0,
+                            false, false, &remapLayout, AE_QUALITY_MID, false));
+
+  const unsigned int frames = 257;
+  std::vector<float> src = MakeSamples(frames * 2);
+  // out of range values are passed through untouched
+  src[0] = 4.0f;
+  std::vector<float> dst(frames * 3, -1.0f);
+  uint8_t* srcPlanes[] = { reinterpret_cast<uint8_t*>(src.data()) };
+  uint8_t* dstPlanes[] = { reinterpret_cast<uint8_t*>(dst.data()) };
+  ASSERT_EQ(static_cast<int>(frames), resample.Resample(dstPlanes, frames, srcPlanes, frames, 1.0));
+
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    EXPECT_EQ(src[i * 2 + 1], dst[i * 3]) << "frame " << i;
+    EXPECT_EQ(src[i * 2], dst[i * 3 + 1]) << "frame " << i;
+    EXPECT_EQ(0.0f, dst[i * 3 + 2]) << "frame " << i;
+  }
+}
+
+TEST(TestActiveAEResampleFFMPEG, PlanarCopy)
+{
+  CTestResample resample;
+  ASSERT_TRUE(resample.Init(AV_CH_LAYOUT_STEREO, 2, 48000, AV_SAMPLE_FMT_FLTP, 32, 0,
+                            AV_CH_LAYOUT_STEREO, 2, 48000, AV_SAMPLE_FMT_FLTP, 32, 0,
+                            false, false, nullptr, AE_QUALITY_MID, false));
+
+  const unsigned int frames = 100;
+  std::vector<float> left = MakeSamples(frames);
+  std::vector<float> right(frames, 0.25f);
+  std::vector<float> dstLeft(frames), dstRight(frames);
+  uint8_t* srcPlanes[] = { reinterpret_cast<uint8_t*>(left.data()), reinterpret_cast<uint8_t*>(right.data()) };
+  uint8_t* dstPlanes[] = { reinterpret_cast<uint8_t*>(dstLeft.data()), reinterpret_cast<uint8_t*>(dstRight.data()) };
+  ASSERT_EQ(static_cast<int>(frames), resample.Resample(dstPlanes, frames, srcPlanes, frames, 1.0));
+  EXPECT_EQ(left, dstLeft);
+  EXPECT_EQ(right, dstRight);
+}
@@ -38,6 +38,7 @@ class IAEPacketizer;
 class IAudioCallback;
 class IAEClockCallback;
 class CAEStreamInfo;
+struct AESpectrum;
 
 /* sound options */
 #define AE_SOUND_OFF    0 /* disable sounds */
@@ -208,6 +209,16 @@ public:
 
   virtual void UnregisterAudioCallback(IAudioCallback* pCallback) {}
 
+  /**
+   * Copies the spectrum of the visualisation packet last passed to the audio
+   * callbacks. The engine analyzes audio while at least one audio callback
+   * is registered or while the spectrum is polled, so readers without a
+   * callback get nothing on their first call.
+   * @param spectrum receives the magnitudes, interleaved left/right
+   * @returns false if no spectrum is available
+   */
+  virtual bool GetSpectrum(AESpectrum& spectrum) { return false; }
+
   /**
    * Returns true if AudioEngine supports specified quality level
    * @return true if specified quality level is supported, otherwise false
@@ -31,6 +31,7 @@
 #include "cores/AudioEngine/AESinkFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEELDParser.h"
+#include "cores/AudioEngine/Utils/AESinkTelemetry.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
 #include "utils/SystemInfo.h"
@@ -772,9 +773,12 @@ bool CAESinkALSA::InitializeHW(const ALSAConfig &inconfig, ALSAConfig &outconfig
    a periodSize of approx 50 ms. Choosing a higher bufferSize
    will cause problems with menu sounds. Buffer will be increased
    after those are fixed.
+   In adaptive mode the buffer grows after sessions with underruns and
+   shrinks after long steady sessions, see CAESinkTelemetry.
   */
+  double bufferScale = CAESinkTelemetry::GetInstance().GetBufferScale(m_initDevice);
   periodSize  = std::min(periodSize, (snd_pcm_uframes_t) sampleRate / 20);
-  bufferSize  = std::min(bufferSize, (snd_pcm_uframes_t) sampleRate / 5);
+  bufferSize  = std::min(bufferSize, (snd_pcm_uframes_t) (sampleRate / 5 * bufferScale));
   
   /* 
    According to upstream we should set buffer size first - so make sure it is always at least
@@ -960,6 +964,8 @@ unsigned int CAESinkALSA::AddPackets(uint8_t **data, unsigned int frames, unsign
     int ret = snd_pcm_writei(m_pcm, buffer, amount);
     if (ret < 0)
     {
+      if (ret == -EPIPE)
+        CAESinkTelemetry::GetInstance().AddUnderrun();
       CLog::Log(LOGERROR, "CAESinkALSA - snd_pcm_writei(%d) %s - trying to recover", ret, snd_strerror(ret));
       ret = snd_pcm_recover(m_pcm, ret, 1);
       if(ret < 0)
@@ -23,6 +23,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "Application.h"
 #include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AESinkTelemetry.h"
 #include "ServiceBroker.h"
 #include "utils/StringUtils.h"
 
@@ -206,6 +207,11 @@ static void StreamLatencyUpdateCallback(pa_stream *s, void *userdata)
   pa_threaded_mainloop_signal(m, 0);
 }
 
+static void StreamUnderflowCallback(pa_stream *s, void *userdata)
+{
+  CAESinkTelemetry::GetInstance().AddUnderrun();
+}
+
 
 static void SinkInputInfoCallback(pa_context *c, const pa_sink_input_info *i, int eol, void *userdata)
 {
@@ -742,6 +748,7 @@ bool CAESinkPULSE::Initialize(AEAudioFormat &format, std::string &device)
   pa_stream_set_state_callback(m_Stream, StreamStateCallback, m_MainLoop);
   pa_stream_set_write_callback(m_Stream, StreamRequestCallback, m_MainLoop);
   pa_stream_set_latency_update_callback(m_Stream, StreamLatencyUpdateCallback, m_MainLoop);
+  pa_stream_set_underflow_callback(m_Stream, StreamUnderflowCallback, nullptr);
 
   // default buffer construction
   // align with AE's max buffer
@@ -756,6 +763,12 @@ bool CAESinkPULSE::Initialize(AEAudioFormat &format, std::string &device)
     process_time = latency / 4;
   }
 
+  // grown after underruns, shrunk after steady sessions in adaptive mode
+  // pulse expects whole frames
+  latency = static_cast<unsigned int>(latency * CAESinkTelemetry::GetInstance().GetBufferScale(device));
+  latency = std::max(latency - latency % frameSize, frameSize);
+  process_time = std::max(latency / 4 - (latency / 4) % frameSize, frameSize);
+
   pa_buffer_attr buffer_attr;
   buffer_attr.fragsize = latency;
   buffer_attr.maxlength = (uint32_t) -1;
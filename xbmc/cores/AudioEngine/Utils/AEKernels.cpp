@@ -0,0 +1,1017 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEKernels.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <atomic>
+#include <math.h>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#define AE_KERNELS_SSE2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AE_KERNELS_AVX2
+#define AE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(HAS_NEON) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#define AE_KERNELS_NEON
+#if defined(__aarch64__)
+// round to nearest conversions are only available on ARMv8
+#define AE_KERNELS_NEON_CONVERT
+#endif
+#endif
+
+namespace
+{
+
+const float SCALE_S16 = 32768.0f;
+const float SCALE_S24 = 8388608.0f;
+const float SCALE_S32 = 2147483648.0f;
+// largest float below 2^31, 2^31 itself does not fit into int32
+const float MAX_S32 = 2147483520.0f;
+const float DITHER_SCALE = 1.0f / 65536.0f;
+
+/*
+ * Stateless hash of the sample position, SIMD variants compute the dither of
+ * several samples at once and still produce the same sequence.
+ */
+inline uint32_t DitherHash(uint32_t x)
+{
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+
+// triangular dither in -1..1 LSB, difference of two uniform 16 bit values
+inline float Dither(uint32_t position)
+{
+  uint32_t h = DitherHash(position);
+  return static_cast<int>((h & 0xFFFF) - (h >> 16)) * DITHER_SCALE;
+}
+
+inline float SoftClamp(float x)
+{
+  /*
+     This is a rational function to approximate a tanh-like soft clipper.
+     It is based on the pade-approximation of the tanh function with tweaked coefficients.
+     See: http://www.musicdsp.org/showone.php?id=238
+  */
+  if (x < -3.0f)
+    return -1.0f;
+  else if (x > 3.0f)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+inline int32_t ToInt(float value, float scale, float min, float max, float dither)
+{
+  float v = value * scale + dither;
+  v = v < min ? min : (v > max ? max : v);
+  return static_cast<int32_t>(lrintf(v));
+}
+
+//------------------------------------------------------------------------------
+// scalar reference kernels
+//------------------------------------------------------------------------------
+
+void Mul_C(float* data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] *= mul;
+}
+
+void MulAdd_C(float* data, const float* add, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] += add[i] * mul;
+}
+
+void Clamp_C(float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] = SoftClamp(data[i]);
+}
+
+bool NeedsClamp_C(const float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (fabsf(data[i]) > 1.0f)
+      return true;
+  }
+  return false;
+}
+
+void Interleave_C(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  for (unsigned int c = 0; c < channels; c++)
+  {
+    const float* plane = src[c];
+    float* out = dst + c;
+    for (uint32_t i = 0; i < frames; i++, out += channels)
+      *out = plane[i];
+  }
+}
+
+void Deinterleave_C(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  for (unsigned int c = 0; c < channels; c++)
+  {
+    float* plane = dst[c];
+    const float* in = src + c;
+    for (uint32_t i = 0; i < frames; i++, in += channels)
+      plane[i] = *in;
+  }
+}
+
+void Remap_C(float* dst, const float* src, const int* map,
+             unsigned int dstChannels, unsigned int srcChannels, uint32_t frames)
+{
+  for (uint32_t i = 0; i < frames; i++, dst += dstChannels, src += srcChannels)
+  {
+    for (unsigned int c = 0; c < dstChannels; c++)
+      dst[c] = map[c] < 0 ? 0.0f : src[map[c]];
+  }
+}
+
+void FloatToS16_C(int16_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed)
+{
+  uint32_t seed = ditherSeed ? *ditherSeed : 0;
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = static_cast<int16_t>(ToInt(src[i], SCALE_S16, -32768.0f, 32767.0f, ditherSeed ? Dither(seed + i) : 0.0f));
+  if (ditherSeed)
+    *ditherSeed = seed + count;
+}
+
+void FloatToS24_C(int32_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed)
+{
+  uint32_t seed = ditherSeed ? *ditherSeed : 0;
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = ToInt(src[i], SCALE_S24, -8388608.0f, 8388607.0f, ditherSeed ? Dither(seed + i) : 0.0f);
+  if (ditherSeed)
+    *ditherSeed = seed + count;
+}
+
+void FloatToS32_C(int32_t* dst, const float* src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = ToInt(src[i], SCALE_S32, -SCALE_S32, MAX_S32, 0.0f);
+}
+
+void S16ToFloat_C(float* dst, const int16_t* src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = src[i] * (1.0f / SCALE_S16);
+}
+
+void S32ToFloat_C(float* dst, const int32_t* src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / SCALE_S32);
+}
+
+//------------------------------------------------------------------------------
+// SSE2 kernels
+//------------------------------------------------------------------------------
+
+#if defined(AE_KERNELS_SSE2)
+void Mul_SSE2(float* data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  Mul_C(data + i, mul, count - i);
+}
+
+void MulAdd_SSE2(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 a = _mm_mul_ps(_mm_loadu_ps(add + i), m);
+    _mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), a));
+  }
+  MulAdd_C(data + i, add + i, mul, count - i);
+}
+
+void Clamp_SSE2(float* data, uint32_t count)
+{
+  const __m128 c27 = _mm_set1_ps(27.0f);
+  const __m128 c9 = _mm_set1_ps(9.0f);
+  const __m128 max = _mm_set1_ps(3.0f);
+  const __m128 min = _mm_set1_ps(-3.0f);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // clipping at +-3 yields exactly +-1, the operand order keeps NaN
+    __m128 x = _mm_min_ps(max, _mm_max_ps(min, _mm_loadu_ps(data + i)));
+    __m128 y = _mm_mul_ps(x, x);
+    __m128 r = _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c27, y)), _mm_add_ps(c27, _mm_mul_ps(c9, y)));
+    _mm_storeu_ps(data + i, r);
+  }
+  Clamp_C(data + i, count - i);
+}
+
+bool NeedsClamp_SSE2(const float* data, uint32_t count)
+{
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  const __m128 one = _mm_set1_ps(1.0f);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_and_ps(_mm_loadu_ps(data + i), absMask);
+    if (_mm_movemask_ps(_mm_cmpgt_ps(x, one)))
+      return true;
+  }
+  return NeedsClamp_C(data + i, count - i);
+}
+
+void Interleave_SSE2(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    Interleave_C(dst, src, channels, frames);
+    return;
+  }
+
+  const float* l = src[0];
+  const float* r = src[1];
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    __m128 a = _mm_loadu_ps(l + i);
+    __m128 b = _mm_loadu_ps(r + i);
+    _mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(a, b));
+    _mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(a, b));
+  }
+  for (; i < frames; i++)
+  {
+    dst[i * 2] = l[i];
+    dst[i * 2 + 1] = r[i];
+  }
+}
+
+void Deinterleave_SSE2(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    Deinterleave_C(dst, src, channels, frames);
+    return;
+  }
+
+  float* l = dst[0];
+  float* r = dst[1];
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    __m128 a = _mm_loadu_ps(src + i * 2);
+    __m128 b = _mm_loadu_ps(src + i * 2 + 4);
+    _mm_storeu_ps(l + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(r + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; i < frames; i++)
+  {
+    l[i] = src[i * 2];
+    r[i] = src[i * 2 + 1];
+  }
+}
+#endif
+
+//------------------------------------------------------------------------------
+// AVX2 kernels, compiled for AVX2 per function and only called if the CPU
+// reports it
+//------------------------------------------------------------------------------
+
+#if defined(AE_KERNELS_AVX2)
+AE_TARGET_AVX2
+void Mul_AVX2(float* data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  Mul_C(data + i, mul, count - i);
+}
+
+AE_TARGET_AVX2
+void MulAdd_AVX2(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 a = _mm256_mul_ps(_mm256_loadu_ps(add + i), m);
+    _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), a));
+  }
+  MulAdd_C(data + i, add + i, mul, count - i);
+}
+
+AE_TARGET_AVX2
+void Clamp_AVX2(float* data, uint32_t count)
+{
+  const __m256 c27 = _mm256_set1_ps(27.0f);
+  const __m256 c9 = _mm256_set1_ps(9.0f);
+  const __m256 max = _mm256_set1_ps(3.0f);
+  const __m256 min = _mm256_set1_ps(-3.0f);
+
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_min_ps(max, _mm256_max_ps(min, _mm256_loadu_ps(data + i)));
+    __m256 y = _mm256_mul_ps(x, x);
+    __m256 r = _mm256_div_ps(_mm256_mul_ps(x, _mm256_add_ps(c27, y)), _mm256_add_ps(c27, _mm256_mul_ps(c9, y)));
+    _mm256_storeu_ps(data + i, r);
+  }
+  Clamp_C(data + i, count - i);
+}
+
+AE_TARGET_AVX2
+bool NeedsClamp_AVX2(const float* data, uint32_t count)
+{
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  const __m256 one = _mm256_set1_ps(1.0f);
+
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_and_ps(_mm256_loadu_ps(data + i), absMask);
+    if (_mm256_movemask_ps(_mm256_cmp_ps(x, one, _CMP_GT_OQ)))
+      return true;
+  }
+  return NeedsClamp_C(data + i, count - i);
+}
+
+AE_TARGET_AVX2
+void Interleave_AVX2(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    Interleave_C(dst, src, channels, frames);
+    return;
+  }
+
+  const float* l = src[0];
+  const float* r = src[1];
+  uint32_t i = 0;
+  for (; i + 8 <= frames; i += 8)
+  {
+    __m256 a = _mm256_loadu_ps(l + i);
+    __m256 b = _mm256_loadu_ps(r + i);
+    // unpack works within 128 bit lanes, reorder the lanes afterwards
+    __m256 lo = _mm256_unpacklo_ps(a, b);
+    __m256 hi = _mm256_unpackhi_ps(a, b);
+    _mm256_storeu_ps(dst + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(dst + i * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+  }
+  for (; i < frames; i++)
+  {
+    dst[i * 2] = l[i];
+    dst[i * 2 + 1] = r[i];
+  }
+}
+
+AE_TARGET_AVX2
+void Deinterleave_AVX2(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    Deinterleave_C(dst, src, channels, frames);
+    return;
+  }
+
+  float* l = dst[0];
+  float* r = dst[1];
+  uint32_t i = 0;
+  for (; i + 8 <= frames; i += 8)
+  {
+    __m256 a = _mm256_loadu_ps(src + i * 2);
+    __m256 b = _mm256_loadu_ps(src + i * 2 + 8);
+    __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+    __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+    _mm256_storeu_ps(l + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm256_storeu_ps(r + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; i < frames; i++)
+  {
+    l[i] = src[i * 2];
+    r[i] = src[i * 2 + 1];
+  }
+}
+
+AE_TARGET_AVX2
+void Remap_AVX2(float* dst, const float* src, const int* map,
+                unsigned int dstChannels, unsigned int srcChannels, uint32_t frames)
+{
+  if (dstChannels > 8)
+  {
+    Remap_C(dst, src, map, dstChannels, srcChannels, frames);
+    return;
+  }
+
+  // one masked gather and one masked store per frame
+  int32_t index[8], gather[8], store[8];
+  for (unsigned int c = 0; c < 8; c++)
+  {
+    bool valid = c < dstChannels && map[c] >= 0;
+    index[c] = valid ? map[c] : 0;
+    gather[c] = valid ? -1 : 0;
+    store[c] = c < dstChannels ? -1 : 0;
+  }
+  const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index));
+  const __m256 gatherMask = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(gather)));
+  const __m256i storeMask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(store));
+  const __m256 zero = _mm256_setzero_ps();
+  for (uint32_t i = 0; i < frames; i++, dst += dstChannels, src += srcChannels)
+    _mm256_maskstore_ps(dst, storeMask, _mm256_mask_i32gather_ps(zero, src, idx, gatherMask, 4));
+}
+
+AE_TARGET_AVX2
+inline __m256i ToInt_AVX2(__m256 x, __m256 scale, __m256 min, __m256 max, bool dither, uint32_t position)
+{
+  __m256 v = _mm256_mul_ps(x, scale);
+  if (dither)
+  {
+    __m256i h = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(position)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0x7feb352d));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32(static_cast<int>(0x846ca68b)));
+    h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    __m256i d = _mm256_sub_epi32(_mm256_and_si256(h, _mm256_set1_epi32(0xFFFF)), _mm256_srli_epi32(h, 16));
+    v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_cvtepi32_ps(d), _mm256_set1_ps(DITHER_SCALE)));
+  }
+  v = _mm256_min_ps(max, _mm256_max_ps(min, v));
+  return _mm256_cvtps_epi32(v);
+}
+
+AE_TARGET_AVX2
+void FloatToS16_AVX2(int16_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed)
+{
+  const __m256 scale = _mm256_set1_ps(SCALE_S16);
+  const __m256 min = _mm256_set1_ps(-32768.0f);
+  const __m256 max = _mm256_set1_ps(32767.0f);
+  uint32_t seed = ditherSeed ? *ditherSeed : 0;
+
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i v = ToInt_AVX2(_mm256_loadu_ps(src + i), scale, min, max, ditherSeed != nullptr, seed + i);
+    __m128i s = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+  }
+
+  if (ditherSeed)
+  {
+    *ditherSeed = seed + i;
+    FloatToS16_C(dst + i, src + i, count - i, ditherSeed);
+  }
+  else
+    FloatToS16_C(dst + i, src + i, count - i, nullptr);
+}
+
+AE_TARGET_AVX2
+void FloatToS24_AVX2(int32_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed)
+{
+  const __m256 scale = _mm256_set1_ps(SCALE_S24);
+  const __m256 min = _mm256_set1_ps(-8388608.0f);
+  const __m256 max = _mm256_set1_ps(8388607.0f);
+  uint32_t seed = ditherSeed ? *ditherSeed : 0;
+
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i v = ToInt_AVX2(_mm256_loadu_ps(src + i), scale, min, max, ditherSeed != nullptr, seed + i);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+  }
+
+  if (ditherSeed)
+  {
+    *ditherSeed = seed + i;
+    FloatToS24_C(dst + i, src + i, count - i, ditherSeed);
+  }
+  else
+    FloatToS24_C(dst + i, src + i, count - i, nullptr);
+}
+
+AE_TARGET_AVX2
+void FloatToS32_AVX2(int32_t* dst, const float* src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(SCALE_S32);
+  const __m256 min = _mm256_set1_ps(-SCALE_S32);
+  const __m256 max = _mm256_set1_ps(MAX_S32);
+
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i v = ToInt_AVX2(_mm256_loadu_ps(src + i), scale, min, max, false, 0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+  }
+  FloatToS32_C(dst + i, src + i, count - i);
+}
+
+AE_TARGET_AVX2
+void S16ToFloat_AVX2(float* dst, const int16_t* src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / SCALE_S16);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  S16ToFloat_C(dst + i, src + i, count - i);
+}
+
+AE_TARGET_AVX2
+void S32ToFloat_AVX2(float* dst, const int32_t* src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / SCALE_S32);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  S32ToFloat_C(dst + i, src + i, count - i);
+}
+#endif
+
+//------------------------------------------------------------------------------
+// NEON kernels
+//------------------------------------------------------------------------------
+
+#if defined(AE_KERNELS_NEON)
+void Mul_NEON(float* data, float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+  Mul_C(data + i, mul, count - i);
+}
+
+void MulAdd_NEON(float* data, const float* add, float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // separate multiply and add, vmla/vfma would round differently
+    float32x4_t a = vmulq_f32(vld1q_f32(add + i), m);
+    vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), a));
+  }
+  MulAdd_C(data + i, add + i, mul, count - i);
+}
+
+inline float32x4_t Div_NEON(float32x4_t a, float32x4_t b)
+{
+#if defined(__aarch64__)
+  return vdivq_f32(a, b);
+#else
+  // ARMv7 NEON has no exact division
+  float va[4], vb[4];
+  vst1q_f32(va, a);
+  vst1q_f32(vb, b);
+  for (int i = 0; i < 4; i++)
+    va[i] /= vb[i];
+  return vld1q_f32(va);
+#endif
+}
+
+void Clamp_NEON(float* data, uint32_t count)
+{
+  const float32x4_t c27 = vdupq_n_f32(27.0f);
+  const float32x4_t c9 = vdupq_n_f32(9.0f);
+  const float32x4_t max = vdupq_n_f32(3.0f);
+  const float32x4_t min = vdupq_n_f32(-3.0f);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vminq_f32(max, vmaxq_f32(min, vld1q_f32(data + i)));
+    float32x4_t y = vmulq_f32(x, x);
+    float32x4_t r = Div_NEON(vmulq_f32(x, vaddq_f32(c27, y)), vaddq_f32(c27, vmulq_f32(c9, y)));
+    vst1q_f32(data + i, r);
+  }
+  Clamp_C(data + i, count - i);
+}
+
+bool NeedsClamp_NEON(const float* data, uint32_t count)
+{
+  const float32x4_t one = vdupq_n_f32(1.0f);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    uint32x4_t gt = vcgtq_f32(vabsq_f32(vld1q_f32(data + i)), one);
+    uint32x2_t any = vorr_u32(vget_low_u32(gt), vget_high_u32(gt));
+    if (vget_lane_u32(vpmax_u32(any, any), 0))
+      return true;
+  }
+  return NeedsClamp_C(data + i, count - i);
+}
+
+void Interleave_NEON(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  uint32_t i = 0;
+  if (channels == 2)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      float32x4x2_t v = { { vld1q_f32(src[0] + i), vld1q_f32(src[1] + i) } };
+      vst2q_f32(dst + i * 2, v);
+    }
+  }
+  else if (channels == 4 || channels == 8)
+  {
+    // quad and 7.1 layouts, 7.1 as two groups of four channels
+    for (; i + 4 <= frames; i += 4)
+    {
+      for (unsigned int c = 0; c < channels; c += 4)
+      {
+        float32x4x4_t v = { { vld1q_f32(src[c] + i), vld1q_f32(src[c + 1] + i),
+                              vld1q_f32(src[c + 2] + i), vld1q_f32(src[c + 3] + i) } };
+        if (channels == 4)
+          vst4q_f32(dst + i * 4, v);
+        else
+        {
+          float buffer[16];
+          vst4q_f32(buffer, v);
+          for (int f = 0; f < 4; f++)
+            vst1q_f32(dst + (i + f) * 8 + c, vld1q_f32(buffer + f * 4));
+        }
+      }
+    }
+  }
+
+  if (i < frames)
+  {
+    const float* tail[8];
+    const float* const* planes = src;
+    if (i > 0)
+    {
+      for (unsigned int c = 0; c < channels; c++)
+        tail[c] = src[c] + i;
+      planes = tail;
+    }
+    Interleave_C(dst + i * channels, planes, channels, frames - i);
+  }
+}
+
+void Deinterleave_NEON(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  if (channels != 2)
+  {
+    Deinterleave_C(dst, src, channels, frames);
+    return;
+  }
+
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    float32x4x2_t v = vld2q_f32(src + i * 2);
+    vst1q_f32(dst[0] + i, v.val[0]);
+    vst1q_f32(dst[1] + i, v.val[1]);
+  }
+  for (; i < frames; i++)
+  {
+    dst[0][i] = src[i * 2];
+    dst[1][i] = src[i * 2 + 1];
+  }
+}
+
+void Remap_NEON(float* dst, const float* src, const int* map,
+                unsigned int dstChannels, unsigned int srcChannels, uint32_t frames)
+{
+  if (dstChannels > 8 || srcChannels > 8)
+  {
+    Remap_C(dst, src, map, dstChannels, srcChannels, frames);
+    return;
+  }
+
+  // byte shuffle of one frame, indices outside of the 32 byte table give zero
+  uint8_t table[32];
+  for (unsigned int c = 0; c < 8; c++)
+  {
+    for (unsigned int b = 0; b < 4; b++)
+      table[c * 4 + b] = c < dstChannels && map[c] >= 0 ? static_cast<uint8_t>(map[c] * 4 + b) : 0xFF;
+  }
+  const uint8x8_t i0 = vld1_u8(table);
+  const uint8x8_t i1 = vld1_u8(table + 8);
+  const uint8x8_t i2 = vld1_u8(table + 16);
+  const uint8x8_t i3 = vld1_u8(table + 24);
+
+  // every frame loads and stores 8 channels, the surplus stores are overwritten
+  // by the following frames and the last frames are left to the scalar loop
+  uint32_t i = 0;
+  for (; (frames - i) * srcChannels >= 8 && (frames - i) * dstChannels >= 8; i++)
+  {
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(src + i * srcChannels);
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst + i * dstChannels);
+    uint8x8x4_t t;
+    t.val[0] = vld1_u8(in);
+    t.val[1] = vld1_u8(in + 8);
+    t.val[2] = vld1_u8(in + 16);
+    t.val[3] = vld1_u8(in + 24);
+    vst1_u8(out, vtbl4_u8(t, i0));
+    vst1_u8(out + 8, vtbl4_u8(t, i1));
+    vst1_u8(out + 16, vtbl4_u8(t, i2));
+    vst1_u8(out + 24, vtbl4_u8(t, i3));
+  }
+  Remap_C(dst + i * dstChannels, src + i * srcChannels, map, dstChannels, srcChannels, frames - i);
+}
+
+#if defined(AE_KERNELS_NEON_CONVERT)
+inline int32x4_t ToInt_NEON(float32x4_t x, float32x4_t scale, float32x4_t min, float32x4_t max, bool dither, uint32_t position)
+{
+  float32x4_t v = vmulq_f32(x, scale);
+  if (dither)
+  {
+    static const uint32_t offsets[4] = { 0, 1, 2, 3 };
+    uint32x4_t h = vaddq_u32(vdupq_n_u32(position), vld1q_u32(offsets));
+    h = veorq_u32(h, vshrq_n_u32(h, 16));
+    h = vmulq_u32(h, vdupq_n_u32(0x7feb352d));
+    h = veorq_u32(h, vshrq_n_u32(h, 15));
+    h = vmulq_u32(h, vdupq_n_u32(0x846ca68b));
+    h = veorq_u32(h, vshrq_n_u32(h, 16));
+    int32x4_t d = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(h, vdupq_n_u32(0xFFFF))),
+                            vreinterpretq_s32_u32(vshrq_n_u32(h, 16)));
+    v = vaddq_f32(v, vmulq_f32(vcvtq_f32_s32(d), vdupq_n_f32(DITHER_SCALE)));
+  }
+  v = vminq_f32(max, vmaxq_f32(min, v));
+  return vcvtnq_s32_f32(v);
+}
+
+void FloatToS16_NEON(int16_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed)
+{
+  const float32x4_t scale = vdupq_n_f32(SCALE_S16);
+  const float32x4_t min = vdupq_n_f32(-32768.0f);
+  const float32x4_t max = vdupq_n_f32(32767.0f);
+  uint32_t seed = ditherSeed ? *ditherSeed : 0;
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    int32x4_t v = ToInt_NEON(vld1q_f32(src + i), scale, min, max, ditherSeed != nullptr, seed + i);
+    vst1_s16(dst + i, vqmovn_s32(v));
+  }
+
+  if (ditherSeed)
+  {
+    *ditherSeed = seed + i;
+    FloatToS16_C(dst + i, src + i, count - i, ditherSeed);
+  }
+  else
+    FloatToS16_C(dst + i, src + i, count - i, nullptr);
+}
+
+void FloatToS24_NEON(int32_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed)
+{
+  const float32x4_t scale = vdupq_n_f32(SCALE_S24);
+  const float32x4_t min = vdupq_n_f32(-8388608.0f);
+  const float32x4_t max = vdupq_n_f32(8388607.0f);
+  uint32_t seed = ditherSeed ? *ditherSeed : 0;
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_s32(dst + i, ToInt_NEON(vld1q_f32(src + i), scale, min, max, ditherSeed != nullptr, seed + i));
+
+  if (ditherSeed)
+  {
+    *ditherSeed = seed + i;
+    FloatToS24_C(dst + i, src + i, count - i, ditherSeed);
+  }
+  else
+    FloatToS24_C(dst + i, src + i, count - i, nullptr);
+}
+
+void FloatToS32_NEON(int32_t* dst, const float* src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(SCALE_S32);
+  const float32x4_t min = vdupq_n_f32(-SCALE_S32);
+  const float32x4_t max = vdupq_n_f32(MAX_S32);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_s32(dst + i, ToInt_NEON(vld1q_f32(src + i), scale, min, max, false, 0));
+  FloatToS32_C(dst + i, src + i, count - i);
+}
+
+void S16ToFloat_NEON(float* dst, const int16_t* src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(1.0f / SCALE_S16);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(src + i))), scale));
+  S16ToFloat_C(dst + i, src + i, count - i);
+}
+
+void S32ToFloat_NEON(float* dst, const int32_t* src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(1.0f / SCALE_S32);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+  S32ToFloat_C(dst + i, src + i, count - i);
+}
+#endif
+#endif
+
+struct AEKernels
+{
+  const char* name;
+  void (*mul)(float* data, float mul, uint32_t count);
+  void (*mulAdd)(float* data, const float* add, float mul, uint32_t count);
+  void (*clamp)(float* data, uint32_t count);
+  bool (*needsClamp)(const float* data, uint32_t count);
+  void (*interleave)(float* dst, const float* const* src, unsigned int channels, uint32_t frames);
+  void (*deinterleave)(float* const* dst, const float* src, unsigned int channels, uint32_t frames);
+  void (*remap)(float* dst, const float* src, const int* map,
+                unsigned int dstChannels, unsigned int srcChannels, uint32_t frames);
+  void (*floatToS16)(int16_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed);
+  void (*floatToS24)(int32_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed);
+  void (*floatToS32)(int32_t* dst, const float* src, uint32_t count);
+  void (*s16ToFloat)(float* dst, const int16_t* src, uint32_t count);
+  void (*s32ToFloat)(float* dst, const int32_t* src, uint32_t count);
+};
+
+const AEKernels KERNELS_C = { "C", Mul_C, MulAdd_C, Clamp_C, NeedsClamp_C, Interleave_C, Deinterleave_C, Remap_C,
+                              FloatToS16_C, FloatToS24_C, FloatToS32_C, S16ToFloat_C, S32ToFloat_C };
+#if defined(AE_KERNELS_SSE2)
+// SSE2 lacks 32 bit multiplies for the dither and gathers, conversions and remap stay scalar
+const AEKernels KERNELS_SSE2 = { "SSE2", Mul_SSE2, MulAdd_SSE2, Clamp_SSE2, NeedsClamp_SSE2, Interleave_SSE2, Deinterleave_SSE2, Remap_C,
+                                 FloatToS16_C, FloatToS24_C, FloatToS32_C, S16ToFloat_C, S32ToFloat_C };
+#endif
+#if defined(AE_KERNELS_AVX2)
+const AEKernels KERNELS_AVX2 = { "AVX2", Mul_AVX2, MulAdd_AVX2, Clamp_AVX2, NeedsClamp_AVX2, Interleave_AVX2, Deinterleave_AVX2, Remap_AVX2,
+                                 FloatToS16_AVX2, FloatToS24_AVX2, FloatToS32_AVX2, S16ToFloat_AVX2, S32ToFloat_AVX2 };
+#endif
+#if defined(AE_KERNELS_NEON)
+#if defined(AE_KERNELS_NEON_CONVERT)
+const AEKernels KERNELS_NEON = { "NEON", Mul_NEON, MulAdd_NEON, Clamp_NEON, NeedsClamp_NEON, Interleave_NEON, Deinterleave_NEON, Remap_NEON,
+                                 FloatToS16_NEON, FloatToS24_NEON, FloatToS32_NEON, S16ToFloat_NEON, S32ToFloat_NEON };
+#else
+const AEKernels KERNELS_NEON = { "NEON", Mul_NEON, MulAdd_NEON, Clamp_NEON, NeedsClamp_NEON, Interleave_NEON, Deinterleave_NEON, Remap_NEON,
+                                 FloatToS16_C, FloatToS24_C, FloatToS32_C, S16ToFloat_C, S32ToFloat_C };
+#endif
+#endif
+
+// supported kernel sets, best last
+std::vector<const AEKernels*> GetSupportedKernels()
+{
+  std::vector<const AEKernels*> kernels = { &KERNELS_C };
+  unsigned int features = g_cpuInfo.GetCPUFeatures();
+
+#if defined(AE_KERNELS_SSE2)
+  if (features & CPU_FEATURE_SSE2)
+    kernels.push_back(&KERNELS_SSE2);
+#endif
+#if defined(AE_KERNELS_AVX2)
+  if ((features & CPU_FEATURE_SSE2) && (features & CPU_FEATURE_AVX2))
+    kernels.push_back(&KERNELS_AVX2);
+#endif
+#if defined(AE_KERNELS_NEON)
+  if (features & CPU_FEATURE_NEON)
+    kernels.push_back(&KERNELS_NEON);
+#endif
+
+  return kernels;
+}
+
+const AEKernels* SelectKernels()
+{
+  const AEKernels* kernels = GetSupportedKernels().back();
+  CLog::Log(LOGDEBUG, "CAEKernels: using %s kernels", kernels->name);
+  return kernels;
+}
+
+std::atomic<const AEKernels*>& GetKernelsRef()
+{
+  static std::atomic<const AEKernels*> kernels(SelectKernels());
+  return kernels;
+}
+
+inline const AEKernels& GetKernels()
+{
+  return *GetKernelsRef().load(std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+void CAEKernels::Mul(float* data, float mul, uint32_t count)
+{
+  GetKernels().mul(data, mul, count);
+}
+
+void CAEKernels::MulAdd(float* data, const float* add, float mul, uint32_t count)
+{
+  GetKernels().mulAdd(data, add, mul, count);
+}
+
+void CAEKernels::Clamp(float* data, uint32_t count)
+{
+  GetKernels().clamp(data, count);
+}
+
+bool CAEKernels::NeedsClamp(const float* data, uint32_t count)
+{
+  return GetKernels().needsClamp(data, count);
+}
+
+void CAEKernels::Interleave(float* dst, const float* const* src, unsigned int channels, uint32_t frames)
+{
+  GetKernels().interleave(dst, src, channels, frames);
+}
+
+void CAEKernels::Deinterleave(float* const* dst, const float* src, unsigned int channels, uint32_t frames)
+{
+  GetKernels().deinterleave(dst, src, channels, frames);
+}
+
+void CAEKernels::Remap(float* dst, const float* src, const int* map,
+                       unsigned int dstChannels, unsigned int srcChannels, uint32_t frames)
+{
+  GetKernels().remap(dst, src, map, dstChannels, srcChannels, frames);
+}
+
+void CAEKernels::FloatToS16(int16_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed)
+{
+  GetKernels().floatToS16(dst, src, count, ditherSeed);
+}
+
+void CAEKernels::FloatToS24(int32_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed)
+{
+  GetKernels().floatToS24(dst, src, count, ditherSeed);
+}
+
+void CAEKernels::FloatToS32(int32_t* dst, const float* src, uint32_t count)
+{
+  GetKernels().floatToS32(dst, src, count);
+}
+
+void CAEKernels::S16ToFloat(float* dst, const int16_t* src, uint32_t count)
+{
+  GetKernels().s16ToFloat(dst, src, count);
+}
+
+void CAEKernels::S32ToFloat(float* dst, const int32_t* src, uint32_t count)
+{
+  GetKernels().s32ToFloat(dst, src, count);
+}
+
+const char* CAEKernels::GetKernelName()
+{
+  return GetKernels().name;
+}
+
+std::vector<std::string> CAEKernels::GetKernelNames()
+{
+  std::vector<std::string> names;
+  for (auto kernels : GetSupportedKernels())
+    names.push_back(kernels->name);
+  return names;
+}
+
+bool CAEKernels::SetKernels(const std::string& name)
+{
+  for (auto kernels : GetSupportedKernels())
+  {
+    if (name == kernels->name)
+    {
+      GetKernelsRef().store(kernels);
+      return true;
+    }
+  }
+  return false;
+}
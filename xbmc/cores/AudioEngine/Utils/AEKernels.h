@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Sample processing kernels used for mixing and format conversion
+ *
+ * Every kernel has a scalar reference implementation plus SSE2, AVX2 and NEON
+ * variants. The variant is picked once, on first use, from the features
+ * reported by CCPUInfo. All variants produce bit-identical output, multiplies
+ * and adds are never fused.
+ */
+class CAEKernels
+{
+public:
+  //! data[i] *= mul
+  static void Mul(float* data, float mul, uint32_t count);
+
+  //! data[i] += add[i] * mul
+  static void MulAdd(float* data, const float* add, float mul, uint32_t count);
+
+  /*!
+   * \brief Soft clip every sample to -1..1 with a tanh-like rational function
+   */
+  static void Clamp(float* data, uint32_t count);
+
+  /*!
+   * \brief Check if any sample lies outside of -1..1
+   */
+  static bool NeedsClamp(const float* data, uint32_t count);
+
+  /*!
+   * \brief Interleave planar channels
+   * \param dst destination, channels * frames samples
+   * \param src one plane of frames samples per channel
+   */
+  static void Interleave(float* dst, const float* const* src, unsigned int channels, uint32_t frames);
+
+  /*!
+   * \brief Split interleaved samples into planar channels
+   */
+  static void Deinterleave(float* const* dst, const float* src, unsigned int channels, uint32_t frames);
+
+  /*!
+   * \brief Reorder, drop or silence the channels of interleaved samples
+   * \param map source channel of every destination channel, -1 for silence
+   * \note dst and src must not overlap
+   */
+  static void Remap(float* dst, const float* src, const int* map,
+                    unsigned int dstChannels, unsigned int srcChannels, uint32_t frames);
+
+  /*!
+   * \brief Convert float samples to signed 16 bit
+   *
+   * Samples are clipped to the output range and rounded to nearest.
+   * \param ditherSeed if not null, triangular dither of one LSB is added and
+   * the seed is advanced by count. Dither is derived from the seed and the
+   * sample position only, so consecutive calls continue the same sequence.
+   */
+  static void FloatToS16(int16_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed);
+
+  /*!
+   * \brief Convert float samples to signed 24 bit in the low bytes of 32 bit words
+   * \sa FloatToS16
+   */
+  static void FloatToS24(int32_t* dst, const float* src, uint32_t count, uint32_t* ditherSeed);
+
+  /*!
+   * \brief Convert float samples to signed 32 bit, float has no precision
+   * left to dither at this depth
+   */
+  static void FloatToS32(int32_t* dst, const float* src, uint32_t count);
+
+  static void S16ToFloat(float* dst, const int16_t* src, uint32_t count);
+  static void S32ToFloat(float* dst, const int32_t* src, uint32_t count);
+
+  /*!
+   * \brief Name of the kernel set in use, for logging
+   */
+  static const char* GetKernelName();
+
+  /*!
+   * \brief Names of all kernel sets supported by this CPU
+   */
+  static std::vector<std::string> GetKernelNames();
+
+  /*!
+   * \brief Switch to another supported kernel set, used by tests and benchmarks
+   * \return false if the kernel set is not supported
+   */
+  static bool SetKernels(const std::string& name);
+};
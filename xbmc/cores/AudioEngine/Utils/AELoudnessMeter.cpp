@@ -0,0 +1,305 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AELoudnessMeter.h"
+#include "AEKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// frames deinterleaved at a time
+#define METER_CHUNK_FRAMES 1024
+
+// absolute and relative gates of BS.1770-4 in LUFS and LU
+#define GATE_ABSOLUTE -70.0
+#define GATE_RELATIVE -10.0
+
+namespace
+{
+inline double EnergyToLoudness(double energy)
+{
+  return -0.691 + 10.0 * log10(energy);
+}
+}
+
+constexpr double CAELoudnessMeter::REFERENCE_LOUDNESS;
+
+CAELoudnessMeter::CAELoudnessMeter()
+  : m_shelf(),
+    m_highpass(),
+    m_sampleRate(0),
+    m_subBlockFrames(0),
+    m_subBlockPos(0),
+    m_subBlocks(),
+    m_subBlockCount(0),
+    m_oversampling(1),
+    m_peakFilter(),
+    m_truePeak(0.0)
+{
+}
+
+bool CAELoudnessMeter::Init(const CAEChannelInfo& layout, unsigned int sampleRate)
+{
+  if (layout.Count() == 0 || sampleRate < 8000)
+    return false;
+
+  m_sampleRate = sampleRate;
+  m_subBlockFrames = sampleRate / 10;
+
+  // K-weighting, the pre-filter (high shelf) and RLB filter (high pass) of
+  // BS.1770 re-designed for the given sample rate
+  double f0 = 1681.974450955533;
+  double gain = 3.999843853973347;
+  double q = 0.7071752369554196;
+  double k = tan(M_PI * f0 / sampleRate);
+  double vh = pow(10.0, gain / 20.0);
+  double vb = pow(vh, 0.4996667741545416);
+  double a0 = 1.0 + k / q + k * k;
+  m_shelf.b0 = (vh + vb * k / q + k * k) / a0;
+  m_shelf.b1 = 2.0 * (k * k - vh) / a0;
+  m_shelf.b2 = (vh - vb * k / q + k * k) / a0;
+  m_shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+  m_shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = tan(M_PI * f0 / sampleRate);
+  a0 = 1.0 + k / q + k * k;
+  m_highpass.b0 = 1.0;
+  m_highpass.b1 = -2.0;
+  m_highpass.b2 = 1.0;
+  m_highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+  m_highpass.a2 = (1.0 - k / q + k * k) / a0;
+
+  m_channels.resize(layout.Count());
+  m_planes.resize(layout.Count());
+  for (unsigned int i = 0; i < layout.Count(); i++)
+  {
+    switch (layout[i])
+    {
+      case AE_CH_LFE:
+        m_channels[i].weight = 0.0;
+        break;
+      case AE_CH_BL:
+      case AE_CH_BR:
+      case AE_CH_SL:
+      case AE_CH_SR:
+        m_channels[i].weight = 1.41;
+        break;
+      default:
+        m_channels[i].weight = 1.0;
+        break;
+    }
+    m_channels[i].samples.resize(PEAK_TAPS - 1 + METER_CHUNK_FRAMES);
+  }
+
+  // polyphase windowed sinc interpolator, every phase has a dc gain of one
+  m_oversampling = sampleRate < 96000 ? 4 : sampleRate < 192000 ? 2 : 1;
+  unsigned int length = m_oversampling * PEAK_TAPS;
+  double center = (length - 1) / 2.0;
+  for (unsigned int p = 0; p < m_oversampling; p++)
+  {
+    double sum = 0.0;
+    double taps[PEAK_TAPS];
+    for (unsigned int t = 0; t < PEAK_TAPS; t++)
+    {
+      unsigned int n = p + m_oversampling * t;
+      double x = (n - center) / m_oversampling;
+      double sinc = x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+      double window = 0.5 - 0.5 * cos(2.0 * M_PI * (n + 0.5) / length);
+      taps[t] = sinc * window;
+      sum += taps[t];
+    }
+    // stored reversed, the last tap is applied to the newest sample
+    for (unsigned int t = 0; t < PEAK_TAPS; t++)
+      m_peakFilter[p][PEAK_TAPS - 1 - t] = static_cast<float>(taps[t] / sum);
+  }
+
+  Reset();
+  return true;
+}
+
+void CAELoudnessMeter::Reset()
+{
+  for (auto& channel : m_channels)
+  {
+    std::fill(channel.z, channel.z + 4, 0.0);
+    channel.energy = 0.0;
+    std::fill(channel.samples.begin(), channel.samples.end(), 0.0f);
+  }
+  m_subBlockPos = 0;
+  m_subBlockCount = 0;
+  std::fill(m_subBlocks, m_subBlocks + 4, 0.0);
+  m_blocks.clear();
+  m_truePeak = 0.0;
+}
+
+void CAELoudnessMeter::AddFrames(const float* data, unsigned int frames)
+{
+  unsigned int channels = m_channels.size();
+  if (!channels)
+    return;
+
+  while (frames)
+  {
+    unsigned int chunk = std::min(frames, (unsigned int)METER_CHUNK_FRAMES);
+    for (unsigned int ch = 0; ch < channels; ch++)
+      m_planes[ch] = m_channels[ch].samples.data() + PEAK_TAPS - 1;
+    CAEKernels::Deinterleave(m_planes.data(), data, channels, chunk);
+
+    // true peak, the filter runs over the history of the previous chunk
+    for (auto& channel : m_channels)
+    {
+      const float* samples = channel.samples.data();
+      float peak = 0.0f;
+      for (unsigned int p = 0; m_oversampling > 1 && p < m_oversampling; p++)
+      {
+        // taps outer, frames inner: the inner loops vectorize without
+        // reassociating float sums
+        const float* filter = m_peakFilter[p];
+        float out[METER_CHUNK_FRAMES];
+        for (unsigned int n = 0; n < chunk; n++)
+          out[n] = filter[0] * samples[n];
+        for (unsigned int t = 1; t < PEAK_TAPS; t++)
+        {
+          const float tap = filter[t];
+          const float* in = samples + t;
+          for (unsigned int n = 0; n < chunk; n++)
+            out[n] += tap * in[n];
+        }
+        for (unsigned int n = 0; n < chunk; n++)
+          peak = std::max(peak, std::fabs(out[n]));
+      }
+      for (unsigned int n = 0; n < chunk; n++)
+        peak = std::max(peak, std::fabs(samples[n + PEAK_TAPS - 1]));
+      m_truePeak = std::max(m_truePeak, (double)peak);
+    }
+
+    // loudness, split at the sub-block boundaries
+    unsigned int offset = 0;
+    while (offset < chunk)
+    {
+      unsigned int count = std::min(chunk - offset, m_subBlockFrames - m_subBlockPos);
+      ProcessSubBlock(count, offset);
+      offset += count;
+      m_subBlockPos += count;
+      if (m_subBlockPos == m_subBlockFrames)
+        CloseSubBlock();
+    }
+
+    for (auto& channel : m_channels)
+      std::copy(channel.samples.begin() + chunk, channel.samples.begin() + chunk + PEAK_TAPS - 1,
+                channel.samples.begin());
+
+    data += chunk * channels;
+    frames -= chunk;
+  }
+}
+
+void CAELoudnessMeter::ProcessSubBlock(unsigned int frames, unsigned int offset)
+{
+  const Biquad s = m_shelf;
+  const Biquad h = m_highpass;
+  for (auto& channel : m_channels)
+  {
+    if (channel.weight == 0.0)
+      continue;
+
+    const float* samples = channel.samples.data() + PEAK_TAPS - 1 + offset;
+    double z0 = channel.z[0], z1 = channel.z[1], z2 = channel.z[2], z3 = channel.z[3];
+    double energy = 0.0;
+    for (unsigned int n = 0; n < frames; n++)
+    {
+      // transposed direct form II
+      double x = samples[n];
+      double y = s.b0 * x + z0;
+      z0 = s.b1 * x - s.a1 * y + z1;
+      z1 = s.b2 * x - s.a2 * y;
+      double w = h.b0 * y + z2;
+      z2 = h.b1 * y - h.a1 * w + z3;
+      z3 = h.b2 * y - h.a2 * w;
+      energy += w * w;
+    }
+    channel.z[0] = z0;
+    channel.z[1] = z1;
+    channel.z[2] = z2;
+    channel.z[3] = z3;
+    channel.energy += energy;
+  }
+}
+
+void CAELoudnessMeter::CloseSubBlock()
+{
+  double energy = 0.0;
+  for (auto& channel : m_channels)
+  {
+    energy += channel.weight * channel.energy;
+    channel.energy = 0.0;
+  }
+
+  m_subBlocks[m_subBlockCount % 4] = energy;
+  m_subBlockCount++;
+  m_subBlockPos = 0;
+
+  // a gating block spans 4 sub-blocks
+  if (m_subBlockCount >= 4)
+  {
+    double sum = m_subBlocks[0] + m_subBlocks[1] + m_subBlocks[2] + m_subBlocks[3];
+    m_blocks.push_back(sum / (4.0 * m_subBlockFrames));
+  }
+}
+
+double CAELoudnessMeter::GetIntegratedLoudness(const std::vector<double>& blocks)
+{
+  double sum = 0.0;
+  unsigned int count = 0;
+  for (double block : blocks)
+  {
+    if (block > 0.0 && EnergyToLoudness(block) > GATE_ABSOLUTE)
+    {
+      sum += block;
+      count++;
+    }
+  }
+  if (!count)
+    return -std::numeric_limits<double>::infinity();
+
+  double relative = EnergyToLoudness(sum / count) + GATE_RELATIVE;
+  sum = 0.0;
+  count = 0;
+  for (double block : blocks)
+  {
+    if (block > 0.0 && EnergyToLoudness(block) > GATE_ABSOLUTE && EnergyToLoudness(block) > relative)
+    {
+      sum += block;
+      count++;
+    }
+  }
+  if (!count)
+    return -std::numeric_limits<double>::infinity();
+
+  return EnergyToLoudness(sum / count);
+}
+
+double CAELoudnessMeter::GetReplayGain(double loudness)
+{
+  return REFERENCE_LOUDNESS - loudness;
+}
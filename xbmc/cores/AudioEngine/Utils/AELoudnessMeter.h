@@ -0,0 +1,109 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "AEChannelInfo.h"
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \brief Loudness and true peak measurement after EBU R128 / ITU-R BS.1770-4
+ *
+ * Frames are K-weighted with two biquads per channel and summed into 100ms
+ * sub-blocks, every sub-block closes a 400ms gating block (75% overlap).
+ * The energies of the gating blocks are kept so that the integrated loudness
+ * of several meters (an album) can be computed from their combined blocks.
+ *
+ * The true peak is measured on a 4x (2x at 96kHz and above) polyphase
+ * oversampled signal. Channels are processed planar so that the filter loops
+ * vectorize.
+ */
+class CAELoudnessMeter
+{
+public:
+  //! ReplayGain 2.0 reference level
+  static constexpr double REFERENCE_LOUDNESS = -18.0;
+
+  CAELoudnessMeter();
+
+  /*!
+   * \brief Prepare the meter for a stream, resets all measurements
+   * \param layout channel layout, LFE is ignored and surround channels are weighted +1.5dB
+   * \return false if the format can't be measured
+   */
+  bool Init(const CAEChannelInfo& layout, unsigned int sampleRate);
+  void Reset();
+
+  //! Add interleaved float frames
+  void AddFrames(const float* data, unsigned int frames);
+
+  /*!
+   * \brief Integrated loudness of everything added so far
+   * \return loudness in LUFS, -infinity if everything was gated (silence)
+   */
+  double GetIntegratedLoudness() const { return GetIntegratedLoudness(m_blocks); }
+  //! Highest true peak, linear with 1.0 == full digital scale
+  double GetTruePeak() const { return m_truePeak; }
+  //! Energies of the gating blocks, input for the loudness of a group of meters
+  const std::vector<double>& GetBlocks() const { return m_blocks; }
+
+  //! Gated loudness of the given block energies in LUFS
+  static double GetIntegratedLoudness(const std::vector<double>& blocks);
+  //! ReplayGain in dB to bring the given loudness to the reference level
+  static double GetReplayGain(double loudness);
+
+private:
+  static const unsigned int PEAK_TAPS = 12;
+  static const unsigned int MAX_OVERSAMPLING = 4;
+
+  struct Biquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+
+  struct Channel
+  {
+    double weight;
+    double z[4];                      // state of both biquads
+    double energy;                    // squared sum of the current sub-block
+    std::vector<float> samples;       // PEAK_TAPS - 1 history followed by the new frames
+  };
+
+  void ProcessSubBlock(unsigned int frames, unsigned int offset);
+  void CloseSubBlock();
+
+  Biquad m_shelf;
+  Biquad m_highpass;
+  std::vector<Channel> m_channels;
+  std::vector<float*> m_planes;
+
+  unsigned int m_sampleRate;
+  unsigned int m_subBlockFrames;
+  unsigned int m_subBlockPos;
+  double m_subBlocks[4];
+  unsigned int m_subBlockCount;
+  std::vector<double> m_blocks;
+
+  unsigned int m_oversampling;
+  float m_peakFilter[MAX_OVERSAMPLING][PEAK_TAPS];
+  double m_truePeak;
+};
@@ -0,0 +1,142 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "AESinkTelemetry.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+const double CAESinkTelemetry::MIN_SCALE = 0.5;
+const double CAESinkTelemetry::MAX_SCALE = 4.0;
+
+CAESinkTelemetry& CAESinkTelemetry::GetInstance()
+{
+  static CAESinkTelemetry telemetry;
+  return telemetry;
+}
+
+CAESinkTelemetry::CAESinkTelemetry()
+{
+  m_adaptive = false;
+  m_underruns = 0;
+  m_interrupted = false;
+  m_writes = 0;
+  m_lastEnd = 0;
+  m_lastDelay = 0.0;
+  m_lastDuration = 0.0;
+  m_bufferTime = 0.0;
+}
+
+int64_t CAESinkTelemetry::Now()
+{
+  int64_t counter = CurrentHostCounter();
+  int64_t freq = CurrentHostFrequency();
+  return (counter / freq) * 1000000 + (counter % freq) * 1000000 / freq;
+}
+
+void CAESinkTelemetry::StartSession(const std::string &device, double bufferTime)
+{
+  CSingleLock lock(m_section);
+  Judge();
+
+  m_device = device;
+  m_bufferTime = bufferTime;
+  m_underruns = 0;
+  m_interrupted = false;
+  m_writes = 0;
+  m_delayJitter.Reset();
+  m_wakeupLateness.Reset();
+  m_lastEnd = 0;
+}
+
+void CAESinkTelemetry::EndSession()
+{
+  CSingleLock lock(m_section);
+  Judge();
+  m_device.clear();
+}
+
+double CAESinkTelemetry::GetBufferScale(const std::string &device)
+{
+  if (!m_adaptive)
+    return 1.0;
+
+  CSingleLock lock(m_section);
+  auto it = m_scales.find(device);
+  if (it == m_scales.end())
+    return 1.0;
+  return it->second;
+}
+
+void CAESinkTelemetry::AddWrite(int64_t start, int64_t end, double delay, double duration)
+{
+  m_writes++;
+  m_interrupted = false;
+
+  if (m_lastEnd)
+  {
+    // the sink was fed in real time if the gap between two writes matches the
+    // audio handed over the last time
+    int64_t lateness = (start - m_lastEnd) - static_cast<int64_t>(m_lastDuration * 1000000);
+    m_wakeupLateness.Add(std::max<int64_t>(lateness, 0));
+
+    double expected = m_lastDelay + duration - (end - m_lastEnd) / 1000000.0;
+    if (expected > 0.0)
+      m_delayJitter.Add(static_cast<int64_t>(std::abs(delay - expected) * 1000000));
+  }
+
+  m_lastEnd = end;
+  m_lastDelay = delay;
+  m_lastDuration = duration;
+}
+
+void CAESinkTelemetry::Judge()
+{
+  if (m_device.empty())
+    return;
+
+  CLog::Log(LOGDEBUG, "CAESinkTelemetry::Judge - %s: %u writes, %u underruns, jitter p99 %.1f ms, "
+            "lateness p99 %.1f ms",
+            m_device.c_str(), static_cast<unsigned int>(m_writes), static_cast<unsigned int>(m_underruns),
+            m_delayJitter.GetPercentile(99.0) / 1000.0, m_wakeupLateness.GetPercentile(99.0) / 1000.0);
+
+  if (!m_adaptive || m_bufferTime <= 0.0)
+    return;
+
+  double &scale = m_scales.emplace(m_device, 1.0).first->second;
+  double oldScale = scale;
+
+  // keep a quarter of the buffer as headroom for jitter and late wakeups
+  int64_t headroom = static_cast<int64_t>(m_bufferTime * 1000000 / 4);
+  if (m_underruns > 0)
+    scale = std::min(scale * 1.5, MAX_SCALE);
+  else if (m_writes >= MIN_WRITES_TO_SHRINK &&
+           m_delayJitter.GetPercentile(99.0) < headroom / 2 &&
+           m_wakeupLateness.GetPercentile(99.0) < headroom / 2)
+    scale = std::max(scale * 0.8, MIN_SCALE);
+
+  if (scale != oldScale)
+    CLog::Log(LOGNOTICE, "CAESinkTelemetry::Judge - buffer of %s scaled from %.2f to %.2f",
+              m_device.c_str(), oldScale, scale);
+}
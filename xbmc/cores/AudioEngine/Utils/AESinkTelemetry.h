@@ -0,0 +1,120 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include "cores/VideoPlayer/Process/FrameTiming.h"
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <map>
+#include <stdint.h>
+#include <string>
+
+/*!
+ * \brief Timing statistics of the audio sink and adaptive device buffer sizing
+ *
+ * CActiveAESink reports every write to the device, sinks report underruns
+ * from whatever thread detects them. Histograms are in microseconds:
+ * - delay jitter is the difference between the delay reported by the sink
+ *   and the delay predicted from the previous write and the elapsed time
+ * - wakeup lateness is how much longer the sink thread took to come back
+ *   than the duration of audio it wrote the previous time
+ *
+ * In adaptive mode every session (sink open to sink open) is judged when the
+ * next one starts: underruns grow the buffer of the device, long sessions
+ * with low jitter shrink it. Sinks scale their default buffer by
+ * GetBufferScale() when they are initialised.
+ */
+class CAESinkTelemetry
+{
+public:
+  static CAESinkTelemetry& GetInstance();
+
+  CAESinkTelemetry();
+
+  void SetAdaptive(bool adaptive) { m_adaptive = adaptive; }
+  bool IsAdaptive() const { return m_adaptive; }
+
+  /*!
+   * \brief Judge the previous session and start collecting for a new one
+   * \param device device of the new session, empty if the sink failed to open
+   * \param bufferTime total buffer of the sink in seconds
+   */
+  void StartSession(const std::string &device, double bufferTime);
+  void EndSession();
+
+  /*!
+   * \brief Factor for the default buffer size of the given device, always 1 unless adaptive
+   */
+  double GetBufferScale(const std::string &device);
+
+  /*!
+   * \brief Account an underrun, ignored after Interrupt() until the next write
+   */
+  void AddUnderrun() { if (!m_interrupted) m_underruns++; }
+  /*!
+   * \brief Account a write to the device
+   * \param start time OutputSamples was entered, see Now()
+   * \param end time after the last write
+   * \param delay delay reported by the sink after the write in seconds
+   * \param duration duration of the audio written in seconds
+   */
+  void AddWrite(int64_t start, int64_t end, double delay, double duration);
+  /*!
+   * \brief The sink stops being fed on purpose (idle, drain), the device running
+   * dry is not an underrun and the next write is not late
+   */
+  void Interrupt() { m_lastEnd = 0; m_interrupted = true; }
+
+  unsigned int GetUnderruns() const { return m_underruns; }
+  unsigned int GetWrites() const { return m_writes; }
+  const CFrameTimingHistogram& GetDelayJitter() const { return m_delayJitter; }
+  const CFrameTimingHistogram& GetWakeupLateness() const { return m_wakeupLateness; }
+
+  static int64_t Now();
+
+  static const double MIN_SCALE;
+  static const double MAX_SCALE;
+
+protected:
+  void Judge();
+
+  // writes a session needs before it may shrink the buffer, about a minute
+  static const unsigned int MIN_WRITES_TO_SHRINK = 1000;
+
+  std::atomic_bool m_adaptive;
+  std::atomic<unsigned int> m_underruns;
+  std::atomic_bool m_interrupted;
+  std::atomic<unsigned int> m_writes;
+  CFrameTimingHistogram m_delayJitter;
+  CFrameTimingHistogram m_wakeupLateness;
+
+  // only touched by the sink thread
+  int64_t m_lastEnd;
+  double m_lastDelay;
+  double m_lastDuration;
+
+  CCriticalSection m_section;
+  std::string m_device;
+  double m_bufferTime;
+  std::map<std::string, double> m_scales;
+};
@@ -0,0 +1,146 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "AESpectrumAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+static_assert(sizeof(kiss_fft_cpx) == 2 * sizeof(float), "kissfft has to be built for float");
+
+const uint64_t CAESpectrumAnalyzer::NO_PACKET;
+
+CAESpectrumAnalyzer::CAESpectrumAnalyzer() :
+  CThread("AESpectrum"),
+  m_readPos(1),
+  m_writePos(1),
+  m_publishPos(1),
+  m_output(FFT_SIZE)
+{
+  m_cfg = kiss_fft_alloc(FFT_SIZE, 0, nullptr, nullptr);
+}
+
+CAESpectrumAnalyzer::~CAESpectrumAnalyzer()
+{
+  Stop();
+  // see RFFT, kiss_fft_free does not know about SIMD allocations
+  KISS_FFT_FREE(m_cfg);
+}
+
+void CAESpectrumAnalyzer::Start()
+{
+  if (IsRunning())
+    return;
+
+  m_readPos = m_writePos.load();
+  m_publishPos = m_readPos;
+  Create();
+  SetPriority(GetMinPriority());
+}
+
+void CAESpectrumAnalyzer::Stop()
+{
+  m_bStop = true;
+  m_dataEvent.Set();
+  StopThread(true);
+}
+
+uint64_t CAESpectrumAnalyzer::AddSamples(const float* samples, unsigned int frames, unsigned int sampleRate)
+{
+  uint64_t writePos = m_writePos.load(std::memory_order_relaxed);
+  if (writePos - m_readPos.load(std::memory_order_acquire) >= QUEUE_SIZE ||
+      writePos - m_publishPos >= QUEUE_SIZE)
+    return NO_PACKET;
+
+  Packet& packet = m_queue[writePos % QUEUE_SIZE];
+  frames = std::min(frames, FFT_SIZE);
+  memcpy(packet.samples, samples, frames * 2 * sizeof(float));
+  memset(packet.samples + frames * 2, 0, (FFT_SIZE - frames) * 2 * sizeof(float));
+  packet.spectrum.sampleRate = sampleRate;
+
+  m_writePos.store(writePos + 1, std::memory_order_release);
+  m_dataEvent.Set();
+  return writePos;
+}
+
+bool CAESpectrumAnalyzer::Publish(uint64_t packet)
+{
+  if (packet == NO_PACKET || packet < m_publishPos || packet >= m_writePos.load(std::memory_order_relaxed))
+    return false;
+
+  // skip older packets, the packet itself can be published once it is analyzed
+  m_publishPos = packet;
+  if (packet >= m_readPos.load(std::memory_order_acquire))
+    return false;
+
+  // the worker is done with the slot and doesn't touch it again until it is reused
+  m_spectrum.BeginWrite() = m_queue[packet % QUEUE_SIZE].spectrum;
+  m_spectrum.Publish();
+  m_publishPos = packet + 1;
+  return true;
+}
+
+void CAESpectrumAnalyzer::Flush()
+{
+  m_publishPos = m_writePos.load(std::memory_order_relaxed);
+}
+
+void CAESpectrumAnalyzer::Process()
+{
+  while (!m_bStop)
+  {
+    uint64_t readPos = m_readPos.load(std::memory_order_relaxed);
+    if (readPos == m_writePos.load(std::memory_order_acquire))
+    {
+      m_dataEvent.WaitMSec(100);
+      continue;
+    }
+
+    Packet& packet = m_queue[readPos % QUEUE_SIZE];
+    Analyze(packet.samples, packet.spectrum);
+
+    m_readPos.store(readPos + 1, std::memory_order_release);
+  }
+}
+
+void CAESpectrumAnalyzer::Analyze(const float* samples, AESpectrum& spectrum)
+{
+  kiss_fft(m_cfg, reinterpret_cast<const kiss_fft_cpx*>(samples), m_output.data());
+
+  // with z = l + i*r the spectra of the real signals are
+  // L[k] = (Z[k] + conj(Z[N-k])) / 2 and R[k] = (Z[k] - conj(Z[N-k])) / 2i
+  const kiss_fft_cpx* z = m_output.data();
+  const float scale = 1.0f / FFT_SIZE;
+  float* out = spectrum.magnitudes;
+  for (unsigned int k = 0; k < AESpectrum::BINS; k++)
+  {
+    const kiss_fft_cpx& a = z[k];
+    const kiss_fft_cpx& b = z[(FFT_SIZE - k) % FFT_SIZE];
+    float lr = a.r + b.r;
+    float li = a.i - b.i;
+    float rr = a.i + b.i;
+    float ri = b.r - a.r;
+    // the halves cancel against the factor 2 of the single sided spectrum
+    out[2 * k] = std::sqrt(lr * lr + li * li) * scale;
+    out[2 * k + 1] = std::sqrt(rr * rr + ri * ri) * scale;
+  }
+}
@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include "contrib/kissfft/kiss_fft.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/TripleBuffer.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \brief Magnitude spectrum of a stereo audio packet
+ *
+ * Same layout as the output of RFFT, which visualisation addons expect:
+ * BINS magnitudes per channel, interleaved left/right.
+ */
+struct AESpectrum
+{
+  static const unsigned int BINS = 128;
+
+  float magnitudes[BINS * 2];
+  unsigned int sampleRate;
+};
+
+/*!
+ * \brief Spectrum analyzer for the visualisation stream of the engine
+ *
+ * The engine hands over every visualisation packet with AddSamples while it
+ * waits for its playback time, which only copies the first FFT_SIZE frames
+ * into a wait-free queue. A worker thread transforms them ahead of time. When
+ * the engine passes the packet to the audio callbacks it calls Publish, which
+ * hands the spectrum of exactly that packet to a triple buffer, so any number
+ * of consumers can read it without locking and without running another FFT.
+ *
+ * Both channels go through a single complex FFT, left as real and right as
+ * imaginary part. Interleaved stereo floats already have the memory layout of
+ * kiss_fft_cpx, so the packet is transformed in place of the queue, and the
+ * two spectra are separated using the conjugate symmetry of real signals.
+ */
+class CAESpectrumAnalyzer : private CThread
+{
+public:
+  static const unsigned int FFT_SIZE = AESpectrum::BINS * 2;
+
+  CAESpectrumAnalyzer();
+  ~CAESpectrumAnalyzer() override;
+
+  void Start();
+  void Stop();
+
+  static const uint64_t NO_PACKET = 0;
+
+  /*!
+   * \brief Queue a packet of interleaved stereo float samples, never blocks
+   *
+   * Only one thread may add samples and publish. Packets are dropped if the
+   * queue is full.
+   * \return the id to publish the spectrum of the packet with, NO_PACKET if it was dropped
+   */
+  uint64_t AddSamples(const float* samples, unsigned int frames, unsigned int sampleRate);
+
+  /*!
+   * \brief Publish the spectrum of a queued packet, never blocks
+   *
+   * Packets queued before it are skipped. If the worker did not analyze the
+   * packet yet the previous spectrum stays published and the packet can be
+   * published again later.
+   * \return true if the spectrum of the packet was published
+   */
+  bool Publish(uint64_t packet);
+
+  /*!
+   * \brief Skip all queued packets
+   */
+  void Flush();
+
+  /*!
+   * \brief Copy the spectrum of the most recently published packet
+   * \return false if no packet was published yet
+   */
+  bool GetSpectrum(AESpectrum& spectrum) const { return m_spectrum.Read(spectrum); }
+  uint64_t GetSpectrumCount() const { return m_spectrum.GetPublished(); }
+
+  /*!
+   * \brief Compute the spectrum of FFT_SIZE frames of interleaved stereo samples
+   */
+  void Analyze(const float* samples, AESpectrum& spectrum);
+
+protected:
+  void Process() override;
+
+private:
+  // packets are queued for the delay of the sink, about 0.5 s at most
+  static const unsigned int QUEUE_SIZE = 64;
+
+  struct Packet
+  {
+    float samples[FFT_SIZE * 2];
+    AESpectrum spectrum;
+  };
+
+  // positions count packets from 1, the slot of a position is reused once
+  // the worker analyzed it and it was published or skipped
+  Packet m_queue[QUEUE_SIZE];
+  std::atomic<uint64_t> m_readPos;
+  std::atomic<uint64_t> m_writePos;
+  uint64_t m_publishPos;
+  CEvent m_dataEvent;
+
+  kiss_fft_cfg m_cfg;
+  std::vector<kiss_fft_cpx> m_output;
+  CTripleBuffer<AESpectrum> m_spectrum;
+};
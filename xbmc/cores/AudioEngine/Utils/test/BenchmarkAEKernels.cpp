@@ -0,0 +1,82 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Mixing benchmark, 7.1 float at 48kHz, one second of audio per round.
+ * Not part of the unit tests, build and run the kodi-benchmark-aekernels target.
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <stdint.h>
+#include <vector>
+
+namespace
+{
+std::vector<float> MakeSamples(uint32_t count, float range, uint32_t seed)
+{
+  std::vector<float> samples(count);
+  for (auto& value : samples)
+  {
+    seed = seed * 1103515245 + 12345;
+    value = ((seed >> 8) / 16777216.0f * 2.0f - 1.0f) * range;
+  }
+  return samples;
+}
+}
+
+int main()
+{
+  const uint32_t frames = 48000;
+  const unsigned int channels = 8;
+  const int rounds = 100;
+
+  std::vector<float> mix = MakeSamples(frames * channels, 0.8f, 9);
+  std::vector<float> stream = MakeSamples(frames * channels, 0.8f, 10);
+  std::vector<int16_t> s16(frames * channels);
+  std::vector<int32_t> s32(frames * channels);
+
+  for (const auto& name : CAEKernels::GetKernelNames())
+  {
+    if (!CAEKernels::SetKernels(name))
+      return 1;
+
+    auto run = [&](const char* kernel, std::function<void()> func)
+    {
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < rounds; i++)
+        func();
+      auto end = std::chrono::steady_clock::now();
+      double us = std::chrono::duration<double, std::micro>(end - start).count() / rounds;
+      std::cout << name << " " << kernel << ": " << us << " us per second of 7.1" << std::endl;
+    };
+
+    run("Mul", [&]() { CAEKernels::Mul(mix.data(), 0.999f, frames * channels); });
+    run("MulAdd", [&]() { CAEKernels::MulAdd(mix.data(), stream.data(), 0.5f, frames * channels); });
+    run("NeedsClamp", [&]() { CAEKernels::NeedsClamp(stream.data(), frames * channels); });
+    run("Clamp", [&]() { CAEKernels::Clamp(mix.data(), frames * channels); });
+    run("FloatToS16", [&]() { uint32_t seed = 0; CAEKernels::FloatToS16(s16.data(), mix.data(), frames * channels, &seed); });
+    run("FloatToS32", [&]() { CAEKernels::FloatToS32(s32.data(), mix.data(), frames * channels); });
+  }
+  return 0;
+}
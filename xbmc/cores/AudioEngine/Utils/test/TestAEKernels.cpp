@@ -0,0 +1,304 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <vector>
+
+namespace
+{
+// odd size so both the vector loops and the scalar tails are exercised
+const uint32_t SAMPLES = 1027;
+
+std::vector<float> MakeSamples(uint32_t count, float range, uint32_t seed)
+{
+  std::vector<float> samples(count);
+  for (auto& value : samples)
+  {
+    seed = seed * 1103515245 + 12345;
+    value = ((seed >> 8) / 16777216.0f * 2.0f - 1.0f) * range;
+  }
+  return samples;
+}
+
+bool Equal(const std::vector<float>& a, const std::vector<float>& b)
+{
+  return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+/*
+ * Runs the test body once per supported kernel set and compares the result
+ * with the scalar reference.
+ */
+template<typename T, typename F>
+void ExpectBitExact(F kernel)
+{
+  ASSERT_TRUE(CAEKernels::SetKernels("C"));
+  T reference = kernel();
+
+  for (const auto& name : CAEKernels::GetKernelNames())
+  {
+    ASSERT_TRUE(CAEKernels::SetKernels(name));
+    EXPECT_TRUE(kernel() == reference) << "kernel set " << name;
+  }
+  CAEKernels::SetKernels(CAEKernels::GetKernelNames().back());
+}
+}
+
+TEST(TestAEKernels, Mul)
+{
+  ExpectBitExact<std::vector<float>>([]()
+  {
+    std::vector<float> data = MakeSamples(SAMPLES, 1.0f, 1);
+    CAEKernels::Mul(data.data(), 0.7f, SAMPLES);
+    return data;
+  });
+
+  std::vector<float> data = { 1.0f, -0.5f };
+  CAEKernels::Mul(data.data(), 0.5f, 2);
+  EXPECT_EQ(0.5f, data[0]);
+  EXPECT_EQ(-0.25f, data[1]);
+}
+
+TEST(TestAEKernels, MulAdd)
+{
+  ExpectBitExact<std::vector<float>>([]()
+  {
+    std::vector<float> data = MakeSamples(SAMPLES, 1.0f, 1);
+    std::vector<float> add = MakeSamples(SAMPLES, 1.0f, 2);
+    // unaligned source
+    CAEKernels::MulAdd(data.data(), add.data() + 1, 0.3f, SAMPLES - 1);
+    return data;
+  });
+}
+
+TEST(TestAEKernels, Clamp)
+{
+  ExpectBitExact<std::vector<float>>([]()
+  {
+    std::vector<float> data = MakeSamples(SAMPLES, 5.0f, 3);
+    CAEKernels::Clamp(data.data(), SAMPLES);
+    return data;
+  });
+
+  std::vector<float> data = { 0.0f, 3.0f, -3.0f, 10.0f, -10.0f, 1.0f };
+  CAEKernels::Clamp(data.data(), data.size());
+  EXPECT_EQ(0.0f, data[0]);
+  EXPECT_EQ(1.0f, data[1]);
+  EXPECT_EQ(-1.0f, data[2]);
+  EXPECT_EQ(1.0f, data[3]);
+  EXPECT_EQ(-1.0f, data[4]);
+  EXPECT_LT(data[5], 1.0f);
+}
+
+TEST(TestAEKernels, ClampFollowsSoftClamp)
+{
+  // x * (27 + x^2) / (27 + 9 * x^2) inside +-3, hard clip outside
+  const std::vector<float> input = { 0.5f, -0.5f, 2.0f, -2.0f, 2.9f, 3.5f, -3.5f, 100.0f,
+                                     -100.0f, 0.25f, -1.0f, 1.5f, 4.0f, -0.75f, 3.01f, -2.5f,
+                                     0.1f };
+  std::vector<float> expected;
+  for (float x : input)
+  {
+    if (x < -3.0f)
+      expected.push_back(-1.0f);
+    else if (x > 3.0f)
+      expected.push_back(1.0f);
+    else
+      expected.push_back(x * (27.0f + x * x) / (27.0f + 9.0f * (x * x)));
+  }
+
+  for (const auto& name : CAEKernels::GetKernelNames())
+  {
+    ASSERT_TRUE(CAEKernels::SetKernels(name));
+    std::vector<float> data = input;
+    CAEKernels::Clamp(data.data(), data.size());
+    for (size_t i = 0; i < input.size(); i++)
+      EXPECT_FLOAT_EQ(expected[i], data[i]) << name << " input " << input[i];
+  }
+  CAEKernels::SetKernels(CAEKernels::GetKernelNames().back());
+}
+
+TEST(TestAEKernels, NeedsClamp)
+{
+  for (const auto& name : CAEKernels::GetKernelNames())
+  {
+    ASSERT_TRUE(CAEKernels::SetKernels(name));
+    std::vector<float> data = MakeSamples(SAMPLES, 1.0f, 4);
+    EXPECT_FALSE(CAEKernels::NeedsClamp(data.data(), SAMPLES)) << name;
+
+    // every position, vector body and tail
+    for (uint32_t i = 0; i < 20; i++)
+    {
+      data = MakeSamples(20, 1.0f, 4);
+      data[i] = -1.5f;
+      EXPECT_TRUE(CAEKernels::NeedsClamp(data.data(), 20)) << name << " position " << i;
+    }
+  }
+}
+
+TEST(TestAEKernels, Interleave)
+{
+  for (unsigned int channels = 1; channels <= 8; channels++)
+  {
+    ExpectBitExact<std::vector<float>>([channels]()
+    {
+      std::vector<std::vector<float>> planes;
+      std::vector<const float*> src;
+      for (unsigned int c = 0; c < channels; c++)
+      {
+        planes.push_back(MakeSamples(SAMPLES, 1.0f, c));
+        src.push_back(planes.back().data());
+      }
+
+      std::vector<float> interleaved(SAMPLES * channels);
+      CAEKernels::Interleave(interleaved.data(), src.data(), channels, SAMPLES);
+
+      // back to planar, the round trip must be lossless
+      std::vector<std::vector<float>> result(channels, std::vector<float>(SAMPLES));
+      std::vector<float*> dst;
+      for (auto& plane : result)
+        dst.push_back(plane.data());
+      CAEKernels::Deinterleave(dst.data(), interleaved.data(), channels, SAMPLES);
+      for (unsigned int c = 0; c < channels; c++)
+        EXPECT_TRUE(Equal(planes[c], result[c]));
+
+      return interleaved;
+    });
+  }
+}
+
+TEST(TestAEKernels, Remap)
+{
+  // reorder 5.1, drop channels, add silent channels and widen past 8 channels
+  const std::vector<std::vector<int>> maps = {
+    { 0, 1, 4, 5, 2, 3 },
+    { 1, 0 },
+    { 0, 1, -1, -1, 2, 3, -1, -1 },
+    { 7, 6, 5, 4, 3, 2, 1, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, -1, 0 },
+  };
+  const std::vector<unsigned int> srcChannels = { 6, 2, 4, 8, 8 };
+
+  for (size_t m = 0; m < maps.size(); m++)
+  {
+    const std::vector<int>& map = maps[m];
+    unsigned int channels = srcChannels[m];
+    std::vector<float> src = MakeSamples(SAMPLES * channels, 1.0f, m);
+    ExpectBitExact<std::vector<float>>([&]()
+    {
+      std::vector<float> dst(SAMPLES * map.size(), 2.0f);
+      CAEKernels::Remap(dst.data(), src.data(), map.data(), map.size(), channels, SAMPLES);
+      return dst;
+    });
+
+    std::vector<float> dst(SAMPLES * map.size());
+    CAEKernels::Remap(dst.data(), src.data(), map.data(), map.size(), channels, SAMPLES);
+    for (uint32_t i = 0; i < SAMPLES; i += 97)
+    {
+      for (size_t c = 0; c < map.size(); c++)
+        EXPECT_EQ(map[c] < 0 ? 0.0f : src[i * channels + map[c]], dst[i * map.size() + c]);
+    }
+  }
+}
+
+TEST(TestAEKernels, FloatToS16)
+{
+  ExpectBitExact<std::vector<int16_t>>([]()
+  {
+    std::vector<float> src = MakeSamples(SAMPLES, 1.2f, 5);
+    std::vector<int16_t> dst(SAMPLES * 2);
+    CAEKernels::FloatToS16(dst.data(), src.data(), SAMPLES, nullptr);
+
+    // dithered in two calls, the sequence continues
+    uint32_t seed = 42;
+    CAEKernels::FloatToS16(dst.data() + SAMPLES, src.data(), 13, &seed);
+    CAEKernels::FloatToS16(dst.data() + SAMPLES + 13, src.data() + 13, SAMPLES - 13, &seed);
+    EXPECT_EQ(42 + SAMPLES, seed);
+    return dst;
+  });
+
+  std::vector<float> src = { 0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.5f };
+  std::vector<int16_t> dst(src.size());
+  CAEKernels::FloatToS16(dst.data(), src.data(), src.size(), nullptr);
+  EXPECT_EQ(0, dst[0]);
+  EXPECT_EQ(32767, dst[1]);
+  EXPECT_EQ(-32768, dst[2]);
+  EXPECT_EQ(32767, dst[3]);
+  EXPECT_EQ(-32768, dst[4]);
+  EXPECT_EQ(16384, dst[5]);
+}
+
+TEST(TestAEKernels, FloatToS24)
+{
+  ExpectBitExact<std::vector<int32_t>>([]()
+  {
+    std::vector<float> src = MakeSamples(SAMPLES, 1.2f, 6);
+    std::vector<int32_t> dst(SAMPLES * 2);
+    CAEKernels::FloatToS24(dst.data(), src.data(), SAMPLES, nullptr);
+    uint32_t seed = 7;
+    CAEKernels::FloatToS24(dst.data() + SAMPLES, src.data(), SAMPLES, &seed);
+    return dst;
+  });
+
+  float src[2] = { 1.0f, -1.0f };
+  int32_t dst[2];
+  CAEKernels::FloatToS24(dst, src, 2, nullptr);
+  EXPECT_EQ(8388607, dst[0]);
+  EXPECT_EQ(-8388608, dst[1]);
+}
+
+TEST(TestAEKernels, FloatToS32)
+{
+  ExpectBitExact<std::vector<int32_t>>([]()
+  {
+    std::vector<float> src = MakeSamples(SAMPLES, 1.2f, 8);
+    std::vector<int32_t> dst(SAMPLES);
+    CAEKernels::FloatToS32(dst.data(), src.data(), SAMPLES);
+    return dst;
+  });
+
+  float src[2] = { 1.0f, -1.0f };
+  int32_t dst[2];
+  CAEKernels::FloatToS32(dst, src, 2);
+  EXPECT_EQ(2147483520, dst[0]);
+  EXPECT_EQ(INT32_MIN, dst[1]);
+}
+
+TEST(TestAEKernels, ToFloat)
+{
+  ExpectBitExact<std::vector<float>>([]()
+  {
+    std::vector<int16_t> s16(SAMPLES);
+    std::vector<int32_t> s32(SAMPLES);
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+      s16[i] = static_cast<int16_t>(i * 97);
+      s32[i] = static_cast<int32_t>(i * 4194301u);
+    }
+    std::vector<float> dst(SAMPLES * 2);
+    CAEKernels::S16ToFloat(dst.data(), s16.data(), SAMPLES);
+    CAEKernels::S32ToFloat(dst.data() + SAMPLES, s32.data(), SAMPLES);
+    return dst;
+  });
+}
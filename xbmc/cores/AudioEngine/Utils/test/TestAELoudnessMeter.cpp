@@ -0,0 +1,128 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AELoudnessMeter.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+std::vector<float> MakeSine(unsigned int channels, unsigned int sampleRate, double frequency,
+                            double amplitude, double phase, double seconds)
+{
+  unsigned int frames = static_cast<unsigned int>(sampleRate * seconds);
+  std::vector<float> data(frames * channels);
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    float value = static_cast<float>(amplitude * sin(2.0 * M_PI * frequency * i / sampleRate + phase));
+    for (unsigned int ch = 0; ch < channels; ch++)
+      data[i * channels + ch] = value;
+  }
+  return data;
+}
+}
+
+TEST(TestAELoudnessMeter, Sine)
+{
+  // EBU Tech 3341 case 1: 1kHz stereo sine at -23dBFS reads -23 LUFS
+  for (unsigned int sampleRate : {44100, 48000, 96000})
+  {
+    CAELoudnessMeter meter;
+    ASSERT_TRUE(meter.Init(CAEChannelInfo(AE_CH_LAYOUT_2_0), sampleRate));
+    std::vector<float> data = MakeSine(2, sampleRate, 1000.0, pow(10.0, -23.0 / 20.0), 0.0, 20.0);
+    // odd pieces so chunks and sub-blocks don't line up
+    for (size_t pos = 0; pos < data.size() / 2; pos += 777)
+      meter.AddFrames(data.data() + pos * 2, std::min<size_t>(777, data.size() / 2 - pos));
+
+    EXPECT_NEAR(-23.0, meter.GetIntegratedLoudness(), 0.1) << sampleRate;
+    EXPECT_NEAR(5.0, CAELoudnessMeter::GetReplayGain(meter.GetIntegratedLoudness()), 0.1);
+  }
+}
+
+TEST(TestAELoudnessMeter, Gating)
+{
+  // EBU Tech 3341 case 3: -36, -23 and -36dBFS for 10, 60 and 10 seconds
+  CAELoudnessMeter meter;
+  ASSERT_TRUE(meter.Init(CAEChannelInfo(AE_CH_LAYOUT_2_0), 48000));
+  for (double level : {-36.0, -23.0, -36.0})
+  {
+    std::vector<float> data = MakeSine(2, 48000, 1000.0, pow(10.0, level / 20.0), 0.0, level < -30.0 ? 10.0 : 60.0);
+    meter.AddFrames(data.data(), data.size() / 2);
+  }
+  EXPECT_NEAR(-23.0, meter.GetIntegratedLoudness(), 0.1);
+
+  // silence is gated away completely
+  CAELoudnessMeter silence;
+  ASSERT_TRUE(silence.Init(CAEChannelInfo(AE_CH_LAYOUT_2_0), 48000));
+  std::vector<float> zeros(48000 * 2 * 3);
+  silence.AddFrames(zeros.data(), 48000 * 3);
+  EXPECT_TRUE(std::isinf(silence.GetIntegratedLoudness()));
+  EXPECT_EQ(0.0, silence.GetTruePeak());
+
+  // an album is measured from the blocks of all of its tracks
+  std::vector<double> blocks = meter.GetBlocks();
+  blocks.insert(blocks.end(), silence.GetBlocks().begin(), silence.GetBlocks().end());
+  EXPECT_DOUBLE_EQ(meter.GetIntegratedLoudness(), CAELoudnessMeter::GetIntegratedLoudness(blocks));
+}
+
+TEST(TestAELoudnessMeter, TruePeak)
+{
+  // a sine at a quarter of the sample rate with 45 degrees of phase never
+  // hits its peak on a sample
+  CAELoudnessMeter meter;
+  ASSERT_TRUE(meter.Init(CAEChannelInfo(AE_CH_LAYOUT_2_0), 48000));
+  std::vector<float> data = MakeSine(2, 48000, 12000.0, 0.5, M_PI / 4, 1.0);
+  meter.AddFrames(data.data(), data.size() / 2);
+
+  float samplePeak = 0.0f;
+  for (float value : data)
+    samplePeak = std::max(samplePeak, std::fabs(value));
+  EXPECT_NEAR(0.354, samplePeak, 0.001);
+  EXPECT_NEAR(0.5, meter.GetTruePeak(), 0.02);
+}
+
+TEST(TestAELoudnessMeter, ChannelWeights)
+{
+  // the LFE does not count, surround channels count +1.5dB
+  CAEChannelInfo layout(AE_CH_LAYOUT_5_1);
+  CAELoudnessMeter meter;
+  ASSERT_TRUE(meter.Init(layout, 48000));
+
+  unsigned int channels = layout.Count();
+  std::vector<float> sine = MakeSine(1, 48000, 1000.0, pow(10.0, -23.0 / 20.0), 0.0, 5.0);
+  for (unsigned int i = 0; i < channels; i++)
+  {
+    meter.Reset();
+    std::vector<float> data(sine.size() * channels);
+    for (size_t n = 0; n < sine.size(); n++)
+      data[n * channels + i] = sine[n];
+    meter.AddFrames(data.data(), sine.size());
+
+    if (layout[i] == AE_CH_LFE)
+      EXPECT_TRUE(std::isinf(meter.GetIntegratedLoudness()));
+    else if (layout[i] == AE_CH_BL || layout[i] == AE_CH_BR || layout[i] == AE_CH_SL || layout[i] == AE_CH_SR)
+      EXPECT_NEAR(-24.51, meter.GetIntegratedLoudness(), 0.1);
+    else
+      EXPECT_NEAR(-26.0, meter.GetIntegratedLoudness(), 0.1);
+  }
+}
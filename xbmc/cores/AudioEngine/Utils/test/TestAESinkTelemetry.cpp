@@ -0,0 +1,126 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AESinkTelemetry.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// feed 10 ms writes in real time to a sink holding about 100 ms
+void FeedSession(CAESinkTelemetry &telemetry, unsigned int writes, int64_t jitter)
+{
+  int64_t now = 1000000;
+  for (unsigned int i = 0; i < writes; i++)
+  {
+    double delay = 0.1 + ((i & 1) ? jitter : -jitter) / 1000000.0;
+    telemetry.AddWrite(now, now + 100, delay, 0.01);
+    now += 10000;
+  }
+}
+}
+
+TEST(TestAESinkTelemetry, Timing)
+{
+  CAESinkTelemetry telemetry;
+  telemetry.StartSession("null", 0.2);
+
+  int64_t now = 1000000;
+  telemetry.AddWrite(now, now, 0.1, 0.01);
+  // back 5 ms late, the sink reports 2 ms less than predicted
+  now += 15000;
+  telemetry.AddWrite(now, now, 0.093, 0.01);
+
+  EXPECT_EQ(2U, telemetry.GetWrites());
+  EXPECT_EQ(1U, telemetry.GetWakeupLateness().GetCount());
+  EXPECT_EQ(5000, telemetry.GetWakeupLateness().GetMax());
+  EXPECT_EQ(1U, telemetry.GetDelayJitter().GetCount());
+  EXPECT_NEAR(2000, telemetry.GetDelayJitter().GetMax(), 1);
+
+  // after an interruption the next write is not late
+  telemetry.Interrupt();
+  telemetry.AddWrite(now + 1000000, now + 1000000, 0.1, 0.01);
+  EXPECT_EQ(1U, telemetry.GetWakeupLateness().GetCount());
+}
+
+TEST(TestAESinkTelemetry, Underruns)
+{
+  CAESinkTelemetry telemetry;
+  telemetry.StartSession("null", 0.2);
+
+  int64_t now = 1000000;
+  telemetry.AddWrite(now, now, 0.1, 0.01);
+  telemetry.AddUnderrun();
+  EXPECT_EQ(1U, telemetry.GetUnderruns());
+
+  // draining runs the device dry until it is fed again
+  telemetry.Interrupt();
+  telemetry.AddUnderrun();
+  EXPECT_EQ(1U, telemetry.GetUnderruns());
+
+  telemetry.AddWrite(now + 1000000, now + 1000000, 0.1, 0.01);
+  telemetry.AddUnderrun();
+  EXPECT_EQ(2U, telemetry.GetUnderruns());
+}
+
+TEST(TestAESinkTelemetry, Adaptive)
+{
+  CAESinkTelemetry telemetry;
+  telemetry.StartSession("null", 0.2);
+  telemetry.AddUnderrun();
+  telemetry.StartSession("null", 0.2);
+  // not adaptive, nothing changes
+  EXPECT_DOUBLE_EQ(1.0, telemetry.GetBufferScale("null"));
+
+  telemetry.SetAdaptive(true);
+  telemetry.AddUnderrun();
+  telemetry.EndSession();
+  EXPECT_DOUBLE_EQ(1.5, telemetry.GetBufferScale("null"));
+  EXPECT_DOUBLE_EQ(1.0, telemetry.GetBufferScale("file"));
+
+  for (int i = 0; i < 10; i++)
+  {
+    telemetry.StartSession("null", 0.2);
+    telemetry.AddUnderrun();
+  }
+  telemetry.EndSession();
+  EXPECT_DOUBLE_EQ(CAESinkTelemetry::MAX_SCALE, telemetry.GetBufferScale("null"));
+
+  // short sessions never shrink the buffer
+  telemetry.StartSession("null", 0.8);
+  FeedSession(telemetry, 100, 0);
+  telemetry.EndSession();
+  EXPECT_DOUBLE_EQ(CAESinkTelemetry::MAX_SCALE, telemetry.GetBufferScale("null"));
+
+  // long sessions with high jitter neither
+  telemetry.StartSession("null", 0.8);
+  FeedSession(telemetry, 2000, 60000);
+  telemetry.EndSession();
+  EXPECT_DOUBLE_EQ(CAESinkTelemetry::MAX_SCALE, telemetry.GetBufferScale("null"));
+
+  for (int i = 0; i < 10; i++)
+  {
+    telemetry.StartSession("null", 0.2);
+    FeedSession(telemetry, 2000, 0);
+  }
+  telemetry.EndSession();
+  EXPECT_DOUBLE_EQ(CAESinkTelemetry::MIN_SCALE, telemetry.GetBufferScale("null"));
+}
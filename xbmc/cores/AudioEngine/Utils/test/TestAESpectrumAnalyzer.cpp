@@ -0,0 +1,123 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AESpectrumAnalyzer.h"
+#include "threads/SystemClock.h"
+#include "utils/rfft.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::vector<float> MakeStereo(unsigned int frames)
+{
+  std::vector<float> data(frames * 2);
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    // different tones and some noise like content on both channels
+    data[2 * i] = static_cast<float>(0.5 * sin(2.0 * M_PI * 10 * i / frames) + 0.1 * cos(i * 1.3));
+    data[2 * i + 1] = static_cast<float>(0.25 * sin(2.0 * M_PI * 37 * i / frames) + 0.05 * sin(i * 0.7));
+  }
+  return data;
+}
+}
+
+TEST(TestAESpectrumAnalyzer, MatchesRFFT)
+{
+  const unsigned int size = CAESpectrumAnalyzer::FFT_SIZE;
+  std::vector<float> input = MakeStereo(size);
+
+  std::vector<float> expected(size);
+  RFFT transform(size, false);
+  transform.calc(input.data(), expected.data());
+
+  AESpectrum spectrum;
+  CAESpectrumAnalyzer analyzer;
+  analyzer.Analyze(input.data(), spectrum);
+
+  for (unsigned int i = 0; i < AESpectrum::BINS * 2; i++)
+    EXPECT_NEAR(expected[i], spectrum.magnitudes[i], 1e-4) << "bin " << i / 2 << " channel " << i % 2;
+
+  EXPECT_NEAR(0.5, spectrum.magnitudes[2 * 10], 0.02);
+  EXPECT_NEAR(0.25, spectrum.magnitudes[2 * 37 + 1], 0.02);
+}
+
+TEST(TestAESpectrumAnalyzer, Worker)
+{
+  const unsigned int size = CAESpectrumAnalyzer::FFT_SIZE;
+  std::vector<float> input = MakeStereo(size * 2);
+
+  CAESpectrumAnalyzer analyzer;
+  AESpectrum spectrum;
+  EXPECT_FALSE(analyzer.GetSpectrum(spectrum));
+
+  analyzer.Start();
+  // longer packets are cut to the transform size
+  uint64_t packet = analyzer.AddSamples(input.data(), size * 2, 44100);
+  ASSERT_NE(CAESpectrumAnalyzer::NO_PACKET, packet);
+
+  XbmcThreads::EndTime timeout(5000);
+  while (!analyzer.Publish(packet) && !timeout.IsTimePast())
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  analyzer.Stop();
+
+  EXPECT_EQ(1U, analyzer.GetSpectrumCount());
+  ASSERT_TRUE(analyzer.GetSpectrum(spectrum));
+  EXPECT_EQ(44100U, spectrum.sampleRate);
+
+  AESpectrum expected;
+  analyzer.Analyze(input.data(), expected);
+  for (unsigned int i = 0; i < AESpectrum::BINS * 2; i++)
+    EXPECT_FLOAT_EQ(expected.magnitudes[i], spectrum.magnitudes[i]);
+}
+
+TEST(TestAESpectrumAnalyzer, PublishSkipsOlderPackets)
+{
+  const unsigned int size = CAESpectrumAnalyzer::FFT_SIZE;
+  std::vector<float> first = MakeStereo(size);
+  std::vector<float> second(size * 2, 0.0f);
+
+  CAESpectrumAnalyzer analyzer;
+  analyzer.Start();
+  uint64_t firstPacket = analyzer.AddSamples(first.data(), size, 44100);
+  uint64_t secondPacket = analyzer.AddSamples(second.data(), size, 48000);
+
+  XbmcThreads::EndTime timeout(5000);
+  while (!analyzer.Publish(secondPacket) && !timeout.IsTimePast())
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  analyzer.Stop();
+
+  // the spectrum belongs to the published packet, not to the latest analyzed one
+  AESpectrum spectrum;
+  ASSERT_TRUE(analyzer.GetSpectrum(spectrum));
+  EXPECT_EQ(48000U, spectrum.sampleRate);
+  EXPECT_FLOAT_EQ(0.0f, spectrum.magnitudes[2 * 10]);
+
+  // skipped packets can't be published anymore
+  EXPECT_FALSE(analyzer.Publish(firstPacket));
+  EXPECT_FALSE(analyzer.Publish(secondPacket));
+  EXPECT_EQ(1U, analyzer.GetSpectrumCount());
+}
@@ -22,6 +22,8 @@
 
 #include <atomic>
 #include <string>
+#include "cores/VideoPlayer/Process/ChannelSwitchTiming.h"
+#include "cores/VideoPlayer/Process/FrameTiming.h"
 #include "threads/CriticalSection.h"
 
 class CDataCacheCore
@@ -113,6 +115,18 @@ public:
    */
   int64_t GetMaxTime();
 
+  /*!
+   * \brief Per stage latency statistics of the video pipeline
+   *
+   * Stamped lock-free by the video thread and the render thread.
+   */
+  CFrameTiming& GetFrameTiming() { return m_frameTiming; }
+
+  /*!
+   * \brief Latency breakdown of PVR channel switches
+   */
+  CChannelSwitchTiming& GetChannelSwitchTiming() { return m_channelSwitchTiming; }
+
 protected:
   std::atomic_bool m_hasAVInfoChanges;
 
@@ -163,4 +177,7 @@ protected:
     int64_t m_timeMax;
     int64_t m_timeMin;
   } m_timeInfo = {};
+
+  CFrameTiming m_frameTiming;
+  CChannelSwitchTiming m_channelSwitchTiming;
 };
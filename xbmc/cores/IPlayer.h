@@ -230,6 +230,12 @@ public:
   virtual void RenderCaptureRelease(unsigned int captureId) {};
   virtual void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags) {};
   virtual bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size) { return false; };
+  /*!
+   \brief Copy the newest captured frame without waiting for the renderer
+   \param frameId id of the frame the caller already has, updated to the id of the copied frame
+   \return true if a newer frame than frameId was copied
+   */
+  virtual bool RenderCaptureGetLatestPixels(unsigned int captureId, uint8_t *buffer, unsigned int size, unsigned int &frameId) { return false; };
 
   // video and audio settings
   virtual CVideoSettings GetVideoSettings() { return CVideoSettings(); };
@@ -53,6 +53,7 @@
 #include <deque>
 #include <list>
 #include <map>
+#include <queue>
 #include <vector>
 
 extern "C" {
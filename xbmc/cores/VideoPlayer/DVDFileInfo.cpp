@@ -44,6 +44,7 @@
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "Process/ProcessInfo.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderCaptureConvert.h"
 
 #include "libavcodec/avcodec.h"
 #include "libswscale/swscale.h"
@@ -55,6 +56,7 @@
 
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
 extern "C" {
 #include "libavformat/avformat.h"
@@ -264,23 +266,47 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
             unsigned int nHeight = (unsigned int)((double)g_advancedSettings.m_imageRes / aspect);
 
             uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
+            uint8_t *planes[YuvImage::MAX_PLANES];
+            int stride[YuvImage::MAX_PLANES];
+            picture.videoBuffer->GetPlanes(planes);
+            picture.videoBuffer->GetStrides(stride);
+            int orientation = DegreeToOrientation(hint.orientation);
+            bool converted = false;
+
+            // same size or power of two downscale can skip swscale
+            if (nWidth == picture.iWidth && nHeight == picture.iHeight)
+            {
+              CRenderCaptureConvert::YUV420ToBGRA(planes[0], planes[1], planes[2], stride[0], stride[1], stride[2],
+                                                  nWidth, nHeight, pOutBuf, nWidth * 4);
+              converted = true;
+            }
+            else if (CRenderCaptureConvert::CanBoxDownscale(picture.iWidth, picture.iHeight, nWidth, nHeight))
             {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
+              std::vector<uint8_t> frame(picture.iWidth * picture.iHeight * 4);
+              CRenderCaptureConvert::YUV420ToBGRA(planes[0], planes[1], planes[2], stride[0], stride[1], stride[2],
+                                                  picture.iWidth, picture.iHeight, frame.data(), picture.iWidth * 4);
+              converted = CRenderCaptureConvert::BoxDownscale(frame.data(), picture.iWidth, picture.iHeight, picture.iWidth * 4,
+                                                              pOutBuf, nWidth, nHeight, nWidth * 4);
+            }
+            else
+            {
+              struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
+                    AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+
+              if (context)
+              {
+                uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+                int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+                uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+                int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+                sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+                sws_freeContext(context);
+                converted = true;
+              }
+            }
 
+            if (converted)
+            {
               details.width = nWidth;
               details.height = nHeight;
               CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
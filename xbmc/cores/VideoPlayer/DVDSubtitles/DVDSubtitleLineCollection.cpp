@@ -19,16 +19,13 @@
  */
 
 #include "DVDSubtitleLineCollection.h"
-#include <stddef.h>
 
+#include <algorithm>
 
 CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
-
-  m_iSize = 0;
+  m_current = 0;
+  m_sorted = true;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +35,86 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
+  // most files are in order already, keep the index up to date while they are
+  if (m_sorted && !m_overlays.empty() && pOverlay->iPTSStartTime < m_overlays.back()->iPTSStartTime)
+    m_sorted = false;
 
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
+  m_overlays.push_back(pOverlay);
+
+  if (m_sorted)
   {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
+    double maxStopTime = pOverlay->iPTSStopTime;
+    if (!m_maxStopTime.empty())
+      maxStopTime = std::max(maxStopTime, m_maxStopTime.back());
+    m_maxStopTime.push_back(maxStopTime);
   }
-
-  m_iSize++;
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
+  if (m_sorted)
     return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext != NULL; p1 = p1->pNext)
+
+  std::stable_sort(m_overlays.begin(), m_overlays.end(), [](const CDVDOverlay* a, const CDVDOverlay* b)
   {
-    for (ListElement* p2 = p1->pNext; p2 != NULL; p2 = p2->pNext)
-    {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
-    }
+    return a->iPTSStartTime < b->iPTSStartTime;
+  });
+
+  m_maxStopTime.clear();
+  m_maxStopTime.reserve(m_overlays.size());
+  double maxStopTime = 0.0;
+  for (size_t i = 0; i < m_overlays.size(); i++)
+  {
+    if (i == 0 || m_overlays[i]->iPTSStopTime > maxStopTime)
+      maxStopTime = m_overlays[i]->iPTSStopTime;
+    m_maxStopTime.push_back(maxStopTime);
   }
+
+  m_current = 0;
+  m_sorted = true;
 }
 
-CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
+size_t CDVDSubtitleLineCollection::FindFirstActive(double iPts) const
 {
-  CDVDOverlay* pOverlay = NULL;
+  // nothing before the first index whose running maximum reaches pts can
+  // still be shown, and the overlay at that index is the first one that can
+  return std::lower_bound(m_maxStopTime.begin(), m_maxStopTime.end(), iPts) - m_maxStopTime.begin();
+}
 
-  if (m_pCurrent)
-  {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
-
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
-
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
-  }
+CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts, double iLookAhead)
+{
+  Sort();
+
+  m_current = std::max(m_current, FindFirstActive(iPts));
+
+  // overlays that ended while a longer one is still shown
+  while (m_current < m_overlays.size() && m_overlays[m_current]->iPTSStopTime < iPts)
+    m_current++;
+
+  if (m_current >= m_overlays.size())
+    return NULL;
+
+  CDVDOverlay* pOverlay = m_overlays[m_current];
+  if (pOverlay->iPTSStartTime > iPts + iLookAhead)
+    return NULL;
+
+  // advance to the next overlay
+  m_current++;
   return pOverlay;
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
+  for (auto& overlay : m_overlays)
+    overlay->Release();
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_overlays.clear();
+  m_maxStopTime.clear();
+  m_current = 0;
+  m_sorted = true;
 }
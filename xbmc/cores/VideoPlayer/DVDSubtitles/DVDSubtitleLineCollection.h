@@ -22,39 +22,43 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <stddef.h>
+#include <vector>
 
+/*!
+ * \brief Overlays of a subtitle file, indexed by time
+ *
+ * Overlays are kept sorted by start time together with the running maximum of
+ * their stop times. The running maximum only grows, so the first overlay that
+ * has not ended at a given pts is found with a binary search instead of a
+ * linear walk through the file.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
   void Sort();
 
-  CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
+  /*!
+   * \brief Get the next overlay that has not ended at iPts and starts before
+   * iPts + iLookAhead, NULL if there is none. Every overlay is returned once
+   * until the next Reset().
+   */
+  CDVDOverlay* Get(double iPts, double iLookAhead);
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return m_overlays.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  size_t FindFirstActive(double iPts) const;
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
+  std::vector<CDVDOverlay*> m_overlays;
+  std::vector<double> m_maxStopTime;
+  size_t m_current;
+  bool m_sorted;
 };
-
@@ -21,6 +21,7 @@
  */
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "DVDSubtitleStream.h"
 #include "DVDSubtitleLineCollection.h"
 
@@ -37,7 +38,11 @@ public:
   virtual bool Open(CDVDStreamInfo &hints) = 0;
   virtual void Dispose() = 0;
   virtual void Reset() = 0;
-  virtual CDVDOverlay* Parse(double iPts) = 0;
+  /*!
+   * \brief Get the next overlay that is shown at iPts or starts before
+   * iPts + iLookAhead, NULL if there is none
+   */
+  virtual CDVDOverlay* Parse(double iPts, double iLookAhead) = 0;
 };
 
 class CDVDSubtitleParserCollection
@@ -46,9 +51,11 @@ class CDVDSubtitleParserCollection
 public:
   explicit CDVDSubtitleParserCollection(const std::string& strFile) : m_filename(strFile) {}
   ~CDVDSubtitleParserCollection() override = default;
-  CDVDOverlay* Parse(double iPts) override
+  CDVDOverlay* Parse(double iPts, double iLookAhead) override
   {
-    CDVDOverlay* o = m_collection.Get(iPts);
+    // hand out overlays a little before they are due, the container then
+    // only holds what is about to be shown instead of the whole file
+    CDVDOverlay* o = m_collection.Get(iPts, iLookAhead);
     if(o == NULL)
       return o;
     return o->Clone();
@@ -30,6 +30,9 @@
 #include "threads/SingleLock.h"
 #include "guilib/GraphicContext.h"
 
+#include <algorithm>
+#include <cstring>
+
 static void libass_log(int level, const char *fmt, va_list args, void *data)
 {
   if(level >= 5)
@@ -118,6 +121,8 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   m_dll.ass_process_codec_private(m_track, data, size);
+  m_boundariesValid = false;
+  m_imageValid = false;
   return true;
 }
 
@@ -130,7 +135,17 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, dou
     return false;
   }
 
+  int numEvents = m_track->n_events;
   m_dll.ass_process_chunk(m_track, data, size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+
+  // packets add one event at a time, insert its times instead of rebuilding
+  // the boundaries of all events on the next render
+  if (m_boundariesValid)
+  {
+    for (int i = numEvents; i < m_track->n_events; i++)
+      InsertBoundaries(m_track->events[i]);
+  }
+  m_imageValid = false;
   return true;
 }
 
@@ -146,6 +161,8 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
   CLog::Log(LOGINFO, "SSA Parser: Creating m_track from SSA buffer");
 
   m_track = m_dll.ass_read_memory(m_library, buf, size, 0);
+  m_boundariesValid = false;
+  m_imageValid = false;
   if(m_track == NULL)
     return false;
 
@@ -161,6 +178,26 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int
     return NULL;
   }
 
+  float pixelRatio = g_graphicsContext.GetResInfo().fPixelRatio;
+
+  if (!m_boundariesValid)
+    UpdateBoundaries();
+
+  long long now = DVD_TIME_TO_MSEC(pts);
+  size_t segment = std::upper_bound(m_boundaries.begin(), m_boundaries.end(), now) - m_boundaries.begin();
+
+  // nothing that affects the output changed since the last render
+  if (m_imageValid &&
+      segment == m_imageSegment && !m_animated[segment] &&
+      frameWidth == m_frameWidth && frameHeight == m_frameHeight &&
+      videoWidth == m_videoWidth && videoHeight == m_videoHeight &&
+      useMargin == m_useMargin && position == m_position && pixelRatio == m_pixelRatio)
+  {
+    if (changes)
+      *changes = 0;
+    return m_image;
+  }
+
   double storage_aspect = (double)frameWidth / frameHeight;
   m_dll.ass_set_frame_size(m_renderer, frameWidth, frameHeight);
   int topmargin = (frameHeight - videoHeight) / 2;
@@ -168,8 +205,102 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int
   m_dll.ass_set_margins(m_renderer, topmargin, topmargin, leftmargin, leftmargin);
   m_dll.ass_set_use_margins(m_renderer, useMargin);
   m_dll.ass_set_line_position(m_renderer, position);
-  m_dll.ass_set_aspect_ratio(m_renderer, storage_aspect / g_graphicsContext.GetResInfo().fPixelRatio, storage_aspect);
-  return m_dll.ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
+  m_dll.ass_set_aspect_ratio(m_renderer, storage_aspect / pixelRatio, storage_aspect);
+  m_image = m_dll.ass_render_frame(m_renderer, m_track, now, changes);
+
+  m_imageValid = true;
+  m_imageSegment = segment;
+  m_frameWidth = frameWidth;
+  m_frameHeight = frameHeight;
+  m_videoWidth = videoWidth;
+  m_videoHeight = videoHeight;
+  m_useMargin = useMargin;
+  m_position = position;
+  m_pixelRatio = pixelRatio;
+  return m_image;
+}
+
+bool CDVDSubtitlesLibass::IsAnimated(const ASS_Event& event)
+{
+  // scrolling and banner effects move the text continuously
+  if (event.Effect && event.Effect[0])
+    return true;
+
+  const char* text = event.Text;
+  if (!text)
+    return false;
+
+  return strstr(text, "\\k") || strstr(text, "\\K") ||
+         strstr(text, "\\fad") || strstr(text, "\\move") || strstr(text, "\\t(");
+}
+
+void CDVDSubtitlesLibass::UpdateBoundaries()
+{
+  m_boundaries.clear();
+  m_animated.clear();
+
+  int numEvents = m_track->n_events;
+  m_boundaries.reserve(numEvents * 2);
+  for (int i = 0; i < numEvents; i++)
+  {
+    const ASS_Event& event = m_track->events[i];
+    m_boundaries.push_back(event.Start);
+    m_boundaries.push_back(event.Start + event.Duration);
+  }
+  std::sort(m_boundaries.begin(), m_boundaries.end());
+  m_boundaries.erase(std::unique(m_boundaries.begin(), m_boundaries.end()), m_boundaries.end());
+
+  // segment i lies between boundary i - 1 and boundary i, count the animated
+  // events covering each one with a difference array
+  std::vector<int> animated(m_boundaries.size() + 2, 0);
+  for (int i = 0; i < numEvents; i++)
+  {
+    const ASS_Event& event = m_track->events[i];
+    if (event.Duration <= 0 || !IsAnimated(event))
+      continue;
+
+    size_t first = std::upper_bound(m_boundaries.begin(), m_boundaries.end(), event.Start) - m_boundaries.begin();
+    size_t last = std::upper_bound(m_boundaries.begin(), m_boundaries.end(), event.Start + event.Duration) - m_boundaries.begin();
+    animated[first]++;
+    animated[last]--;
+  }
+
+  m_animated.resize(m_boundaries.size() + 1);
+  int count = 0;
+  for (size_t i = 0; i < m_animated.size(); i++)
+  {
+    count += animated[i];
+    m_animated[i] = count > 0;
+  }
+
+  m_boundariesValid = true;
+}
+
+void CDVDSubtitlesLibass::InsertBoundary(long long time)
+{
+  auto it = std::lower_bound(m_boundaries.begin(), m_boundaries.end(), time);
+  if (it != m_boundaries.end() && *it == time)
+    return;
+
+  // the new boundary splits segment index in two, both keep its state
+  size_t index = it - m_boundaries.begin();
+  bool animated = m_animated[index];
+  m_boundaries.insert(it, time);
+  m_animated.insert(m_animated.begin() + index, animated);
+}
+
+void CDVDSubtitlesLibass::InsertBoundaries(const ASS_Event& event)
+{
+  InsertBoundary(event.Start);
+  InsertBoundary(event.Start + event.Duration);
+
+  if (event.Duration <= 0 || !IsAnimated(event))
+    return;
+
+  size_t first = std::upper_bound(m_boundaries.begin(), m_boundaries.end(), event.Start) - m_boundaries.begin();
+  size_t last = std::upper_bound(m_boundaries.begin(), m_boundaries.end(), event.Start + event.Duration) - m_boundaries.begin();
+  for (size_t i = first; i < last; i++)
+    m_animated[i] = true;
 }
 
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
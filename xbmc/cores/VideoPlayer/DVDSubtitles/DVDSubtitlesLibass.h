@@ -24,6 +24,8 @@
 #include "DVDResource.h"
 #include "threads/CriticalSection.h"
 
+#include <vector>
+
 /** Wrapper for Libass **/
 
 class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>
@@ -42,11 +44,44 @@ public:
   bool CreateTrack(char* buf, size_t size);
 
 private:
+  /*!
+   * \brief Rebuild the sorted start and end times of all events
+   *
+   * The set of active events only changes at these boundaries, a rendered
+   * image stays valid until pts crosses the next one. Segments with animated
+   * events (karaoke, fades, moves, transforms) change on every frame and are
+   * always rendered.
+   */
+  void UpdateBoundaries();
+
+  /*!
+   * \brief Add the start and end time of a new event to valid boundaries
+   */
+  void InsertBoundaries(const ASS_Event& event);
+  void InsertBoundary(long long time);
+  static bool IsAnimated(const ASS_Event& event);
+
   DllLibass m_dll;
   long m_references;
   ASS_Library* m_library;
   ASS_Track* m_track;
   ASS_Renderer* m_renderer;
   CCriticalSection m_section;
+
+  std::vector<long long> m_boundaries;
+  std::vector<bool> m_animated;
+  bool m_boundariesValid = false;
+
+  // result and parameters of the last render
+  ASS_Image* m_image = nullptr;
+  bool m_imageValid = false;
+  size_t m_imageSegment = 0;
+  int m_frameWidth = 0;
+  int m_frameHeight = 0;
+  int m_videoWidth = 0;
+  int m_videoHeight = 0;
+  int m_useMargin = 0;
+  double m_position = 0.0;
+  float m_pixelRatio = 0.0f;
 };
 
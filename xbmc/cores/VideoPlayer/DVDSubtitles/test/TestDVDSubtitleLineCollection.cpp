@@ -0,0 +1,89 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleLineCollection.h"
+
+#include "gtest/gtest.h"
+
+static CDVDOverlay* CreateOverlay(double start, double stop)
+{
+  CDVDOverlay* overlay = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+  overlay->iPTSStartTime = start;
+  overlay->iPTSStopTime = stop;
+  return overlay;
+}
+
+TEST(TestDVDSubtitleLineCollection, Sort)
+{
+  CDVDSubtitleLineCollection collection;
+  collection.Add(CreateOverlay(300, 400));
+  collection.Add(CreateOverlay(100, 200));
+  collection.Add(CreateOverlay(200, 300));
+  EXPECT_EQ(3, collection.GetSize());
+
+  // unsorted collections are sorted on first use
+  CDVDOverlay* overlay = collection.Get(0, 1000);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(100, overlay->iPTSStartTime);
+  EXPECT_EQ(200, collection.Get(0, 1000)->iPTSStartTime);
+  EXPECT_EQ(300, collection.Get(0, 1000)->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(0, 1000));
+}
+
+TEST(TestDVDSubtitleLineCollection, LookAhead)
+{
+  CDVDSubtitleLineCollection collection;
+  for (int i = 0; i < 100; i++)
+    collection.Add(CreateOverlay(i * 100, i * 100 + 50));
+
+  // ended overlays are skipped, upcoming ones wait for the window
+  CDVDOverlay* overlay = collection.Get(1020, 100);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(1000, overlay->iPTSStartTime);
+  EXPECT_EQ(1100, collection.Get(1020, 100)->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(1020, 100));
+  EXPECT_EQ(1200, collection.Get(1150, 100)->iPTSStartTime);
+
+  // seek forward
+  EXPECT_EQ(5000, collection.Get(5000, 0)->iPTSStartTime);
+
+  // seek back
+  collection.Reset();
+  EXPECT_EQ(0, collection.Get(0, 0)->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(0, 0));
+}
+
+TEST(TestDVDSubtitleLineCollection, Overlapping)
+{
+  CDVDSubtitleLineCollection collection;
+  collection.Add(CreateOverlay(0, 10000));
+  collection.Add(CreateOverlay(100, 200));
+  collection.Add(CreateOverlay(300, 400));
+  collection.Add(CreateOverlay(500, 600));
+
+  // the long overlay is still shown, the short ones in between have ended
+  EXPECT_EQ(0, collection.Get(550, 0)->iPTSStartTime);
+  EXPECT_EQ(500, collection.Get(550, 0)->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(550, 0));
+
+  collection.Clear();
+  EXPECT_EQ(0, collection.GetSize());
+  EXPECT_EQ(nullptr, collection.Get(0, 1000));
+}
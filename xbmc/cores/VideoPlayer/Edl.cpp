@@ -29,6 +29,9 @@
 #include "pvr/recordings/PVRRecordings.h"
 #include "pvr/PVRManager.h"
 #include "ServiceBroker.h"
+#include "utils/JobManager.h"
+
+#include <algorithm>
 
 #define COMSKIP_HEADER "FILE PROCESSING COMPLETE"
 #define VIDEOREDO_HEADER "<Version>2"
@@ -46,6 +49,8 @@ void CEdl::Clear()
 {
   m_vecCuts.clear();
   m_vecSceneMarkers.clear();
+  m_vecCutTimes.assign(1, 0);
+  m_vecPlayStarts.clear();
   m_iTotalCutTime = 0;
   m_lastCutTime = 0;
 }
@@ -133,7 +138,9 @@ bool CEdl::ReadEditDecisionLists(const std::string& strMovie, const float fFrame
   }
 
   if (bFound)
-    MergeShortCommBreaks();
+    MergeShortCommBreaks(); // also updates the cut times
+  else
+    UpdateCutTimes();
 
   return bFound;
 }
@@ -661,15 +668,18 @@ bool CEdl::AddCut(Cut& cut)
     return false;
   }
 
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
+  /*
+   * Cuts don't overlap, so if any existing cut is surrounded it is the first one starting after the
+   * new cut.
+   */
+  std::vector<Cut>::iterator pNextCut = std::upper_bound(m_vecCuts.begin(), m_vecCuts.end(), cut.start,
+                                                         [](int start, const Cut& c) { return start < c.start; });
+  if (pNextCut != m_vecCuts.end() && cut.end > pNextCut->end)
   {
-    if (cut.start < m_vecCuts[i].start && cut.end > m_vecCuts[i].end)
-    {
-      CLog::Log(LOGERROR, "%s - Cut surrounds an existing cut! [%s - %s], %d", __FUNCTION__,
-                MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
-                cut.action);
-      return false;
-    }
+    CLog::Log(LOGERROR, "%s - Cut surrounds an existing cut! [%s - %s], %d", __FUNCTION__,
+              MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
+              cut.action);
+    return false;
   }
 
   if (cut.action == COMM_BREAK)
@@ -700,23 +710,17 @@ bool CEdl::AddCut(Cut& cut)
   }
   else
   {
-    std::vector<Cut>::iterator pCurrentCut;
-    for (pCurrentCut = m_vecCuts.begin(); pCurrentCut != m_vecCuts.end(); ++pCurrentCut)
-    {
-      if (cut.start < pCurrentCut->start)
-      {
-        CLog::Log(LOGDEBUG, "%s - Inserting new cut [%s - %s], %d", __FUNCTION__,
-                  MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
-                  cut.action);
-        m_vecCuts.insert(pCurrentCut, cut);
-        break;
-      }
-    }
+    CLog::Log(LOGDEBUG, "%s - Inserting new cut [%s - %s], %d", __FUNCTION__,
+              MillisecondsToTimeString(cut.start).c_str(), MillisecondsToTimeString(cut.end).c_str(),
+              cut.action);
+    m_vecCuts.insert(std::upper_bound(m_vecCuts.begin(), m_vecCuts.end(), cut.start,
+                                      [](int start, const Cut& c) { return start < c.start; }), cut);
   }
 
-  if (cut.action == CUT)
-    m_iTotalCutTime += cut.end - cut.start;
-
+  /*
+   * The cut times are only used after the whole list is read and are built once by
+   * ReadEditDecisionLists(), so don't rebuild them for every cut added.
+   */
   return true;
 }
 
@@ -729,11 +733,36 @@ bool CEdl::AddSceneMarker(const int iSceneMarker)
 
   CLog::Log(LOGDEBUG, "%s - Inserting new scene marker: %s", __FUNCTION__,
             MillisecondsToTimeString(iSceneMarker).c_str());
-  m_vecSceneMarkers.push_back(iSceneMarker); // Unsorted
+  m_vecSceneMarkers.insert(std::upper_bound(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end(), iSceneMarker),
+                           iSceneMarker);
 
   return true;
 }
 
+void CEdl::UpdateCutTimes()
+{
+  m_vecCutTimes.resize(m_vecCuts.size() + 1);
+  m_vecPlayStarts.resize(m_vecCuts.size());
+
+  m_vecCutTimes[0] = 0;
+  for (size_t i = 0; i < m_vecCuts.size(); i++)
+  {
+    m_vecPlayStarts[i] = m_vecCuts[i].start - m_vecCutTimes[i];
+    m_vecCutTimes[i + 1] = m_vecCutTimes[i];
+    if (m_vecCuts[i].action == CUT)
+      m_vecCutTimes[i + 1] += m_vecCuts[i].end - m_vecCuts[i].start;
+  }
+
+  m_iTotalCutTime = m_vecCutTimes.back();
+}
+
+int CEdl::FindCut(const int iSeek) const
+{
+  std::vector<Cut>::const_iterator pCut = std::upper_bound(m_vecCuts.begin(), m_vecCuts.end(), iSeek,
+                                                           [](int seek, const Cut& cut) { return seek < cut.start; });
+  return static_cast<int>(pCut - m_vecCuts.begin()) - 1;
+}
+
 bool CEdl::HasCut() const
 {
   return !m_vecCuts.empty();
@@ -749,21 +778,18 @@ int CEdl::RemoveCutTime(int iSeek) const
   if (!HasCut())
     return iSeek;
 
-  /**
-   * @todo Consider an optimization of using the (now unused) total cut time if the seek time
-   * requested is later than the end of the last recorded cut. For example, when calculating the
-   * total duration for display.
-   */
-  int iCutTime = 0;
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
+  int i = FindCut(iSeek);
+  if (i < 0)
+    return iSeek;
+
+  // all cuts before the last one starting at or before iSeek have been passed over
+  int iCutTime = m_vecCutTimes[i];
+  if (m_vecCuts[i].action == CUT)
   {
-    if (m_vecCuts[i].action == CUT)
-    {
-      if (iSeek >= m_vecCuts[i].start && iSeek <= m_vecCuts[i].end) // Inside cut
-        iCutTime += iSeek - m_vecCuts[i].start - 1; // Decrease cut length by 1ms to jump over end boundary.
-      else if (iSeek >= m_vecCuts[i].start) // Cut has already been passed over.
-        iCutTime += m_vecCuts[i].end - m_vecCuts[i].start;
-    }
+    if (iSeek <= m_vecCuts[i].end) // Inside cut
+      iCutTime += iSeek - m_vecCuts[i].start - 1; // Decrease cut length by 1ms to jump over end boundary.
+    else
+      iCutTime += m_vecCuts[i].end - m_vecCuts[i].start;
   }
   return iSeek - iCutTime;
 }
@@ -773,14 +799,12 @@ double CEdl::RestoreCutTime(double dClock) const
   if (!HasCut())
     return dClock;
 
-  double dSeek = dClock;
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
-  {
-    if (m_vecCuts[i].action == CUT && dSeek >= m_vecCuts[i].start)
-      dSeek += static_cast<double>(m_vecCuts[i].end - m_vecCuts[i].start);
-  }
-
-  return dSeek;
+  /*
+   * Every cut starting at or before the clock once the time of the preceding cuts is restored has
+   * been passed over. The start of the cuts on the clock only grows, so that is a binary search.
+   */
+  size_t i = std::upper_bound(m_vecPlayStarts.begin(), m_vecPlayStarts.end(), dClock) - m_vecPlayStarts.begin();
+  return dClock + m_vecCutTimes[i];
 }
 
 bool CEdl::HasSceneMarker() const
@@ -824,17 +848,13 @@ std::string CEdl::GetInfo() const
 
 bool CEdl::InCut(const int iSeek, Cut *pCut)
 {
-  for (int i = 0; i < (int)m_vecCuts.size(); i++)
+  // cuts don't overlap, only the last one starting at or before iSeek can contain it
+  int i = FindCut(iSeek);
+  if (i >= 0 && iSeek <= m_vecCuts[i].end) // Inside cut.
   {
-    if (iSeek < m_vecCuts[i].start) // Early exit if not even up to the cut start time.
-      return false;
-
-    if (iSeek >= m_vecCuts[i].start && iSeek <= m_vecCuts[i].end) // Inside cut.
-    {
-      if (pCut)
-        *pCut = m_vecCuts[i];
-      return true;
-    }
+    if (pCut)
+      *pCut = m_vecCuts[i];
+    return true;
   }
 
   return false;
@@ -852,44 +872,34 @@ void CEdl::SetLastCutTime(const int iCutTime)
 
 bool CEdl::GetNearestCut(bool bPlus, const int iSeek, Cut *pCut) const
 {
-  if (bPlus) 
+  // first cut that iSeek is inside of or before, cuts don't overlap so the ends are sorted too
+  std::vector<Cut>::const_iterator pNext = std::lower_bound(m_vecCuts.begin(), m_vecCuts.end(), iSeek,
+                                                            [](const Cut& cut, int seek) { return cut.end < seek; });
+  if (bPlus)
   {
     // Searching forwards
-    for (auto &cut : m_vecCuts)
-    {
-      if (iSeek >= cut.start && iSeek <= cut.end) // Inside cut.
-      {
-        if (pCut)
-          *pCut = cut;
-        return true;
-      }
-      else if (iSeek < cut.start) // before this cut
-      {
-        if (pCut)
-          *pCut = cut;
-        return true;
-      }
-    }
-    return false;
-  } 
+    if (pNext == m_vecCuts.end())
+      return false;
+
+    if (pCut)
+      *pCut = *pNext;
+    return true;
+  }
   else
   {
     // Searching backwards
-    for (int i = (int)m_vecCuts.size() - 1; i >= 0; i--)
+    if (pNext != m_vecCuts.end() && iSeek - 20000 >= pNext->start)
     {
-      if (iSeek - 20000 >= m_vecCuts[i].start && iSeek <= m_vecCuts[i].end) 
-        // Inside cut. We ignore if we're closer to 20 seconds inside
-      {
-        if (pCut)
-          *pCut = m_vecCuts[i];
-        return true;
-      }
-      else if (iSeek > m_vecCuts[i].end) // after this cut
-      {
-        if (pCut)
-          *pCut = m_vecCuts[i];
-        return true;
-      }
+      // Inside cut. We ignore if we're closer to 20 seconds inside
+      if (pCut)
+        *pCut = *pNext;
+      return true;
+    }
+    else if (pNext != m_vecCuts.begin()) // after this cut
+    {
+      if (pCut)
+        *pCut = *(pNext - 1);
+      return true;
     }
     return false;
   }
@@ -907,26 +917,20 @@ bool CEdl::GetNextSceneMarker(bool bPlus, const int iClock, int *iSceneMarker)
 
   if (bPlus) // Find closest scene forwards
   {
-    for (int i = 0; i < (int)m_vecSceneMarkers.size(); i++)
+    std::vector<int>::const_iterator it = std::upper_bound(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end(), iSeek);
+    if (it != m_vecSceneMarkers.end() && *it - iSeek < iDiff)
     {
-      if ((m_vecSceneMarkers[i] > iSeek) && ((m_vecSceneMarkers[i] - iSeek) < iDiff))
-      {
-        iDiff = m_vecSceneMarkers[i] - iSeek;
-        *iSceneMarker = m_vecSceneMarkers[i];
-        bFound = true;
-      }
+      *iSceneMarker = *it;
+      bFound = true;
     }
   }
   else // Find closest scene backwards
   {
-    for (int i = 0; i < (int)m_vecSceneMarkers.size(); i++)
+    std::vector<int>::const_iterator it = std::lower_bound(m_vecSceneMarkers.begin(), m_vecSceneMarkers.end(), iSeek);
+    if (it != m_vecSceneMarkers.begin() && iSeek - *(it - 1) < iDiff)
     {
-      if ((m_vecSceneMarkers[i] < iSeek) && ((iSeek - m_vecSceneMarkers[i]) < iDiff))
-      {
-        iDiff = iSeek - m_vecSceneMarkers[i];
-        *iSceneMarker = m_vecSceneMarkers[i];
-        bFound = true;
-      }
+      *iSceneMarker = *(it - 1);
+      bFound = true;
     }
   }
 
@@ -1027,6 +1031,8 @@ void CEdl::MergeShortCommBreaks()
     }
   }
 
+  UpdateCutTimes();
+
   /*
    * Add in scene markers at the start and end of the commercial breaks.
    */
@@ -1041,3 +1047,24 @@ void CEdl::MergeShortCommBreaks()
   }
   return;
 }
+
+std::shared_ptr<CEdlImport> CEdlImport::Start(const std::string& strMovie, const float fFramesPerSecond, const int iHeight)
+{
+  std::shared_ptr<CEdlImport> import(new CEdlImport());
+  CJobManager::GetInstance().Submit([import, strMovie, fFramesPerSecond, iHeight]()
+  {
+    import->m_edl.ReadEditDecisionLists(strMovie, fFramesPerSecond, iHeight);
+    import->m_done.Set();
+  }, CJob::PRIORITY_HIGH);
+  return import;
+}
+
+bool CEdlImport::Wait(unsigned int milliSeconds)
+{
+  return m_done.WaitMSec(milliSeconds);
+}
+
+bool CEdlImport::Wait()
+{
+  return m_done.Wait();
+}
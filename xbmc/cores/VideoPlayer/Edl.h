@@ -20,6 +20,9 @@
  *
  */
 
+#include "threads/Event.h"
+
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -65,8 +68,10 @@ public:
 
 private:
   int m_iTotalCutTime; // ms
-  std::vector<Cut> m_vecCuts;
-  std::vector<int> m_vecSceneMarkers;
+  std::vector<Cut> m_vecCuts; // sorted by start, never overlapping
+  std::vector<int> m_vecSceneMarkers; // sorted
+  std::vector<int> m_vecCutTimes; // ms of CUT before each cut, and in total as the last element
+  std::vector<int> m_vecPlayStarts; // start of each cut with the preceding CUT time removed
   int m_lastCutTime;
 
   bool ReadEdl(const std::string& strMovie, const float fFramesPerSecond);
@@ -77,6 +82,36 @@ private:
 
   bool AddCut(Cut& NewCut);
   bool AddSceneMarker(const int sceneMarker);
+  void UpdateCutTimes();
+  //! index of the last cut starting at or before iSeek, -1 if there is none
+  int FindCut(const int iSeek) const;
 
   void MergeShortCommBreaks();
 };
+
+/*!
+ * \brief Reads the edit decision lists of a movie on a background job
+ *
+ * Comskip, VDR and PVR backend markers may come from slow network shares or
+ * backends, playback starts while they are read and the player picks up the
+ * result once the import is done.
+ */
+class CEdlImport
+{
+public:
+  static std::shared_ptr<CEdlImport> Start(const std::string& strMovie, const float fFramesPerSecond, const int iHeight);
+
+  /*!
+   * \brief Wait for the import to finish
+   * \return true if the import is done and GetEdl() may be used
+   */
+  bool Wait(unsigned int milliSeconds);
+  bool Wait();
+  CEdl& GetEdl() { return m_edl; }
+
+private:
+  CEdlImport() = default;
+
+  CEdl m_edl;
+  CEvent m_done{true};
+};
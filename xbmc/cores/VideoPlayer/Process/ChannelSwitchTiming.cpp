@@ -0,0 +1,169 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ChannelSwitchTiming.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+CChannelSwitchTiming::CChannelSwitchTiming()
+{
+  Reset();
+}
+
+void CChannelSwitchTiming::Reset()
+{
+  m_pending = false;
+  for (auto& time : m_times)
+    time = 0;
+  m_switches = 0;
+
+  for (auto& stage : m_stages)
+    stage.Reset();
+  m_total.Reset();
+
+  CSingleLock lock(m_channelSection);
+  m_channel.clear();
+}
+
+const char* CChannelSwitchTiming::GetStageName(ESWITCHSTAGE stage)
+{
+  switch (stage)
+  {
+    case SWITCHSTAGE_REQUEST:
+      return "request";
+    case SWITCHSTAGE_OPEN:
+      return "open";
+    case SWITCHSTAGE_PACKET:
+      return "packet";
+    case SWITCHSTAGE_DECODE:
+      return "decode";
+    case SWITCHSTAGE_PRESENT:
+      return "present";
+    default:
+      return "unknown";
+  }
+}
+
+int64_t CChannelSwitchTiming::Now()
+{
+  int64_t counter = CurrentHostCounter();
+  int64_t freq = CurrentHostFrequency();
+  return (counter / freq) * 1000000 + (counter % freq) * 1000000 / freq;
+}
+
+void CChannelSwitchTiming::Begin(const std::string& channel)
+{
+  m_pending = false;
+  for (int i = SWITCHSTAGE_OPEN; i < SWITCHSTAGE_COUNT; i++)
+    m_times[i] = 0;
+  m_times[SWITCHSTAGE_REQUEST] = Now();
+
+  {
+    CSingleLock lock(m_channelSection);
+    m_channel = channel;
+  }
+
+  m_pending = true;
+}
+
+void CChannelSwitchTiming::Abort()
+{
+  m_pending = false;
+}
+
+bool CChannelSwitchTiming::IsPending() const
+{
+  return m_pending && Now() - m_times[SWITCHSTAGE_REQUEST] < PENDING_TIMEOUT;
+}
+
+void CChannelSwitchTiming::Stamp(ESWITCHSTAGE stage)
+{
+  if (!m_pending)
+    return;
+
+  if (stage > SWITCHSTAGE_REQUEST && m_times[stage - 1] == 0)
+    return;
+
+  int64_t expected = 0;
+  if (!m_times[stage].compare_exchange_strong(expected, Now()))
+    return;
+
+  if (stage == SWITCHSTAGE_PRESENT)
+    Complete();
+}
+
+void CChannelSwitchTiming::Complete()
+{
+  bool pending = true;
+  if (!m_pending.compare_exchange_strong(pending, false))
+    return;
+
+  int64_t times[SWITCHSTAGE_COUNT];
+  for (int i = 0; i < SWITCHSTAGE_COUNT; i++)
+    times[i] = m_times[i];
+
+  for (int i = SWITCHSTAGE_OPEN; i < SWITCHSTAGE_COUNT; i++)
+    m_stages[i].Add(times[i] - times[i - 1]);
+  m_total.Add(times[SWITCHSTAGE_PRESENT] - times[SWITCHSTAGE_REQUEST]);
+  m_switches++;
+
+  CLog::Log(LOGDEBUG, "CChannelSwitchTiming - channel switch took %lld us (open %lld, packet %lld, decode %lld, present %lld)",
+            static_cast<long long>(times[SWITCHSTAGE_PRESENT] - times[SWITCHSTAGE_REQUEST]),
+            static_cast<long long>(times[SWITCHSTAGE_OPEN] - times[SWITCHSTAGE_REQUEST]),
+            static_cast<long long>(times[SWITCHSTAGE_PACKET] - times[SWITCHSTAGE_OPEN]),
+            static_cast<long long>(times[SWITCHSTAGE_DECODE] - times[SWITCHSTAGE_PACKET]),
+            static_cast<long long>(times[SWITCHSTAGE_PRESENT] - times[SWITCHSTAGE_DECODE]));
+}
+
+void CChannelSwitchTiming::Serialize(CVariant& value) const
+{
+  value["switches"] = GetSwitches();
+
+  CVariant last(CVariant::VariantTypeObject);
+  {
+    CSingleLock lock(m_channelSection);
+    last["channel"] = m_channel;
+  }
+  last["pending"] = IsPending();
+  last["stages"] = CVariant(CVariant::VariantTypeObject);
+  int64_t request = m_times[SWITCHSTAGE_REQUEST];
+  for (int i = SWITCHSTAGE_OPEN; i < SWITCHSTAGE_COUNT && request != 0; i++)
+  {
+    int64_t time = m_times[i];
+    if (time == 0)
+      break;
+    last["stages"][GetStageName(static_cast<ESWITCHSTAGE>(i))] = time - request;
+  }
+  value["last"] = last;
+
+  for (int i = SWITCHSTAGE_OPEN; i < SWITCHSTAGE_COUNT; i++)
+  {
+    CVariant stage(CVariant::VariantTypeObject);
+    m_stages[i].Serialize(stage);
+    value["stages"][GetStageName(static_cast<ESWITCHSTAGE>(i))] = stage;
+  }
+
+  CVariant total(CVariant::VariantTypeObject);
+  m_total.Serialize(total);
+  value["total"] = total;
+}
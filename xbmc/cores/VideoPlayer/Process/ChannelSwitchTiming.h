@@ -0,0 +1,102 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include "FrameTiming.h"
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+class CVariant;
+
+enum ESWITCHSTAGE
+{
+  SWITCHSTAGE_REQUEST = 0,  //!< channel switch requested
+  SWITCHSTAGE_OPEN,         //!< live stream opened by the client
+  SWITCHSTAGE_PACKET,       //!< first packet read from the demuxer
+  SWITCHSTAGE_DECODE,       //!< first picture returned by the decoder
+  SWITCHSTAGE_PRESENT,      //!< first picture presented
+  SWITCHSTAGE_COUNT
+};
+
+/*!
+ * \brief Latency breakdown of PVR channel switches
+ *
+ * A switch is begun when it is requested, or when the live stream is opened
+ * without a request. Every later stage is stamped once, in order, by the
+ * thread that reaches it first; stamps of a stage whose predecessor is
+ * missing are ignored, so packets and frames of the previous channel do not
+ * count. The switch completes when the first picture is presented and its
+ * stage latencies are added to histograms.
+ *
+ * Radio channels never present a picture, their last switch is reported but
+ * not added to the histograms.
+ */
+class CChannelSwitchTiming
+{
+public:
+  CChannelSwitchTiming();
+
+  void Reset();
+  void Begin(const std::string& channel);
+  /*!
+   * \brief Abandon the current switch, e.g. because the stream could not be opened
+   */
+  void Abort();
+  /*!
+   * \brief Check for a switch that was begun recently and did not complete yet
+   */
+  bool IsPending() const;
+  bool HasStage(ESWITCHSTAGE stage) const { return m_times[stage] != 0; }
+
+  /*!
+   * \brief Stamp a stage of the current switch, cheap if no switch is pending
+   */
+  void Stamp(ESWITCHSTAGE stage);
+
+  unsigned int GetSwitches() const { return m_switches; }
+  const CFrameTimingHistogram& GetHistogram(ESWITCHSTAGE stage) const { return m_stages[stage]; }
+  const CFrameTimingHistogram& GetTotal() const { return m_total; }
+  void Serialize(CVariant& value) const;
+
+  static const char* GetStageName(ESWITCHSTAGE stage);
+
+private:
+  // a switch that did not present a picture within this time is stale
+  static const int64_t PENDING_TIMEOUT = 30000000;
+
+  void Complete();
+  static int64_t Now();
+
+  std::atomic_bool m_pending;
+  std::atomic<int64_t> m_times[SWITCHSTAGE_COUNT];
+  std::atomic<unsigned int> m_switches;
+
+  // m_stages[stage] holds the latency from the previous stage to stage
+  CFrameTimingHistogram m_stages[SWITCHSTAGE_COUNT];
+  CFrameTimingHistogram m_total;
+
+  mutable CCriticalSection m_channelSection;
+  std::string m_channel;
+};
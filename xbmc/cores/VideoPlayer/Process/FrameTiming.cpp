@@ -0,0 +1,396 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FrameTiming.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <cmath>
+
+// first bucket boundary is 2^6 = 64us
+#define HISTOGRAM_MIN_SHIFT 6
+
+CFrameTimingHistogram::CFrameTimingHistogram()
+{
+  Reset();
+}
+
+void CFrameTimingHistogram::Reset()
+{
+  for (auto& bucket : m_buckets)
+    bucket = 0;
+  m_count = 0;
+  m_sum = 0;
+  m_max = 0;
+}
+
+int CFrameTimingHistogram::GetBucket(int64_t value)
+{
+  if (value < (1 << HISTOGRAM_MIN_SHIFT))
+    return 0;
+
+  int msb = 0;
+  uint64_t v = static_cast<uint64_t>(value);
+  while (v >>= 1)
+    msb++;
+
+  int sub = static_cast<int>((static_cast<uint64_t>(value) >> (msb - 2)) & 3);
+  int bucket = 1 + (msb - HISTOGRAM_MIN_SHIFT) * 4 + sub;
+  if (bucket >= BUCKETS)
+    bucket = BUCKETS - 1;
+  return bucket;
+}
+
+int64_t CFrameTimingHistogram::GetBucketUpperBound(int bucket)
+{
+  if (bucket <= 0)
+    return 1 << HISTOGRAM_MIN_SHIFT;
+
+  int octave = (bucket - 1) / 4;
+  int sub = (bucket - 1) % 4;
+  return static_cast<int64_t>(5 + sub) << (octave + HISTOGRAM_MIN_SHIFT - 2);
+}
+
+void CFrameTimingHistogram::Add(int64_t value)
+{
+  if (value < 0)
+    value = 0;
+
+  m_buckets[GetBucket(value)]++;
+  m_count++;
+  m_sum += static_cast<uint64_t>(value);
+
+  int64_t max = m_max;
+  while (value > max && !m_max.compare_exchange_weak(max, value))
+    ;
+}
+
+double CFrameTimingHistogram::GetAverage() const
+{
+  uint64_t count = m_count;
+  if (count == 0)
+    return 0.0;
+  return static_cast<double>(m_sum) / count;
+}
+
+int64_t CFrameTimingHistogram::GetPercentile(double percentile) const
+{
+  uint32_t buckets[BUCKETS];
+  uint64_t total = 0;
+  for (int i = 0; i < BUCKETS; i++)
+  {
+    buckets[i] = m_buckets[i];
+    total += buckets[i];
+  }
+  if (total == 0)
+    return 0;
+
+  uint64_t target = static_cast<uint64_t>(std::ceil(total * percentile / 100.0));
+  if (target == 0)
+    target = 1;
+
+  int64_t max = m_max;
+  uint64_t sum = 0;
+  for (int i = 0; i < BUCKETS; i++)
+  {
+    sum += buckets[i];
+    if (sum >= target)
+      return std::min(GetBucketUpperBound(i), max);
+  }
+  return max;
+}
+
+void CFrameTimingHistogram::Serialize(CVariant& value) const
+{
+  value["count"] = static_cast<uint64_t>(m_count);
+  value["average"] = GetAverage();
+  value["max"] = static_cast<int64_t>(m_max);
+  value["p50"] = GetPercentile(50.0);
+  value["p95"] = GetPercentile(95.0);
+  value["p99"] = GetPercentile(99.0);
+
+  value["buckets"] = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < BUCKETS; i++)
+  {
+    uint32_t count = m_buckets[i];
+    if (count == 0)
+      continue;
+
+    CVariant bucket(CVariant::VariantTypeObject);
+    bucket["upper"] = GetBucketUpperBound(i);
+    bucket["count"] = count;
+    value["buckets"].push_back(bucket);
+  }
+}
+
+CFrameTiming::CFrameTiming()
+{
+  m_tracing = false;
+  Reset();
+}
+
+void CFrameTiming::Reset()
+{
+  for (auto& slot : m_slots)
+  {
+    slot.key = INVALID_KEY;
+    for (auto& time : slot.times)
+      time = 0;
+  }
+  m_nextSlot = 0;
+
+  for (auto& stage : m_stages)
+    stage.Reset();
+  m_total.Reset();
+
+  m_presented = 0;
+  m_dropped = 0;
+  m_skipped = 0;
+  m_late = 0;
+  m_queueDepth = 0;
+}
+
+const char* CFrameTiming::GetStageName(EFRAMESTAGE stage)
+{
+  switch (stage)
+  {
+    case FRAMESTAGE_DEMUX:
+      return "demux";
+    case FRAMESTAGE_DECODE:
+      return "decode";
+    case FRAMESTAGE_QUEUE:
+      return "queue";
+    case FRAMESTAGE_RENDER:
+      return "render";
+    case FRAMESTAGE_PRESENT:
+      return "present";
+    default:
+      return "unknown";
+  }
+}
+
+int64_t CFrameTiming::Now()
+{
+  int64_t counter = CurrentHostCounter();
+  int64_t freq = CurrentHostFrequency();
+  return (counter / freq) * 1000000 + (counter % freq) * 1000000 / freq;
+}
+
+CFrameTiming::SFrameSlot* CFrameTiming::Find(int64_t key)
+{
+  // search backwards from the most recent slot, frames are usually found
+  // within the depth of the render queue
+  uint32_t next = m_nextSlot;
+  for (int i = 1; i <= SLOTS; i++)
+  {
+    SFrameSlot& slot = m_slots[(next - i) % SLOTS];
+    if (slot.key == key)
+      return &slot;
+  }
+  return nullptr;
+}
+
+CFrameTiming::SFrameSlot* CFrameTiming::Open(int64_t key)
+{
+  SFrameSlot& slot = m_slots[m_nextSlot++ % SLOTS];
+  slot.key = INVALID_KEY;
+  for (auto& time : slot.times)
+    time = 0;
+  slot.key = key;
+  return &slot;
+}
+
+void CFrameTiming::Stamp(EFRAMESTAGE stage, double pts)
+{
+  if (stage == FRAMESTAGE_PRESENT)
+    m_presented++;
+
+  if (pts == DVD_NOPTS_VALUE)
+    return;
+
+  int64_t key = llrint(pts);
+  int64_t now = Now();
+
+  SFrameSlot* slot = nullptr;
+  if (stage == FRAMESTAGE_DEMUX)
+    slot = Open(key);
+  else
+  {
+    slot = Find(key);
+    if (!slot && stage == FRAMESTAGE_DECODE)
+      slot = Open(key);
+  }
+
+  if (!slot)
+    return;
+
+  slot->times[stage] = now;
+
+  if (stage == FRAMESTAGE_PRESENT)
+    Complete(*slot, key);
+}
+
+void CFrameTiming::StampDecoded(double packetPts, double pts)
+{
+  if (pts == DVD_NOPTS_VALUE)
+    return;
+
+  int64_t key = llrint(pts);
+  SFrameSlot* slot = nullptr;
+  if (packetPts != DVD_NOPTS_VALUE)
+    slot = Find(llrint(packetPts));
+
+  if (slot)
+    slot->key = key;
+  else
+    slot = Open(key);
+
+  slot->times[FRAMESTAGE_DECODE] = Now();
+}
+
+void CFrameTiming::Complete(SFrameSlot& slot, int64_t key)
+{
+  int64_t times[FRAMESTAGE_COUNT];
+  for (int i = 0; i < FRAMESTAGE_COUNT; i++)
+    times[i] = slot.times[i];
+
+  // the slot was recycled while we were reading it
+  if (slot.key != key)
+    return;
+  slot.key = INVALID_KEY;
+
+  int64_t first = 0;
+  int64_t prev = 0;
+  int stamps = 0;
+  for (int i = 0; i < FRAMESTAGE_COUNT; i++)
+  {
+    if (times[i] == 0)
+      continue;
+    if (prev)
+      m_stages[i].Add(times[i] - prev);
+    else
+      first = times[i];
+    prev = times[i];
+    stamps++;
+  }
+
+  if (stamps > 1)
+    m_total.Add(prev - first);
+
+  if (m_tracing)
+  {
+    CSingleLock lock(m_traceSection);
+    if (m_trace.size() < MAX_TRACE_FRAMES)
+    {
+      STraceFrame frame;
+      frame.pts = key;
+      for (int i = 0; i < FRAMESTAGE_COUNT; i++)
+        frame.times[i] = times[i];
+      m_trace.push_back(frame);
+    }
+  }
+}
+
+void CFrameTiming::StartTrace(const std::string& file)
+{
+  CSingleLock lock(m_traceSection);
+  m_traceFile = file;
+  m_trace.clear();
+  m_tracing = !file.empty();
+}
+
+void CFrameTiming::StopTrace()
+{
+  std::vector<STraceFrame> trace;
+  std::string file;
+  {
+    CSingleLock lock(m_traceSection);
+    if (!m_tracing)
+      return;
+    m_tracing = false;
+    trace.swap(m_trace);
+    file = m_traceFile;
+  }
+
+  // one complete ("X") event per stage, drawn on one track per stage
+  std::string out = "{\"traceEvents\":[";
+  bool firstEvent = true;
+  for (const auto& frame : trace)
+  {
+    int64_t prev = 0;
+    for (int i = 0; i < FRAMESTAGE_COUNT; i++)
+    {
+      if (frame.times[i] == 0)
+        continue;
+      if (prev)
+      {
+        if (!firstEvent)
+          out += ",";
+        out += StringUtils::Format("\n{\"name\":\"%s\",\"cat\":\"video\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                                   "\"ts\":%lld,\"dur\":%lld,\"args\":{\"pts\":%lld}}",
+                                   GetStageName(static_cast<EFRAMESTAGE>(i)), i,
+                                   static_cast<long long>(prev), static_cast<long long>(frame.times[i] - prev),
+                                   static_cast<long long>(frame.pts));
+        firstEvent = false;
+      }
+      prev = frame.times[i];
+    }
+  }
+  out += "\n]}\n";
+
+  XFILE::CFile traceFile;
+  if (!traceFile.OpenForWrite(file, true))
+  {
+    CLog::Log(LOGERROR, "CFrameTiming::StopTrace - unable to write %s", file.c_str());
+    return;
+  }
+  traceFile.Write(out.c_str(), out.size());
+  traceFile.Close();
+
+  CLog::Log(LOGDEBUG, "CFrameTiming::StopTrace - wrote %d frames to %s", static_cast<int>(trace.size()), file.c_str());
+}
+
+void CFrameTiming::Serialize(CVariant& value) const
+{
+  value["tracing"] = static_cast<bool>(m_tracing);
+
+  value["session"]["presented"] = GetPresented();
+  value["session"]["dropped"] = GetDropped();
+  value["session"]["skipped"] = GetSkipped();
+  value["session"]["late"] = GetLate();
+  value["session"]["queuedepth"] = static_cast<int>(m_queueDepth);
+
+  for (int i = FRAMESTAGE_DECODE; i < FRAMESTAGE_COUNT; i++)
+  {
+    CVariant stage(CVariant::VariantTypeObject);
+    m_stages[i].Serialize(stage);
+    value["stages"][GetStageName(static_cast<EFRAMESTAGE>(i))] = stage;
+  }
+
+  CVariant total(CVariant::VariantTypeObject);
+  m_total.Serialize(total);
+  value["total"] = total;
+}
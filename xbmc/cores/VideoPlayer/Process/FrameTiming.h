@@ -0,0 +1,163 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CVariant;
+
+enum EFRAMESTAGE
+{
+  FRAMESTAGE_DEMUX = 0,   //!< packet handed to the video thread
+  FRAMESTAGE_DECODE,      //!< picture returned by the decoder
+  FRAMESTAGE_QUEUE,       //!< picture added to the render queue
+  FRAMESTAGE_RENDER,      //!< picture picked for rendering
+  FRAMESTAGE_PRESENT,     //!< buffer swap after the picture was rendered
+  FRAMESTAGE_COUNT
+};
+
+/*!
+ * \brief Lock-free latency histogram with logarithmic buckets
+ *
+ * Values are in microseconds. Buckets are four per octave starting at 64us,
+ * which keeps the relative error below 25% from 64us up to 3.5s. The last
+ * bucket collects everything above.
+ */
+class CFrameTimingHistogram
+{
+public:
+  static const int BUCKETS = 64;
+
+  CFrameTimingHistogram();
+  void Add(int64_t value);
+  void Reset();
+
+  uint64_t GetCount() const { return m_count; }
+  int64_t GetMax() const { return m_max; }
+  double GetAverage() const;
+  /*!
+   * \brief Upper bound of the bucket holding the given percentile (0..100)
+   */
+  int64_t GetPercentile(double percentile) const;
+  void Serialize(CVariant& value) const;
+
+  static int GetBucket(int64_t value);
+  static int64_t GetBucketUpperBound(int bucket);
+
+private:
+  std::atomic<uint32_t> m_buckets[BUCKETS];
+  std::atomic<uint64_t> m_count;
+  std::atomic<uint64_t> m_sum;
+  std::atomic<int64_t> m_max;
+};
+
+/*!
+ * \brief Per frame latency breakdown of the video pipeline
+ *
+ * Every stage is stamped with the presentation timestamp of the frame. The
+ * video thread opens a record on demux and decode, the render thread closes it
+ * on present and adds the latency between consecutive stages to lock-free
+ * histograms.
+ * Records live in a small ring; frames that never reach present (dropped,
+ * flushed) are simply overwritten.
+ *
+ * When a trace file is set every completed frame is also buffered and written
+ * as Chrome trace events (chrome://tracing, Perfetto) on StopTrace.
+ */
+class CFrameTiming
+{
+public:
+  CFrameTiming();
+
+  void Reset();
+  void Stamp(EFRAMESTAGE stage, double pts);
+  /*!
+   * \brief Record the decoder output
+   *
+   * The player may adjust the pts of a decoded picture (repeat field,
+   * missing timestamps), the record of the packet is moved to the final pts.
+   */
+  void StampDecoded(double packetPts, double pts);
+
+  void StartTrace(const std::string& file);
+  void StopTrace();
+
+  // per session frame counters
+  void AddDropped() { m_dropped++; }
+  void AddSkipped() { m_skipped++; }
+  void AddLate() { m_late++; }
+  void SetQueueDepth(int depth) { m_queueDepth = depth; }
+  unsigned int GetPresented() const { return m_presented; }
+  unsigned int GetDropped() const { return m_dropped; }
+  unsigned int GetSkipped() const { return m_skipped; }
+  unsigned int GetLate() const { return m_late; }
+
+  const CFrameTimingHistogram& GetHistogram(EFRAMESTAGE stage) const { return m_stages[stage]; }
+  const CFrameTimingHistogram& GetTotal() const { return m_total; }
+  void Serialize(CVariant& value) const;
+
+  static const char* GetStageName(EFRAMESTAGE stage);
+
+private:
+  static const int SLOTS = 64;
+  static const int64_t INVALID_KEY = INT64_MIN;
+  static const size_t MAX_TRACE_FRAMES = 100000;
+
+  struct SFrameSlot
+  {
+    std::atomic<int64_t> key;
+    std::atomic<int64_t> times[FRAMESTAGE_COUNT];
+  };
+
+  struct STraceFrame
+  {
+    int64_t pts;
+    int64_t times[FRAMESTAGE_COUNT];
+  };
+
+  SFrameSlot* Find(int64_t key);
+  SFrameSlot* Open(int64_t key);
+  void Complete(SFrameSlot& slot, int64_t key);
+  static int64_t Now();
+
+  SFrameSlot m_slots[SLOTS];
+  std::atomic<uint32_t> m_nextSlot;
+
+  // m_stages[stage] holds the latency from the previous stamped stage to stage
+  CFrameTimingHistogram m_stages[FRAMESTAGE_COUNT];
+  CFrameTimingHistogram m_total;
+
+  std::atomic<unsigned int> m_presented;
+  std::atomic<unsigned int> m_dropped;
+  std::atomic<unsigned int> m_skipped;
+  std::atomic<unsigned int> m_late;
+  std::atomic_int m_queueDepth;
+
+  std::atomic_bool m_tracing;
+  CCriticalSection m_traceSection;
+  std::string m_traceFile;
+  std::vector<STraceFrame> m_trace;
+};
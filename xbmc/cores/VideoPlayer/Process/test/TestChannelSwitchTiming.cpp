@@ -0,0 +1,65 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/VideoPlayer/Process/ChannelSwitchTiming.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestChannelSwitchTiming, Switch)
+{
+  CChannelSwitchTiming timing;
+
+  // nothing is recorded without a pending switch
+  timing.Stamp(SWITCHSTAGE_OPEN);
+  EXPECT_FALSE(timing.HasStage(SWITCHSTAGE_OPEN));
+
+  timing.Begin("channel");
+  EXPECT_TRUE(timing.IsPending());
+
+  // frames of the previous channel are ignored until the stream was opened
+  timing.Stamp(SWITCHSTAGE_PRESENT);
+  EXPECT_FALSE(timing.HasStage(SWITCHSTAGE_PRESENT));
+
+  for (int i = SWITCHSTAGE_OPEN; i < SWITCHSTAGE_COUNT; i++)
+    timing.Stamp(static_cast<ESWITCHSTAGE>(i));
+
+  EXPECT_FALSE(timing.IsPending());
+  EXPECT_EQ(1U, timing.GetSwitches());
+  EXPECT_EQ(1U, timing.GetTotal().GetCount());
+  for (int i = SWITCHSTAGE_OPEN; i < SWITCHSTAGE_COUNT; i++)
+    EXPECT_EQ(1U, timing.GetHistogram(static_cast<ESWITCHSTAGE>(i)).GetCount());
+
+  // later frames of the same channel do not count as another switch
+  timing.Stamp(SWITCHSTAGE_PRESENT);
+  EXPECT_EQ(1U, timing.GetSwitches());
+}
+
+TEST(TestChannelSwitchTiming, Abort)
+{
+  CChannelSwitchTiming timing;
+  timing.Begin("channel");
+  timing.Abort();
+  EXPECT_FALSE(timing.IsPending());
+
+  timing.Stamp(SWITCHSTAGE_OPEN);
+  EXPECT_FALSE(timing.HasStage(SWITCHSTAGE_OPEN));
+  EXPECT_EQ(0U, timing.GetSwitches());
+}
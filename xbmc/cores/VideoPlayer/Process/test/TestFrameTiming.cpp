@@ -0,0 +1,80 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/Process/FrameTiming.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestFrameTiming, Buckets)
+{
+  EXPECT_EQ(0, CFrameTimingHistogram::GetBucket(0));
+  EXPECT_EQ(0, CFrameTimingHistogram::GetBucket(63));
+  EXPECT_EQ(1, CFrameTimingHistogram::GetBucket(64));
+  EXPECT_EQ(CFrameTimingHistogram::BUCKETS - 1, CFrameTimingHistogram::GetBucket(INT64_MAX));
+
+  // every value below the overflow bucket lies within the bounds of its bucket
+  for (int64_t value = 1; value < 3000000; value = value * 3 / 2 + 1)
+  {
+    int bucket = CFrameTimingHistogram::GetBucket(value);
+    EXPECT_LT(value, CFrameTimingHistogram::GetBucketUpperBound(bucket));
+    if (bucket > 0)
+      EXPECT_GE(value, CFrameTimingHistogram::GetBucketUpperBound(bucket - 1));
+  }
+}
+
+TEST(TestFrameTiming, Percentiles)
+{
+  CFrameTimingHistogram histogram;
+  for (int i = 0; i < 99; i++)
+    histogram.Add(1000);
+  histogram.Add(40000);
+
+  EXPECT_EQ(100U, histogram.GetCount());
+  EXPECT_EQ(40000, histogram.GetMax());
+  EXPECT_DOUBLE_EQ(1390.0, histogram.GetAverage());
+
+  int bucket = CFrameTimingHistogram::GetBucket(1000);
+  EXPECT_EQ(CFrameTimingHistogram::GetBucketUpperBound(bucket), histogram.GetPercentile(50.0));
+  EXPECT_EQ(CFrameTimingHistogram::GetBucketUpperBound(bucket), histogram.GetPercentile(99.0));
+  EXPECT_EQ(40000, histogram.GetPercentile(100.0));
+
+  histogram.Reset();
+  EXPECT_EQ(0U, histogram.GetCount());
+  EXPECT_EQ(0, histogram.GetPercentile(50.0));
+}
+
+TEST(TestFrameTiming, Pipeline)
+{
+  CFrameTiming timing;
+  timing.Stamp(FRAMESTAGE_DEMUX, 1000.0);
+  timing.StampDecoded(1000.0, 2000.0);
+  timing.Stamp(FRAMESTAGE_QUEUE, 2000.0);
+  timing.Stamp(FRAMESTAGE_RENDER, 2000.0);
+  timing.Stamp(FRAMESTAGE_PRESENT, 2000.0);
+
+  for (int i = FRAMESTAGE_DECODE; i < FRAMESTAGE_COUNT; i++)
+    EXPECT_EQ(1U, timing.GetHistogram(static_cast<EFRAMESTAGE>(i)).GetCount());
+  EXPECT_EQ(1U, timing.GetTotal().GetCount());
+
+  // a frame that is not in flight is ignored
+  timing.Stamp(FRAMESTAGE_PRESENT, 2000.0);
+  timing.Stamp(FRAMESTAGE_PRESENT, 3000.0);
+  EXPECT_EQ(1U, timing.GetHistogram(FRAMESTAGE_PRESENT).GetCount());
+}
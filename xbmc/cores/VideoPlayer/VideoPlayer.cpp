@@ -750,7 +750,11 @@ bool CVideoPlayer::CloseFile(bool reopen)
     StopThread();
   }
 
-  m_Edl.Clear();
+  {
+    CSingleLock lock(m_EdlSection);
+    m_Edl.Clear();
+  }
+  m_edlImport.reset();
 
   m_HasVideo = false;
   m_HasAudio = false;
@@ -795,18 +799,28 @@ bool CVideoPlayer::OpenInputStream()
     m_item.SetPath(g_mediaManager.TranslateDevicePath(""));
   }
 
+  // channels may be played without a switch request, e.g. via JSON-RPC
+  CChannelSwitchTiming& switchTiming = CServiceBroker::GetDataCacheCore().GetChannelSwitchTiming();
+  if (!m_item.IsPVRChannel())
+    switchTiming.Abort();
+  else if (!switchTiming.IsPending() || switchTiming.HasStage(SWITCHSTAGE_OPEN))
+    switchTiming.Begin(m_item.GetLabel());
+
   m_pInputStream = CDVDFactoryInputStream::CreateInputStream(this, m_item, true);
   if(m_pInputStream == NULL)
   {
     CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - unable to create input stream for [%s]", CURL::GetRedacted(m_item.GetPath()).c_str());
+    switchTiming.Abort();
     return false;
   }
 
   if (!m_pInputStream->Open())
   {
     CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - error opening [%s]", CURL::GetRedacted(m_item.GetPath()).c_str());
+    switchTiming.Abort();
     return false;
   }
+  switchTiming.Stamp(SWITCHSTAGE_OPEN);
 
   // find any available external subtitles for non dvd files
   if (!m_pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD)
@@ -1118,6 +1132,7 @@ bool CVideoPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
         UpdateContent();
       }
     }
+    CServiceBroker::GetDataCacheCore().GetChannelSwitchTiming().Stamp(SWITCHSTAGE_PACKET);
     return true;
   }
   return false;
@@ -1302,7 +1317,13 @@ void CVideoPlayer::Prepare()
    */
   CEdl::Cut cut;
   int starttime = 0;
-  if (m_playerOptions.starttime > 0 || m_playerOptions.startpercent > 0)
+  bool resume = m_playerOptions.starttime > 0 || m_playerOptions.startpercent > 0;
+
+  // resume positions are stored without cut time, the cuts are needed to restore it. Otherwise
+  // don't hold up playback, a cut at the start is skipped by CheckAutoSceneSkip once read.
+  UpdateEdl(resume);
+
+  if (resume)
   {
     if (m_playerOptions.startpercent > 0 && m_pDemuxer)
     {
@@ -1395,6 +1416,7 @@ void CVideoPlayer::Process()
     }
 
     // check if in a cut or commercial break that should be automatically skipped
+    UpdateEdl(false);
     CheckAutoSceneSkip();
 
     // handle messages send to this thread, like seek or demuxer reset requests
@@ -2319,6 +2341,21 @@ bool CVideoPlayer::CheckSceneSkip(CCurrentStream& current)
   return m_Edl.InCut(DVD_TIME_TO_MSEC(current.dts + m_offset_pts), &cut) && cut.action == CEdl::CUT;
 }
 
+void CVideoPlayer::UpdateEdl(bool wait)
+{
+  if (!m_edlImport || !(wait ? m_edlImport->Wait() : m_edlImport->Wait(0)))
+    return;
+
+  {
+    CSingleLock lock(m_EdlSection);
+    m_Edl = std::move(m_edlImport->GetEdl());
+  }
+  m_edlImport.reset();
+
+  if (m_Edl.HasCut() || m_Edl.HasSceneMarker())
+    CLog::Log(LOGDEBUG, "%s - Edit decision list loaded: %s", __FUNCTION__, m_Edl.GetInfo().c_str());
+}
+
 void CVideoPlayer::CheckAutoSceneSkip()
 {
   if (!m_Edl.HasCut())
@@ -2371,7 +2408,10 @@ void CVideoPlayer::CheckAutoSceneSkip()
       std::string strTimeString = StringUtils::SecondsToTimeString((cut.end - cut.start) / 1000, TIME_FORMAT_MM_SS);
       CGUIDialogKaiToast::QueueNotification(g_localizeStrings.Get(25011), strTimeString);
 
-      m_Edl.SetLastCutTime(cut.start);
+      {
+        CSingleLock lock(m_EdlSection);
+        m_Edl.SetLastCutTime(cut.start);
+      }
 
       if (m_SkipCommercials)
       {
@@ -3155,9 +3195,6 @@ void CVideoPlayer::Seek(bool bPlus, bool bLargeStep, bool bChapterOverride)
 
 bool CVideoPlayer::SeekScene(bool bPlus)
 {
-  if (!m_Edl.HasSceneMarker())
-    return false;
-
   /*
    * There is a 5 second grace period applied when seeking for scenes backwards. If there is no
    * grace period applied it is impossible to go backwards past a scene marker.
@@ -3167,7 +3204,13 @@ bool CVideoPlayer::SeekScene(bool bPlus)
     clock -= 5 * 1000;
 
   int iScenemarker;
-  if (m_Edl.GetNextSceneMarker(bPlus, clock, &iScenemarker))
+  bool bFound;
+  {
+    CSingleLock lock(m_EdlSection);
+    bFound = m_Edl.HasSceneMarker() && m_Edl.GetNextSceneMarker(bPlus, clock, &iScenemarker);
+  }
+
+  if (bFound)
   {
     /*
      * Seeking is flushed and inaccurate, just like Seek()
@@ -3201,7 +3244,10 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
         dDiff = (apts - vpts) / DVD_TIME_BASE;
 
       std::string strEDL;
-      strEDL += StringUtils::Format(", edl:%s", m_Edl.GetInfo().c_str());
+      {
+        CSingleLock lock(m_EdlSection);
+        strEDL += StringUtils::Format(", edl:%s", m_Edl.GetInfo().c_str());
+      }
 
       std::string strBuf;
       CSingleLock lock(m_StateSection);
@@ -3680,12 +3726,16 @@ bool CVideoPlayer::OpenVideoStream(CDVDStreamInfo& hint, bool reset)
     if (!player->OpenStream(hint))
       return false;
 
-    // look for any EDL files
-    m_Edl.Clear();
+    // look for any EDL files, they are picked up by UpdateEdl once read
+    {
+      CSingleLock lock(m_EdlSection);
+      m_Edl.Clear();
+    }
+    m_edlImport.reset();
     if (hint.fpsrate > 0 && hint.fpsscale > 0)
     {
       float fFramesPerSecond = (float)m_CurrentVideo.hint.fpsrate / (float)m_CurrentVideo.hint.fpsscale;
-      m_Edl.ReadEditDecisionLists(m_item.GetDynPath(), fFramesPerSecond, m_CurrentVideo.hint.height);
+      m_edlImport = CEdlImport::Start(m_item.GetDynPath(), fFramesPerSecond, m_CurrentVideo.hint.height);
     }
 
     if (s.stereo_mode == "mono")
@@ -4831,6 +4881,11 @@ bool CVideoPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned int m
   return m_renderManager.RenderCaptureGetPixels(captureId, millis, buffer, size);
 }
 
+bool CVideoPlayer::RenderCaptureGetLatestPixels(unsigned int captureId, uint8_t *buffer, unsigned int size, unsigned int &frameId)
+{
+  return m_renderManager.RenderCaptureGetLatestPixels(captureId, buffer, size, frameId);
+}
+
 void CVideoPlayer::VideoParamsChange()
 {
   m_messenger.Put(new CDVDMsg(CDVDMsg::PLAYER_AVCHANGE));
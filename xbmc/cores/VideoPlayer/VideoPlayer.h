@@ -377,6 +377,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags) override;
   void RenderCaptureRelease(unsigned int captureId) override;
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size) override;
+  bool RenderCaptureGetLatestPixels(unsigned int captureId, uint8_t *buffer, unsigned int size, unsigned int &frameId) override;
 
   // IDispResource interface
   void OnLostDisplay() override;
@@ -459,6 +460,7 @@ protected:
   bool IsInMenuInternal() const;
   void SynchronizeDemuxer();
   void CheckAutoSceneSkip();
+  void UpdateEdl(bool wait);
   bool CheckContinuity(CCurrentStream& current, DemuxPacket* pPacket);
   bool CheckSceneSkip(CCurrentStream& current);
   bool CheckPlayerInit(CCurrentStream& current);
@@ -578,7 +580,9 @@ protected:
   CCriticalSection m_StateSection;
   XbmcThreads::EndTime m_syncTimer;
 
-  CEdl m_Edl;
+  CEdl m_Edl; // only changed by the player thread, other threads read it under m_EdlSection
+  CCriticalSection m_EdlSection;
+  std::shared_ptr<CEdlImport> m_edlImport;
   bool m_SkipCommercials;
 
   bool m_HasVideo;
@@ -30,6 +30,12 @@
 #include "utils/log.h"
 #include "threads/SingleLock.h"
 
+// overlays that are not due yet are only queued while the container holds
+// fewer than this, overlays that are due are always added
+#define MAX_QUEUED_OVERLAYS 5
+// subtitle files hand out overlays this long before they are due
+#define OVERLAY_LOOKAHEAD DVD_SEC_TO_TIME(5)
+
 CVideoPlayerSubtitle::CVideoPlayerSubtitle(CDVDOverlayContainer* pOverlayContainer, CProcessInfo &processInfo)
 : IDVDStreamPlayer(processInfo)
 {
@@ -203,12 +209,9 @@ void CVideoPlayerSubtitle::Process(double pts, double offset)
       m_pSubtitleFileParser->Reset();
     }
 
-    if(m_pOverlayContainer->GetSize() >= 5)
-      return;
-
-    CDVDOverlay* pOverlay = m_pSubtitleFileParser->Parse(pts);
-    // add all overlays which fit the pts
-    while(pOverlay)
+    // add all overlays which fit the pts, a full container stops the look-ahead
+    CDVDOverlay* pOverlay;
+    while ((pOverlay = m_pSubtitleFileParser->Parse(pts, AcceptsData() ? OVERLAY_LOOKAHEAD : 0.0)))
     {
       pOverlay->iPTSStartTime -= offset;
       if(pOverlay->iPTSStopTime != 0.0)
@@ -216,7 +219,6 @@ void CVideoPlayerSubtitle::Process(double pts, double offset)
 
       m_pOverlayContainer->Add(pOverlay);
       pOverlay->Release();
-      pOverlay = m_pSubtitleFileParser->Parse(pts);
     }
 
     m_lastPts = pts;
@@ -225,7 +227,6 @@ void CVideoPlayerSubtitle::Process(double pts, double offset)
 
 bool CVideoPlayerSubtitle::AcceptsData() const
 {
-  // FIXME : This may still be causing problems + magic number :(
-  return m_pOverlayContainer->GetSize() < 5;
+  return m_pOverlayContainer->GetSize() < MAX_QUEUED_OVERLAYS;
 }
 
@@ -20,6 +20,7 @@
 
 #include "system.h"
 #include "ServiceBroker.h"
+#include "cores/DataCacheCore.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderFlags.h"
 #include "windowing/WinSystem.h"
 #include "settings/AdvancedSettings.h"
@@ -159,6 +160,12 @@ bool CVideoPlayerVideo::OpenStream(CDVDStreamInfo hint)
       return false;
     }
     OpenStream(hint, codec);
+
+    CFrameTiming& frameTiming = CServiceBroker::GetDataCacheCore().GetFrameTiming();
+    frameTiming.Reset();
+    if (!g_advancedSettings.m_videoFrameTimingTrace.empty())
+      frameTiming.StartTrace(g_advancedSettings.m_videoFrameTimingTrace);
+
     CLog::Log(LOGNOTICE, "Creating video thread");
     m_messageQueue.Init();
     m_processInfo.SetLevelVQ(0);
@@ -251,10 +258,16 @@ void CVideoPlayerVideo::CloseStream(bool bWaitForBuffers)
   CLog::Log(LOGNOTICE, "waiting for video thread to exit");
 
   m_bAbortOutput = true;
+  m_renderManager.WakeUpWaiters();
   StopThread();
 
   m_messageQueue.End();
 
+  CFrameTiming& frameTiming = CServiceBroker::GetDataCacheCore().GetFrameTiming();
+  CLog::Log(LOGNOTICE, "CVideoPlayerVideo::CloseStream - presented: %u, dropped: %u, skipped: %u, late: %u",
+            frameTiming.GetPresented(), frameTiming.GetDropped(), frameTiming.GetSkipped(), frameTiming.GetLate());
+  frameTiming.StopTrace();
+
   CLog::Log(LOGNOTICE, "deleting video codec");
   if (m_pVideoCodec)
   {
@@ -287,6 +300,12 @@ bool CVideoPlayerVideo::IsInited() const
 
 inline void CVideoPlayerVideo::SendMessage(CDVDMsg* pMsg, int priority)
 {
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* pPacket = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+    if (pPacket)
+      CServiceBroker::GetDataCacheCore().GetFrameTiming().Stamp(FRAMESTAGE_DEMUX, pPacket->pts);
+  }
   m_messageQueue.Put(pMsg, priority);
   m_processInfo.SetLevelVQ(m_messageQueue.GetLevel());
 }
@@ -547,6 +566,7 @@ void CVideoPlayerVideo::Process()
       if (iDropDirective & DROP_DROPPED)
       {
         m_iDroppedFrames++;
+        CServiceBroker::GetDataCacheCore().GetFrameTiming().AddDropped();
         m_ptsTracker.Flush();
       }
       if (m_messageQueue.GetDataSize() == 0 ||  m_speed < 0)
@@ -667,6 +687,7 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
   if (decoderState == CDVDVideoCodec::VC_PICTURE)
   {
     bool hasTimestamp = true;
+    double decodedPts = m_picture.pts;
 
     m_picture.iDuration = frametime;
 
@@ -703,6 +724,9 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
     if (m_speed != 0)
       pts += m_picture.iDuration * m_speed / abs(m_speed);
 
+    CServiceBroker::GetDataCacheCore().GetFrameTiming().StampDecoded(decodedPts, m_picture.pts);
+    CServiceBroker::GetDataCacheCore().GetChannelSwitchTiming().Stamp(SWITCHSTAGE_DECODE);
+
     m_outputSate = OutputPicture(&m_picture);
 
     if (m_outputSate == OUTPUT_AGAIN)
@@ -716,6 +740,7 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
     else if ((m_outputSate == OUTPUT_DROPPED) && !(m_picture.iFlags & DVP_FLAG_DROPPED))
     {
       m_iDroppedFrames++;
+      CServiceBroker::GetDataCacheCore().GetFrameTiming().AddDropped();
       m_ptsTracker.Flush();
     }
 
@@ -759,6 +784,7 @@ void CVideoPlayerVideo::Flush(bool sync)
   FlushMessages();
   SendMessage(new CDVDMsgBool(CDVDMsg::GENERAL_FLUSH, sync), 1);
   m_bAbortOutput = true;
+  m_renderManager.WakeUpWaiters();
 }
 
 void CVideoPlayerVideo::ProcessOverlays(const VideoPicture* pSource, double pts)
@@ -39,6 +39,7 @@
 #include "guilib/Texture.h"
 #include "threads/SingleLock.h"
 #include "RenderCapture.h"
+#include "RenderCaptureConvert.h"
 #include "Application.h"
 #include "RenderFactory.h"
 #include "cores/IPlayer.h"
@@ -1097,12 +1098,8 @@ bool CLinuxRendererGLES::RenderCapture(CRenderCapture* capture)
                GL_RGBA, GL_UNSIGNED_BYTE, capture->GetRenderBuffer());
 
   // OpenGLES returns in RGBA order but CRenderCapture needs BGRA order
-  // XOR Swap RGBA -> BGRA
-  unsigned char* pixels = (unsigned char*)capture->GetRenderBuffer();
-  for (unsigned int i = 0; i < capture->GetWidth() * capture->GetHeight(); i++, pixels+=4)
-  {
-    std::swap(pixels[0], pixels[2]);
-  }
+  uint8_t* pixels = static_cast<uint8_t*>(capture->GetRenderBuffer());
+  CRenderCaptureConvert::SwapRedBlue(pixels, pixels, capture->GetWidth() * capture->GetHeight());
 
   capture->EndRender();
 
@@ -25,14 +25,14 @@
 #include "settings/AdvancedSettings.h"
 #include "cores/IPlayer.h"
 #include "rendering/RenderSystem.h"
+#include "threads/SingleLock.h"
 #ifdef TARGET_WINDOWS
 #include "rendering/dx/DeviceResources.h"
 #include "rendering/dx/RenderContext.h"
 #endif
 
-extern "C" {
-#include "libavutil/mem.h"
-}
+#include <algorithm>
+#include <string.h>
 
 CRenderCaptureBase::CRenderCaptureBase()
 {
@@ -45,9 +45,65 @@ CRenderCaptureBase::CRenderCaptureBase()
   m_flags          = 0;
   m_asyncSupported = false;
   m_asyncChecked   = false;
+  m_frontPixels    = nullptr;
+  m_frontBufferSize = 0;
+  m_frontWidth     = 0;
+  m_frontHeight    = 0;
+  m_frameId        = 0;
+  m_frameReady     = false;
 }
 
-CRenderCaptureBase::~CRenderCaptureBase() = default;
+CRenderCaptureBase::~CRenderCaptureBase()
+{
+  delete[] m_frontPixels;
+}
+
+bool CRenderCaptureBase::PublishFrame()
+{
+  if (!m_frameReady)
+    return true;
+
+  CSingleTryLock lock(m_frontSection);
+  if (!lock.IsOwner())
+    return false;
+
+  //the renderer keeps writing into m_pixels, so the buffer swapped in needs the same size
+  if (m_frontBufferSize != m_bufferSize)
+  {
+    delete[] m_frontPixels;
+    m_frontPixels = new uint8_t[m_bufferSize];
+    m_frontBufferSize = m_bufferSize;
+  }
+
+  std::swap(m_pixels, m_frontPixels);
+  m_frontWidth = m_width;
+  m_frontHeight = m_height;
+  m_frameId++;
+  m_frameReady = false;
+
+  return true;
+}
+
+bool CRenderCaptureBase::CopyPixels(uint8_t *buffer, unsigned int size, unsigned int *frameId)
+{
+  CSingleLock lock(m_frontSection);
+
+  if (frameId)
+    *frameId = m_frameId;
+
+  if (!m_frameId || !m_frontPixels)
+    return false;
+
+  unsigned int srcSize = m_frontWidth * m_frontHeight * 4;
+  memcpy(buffer, m_frontPixels, std::min(srcSize, size));
+  return true;
+}
+
+unsigned int CRenderCaptureBase::GetFrameId()
+{
+  CSingleLock lock(m_frontSection);
+  return m_frameId;
+}
 
 bool CRenderCaptureBase::UseOcclusionQuery()
 {
@@ -86,6 +142,7 @@ void CRenderCaptureDispmanX::EndRender()
 {
   delete[] m_pixels;
   m_pixels = g_RBP.CaptureDisplay(m_width, m_height, NULL, true);
+  m_bufferSize = m_width * m_height * 4;
 
   SetState(CAPTURESTATE_DONE);
 }
@@ -293,7 +350,7 @@ CRenderCaptureDX::CRenderCaptureDX()
 CRenderCaptureDX::~CRenderCaptureDX()
 {
   CleanupDX();
-  av_freep(&m_pixels);
+  delete[] m_pixels;
   DX::Windowing().Unregister(this);
 }
 
@@ -349,8 +406,8 @@ void CRenderCaptureDX::BeginRender()
   if (m_bufferSize != m_width * m_height * 4)
   {
     m_bufferSize = m_width * m_height * 4;
-    av_freep(&m_pixels);
-    m_pixels = (uint8_t*)av_malloc(m_bufferSize);
+    delete[] m_pixels;
+    m_pixels = new uint8_t[m_bufferSize];
   }
 
   if (m_asyncSupported && UseOcclusionQuery())
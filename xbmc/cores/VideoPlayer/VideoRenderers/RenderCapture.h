@@ -26,6 +26,7 @@
   #include "guilib/D3DResource.h"
 #endif
 
+#include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
 enum ECAPTURESTATE
@@ -45,7 +46,12 @@ class CRenderCaptureBase
     virtual ~CRenderCaptureBase();
 
     /* \brief Called by the rendermanager to set the state, should not be called by anything else */
-    void SetState(ECAPTURESTATE state) { m_state = state; }
+    void SetState(ECAPTURESTATE state)
+    {
+      m_state = state;
+      if (state == CAPTURESTATE_DONE)
+        m_frameReady = true;
+    }
 
     /* \brief Called by the rendermanager to get the state, should not be called by anything else */
     ECAPTURESTATE GetState() { return m_state;}
@@ -83,11 +89,22 @@ class CRenderCaptureBase
     /* \brief Called by the code requesting the capture to get the height */
     unsigned int GetHeight() { return m_height; }
 
-    /* \brief Called by the code requesting the capture to get the buffer where the videoframe is stored,
-       the format is BGRA, this buffer is only valid when GetUserState returns CAPTURESTATE_DONE.
-       The size of the buffer is GetWidth() * GetHeight() * 4.
+    /* \brief Called by the rendermanager when a readout has finished, swaps the back buffer the renderer
+       wrote into with the front buffer handed out by CopyPixels. When the front buffer is being read the
+       swap is skipped and the frame stays in the back buffer, so the render thread never waits on a reader.
+       \return true when the frame was published
     */
-    uint8_t*  GetPixels() const { return m_pixels; }
+    bool PublishFrame();
+
+    /* \brief Called by the code requesting the capture to copy the last published videoframe,
+       the format is BGRA. At most GetWidth() * GetHeight() * 4 bytes are copied.
+       \param frameId receives the sequence number of the copied frame, 0 when nothing was published yet
+       \return false when no frame has been published yet
+    */
+    bool CopyPixels(uint8_t *buffer, unsigned int size, unsigned int *frameId = nullptr);
+
+    /* \brief Sequence number of the last published frame, increases with every PublishFrame */
+    unsigned int GetFrameId();
 
     /* \brief Called by the rendermanager to know if the capture is readout async (using dma for example),
        should not be called by anything else.
@@ -107,6 +124,15 @@ class CRenderCaptureBase
     unsigned int m_height;
     unsigned int m_bufferSize;
 
+    //front buffer of the double buffered readout, guarded by m_frontSection
+    CCriticalSection m_frontSection;
+    uint8_t* m_frontPixels;
+    unsigned int m_frontBufferSize;
+    unsigned int m_frontWidth;
+    unsigned int m_frontHeight;
+    unsigned int m_frameId;
+    bool m_frameReady; //m_pixels holds a frame that wasn't published yet
+
     //this is set after the first render
     bool m_asyncSupported;
     bool m_asyncChecked;
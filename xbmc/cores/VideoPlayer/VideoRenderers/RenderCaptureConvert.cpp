@@ -0,0 +1,471 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderCaptureConvert.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <string.h>
+#include <vector>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#define CAPTURE_KERNELS_SSE2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CAPTURE_KERNELS_AVX2
+#define CAPTURE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(HAS_NEON) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#define CAPTURE_KERNELS_NEON
+#endif
+
+namespace
+{
+
+// BT.601 limited range coefficients, 6 bit fixed point
+const int COEF_Y  = 74;
+const int COEF_RV = 102;
+const int COEF_GU = -25;
+const int COEF_GV = -52;
+const int COEF_BU = 129;
+
+inline uint8_t Avg(uint8_t a, uint8_t b)
+{
+  return (a + b + 1) >> 1;
+}
+
+inline uint8_t Clamp(int value)
+{
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+//------------------------------------------------------------------------------
+// scalar reference kernels
+//------------------------------------------------------------------------------
+
+void SwapRedBlue_C(uint8_t* dst, const uint8_t* src, unsigned int pixels)
+{
+  for (unsigned int i = 0; i < pixels; i++, src += 4, dst += 4)
+  {
+    uint8_t r = src[0];
+    uint8_t b = src[2];
+    dst[0] = b;
+    dst[1] = src[1];
+    dst[2] = r;
+    dst[3] = src[3];
+  }
+}
+
+void SetOpaque_C(uint8_t* pixels, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    pixels[i * 4 + 3] = 0xFF;
+}
+
+void DownscaleRow_C(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, unsigned int dstPixels)
+{
+  for (unsigned int i = 0; i < dstPixels; i++, row0 += 8, row1 += 8, dst += 4)
+  {
+    for (int c = 0; c < 4; c++)
+      dst[c] = Avg(Avg(row0[c], row1[c]), Avg(row0[c + 4], row1[c + 4]));
+  }
+}
+
+void YUVRow_C(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, unsigned int width)
+{
+  for (unsigned int x = 0; x < width; x++, dst += 4)
+  {
+    int yy = COEF_Y * (y[x] - 16);
+    int uu = u[x >> 1] - 128;
+    int vv = v[x >> 1] - 128;
+    dst[0] = Clamp((yy + COEF_BU * uu + 32) >> 6);
+    dst[1] = Clamp((yy + COEF_GU * uu + COEF_GV * vv + 32) >> 6);
+    dst[2] = Clamp((yy + COEF_RV * vv + 32) >> 6);
+    dst[3] = 0xFF;
+  }
+}
+
+//------------------------------------------------------------------------------
+// SSE2 kernels
+//------------------------------------------------------------------------------
+
+#if defined(CAPTURE_KERNELS_SSE2)
+void SwapRedBlue_SSE2(uint8_t* dst, const uint8_t* src, unsigned int pixels)
+{
+  const __m128i maskAG = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+  const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+
+  unsigned int i = 0;
+  for (; i + 4 <= pixels; i += 4, src += 16, dst += 16)
+  {
+    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i ag = _mm_and_si128(p, maskAG);
+    __m128i rb = _mm_and_si128(p, maskRB);
+    rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(ag, rb));
+  }
+  SwapRedBlue_C(dst, src, pixels - i);
+}
+
+void SetOpaque_SSE2(uint8_t* pixels, unsigned int count)
+{
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4, pixels += 16)
+  {
+    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), _mm_or_si128(p, alpha));
+  }
+  SetOpaque_C(pixels, count - i);
+}
+
+void DownscaleRow_SSE2(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, unsigned int dstPixels)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= dstPixels; i += 4, row0 += 32, row1 += 32, dst += 16)
+  {
+    __m128i a = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0)),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1)));
+    __m128i b = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 16)),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 16)));
+    __m128i even = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128i odd = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_avg_epu8(even, odd));
+  }
+  DownscaleRow_C(row0, row1, dst, dstPixels - i);
+}
+
+void YUVRow_SSE2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, unsigned int width)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+  const __m128i offsetY = _mm_set1_epi16(16);
+  const __m128i offsetUV = _mm_set1_epi16(128);
+  const __m128i round = _mm_set1_epi16(32);
+  const __m128i coefY = _mm_set1_epi16(COEF_Y);
+  const __m128i coefRV = _mm_set1_epi16(COEF_RV);
+  const __m128i coefGU = _mm_set1_epi16(COEF_GU);
+  const __m128i coefGV = _mm_set1_epi16(COEF_GV);
+  const __m128i coefBU = _mm_set1_epi16(COEF_BU);
+
+  unsigned int x = 0;
+  for (; x + 8 <= width; x += 8, dst += 32)
+  {
+    int32_t u4, v4;
+    memcpy(&u4, u + x / 2, 4);
+    memcpy(&v4, v + x / 2, 4);
+
+    __m128i yy = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero);
+    __m128i uu = _mm_unpacklo_epi8(_mm_cvtsi32_si128(u4), zero);
+    __m128i vv = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v4), zero);
+    uu = _mm_sub_epi16(_mm_unpacklo_epi16(uu, uu), offsetUV);
+    vv = _mm_sub_epi16(_mm_unpacklo_epi16(vv, vv), offsetUV);
+    yy = _mm_mullo_epi16(_mm_sub_epi16(yy, offsetY), coefY);
+
+    __m128i b = _mm_adds_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(uu, coefBU)), round);
+    __m128i g = _mm_adds_epi16(_mm_adds_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(uu, coefGU)),
+                                              _mm_mullo_epi16(vv, coefGV)), round);
+    __m128i r = _mm_adds_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(vv, coefRV)), round);
+
+    __m128i b8 = _mm_packus_epi16(_mm_srai_epi16(b, 6), zero);
+    __m128i g8 = _mm_packus_epi16(_mm_srai_epi16(g, 6), zero);
+    __m128i r8 = _mm_packus_epi16(_mm_srai_epi16(r, 6), zero);
+
+    __m128i bg = _mm_unpacklo_epi8(b8, g8);
+    __m128i ra = _mm_unpacklo_epi8(r8, alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi16(bg, ra));
+  }
+  YUVRow_C(y + x, u + x / 2, v + x / 2, dst, width - x);
+}
+#endif
+
+//------------------------------------------------------------------------------
+// AVX2 kernels, built with a per function target so the rest of the file
+// keeps running on CPUs without AVX2
+//------------------------------------------------------------------------------
+
+#if defined(CAPTURE_KERNELS_AVX2)
+CAPTURE_TARGET_AVX2
+void SwapRedBlue_AVX2(uint8_t* dst, const uint8_t* src, unsigned int pixels)
+{
+  const __m256i maskAG = _mm256_set1_epi32(static_cast<int>(0xFF00FF00));
+  const __m256i maskRB = _mm256_set1_epi32(0x00FF00FF);
+
+  unsigned int i = 0;
+  for (; i + 8 <= pixels; i += 8, src += 32, dst += 32)
+  {
+    __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    __m256i ag = _mm256_and_si256(p, maskAG);
+    __m256i rb = _mm256_and_si256(p, maskRB);
+    rb = _mm256_or_si256(_mm256_slli_epi32(rb, 16), _mm256_srli_epi32(rb, 16));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_or_si256(ag, rb));
+  }
+  SwapRedBlue_SSE2(dst, src, pixels - i);
+}
+
+CAPTURE_TARGET_AVX2
+void SetOpaque_AVX2(uint8_t* pixels, unsigned int count)
+{
+  const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8, pixels += 32)
+  {
+    __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels), _mm256_or_si256(p, alpha));
+  }
+  SetOpaque_SSE2(pixels, count - i);
+}
+
+CAPTURE_TARGET_AVX2
+void DownscaleRow_AVX2(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, unsigned int dstPixels)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= dstPixels; i += 8, row0 += 64, row1 += 64, dst += 32)
+  {
+    __m256i a = _mm256_avg_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0)),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1)));
+    __m256i b = _mm256_avg_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + 32)),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + 32)));
+    // shuffles work per 128 bit lane, the permute restores the pixel order
+    __m256i even = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+    __m256i odd = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _MM_SHUFFLE(3, 1, 3, 1)));
+    __m256i res = _mm256_permute4x64_epi64(_mm256_avg_epu8(even, odd), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), res);
+  }
+  DownscaleRow_SSE2(row0, row1, dst, dstPixels - i);
+}
+#endif
+
+//------------------------------------------------------------------------------
+// NEON kernels
+//------------------------------------------------------------------------------
+
+#if defined(CAPTURE_KERNELS_NEON)
+void SwapRedBlue_NEON(uint8_t* dst, const uint8_t* src, unsigned int pixels)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= pixels; i += 16, src += 64, dst += 64)
+  {
+    uint8x16x4_t p = vld4q_u8(src);
+    uint8x16_t tmp = p.val[0];
+    p.val[0] = p.val[2];
+    p.val[2] = tmp;
+    vst4q_u8(dst, p);
+  }
+  SwapRedBlue_C(dst, src, pixels - i);
+}
+
+void SetOpaque_NEON(uint8_t* pixels, unsigned int count)
+{
+  const uint32x4_t alpha = vdupq_n_u32(0xFF000000);
+
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4, pixels += 16)
+  {
+    uint32x4_t p = vreinterpretq_u32_u8(vld1q_u8(pixels));
+    vst1q_u8(pixels, vreinterpretq_u8_u32(vorrq_u32(p, alpha)));
+  }
+  SetOpaque_C(pixels, count - i);
+}
+
+void DownscaleRow_NEON(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, unsigned int dstPixels)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= dstPixels; i += 8, row0 += 64, row1 += 64, dst += 32)
+  {
+    uint8x16x4_t a = vld4q_u8(row0);
+    uint8x16x4_t b = vld4q_u8(row1);
+    uint8x8x4_t res;
+    for (int c = 0; c < 4; c++)
+    {
+      uint8x16_t vert = vrhaddq_u8(a.val[c], b.val[c]);
+      uint8x16x2_t split = vuzpq_u8(vert, vert);
+      res.val[c] = vrhadd_u8(vget_low_u8(split.val[0]), vget_low_u8(split.val[1]));
+    }
+    vst4_u8(dst, res);
+  }
+  DownscaleRow_C(row0, row1, dst, dstPixels - i);
+}
+
+void YUVRow_NEON(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, unsigned int width)
+{
+  const int16x8_t offsetY = vdupq_n_s16(16);
+  const int16x8_t offsetUV = vdupq_n_s16(128);
+  const int16x8_t round = vdupq_n_s16(32);
+
+  unsigned int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    uint8x16_t y16 = vld1q_u8(y + x);
+    uint8x8x2_t u16 = vzip_u8(vld1_u8(u + x / 2), vld1_u8(u + x / 2));
+    uint8x8x2_t v16 = vzip_u8(vld1_u8(v + x / 2), vld1_u8(v + x / 2));
+
+    for (int half = 0; half < 2; half++, dst += 32)
+    {
+      uint8x8_t y8 = half ? vget_high_u8(y16) : vget_low_u8(y16);
+      int16x8_t yy = vmulq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y8)), offsetY), COEF_Y);
+      int16x8_t uu = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u16.val[half])), offsetUV);
+      int16x8_t vv = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v16.val[half])), offsetUV);
+
+      int16x8_t b = vqaddq_s16(vqaddq_s16(yy, vmulq_n_s16(uu, COEF_BU)), round);
+      int16x8_t g = vqaddq_s16(vqaddq_s16(vqaddq_s16(yy, vmulq_n_s16(uu, COEF_GU)),
+                                          vmulq_n_s16(vv, COEF_GV)), round);
+      int16x8_t r = vqaddq_s16(vqaddq_s16(yy, vmulq_n_s16(vv, COEF_RV)), round);
+
+      uint8x8x4_t px;
+      px.val[0] = vqmovun_s16(vshrq_n_s16(b, 6));
+      px.val[1] = vqmovun_s16(vshrq_n_s16(g, 6));
+      px.val[2] = vqmovun_s16(vshrq_n_s16(r, 6));
+      px.val[3] = vdup_n_u8(0xFF);
+      vst4_u8(dst, px);
+    }
+  }
+  YUVRow_C(y + x, u + x / 2, v + x / 2, dst, width - x);
+}
+#endif
+
+struct CaptureKernels
+{
+  const char* name;
+  void (*swapRedBlue)(uint8_t* dst, const uint8_t* src, unsigned int pixels);
+  void (*setOpaque)(uint8_t* pixels, unsigned int count);
+  void (*downscaleRow)(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, unsigned int dstPixels);
+  void (*yuvRow)(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, unsigned int width);
+};
+
+CaptureKernels SelectKernels()
+{
+  CaptureKernels kernels = { "C", SwapRedBlue_C, SetOpaque_C, DownscaleRow_C, YUVRow_C };
+  unsigned int features = g_cpuInfo.GetCPUFeatures();
+
+#if defined(CAPTURE_KERNELS_SSE2)
+  if (features & CPU_FEATURE_SSE2)
+    kernels = { "SSE2", SwapRedBlue_SSE2, SetOpaque_SSE2, DownscaleRow_SSE2, YUVRow_SSE2 };
+#endif
+#if defined(CAPTURE_KERNELS_AVX2)
+  if ((features & CPU_FEATURE_SSE2) && (features & CPU_FEATURE_AVX2))
+    kernels = { "AVX2", SwapRedBlue_AVX2, SetOpaque_AVX2, DownscaleRow_AVX2, YUVRow_SSE2 };
+#endif
+#if defined(CAPTURE_KERNELS_NEON)
+  if (features & CPU_FEATURE_NEON)
+    kernels = { "NEON", SwapRedBlue_NEON, SetOpaque_NEON, DownscaleRow_NEON, YUVRow_NEON };
+#endif
+
+  CLog::Log(LOGDEBUG, "CRenderCaptureConvert: using %s kernels", kernels.name);
+  return kernels;
+}
+
+const CaptureKernels& GetKernels()
+{
+  static const CaptureKernels kernels = SelectKernels();
+  return kernels;
+}
+
+} // anonymous namespace
+
+void CRenderCaptureConvert::SwapRedBlue(uint8_t* dst, const uint8_t* src, unsigned int pixels)
+{
+  GetKernels().swapRedBlue(dst, src, pixels);
+}
+
+void CRenderCaptureConvert::SetOpaque(uint8_t* pixels, unsigned int width, unsigned int height, unsigned int stride)
+{
+  const CaptureKernels& kernels = GetKernels();
+  for (unsigned int y = 0; y < height; y++)
+    kernels.setOpaque(pixels + y * stride, width);
+}
+
+void CRenderCaptureConvert::Downscale2x(const uint8_t* src, unsigned int width, unsigned int height, unsigned int srcStride,
+                                        uint8_t* dst, unsigned int dstStride)
+{
+  const CaptureKernels& kernels = GetKernels();
+  for (unsigned int y = 0; y < height / 2; y++)
+  {
+    const uint8_t* row0 = src + 2 * y * srcStride;
+    kernels.downscaleRow(row0, row0 + srcStride, dst + y * dstStride, width / 2);
+  }
+}
+
+bool CRenderCaptureConvert::CanBoxDownscale(unsigned int srcWidth, unsigned int srcHeight,
+                                            unsigned int dstWidth, unsigned int dstHeight)
+{
+  if (dstWidth == 0 || dstHeight == 0)
+    return false;
+
+  for (unsigned int shift = 1; (dstWidth << shift) <= srcWidth; shift++)
+  {
+    if ((srcWidth >> shift) == dstWidth)
+      return (srcHeight >> shift) == dstHeight;
+  }
+  return false;
+}
+
+bool CRenderCaptureConvert::BoxDownscale(const uint8_t* src, unsigned int srcWidth, unsigned int srcHeight, unsigned int srcStride,
+                                         uint8_t* dst, unsigned int dstWidth, unsigned int dstHeight, unsigned int dstStride)
+{
+  if (!CanBoxDownscale(srcWidth, srcHeight, dstWidth, dstHeight))
+    return false;
+
+  std::vector<uint8_t> buffers[2];
+  unsigned int width = srcWidth;
+  unsigned int height = srcHeight;
+  int current = 0;
+
+  while (width / 2 != dstWidth)
+  {
+    std::vector<uint8_t>& out = buffers[current];
+    out.resize((width / 2) * (height / 2) * 4);
+    Downscale2x(src, width, height, srcStride, out.data(), (width / 2) * 4);
+
+    width /= 2;
+    height /= 2;
+    src = out.data();
+    srcStride = width * 4;
+    current ^= 1;
+  }
+
+  Downscale2x(src, width, height, srcStride, dst, dstStride);
+  return true;
+}
+
+void CRenderCaptureConvert::YUV420ToBGRA(const uint8_t* srcY, const uint8_t* srcU, const uint8_t* srcV,
+                                         unsigned int strideY, unsigned int strideU, unsigned int strideV,
+                                         unsigned int width, unsigned int height,
+                                         uint8_t* dst, unsigned int dstStride)
+{
+  const CaptureKernels& kernels = GetKernels();
+  for (unsigned int y = 0; y < height; y++)
+  {
+    kernels.yuvRow(srcY + y * strideY, srcU + (y / 2) * strideU, srcV + (y / 2) * strideV,
+                   dst + y * dstStride, width);
+  }
+}
+
+const char* CRenderCaptureConvert::GetKernelName()
+{
+  return GetKernels().name;
+}
@@ -0,0 +1,85 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*!
+ * \brief CPU pixel kernels used for render captures and screenshots.
+ *
+ * Every kernel has a scalar reference implementation plus SSE2, AVX2 and
+ * NEON variants. The variant is picked once, on first use, from the features
+ * reported by CCPUInfo. All variants produce bit-identical output.
+ */
+class CRenderCaptureConvert
+{
+public:
+  /*!
+   * \brief Swap the red and blue channel of 32 bit pixels (BGRA <-> RGBA)
+   * \param dst destination, may be equal to src for an in-place swap
+   * \param src source pixels
+   * \param pixels number of pixels to convert
+   */
+  static void SwapRedBlue(uint8_t* dst, const uint8_t* src, unsigned int pixels);
+
+  /*!
+   * \brief Set the alpha byte of 32 bit BGRA/RGBA pixels to 0xFF
+   */
+  static void SetOpaque(uint8_t* pixels, unsigned int width, unsigned int height, unsigned int stride);
+
+  /*!
+   * \brief Halve a 32 bit image in both directions with a 2x2 box filter
+   *
+   * Output dimensions are width / 2 and height / 2, odd trailing rows and
+   * columns are dropped.
+   */
+  static void Downscale2x(const uint8_t* src, unsigned int width, unsigned int height, unsigned int srcStride,
+                          uint8_t* dst, unsigned int dstStride);
+
+  /*!
+   * \brief Box downscale a 32 bit image by a power of two factor
+   *
+   * Cascades Downscale2x, which rounds at every step, so factors above 2
+   * only approximate an area average and don't match swscale's SWS_AREA.
+   * \return false if the output size is not the input size divided by a power of two
+   */
+  static bool BoxDownscale(const uint8_t* src, unsigned int srcWidth, unsigned int srcHeight, unsigned int srcStride,
+                           uint8_t* dst, unsigned int dstWidth, unsigned int dstHeight, unsigned int dstStride);
+
+  /*!
+   * \brief Check if BoxDownscale can handle the given sizes
+   */
+  static bool CanBoxDownscale(unsigned int srcWidth, unsigned int srcHeight,
+                              unsigned int dstWidth, unsigned int dstHeight);
+
+  /*!
+   * \brief Convert a limited range BT.601 YUV 4:2:0 planar image to BGRA
+   */
+  static void YUV420ToBGRA(const uint8_t* srcY, const uint8_t* srcU, const uint8_t* srcV,
+                           unsigned int strideY, unsigned int strideU, unsigned int strideV,
+                           unsigned int width, unsigned int height,
+                           uint8_t* dst, unsigned int dstStride);
+
+  /*!
+   * \brief Name of the kernel set that was selected, for logging
+   */
+  static const char* GetKernelName();
+};
@@ -28,10 +28,12 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "windowing/WinSystem.h"
 
 #include "Application.h"
 #include "ServiceBroker.h"
+#include "cores/DataCacheCore.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
@@ -49,6 +51,11 @@
 #include "../VideoPlayer/DVDCodecs/Video/DVDVideoCodec.h"
 #include "../VideoPlayer/DVDCodecs/DVDCodecUtils.h"
 
+#include <cmath>
+
+// fewer queued frames make the player hurry the decoder
+#define MIN_QUEUE_DEPTH 3
+
 using namespace KODI::MESSAGING;
 
 void CRenderManager::CClockSync::Reset()
@@ -59,6 +66,52 @@ void CRenderManager::CClockSync::Reset()
   m_enabled = false;
 }
 
+void CRenderManager::CQueueDepth::Reset()
+{
+  m_lastPicture = 0;
+  m_jitter = 0;
+}
+
+void CRenderManager::CQueueDepth::AddPicture(int64_t now, double frameDuration)
+{
+  if (m_lastPicture && frameDuration > 0)
+  {
+    double interval = static_cast<double>(now - m_lastPicture) * 1000 / CurrentHostFrequency();
+    double deviation = std::abs(interval - frameDuration);
+
+    // stalls after seeks or pauses say nothing about the decoder
+    if (deviation < 1000)
+      m_jitter = std::max(deviation, m_jitter * 0.99);
+  }
+  m_lastPicture = now;
+}
+
+int CRenderManager::CQueueDepth::GetTarget(double frameDuration, double refreshPeriod, int maxDepth) const
+{
+  if (frameDuration <= 0)
+    return maxDepth;
+
+  // cover the worst decoder delay plus one refresh for the frame being rendered
+  int target = 1 + static_cast<int>(std::ceil((m_jitter + refreshPeriod) / frameDuration));
+  return std::min(std::max(target, MIN_QUEUE_DEPTH), maxDepth);
+}
+
+void CRenderManager::CPacing::Reset()
+{
+  m_credit = 0;
+  m_shown = 0;
+}
+
+void CRenderManager::CPacing::NextFrame(double ratio)
+{
+  m_credit -= m_shown;
+  // resync if the cadence got off track, e.g. after a pause
+  if (m_credit < -ratio || m_credit > ratio)
+    m_credit = 0;
+  m_credit += ratio;
+  m_shown = 0;
+}
+
 unsigned int CRenderManager::m_nextCaptureId = 0;
 
 CRenderManager::CRenderManager(CDVDClock &clock, IRenderMsg *player) :
@@ -232,7 +285,11 @@ bool CRenderManager::Configure()
     m_bTriggerUpdateResolution = true;
     m_presentstep = PRESENT_IDLE;
     m_presentpts = DVD_NOPTS_VALUE;
+    m_timingPts = DVD_NOPTS_VALUE;
     m_lateframes = -1;
+    m_queueDepth.Reset();
+    m_queueTarget = m_QueueSize - 1;
+    m_pacing.Reset();
     m_presentevent.notifyAll();
     m_renderedOverlay = false;
     m_renderDebug = false;
@@ -287,6 +344,14 @@ void CRenderManager::FrameMove()
   bool firstFrame = false;
   UpdateResolution();
 
+  // the frame rendered on the previous pass has been flipped by now
+  if (m_timingPts != DVD_NOPTS_VALUE)
+  {
+    CServiceBroker::GetDataCacheCore().GetFrameTiming().Stamp(FRAMESTAGE_PRESENT, m_timingPts);
+    CServiceBroker::GetDataCacheCore().GetChannelSwitchTiming().Stamp(SWITCHSTAGE_PRESENT);
+    m_timingPts = DVD_NOPTS_VALUE;
+  }
+
   {
     CSingleLock lock(m_statelock);
 
@@ -331,6 +396,7 @@ void CRenderManager::FrameMove()
     }
 
     // release all previous
+    bool released = false;
     for (std::deque<int>::iterator it = m_discard.begin(); it != m_discard.end(); )
     {
       // renderer may want to keep the frame for postprocessing
@@ -340,11 +406,16 @@ void CRenderManager::FrameMove()
         m_overlays.Release(*it);
         m_free.push_back(*it);
         it = m_discard.erase(it);
+        released = true;
       }
       else
         ++it;
     }
 
+    // wake up the player waiting for a buffer
+    if (released)
+      m_presentevent.notifyAll();
+
     m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
     m_bRenderGUI = true;
   }
@@ -438,6 +509,7 @@ bool CRenderManager::Flush(bool wait)
       m_presentstep = PRESENT_IDLE;
       for (int i = 1; i < m_QueueSize; i++)
         m_free.push_back(i);
+      m_pacing.Reset();
 
       m_flushEvent.Set();
     }
@@ -540,6 +612,8 @@ void CRenderManager::StartRenderCapture(unsigned int captureId, unsigned int wid
     {
       //render capture and read out immediately
       RenderCapture(capture);
+      if (capture->GetState() == CAPTURESTATE_DONE)
+        capture->PublishFrame();
       capture->SetUserState(capture->GetState());
       capture->GetEvent().Set();
     }
@@ -558,30 +632,52 @@ bool CRenderManager::RenderCaptureGetPixels(unsigned int captureId, unsigned int
   if (it == m_captures.end())
     return false;
 
+  CRenderCapture *capture = it->second;
+  bool result = false;
+
   m_captureWaitCounter++;
 
   {
     if (!millis)
       millis = 1000;
 
+    //captures are not deleted while m_captureWaitCounter is non zero, copy without holding
+    //m_captCritSect so the render thread never waits for us
     CSingleExit exitlock(m_captCritSect);
-    if (!it->second->GetEvent().WaitMSec(millis))
-    {
-      m_captureWaitCounter--;
-      return false;
-    }
+    if (capture->GetEvent().WaitMSec(millis) && capture->GetUserState() == CAPTURESTATE_DONE)
+      result = capture->CopyPixels(buffer, size);
   }
 
   m_captureWaitCounter--;
 
-  if (it->second->GetUserState() != CAPTURESTATE_DONE)
+  return result;
+}
+
+bool CRenderManager::RenderCaptureGetLatestPixels(unsigned int captureId, uint8_t *buffer, unsigned int size, unsigned int &frameId)
+{
+  CSingleLock lock(m_captCritSect);
+
+  std::map<unsigned int, CRenderCapture*>::iterator it;
+  it = m_captures.find(captureId);
+  if (it == m_captures.end())
     return false;
 
-  unsigned int srcSize = it->second->GetWidth() * it->second->GetHeight() * 4;
-  unsigned int bytes = std::min(srcSize, size);
+  CRenderCapture *capture = it->second;
+  if (capture->GetFrameId() == frameId)
+    return false;
 
-  memcpy(buffer, it->second->GetPixels(), bytes);
-  return true;
+  bool result;
+
+  m_captureWaitCounter++;
+
+  {
+    CSingleExit exitlock(m_captCritSect);
+    result = capture->CopyPixels(buffer, size, &frameId);
+  }
+
+  m_captureWaitCounter--;
+
+  return result;
 }
 
 void CRenderManager::ManageCaptures()
@@ -590,7 +686,10 @@ void CRenderManager::ManageCaptures()
   if (!m_hasCaptures)
     return;
 
-  CSingleLock lock(m_captCritSect);
+  //a capture is being started or looked up, handle it on the next frame instead of waiting
+  CSingleTryLock lock(m_captCritSect);
+  if (!lock.IsOwner())
+    return;
 
   std::map<unsigned int, CRenderCapture*>::iterator it = m_captures.begin();
   while (it != m_captures.end())
@@ -599,6 +698,12 @@ void CRenderManager::ManageCaptures()
 
     if (capture->GetState() == CAPTURESTATE_NEEDSDELETE)
     {
+      //a reader might still be copying from it, delete it on a later frame
+      if (m_captureWaitCounter > 0)
+      {
+        ++it;
+        continue;
+      }
       delete capture;
       it = m_captures.erase(it);
       continue;
@@ -609,6 +714,13 @@ void CRenderManager::ManageCaptures()
     else if (capture->GetState() == CAPTURESTATE_NEEDSREADOUT)
       capture->ReadOut();
 
+    //the front buffer is being read, keep the frame and try again on the next frame
+    if (capture->GetState() == CAPTURESTATE_DONE && !capture->PublishFrame())
+    {
+      ++it;
+      continue;
+    }
+
     if (capture->GetState() == CAPTURESTATE_DONE || capture->GetState() == CAPTURESTATE_FAILED)
     {
       //tell the thread that the capture is done or has failed
@@ -752,6 +864,7 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
     if (m_presentstep == PRESENT_FRAME)
     {
+      m_timingPts = m.pts;
       if (m.presentmethod == PRESENT_METHOD_BOB)
         m_presentstep = PRESENT_FRAME2;
       else
@@ -961,6 +1074,17 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
   m_free.pop_front();
   m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
 
+  CFrameTiming& frameTiming = CServiceBroker::GetDataCacheCore().GetFrameTiming();
+  frameTiming.Stamp(FRAMESTAGE_QUEUE, picture.pts);
+
+  double frameDuration = m_fps > 0 ? 1000.0 / m_fps : 0;
+  m_queueDepth.AddPicture(CurrentHostCounter(), frameDuration);
+  m_queueTarget = m_queueDepth.GetTarget(frameDuration, 1000.0 / g_graphicsContext.GetFPS(), m_QueueSize - 1);
+  // trick play renders out of cadence, use all buffers
+  if (std::abs(m_dvdClock.GetClockSpeed() - 1.0) > 0.1)
+    m_queueTarget = m_QueueSize - 1;
+  frameTiming.SetQueueDepth(m_queueTarget);
+
   // signal to any waiters to check state
   if (m_presentstep == PRESENT_IDLE)
   {
@@ -974,7 +1098,7 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
     XbmcThreads::EndTime endtime(200);
     while (m_presentstep == PRESENT_READY)
     {
-      m_presentevent.wait(lock, 20);
+      m_presentevent.wait(lock, endtime.MillisLeft());
       if(endtime.IsTimePast() || bStop)
       {
         if (!bStop)
@@ -1048,10 +1172,14 @@ int CRenderManager::WaitForBuffer(volatile std::atomic_bool&bStop, int timeout)
     return 0;
   }
 
+  // the queue is limited to the adaptive depth, a buffer becomes available
+  // when the render thread moves a frame out of the queue
   XbmcThreads::EndTime endtime(timeout);
-  while(m_free.empty())
+  while (m_free.empty() || static_cast<int>(m_queued.size()) >= m_queueTarget)
   {
-    m_presentevent.wait(lock, std::min(50, timeout));
+    if (bStop)
+      return -1;
+    m_presentevent.wait(lock, endtime.MillisLeft());
     if (endtime.IsTimePast() || bStop)
     {
       if (timeout != 0 && !bStop)
@@ -1069,6 +1197,12 @@ int CRenderManager::WaitForBuffer(volatile std::atomic_bool&bStop, int timeout)
   return m_queued.size() + m_discard.size();
 }
 
+void CRenderManager::WakeUpWaiters()
+{
+  CSingleLock lock(m_presentlock);
+  m_presentevent.notifyAll();
+}
+
 void CRenderManager::PrepareNextRender()
 {
   if (m_queued.empty())
@@ -1121,7 +1255,47 @@ void CRenderManager::PrepareNextRender()
     combined = true;
   }
 
-  if (renderPts >= nextFramePts || m_forceNext)
+  bool due = renderPts >= nextFramePts || m_forceNext;
+  bool early = !due && !combined && renderPts > (nextFramePts - frametime);
+
+  // vsyncs per video frame, pacing is needed when this is not an integer
+  double ratio = 0;
+  if (m_fps > 0 && !m_clockSync.m_enabled &&
+      m_Queue[m_presentsource].presentmethod != PRESENT_METHOD_BOB &&
+      std::abs(m_dvdClock.GetClockSpeed() - 1.0) < 0.1)
+  {
+    ratio = DVD_TIME_BASE / frametime / m_fps;
+    double fraction = ratio - std::floor(ratio);
+    if (ratio < 1.0 || fraction < 0.1 || fraction > 0.9)
+      ratio = 0;
+  }
+
+  if (ratio > 0)
+  {
+    // called once per vsync while frames are queued
+    m_pacing.m_shown++;
+
+    // within one refresh of the frame boundary timestamp jitter decides which
+    // vsync gets the frame, follow the cadence instead. Further away the
+    // timestamps win so that the cadence can not drift.
+    double boundary = combined ? nextFramePts : nextFramePts - frametime;
+    if (!m_forceNext && m_pacing.m_credit > 0 && std::abs(renderPts - boundary) < frametime)
+    {
+      if (m_pacing.m_shown < m_pacing.m_credit - 0.5)
+        due = early = false;
+      else if (!due && !early)
+      {
+        if (combined)
+          due = true;
+        else
+          early = true;
+      }
+    }
+  }
+  else
+    m_pacing.Reset();
+
+  if (due)
   {
     // see if any future queued frames are already due
     auto iter = m_queued.begin();
@@ -1147,6 +1321,7 @@ void CRenderManager::PrepareNextRender()
       {
         m_discard.push_back(m_presentsourcePast);
         m_QueueSkip++;
+        CServiceBroker::GetDataCacheCore().GetFrameTiming().AddSkipped();
       }
       m_presentsourcePast = m_queued.front();
       m_queued.pop_front();
@@ -1158,6 +1333,11 @@ void CRenderManager::PrepareNextRender()
     else
       m_lateframes = 0;
 
+    if (lateframes > 0)
+      CServiceBroker::GetDataCacheCore().GetFrameTiming().AddLate();
+    if (ratio > 0)
+      m_pacing.NextFrame(ratio);
+
     m_presentstep = PRESENT_FLIP;
     m_discard.push_back(m_presentsource);
     m_presentsource = idx;
@@ -1165,10 +1345,15 @@ void CRenderManager::PrepareNextRender()
     m_presentpts = m_Queue[idx].pts - m_displayLatency;
     m_presentevent.notifyAll();
 
+    CServiceBroker::GetDataCacheCore().GetFrameTiming().Stamp(FRAMESTAGE_RENDER, m_Queue[idx].pts);
+
     m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
   }
-  else if (!combined && renderPts > (nextFramePts - frametime))
+  else if (early)
   {
+    if (ratio > 0)
+      m_pacing.NextFrame(ratio);
+
     m_lateframes = 0;
     m_presentstep = PRESENT_FLIP;
     m_presentsourcePast = m_presentsource;
@@ -1176,6 +1361,8 @@ void CRenderManager::PrepareNextRender()
     m_queued.pop_front();
     m_presentpts = m_Queue[m_presentsource].pts - m_displayLatency - frametime / 2;
     m_presentevent.notifyAll();
+
+    CServiceBroker::GetDataCacheCore().GetFrameTiming().Stamp(FRAMESTAGE_RENDER, m_Queue[m_presentsource].pts);
   }
 }
 
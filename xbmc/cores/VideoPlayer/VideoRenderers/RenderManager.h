@@ -36,6 +36,7 @@
 #include "PlatformDefs.h"
 #include "threads/Event.h"
 #include "DVDClock.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 
 class CRenderCapture;
 struct VideoPicture;
@@ -90,6 +91,7 @@ public:
   void ReleaseRenderCapture(unsigned int captureId);
   void StartRenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
+  bool RenderCaptureGetLatestPixels(unsigned int captureId, uint8_t *buffer, unsigned int size, unsigned int &frameId);
 
   // Functions called from GUI
   bool Supports(ERENDERFEATURE feature);
@@ -114,12 +116,18 @@ public:
 
   /**
    * If player uses buffering it has to wait for a buffer before it calls
-   * AddVideoPicture and AddOverlay. It waits for max 50 ms before it returns -1
-   * in case no buffer is available. Player may call this in a loop and decides
-   * by itself when it wants to drop a frame.
+   * AddVideoPicture and AddOverlay. It waits for max timeout ms before it returns -1
+   * in case no buffer is available or the queue has reached its adaptive depth.
+   * Player may call this in a loop and decides by itself when it wants to drop a frame.
    */
   int WaitForBuffer(volatile std::atomic_bool& bStop, int timeout = 100);
 
+  /**
+   * Wakes up a player blocked in WaitForBuffer or AddVideoPicture, called
+   * after the player has set its stop flag.
+   */
+  void WakeUpWaiters();
+
   /**
    * Can be called by player for lateness detection. This is done best by
    * looking at the end of the queue.
@@ -226,6 +234,7 @@ protected:
 
   int m_lateframes = -1;
   double m_presentpts = 0.0;
+  double m_timingPts = DVD_NOPTS_VALUE; // pts of the frame presented on the next flip
   EPRESENTSTEP m_presentstep = PRESENT_IDLE;
   XbmcThreads::EndTime m_presentTimer;
   bool m_forceNext = false;
@@ -247,6 +256,32 @@ protected:
   };
   CClockSync m_clockSync;
 
+  /// Picks the number of queued frames from the measured jitter of the decoder
+  /// output. Smooth decoders get a short queue and low latency, bursty ones
+  /// (hw decoders, deinterlacers outputting in pairs) a deeper one.
+  struct CQueueDepth
+  {
+    void Reset();
+    void AddPicture(int64_t now, double frameDuration);
+    int GetTarget(double frameDuration, double refreshPeriod, int maxDepth) const;
+    int64_t m_lastPicture;
+    double m_jitter;   ///< decaying peak deviation from the frame duration in ms
+  };
+  CQueueDepth m_queueDepth;
+  int m_queueTarget = 1;
+
+  /// Keeps the cadence of frame rates that are not a multiple of the refresh
+  /// rate (e.g. 23.976 fps at 60 Hz shown as 3:2) stable while the vsync is
+  /// close to a frame boundary, where timestamp jitter would flip decisions.
+  struct CPacing
+  {
+    void Reset();
+    void NextFrame(double ratio);
+    double m_credit;   ///< vsyncs the current frame is entitled to
+    int m_shown;       ///< vsyncs the current frame has been shown
+  };
+  CPacing m_pacing;
+
   void RenderCapture(CRenderCapture* capture);
   void RemoveCaptures();
   CCriticalSection m_captCritSect;
@@ -0,0 +1,151 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/RenderCaptureConvert.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace
+{
+std::vector<uint8_t> MakeImage(unsigned int size)
+{
+  std::vector<uint8_t> image(size);
+  uint32_t seed = 12345;
+  for (auto& value : image)
+  {
+    seed = seed * 1103515245 + 12345;
+    value = static_cast<uint8_t>(seed >> 16);
+  }
+  return image;
+}
+
+uint8_t Avg(uint8_t a, uint8_t b)
+{
+  return (a + b + 1) >> 1;
+}
+}
+
+// odd sizes so both the vector loops and the scalar tails are exercised
+TEST(TestRenderCaptureConvert, SwapRedBlue)
+{
+  const unsigned int pixels = 131;
+  std::vector<uint8_t> src = MakeImage(pixels * 4);
+  std::vector<uint8_t> dst(pixels * 4);
+
+  CRenderCaptureConvert::SwapRedBlue(dst.data(), src.data(), pixels);
+  for (unsigned int i = 0; i < pixels; i++)
+  {
+    EXPECT_EQ(src[i * 4 + 2], dst[i * 4 + 0]);
+    EXPECT_EQ(src[i * 4 + 1], dst[i * 4 + 1]);
+    EXPECT_EQ(src[i * 4 + 0], dst[i * 4 + 2]);
+    EXPECT_EQ(src[i * 4 + 3], dst[i * 4 + 3]);
+  }
+
+  // in place swap twice restores the original
+  CRenderCaptureConvert::SwapRedBlue(dst.data(), dst.data(), pixels);
+  EXPECT_EQ(src, dst);
+}
+
+TEST(TestRenderCaptureConvert, SetOpaque)
+{
+  const unsigned int width = 37, height = 5, stride = 40 * 4;
+  std::vector<uint8_t> image = MakeImage(stride * height);
+  std::vector<uint8_t> orig = image;
+
+  CRenderCaptureConvert::SetOpaque(image.data(), width, height, stride);
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < stride; x++)
+    {
+      unsigned int i = y * stride + x;
+      if (x < width * 4 && x % 4 == 3)
+        EXPECT_EQ(0xFF, image[i]);
+      else
+        EXPECT_EQ(orig[i], image[i]);
+    }
+  }
+}
+
+TEST(TestRenderCaptureConvert, Downscale2x)
+{
+  const unsigned int width = 75, height = 9;
+  std::vector<uint8_t> src = MakeImage(width * height * 4);
+  std::vector<uint8_t> dst((width / 2) * (height / 2) * 4);
+
+  CRenderCaptureConvert::Downscale2x(src.data(), width, height, width * 4, dst.data(), (width / 2) * 4);
+  for (unsigned int y = 0; y < height / 2; y++)
+  {
+    for (unsigned int x = 0; x < width / 2; x++)
+    {
+      const uint8_t* p0 = &src[(2 * y * width + 2 * x) * 4];
+      const uint8_t* p1 = p0 + width * 4;
+      for (int c = 0; c < 4; c++)
+        EXPECT_EQ(Avg(Avg(p0[c], p1[c]), Avg(p0[c + 4], p1[c + 4])), dst[(y * (width / 2) + x) * 4 + c]);
+    }
+  }
+}
+
+TEST(TestRenderCaptureConvert, BoxDownscale)
+{
+  EXPECT_TRUE(CRenderCaptureConvert::CanBoxDownscale(1920, 1080, 480, 270));
+  EXPECT_TRUE(CRenderCaptureConvert::CanBoxDownscale(1921, 1081, 960, 540));
+  EXPECT_FALSE(CRenderCaptureConvert::CanBoxDownscale(1920, 1080, 640, 360));
+  EXPECT_FALSE(CRenderCaptureConvert::CanBoxDownscale(1920, 1080, 480, 360));
+  EXPECT_FALSE(CRenderCaptureConvert::CanBoxDownscale(1920, 1080, 1920, 1080));
+
+  // a uniform image stays uniform
+  std::vector<uint8_t> src(64 * 32 * 4, 0x80);
+  std::vector<uint8_t> dst(16 * 8 * 4);
+  EXPECT_TRUE(CRenderCaptureConvert::BoxDownscale(src.data(), 64, 32, 64 * 4, dst.data(), 16, 8, 16 * 4));
+  EXPECT_EQ(std::vector<uint8_t>(dst.size(), 0x80), dst);
+}
+
+TEST(TestRenderCaptureConvert, YUV420ToBGRA)
+{
+  const unsigned int width = 35, height = 3;
+  const unsigned int chromaWidth = (width + 1) / 2;
+  std::vector<uint8_t> y = MakeImage(width * height);
+  std::vector<uint8_t> u(chromaWidth * 2, 128);
+  std::vector<uint8_t> v(chromaWidth * 2, 128);
+  std::vector<uint8_t> dst(width * height * 4);
+
+  // without chroma the output is grey: (y - 16) * 255 / 219
+  CRenderCaptureConvert::YUV420ToBGRA(y.data(), u.data(), v.data(), width, chromaWidth, chromaWidth,
+                                      width, height, dst.data(), width * 4);
+  for (unsigned int i = 0; i < width * height; i++)
+  {
+    int expected = (74 * (y[i] - 16) + 32) >> 6;
+    expected = expected < 0 ? 0 : (expected > 255 ? 255 : expected);
+    EXPECT_EQ(expected, dst[i * 4 + 0]);
+    EXPECT_EQ(expected, dst[i * 4 + 1]);
+    EXPECT_EQ(expected, dst[i * 4 + 2]);
+    EXPECT_EQ(0xFF, dst[i * 4 + 3]);
+  }
+
+  // saturated blue
+  y.assign(y.size(), 235);
+  u.assign(u.size(), 240);
+  CRenderCaptureConvert::YUV420ToBGRA(y.data(), u.data(), v.data(), width, chromaWidth, chromaWidth,
+                                      width, height, dst.data(), width * 4);
+  EXPECT_EQ(255, dst[0]);
+  EXPECT_EQ(255, dst[(width * height - 1) * 4]);
+}
@@ -0,0 +1,243 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/VideoPlayer/Edl.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/*
+ * The linear lookups CEdl used before the cut times were precomputed, used as the reference for
+ * the binary searches.
+ */
+class CEdlReference
+{
+public:
+  std::vector<CEdl::Cut> m_cuts; // sorted by start
+  std::vector<int> m_sceneMarkers; // sorted
+
+  int RemoveCutTime(int iSeek) const
+  {
+    int iCutTime = 0;
+    for (const auto& cut : m_cuts)
+    {
+      if (cut.action == CEdl::CUT)
+      {
+        if (iSeek >= cut.start && iSeek <= cut.end)
+          iCutTime += iSeek - cut.start - 1;
+        else if (iSeek >= cut.start)
+          iCutTime += cut.end - cut.start;
+      }
+    }
+    return iSeek - iCutTime;
+  }
+
+  double RestoreCutTime(double dClock) const
+  {
+    double dSeek = dClock;
+    for (const auto& cut : m_cuts)
+    {
+      if (cut.action == CEdl::CUT && dSeek >= cut.start)
+        dSeek += static_cast<double>(cut.end - cut.start);
+    }
+    return dSeek;
+  }
+
+  bool InCut(int iSeek, CEdl::Cut* pCut) const
+  {
+    for (const auto& cut : m_cuts)
+    {
+      if (iSeek < cut.start)
+        return false;
+      if (iSeek <= cut.end)
+      {
+        *pCut = cut;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool GetNearestCut(bool bPlus, int iSeek, CEdl::Cut* pCut) const
+  {
+    if (bPlus)
+    {
+      for (const auto& cut : m_cuts)
+      {
+        if (iSeek <= cut.end)
+        {
+          *pCut = cut;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    for (auto cut = m_cuts.rbegin(); cut != m_cuts.rend(); ++cut)
+    {
+      if ((iSeek - 20000 >= cut->start && iSeek <= cut->end) || iSeek > cut->end)
+      {
+        *pCut = *cut;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool GetNextSceneMarker(bool bPlus, int iClock, int* iSceneMarker) const
+  {
+    int iSeek = RestoreCutTime(iClock);
+    int iDiff = 10 * 60 * 60 * 1000;
+    bool bFound = false;
+    for (int marker : m_sceneMarkers)
+    {
+      int diff = bPlus ? marker - iSeek : iSeek - marker;
+      if (diff > 0 && diff < iDiff)
+      {
+        iDiff = diff;
+        *iSceneMarker = marker;
+        bFound = true;
+      }
+    }
+
+    CEdl::Cut cut;
+    if (bFound && InCut(*iSceneMarker, &cut) && cut.action == CEdl::CUT)
+      *iSceneMarker = cut.end;
+    return bFound;
+  }
+};
+
+std::string TimeString(int ms)
+{
+  return StringUtils::Format("%02i:%02i:%02i.%03i", ms / 3600000, ms / 60000 % 60, ms / 1000 % 60, ms % 1000);
+}
+
+void ExpectSameCut(const CEdl::Cut& expected, const CEdl::Cut& actual, int iSeek)
+{
+  EXPECT_EQ(expected.start, actual.start) << "seek " << iSeek;
+  EXPECT_EQ(expected.end, actual.end) << "seek " << iSeek;
+  EXPECT_EQ(expected.action, actual.action) << "seek " << iSeek;
+}
+
+} // namespace
+
+TEST(TestEdl, MatchesLinearLookups)
+{
+  std::mt19937 rng(20180601);
+
+  for (int round = 0; round < 20; round++)
+  {
+    CEdlReference reference;
+    int numCuts = std::uniform_int_distribution<int>(0, 200)(rng);
+    int position = 0;
+    for (int i = 0; i < numCuts; i++)
+    {
+      CEdl::Cut cut;
+      cut.start = position + std::uniform_int_distribution<int>(1, 60000)(rng);
+      cut.end = cut.start + std::uniform_int_distribution<int>(1, 120000)(rng);
+      cut.action = std::uniform_int_distribution<int>(0, 1)(rng) ? CEdl::CUT : CEdl::MUTE;
+      reference.m_cuts.push_back(cut);
+      position = cut.end;
+    }
+
+    std::vector<int> markers;
+    for (int i = std::uniform_int_distribution<int>(0, 100)(rng); i > 0; i--)
+    {
+      int marker = std::uniform_int_distribution<int>(0, position + 60000)(rng);
+      markers.push_back(marker);
+      CEdl::Cut cut;
+      if (!reference.InCut(marker, &cut) || cut.action != CEdl::CUT)
+        reference.m_sceneMarkers.push_back(marker);
+    }
+    std::sort(reference.m_sceneMarkers.begin(), reference.m_sceneMarkers.end());
+
+    // the cuts come in random order, the scene markers after them so they see every cut
+    std::vector<std::string> lines;
+    for (const auto& cut : reference.m_cuts)
+      lines.push_back(StringUtils::Format("%s %s %i\n", TimeString(cut.start).c_str(),
+                                          TimeString(cut.end).c_str(), cut.action));
+    std::shuffle(lines.begin(), lines.end(), rng);
+    for (int marker : markers)
+      lines.push_back(StringUtils::Format("%s %s 2\n", TimeString(marker).c_str(), TimeString(marker).c_str()));
+
+    XFILE::CFile* file;
+    ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(".edl"));
+    for (const auto& line : lines)
+      ASSERT_EQ(static_cast<ssize_t>(line.size()), file->Write(line.c_str(), line.size()));
+    file->Close();
+
+    CEdl edl;
+    std::string movie = URIUtils::ReplaceExtension(XBMC_TEMPFILEPATH(file), ".mkv");
+    EXPECT_EQ(!lines.empty(), edl.ReadEditDecisionLists(movie, 25.0f, 720));
+    EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+
+    EXPECT_EQ(position + 1 - reference.RemoveCutTime(position + 1), edl.GetTotalCutTime());
+
+    std::vector<int> seeks;
+    for (const auto& cut : reference.m_cuts)
+    {
+      for (int offset : { -20001, -1, 0, 1, 19999, 20000, 20001 })
+      {
+        seeks.push_back(cut.start + offset);
+        seeks.push_back(cut.end + offset);
+      }
+    }
+    for (int i = 0; i < 1000; i++)
+      seeks.push_back(std::uniform_int_distribution<int>(0, position + 60000)(rng));
+
+    for (int iSeek : seeks)
+    {
+      EXPECT_EQ(reference.RemoveCutTime(iSeek), edl.RemoveCutTime(iSeek)) << "seek " << iSeek;
+      EXPECT_EQ(reference.RestoreCutTime(iSeek), edl.RestoreCutTime(iSeek)) << "seek " << iSeek;
+
+      CEdl::Cut expected, actual;
+      bool inCut = reference.InCut(iSeek, &expected);
+      ASSERT_EQ(inCut, edl.InCut(iSeek, &actual)) << "seek " << iSeek;
+      if (inCut)
+        ExpectSameCut(expected, actual, iSeek);
+
+      for (bool bPlus : { true, false })
+      {
+        bool found = reference.GetNearestCut(bPlus, iSeek, &expected);
+        ASSERT_EQ(found, edl.GetNearestCut(bPlus, iSeek, &actual)) << "seek " << iSeek;
+        if (found)
+          ExpectSameCut(expected, actual, iSeek);
+
+        int expectedMarker, actualMarker;
+        found = reference.GetNextSceneMarker(bPlus, iSeek, &expectedMarker);
+        ASSERT_EQ(found, edl.GetNextSceneMarker(bPlus, iSeek, &actualMarker)) << "seek " << iSeek;
+        if (found)
+          EXPECT_EQ(expectedMarker, actualMarker) << "seek " << iSeek;
+      }
+    }
+  }
+}
@@ -27,6 +27,7 @@
 #include "music/tags/MusicInfoTag.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include <algorithm>
 #include <math.h>
 
 CAudioDecoder::CAudioDecoder()
@@ -45,6 +46,7 @@ CAudioDecoder::CAudioDecoder()
   memset(&m_inputBuffer, 0, INPUT_SAMPLES * sizeof(float));
 
   m_rawBufferSize = 0;
+  m_queueSize = 0;
 }
 
 CAudioDecoder::~CAudioDecoder()
@@ -66,7 +68,7 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, unsigned int preDecodeTime)
 {
   Destroy();
 
@@ -102,8 +104,13 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_format.m_sampleRate);
+  /* allocate the pcmBuffer for at least 2 seconds of audio */
+  unsigned int queueSize = QUEUE_TIME * blockSize * m_codec->m_format.m_sampleRate;
+  uint64_t bufferSize = (uint64_t)preDecodeTime * blockSize * m_codec->m_format.m_sampleRate / 1000;
+  bufferSize = std::min<uint64_t>(bufferSize, MAX_PREDECODE_SIZE);
+  bufferSize -= bufferSize % blockSize;
+  m_pcmBuffer.Create(std::max<unsigned int>(queueSize, (unsigned int)bufferSize));
+  m_queueSize = (unsigned int)(std::min(queueSize, m_pcmBuffer.getSize()) * 0.9);
 
   if (file.HasMusicInfoTag())
   {
@@ -267,7 +274,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
         m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
 
         // update status
-        if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmBuffer.getSize() * 0.9)
+        if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_queueSize)
         {
           CLog::Log(LOGINFO, "AudioDecoder: File is queued");
           m_status = STATUS_QUEUED;
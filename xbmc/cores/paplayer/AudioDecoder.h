@@ -37,6 +37,9 @@ class CFileItem;
 #define OUTPUT_SAMPLES PACKET_SIZE      // max number of output samples
 #define INPUT_SAMPLES  PACKET_SIZE      // number of input samples (distributed over channels)
 
+#define QUEUE_TIME         2                   // seconds of audio decoded before a file is queued
+#define MAX_PREDECODE_SIZE (16 * 1024 * 1024)  // memory cap of the pcm buffer when pre-decoding
+
 #define STATUS_NO_FILE  0
 #define STATUS_QUEUING  1
 #define STATUS_QUEUED   2
@@ -55,7 +58,14 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  /*!
+   * \brief Open the codec of the given file
+   * \param preDecodeTime time in ms the pcm buffer should hold, the file is
+   * queued after QUEUE_TIME seconds and the remainder is decoded by ReadSamples
+   * while the stream waits to be started. The buffer is capped at
+   * MAX_PREDECODE_SIZE but never smaller than QUEUE_TIME seconds.
+   */
+  bool Create(const CFileItem &file, int64_t seekOffset, unsigned int preDecodeTime = 0);
   void Destroy();
 
   int ReadSamples(int numsamples);
@@ -80,6 +90,7 @@ public:
 private:
   // pcm buffer
   CRingBuffer m_pcmBuffer;
+  unsigned int m_queueSize;  // bytes in the pcm buffer before the file is queued
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   float m_outputBuffer[OUTPUT_SAMPLES];
@@ -35,7 +35,11 @@
 #include "cores/VideoPlayer/Process/ProcessInfo.h"
 #include "Util.h"
 
-#define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
+#include <algorithm>
+#include <cmath>
+
+#define TIME_TO_CACHE_NEXT_FILE 15000 /* 15 seconds before end of song, start caching the next song */
+#define TIME_TO_PREDECODE       10000 /* decode up to 10 seconds of the next song ahead of the transition */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
@@ -135,6 +139,7 @@ void PAPlayer::SoftStop(bool wait/* = false */, bool close/* = true */)
       si->m_prepareTriggered  = true;
       si->m_playNextTriggered = true;
       si->m_fadeOutTriggered  = true;
+      si->m_fadeOutFrames     = 0;
     }
   }
 
@@ -254,6 +259,7 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
     StreamInfo* si = m_streams.front();
     si->m_playNextAtFrame  = si->m_framesSent; //start next track at current frame
     si->m_prepareTriggered = true; //next track is ready to go
+    si->m_fadeOutFrames    = 0; //fade out the buffered audio right away
   }
   lock.Leave();
 
@@ -332,7 +338,9 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
 
   StreamInfo *si = new StreamInfo();
   si->m_fileItem = file;
-  if (!si->m_decoder.Create(file, si->m_fileItem.m_lStartOffset))
+  // a queued song is pre-decoded while the current one keeps playing
+  unsigned int preDecodeTime = fadeIn ? TIME_TO_PREDECODE : 0;
+  if (!si->m_decoder.Create(file, si->m_fileItem.m_lStartOffset, preDecodeTime))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -384,6 +392,16 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   si->m_volume = (fadeIn && m_upcomingCrossfadeMS) ? 0.0f : 1.0f;
   si->m_fadeOutTriggered = false;
   si->m_isSlaved = false;
+  si->m_fadeInFrames = 0;
+  si->m_fadeOutAtFrame = 0;
+  si->m_fadeOutFrames = 0;
+
+  // fade in on the samples if we can, the stream itself starts at full volume
+  if (fadeIn && m_upcomingCrossfadeMS && CanSampleFade(si->m_audioFormat.m_dataFormat))
+  {
+    si->m_fadeInFrames = (int)(m_upcomingCrossfadeMS * si->m_audioFormat.m_sampleRate / 1000.0f);
+    si->m_volume = 1.0f;
+  }
 
   int64_t streamTotalTime = si->m_decoder.TotalTime();
   if (si->m_endOffset)
@@ -392,10 +410,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   si->m_prepareNextAtFrame = 0;
   // cd drives don't really like it to be crossfaded or prepared
   if(!file.IsCDDA())
-  {
-    if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-      si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
-  }
+    UpdateStreamInfoPrepareNextAtFrame(si, streamTotalTime);
 
   if (m_currentStream && ((m_currentStream->m_audioFormat.m_dataFormat == AE_FMT_RAW) || (si->m_audioFormat.m_dataFormat == AE_FMT_RAW)))
   {
@@ -445,6 +460,113 @@ void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int cros
       si->m_playNextAtFrame = (int)((streamTotalTime / 2) * si->m_audioFormat.m_sampleRate / 1000.0f);
     else
       si->m_playNextAtFrame = (int)((streamTotalTime - crossFadingTime) * si->m_audioFormat.m_sampleRate / 1000.0f);
+
+    // crossfade on the samples if we can. if we got here late the fade starts
+    // with the next frame to be sent
+    si->m_fadeOutAtFrame = std::max(si->m_playNextAtFrame, si->m_framesSent);
+    si->m_fadeOutFrames = 0;
+    if (crossFadingTime && CanSampleFade(si->m_audioFormat.m_dataFormat))
+    {
+      int totalFrames = (int)(streamTotalTime * si->m_audioFormat.m_sampleRate / 1000.0f);
+      int fadeFrames = (int)(crossFadingTime * si->m_audioFormat.m_sampleRate / 1000.0f);
+      si->m_fadeOutFrames = std::max(std::min(fadeFrames, totalFrames - si->m_fadeOutAtFrame), 0);
+    }
+  }
+}
+
+void PAPlayer::UpdateStreamInfoPrepareNextAtFrame(StreamInfo *si, int64_t streamTotalTime)
+{
+  // prepare early enough to pre-decode the start of the next song, short songs
+  // prepare the next one as soon as they play
+  si->m_prepareNextAtFrame = 0;
+  if (streamTotalTime > 0)
+  {
+    int64_t prepareTime = std::max<int64_t>(streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS, 0);
+    si->m_prepareNextAtFrame = std::max((int)(prepareTime * si->m_audioFormat.m_sampleRate / 1000.0f), 1);
+  }
+}
+
+bool PAPlayer::CanSampleFade(AEDataFormat format)
+{
+  switch (format)
+  {
+    case AE_FMT_U8:
+    case AE_FMT_S16NE:
+    case AE_FMT_S32NE:
+    case AE_FMT_FLOAT:
+    case AE_FMT_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool PAPlayer::IsSampleFading(const StreamInfo *si) const
+{
+  return si->m_fadeOutFrames > 0 && si->m_framesSent < si->m_fadeOutAtFrame + si->m_fadeOutFrames;
+}
+
+namespace
+{
+inline void ScaleSample(uint8_t &sample, double gain) { sample = static_cast<uint8_t>(lrint((sample - 128) * gain) + 128); }
+inline void ScaleSample(int16_t &sample, double gain) { sample = static_cast<int16_t>(lrint(sample * gain)); }
+inline void ScaleSample(int32_t &sample, double gain) { sample = static_cast<int32_t>(llrint(sample * gain)); }
+inline void ScaleSample(float &sample, double gain) { sample = static_cast<float>(sample * gain); }
+inline void ScaleSample(double &sample, double gain) { sample *= gain; }
+
+template<typename T, typename G>
+void ScaleFrames(uint8_t *data, unsigned int channels, unsigned int frames, G gain)
+{
+  T *samples = reinterpret_cast<T*>(data);
+  for (unsigned int frame = 0; frame < frames; frame++)
+  {
+    double g = gain(frame);
+    for (unsigned int ch = 0; ch < channels; ch++)
+      ScaleSample(*samples++, g);
+  }
+}
+}
+
+void PAPlayer::ApplySampleFade(StreamInfo *si, uint8_t *data, unsigned int frames)
+{
+  int first = si->m_framesSent;
+  bool fadeIn = first < si->m_fadeInFrames;
+  bool fadeOut = si->m_fadeOutFrames > 0 && first + (int)frames > si->m_fadeOutAtFrame;
+  if (!fadeIn && !fadeOut)
+    return;
+
+  // linear ramps, the gains of both streams of a crossfade add up to one
+  auto gain = [si, first](unsigned int frame)
+  {
+    int pos = first + frame;
+    double g = 1.0;
+    if (pos < si->m_fadeInFrames)
+      g = std::max(pos, 0) / (double)si->m_fadeInFrames;
+    if (si->m_fadeOutFrames > 0 && pos >= si->m_fadeOutAtFrame)
+      g *= std::max(1.0 - (pos - si->m_fadeOutAtFrame) / (double)si->m_fadeOutFrames, 0.0);
+    return g;
+  };
+
+  unsigned int channels = si->m_audioFormat.m_channelLayout.Count();
+  switch (si->m_audioFormat.m_dataFormat)
+  {
+    case AE_FMT_U8:
+      ScaleFrames<uint8_t>(data, channels, frames, gain);
+      break;
+    case AE_FMT_S16NE:
+      ScaleFrames<int16_t>(data, channels, frames, gain);
+      break;
+    case AE_FMT_S32NE:
+      ScaleFrames<int32_t>(data, channels, frames, gain);
+      break;
+    case AE_FMT_FLOAT:
+      ScaleFrames<float>(data, channels, frames, gain);
+      break;
+    case AE_FMT_DOUBLE:
+      ScaleFrames<double>(data, channels, frames, gain);
+      break;
+    default:
+      break;
   }
 }
 
@@ -620,7 +742,8 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
       UpdateGUIData(si); //update for GUI
     }
     /* if the stream is finishing */
-    if ((si->m_playNextTriggered && si->m_stream && !si->m_stream->IsFading()) || !ProcessStream(si, freeBufferTime))
+    if ((si->m_playNextTriggered && si->m_stream && !si->m_stream->IsFading() && !IsSampleFading(si)) ||
+        !ProcessStream(si, freeBufferTime))
     {
       if (!si->m_prepareTriggered)
       {
@@ -680,7 +803,16 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
     }
 
     // it is time to start playing the next stream?
-    if (si->m_playNextAtFrame > 0 && !si->m_playNextTriggered && !si->m_nextFileItem && si->m_framesSent >= si->m_playNextAtFrame)
+    // a sample-accurate fade out starts the next stream once its first faded
+    // frame leaves the stream buffer, so both fades line up in the engine
+    int playNextAtFrame = si->m_playNextAtFrame;
+    int framesPlayed = si->m_framesSent;
+    if (si->m_fadeOutFrames > 0)
+    {
+      playNextAtFrame = si->m_fadeOutAtFrame;
+      framesPlayed -= (int)(si->m_stream->GetCacheTime() * si->m_audioFormat.m_sampleRate);
+    }
+    if (si->m_playNextAtFrame > 0 && !si->m_playNextTriggered && !si->m_nextFileItem && framesPlayed >= playNextAtFrame)
     {
       if (!si->m_prepareTriggered)
       {
@@ -690,7 +822,9 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
 
       if (!m_isFinished)
       {
-        if (m_upcomingCrossfadeMS)
+        if (si->m_fadeOutFrames > 0)
+          si->m_fadeOutTriggered = true;
+        else if (m_upcomingCrossfadeMS)
         {
           si->m_stream->FadeVolume(1.0f, 0.0f, m_upcomingCrossfadeMS);
           si->m_fadeOutTriggered = true;
@@ -715,14 +849,19 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
     si->m_stream->RegisterAudioCallback(m_audioCallback);
     if (!si->m_isSlaved)
       si->m_stream->Resume();
-    si->m_stream->FadeVolume(0.0f, 1.0f, m_upcomingCrossfadeMS);
+    if (!si->m_fadeInFrames)
+      si->m_stream->FadeVolume(0.0f, 1.0f, m_upcomingCrossfadeMS);
     m_callback.OnPlayBackStarted(si->m_fileItem);
   }
 
-  /* if we have not started yet and the stream has been primed */
+  /* if we have not started yet and the stream has been primed, keep filling
+   * the pre-decode buffer */
   unsigned int space = si->m_stream->GetSpace();
   if (!si->m_started && !space)
+  {
+    si->m_decoder.ReadSamples(PACKET_SIZE);
     return true;
+  }
 
   /* see if it is time yet to FF/RW or a direct seek */
   if (!si->m_playNextTriggered && ((m_playbackSpeed != 1 && si->m_framesSent >= si->m_seekNextAtFrame) || si->m_seekFrame > -1))
@@ -734,6 +873,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
       time = (int64_t)((float)si->m_seekFrame / (float)si->m_audioFormat.m_sampleRate * 1000.0f);
       si->m_framesSent = (int)(si->m_seekFrame - ((float)si->m_startOffset * (float)si->m_audioFormat.m_sampleRate) / 1000.0f);
       si->m_seekFrame  = -1;
+      si->m_fadeInFrames = 0;
       m_playerGUIData.m_time = time; //update for GUI
       si->m_seekNextAtFrame = 0;
       CDataCacheCore::GetInstance().SetPlayTimes(0, time, 0, m_playerGUIData.m_totalTime);
@@ -784,14 +924,13 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
         streamTotalTime = si->m_endOffset - si->m_startOffset;
 
       // calculate time when to prepare next stream
-      si->m_prepareNextAtFrame = 0;
-      if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-        si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+      UpdateStreamInfoPrepareNextAtFrame(si, streamTotalTime);
 
       si->m_prepareTriggered = false;
       si->m_playNextAtFrame = 0;
       si->m_playNextTriggered = false;
       si->m_seekNextAtFrame = 0;
+      si->m_fadeOutFrames = 0;
 
       //update the current stream to start playing the next track at the correct frame.
       UpdateStreamInfoPlayNextAtFrame(m_currentStream, m_upcomingCrossfadeMS);
@@ -850,6 +989,7 @@ bool PAPlayer::QueueData(StreamInfo *si)
     }
 
     unsigned int frames = samples/si->m_audioFormat.m_channelLayout.Count();
+    ApplySampleFade(si, data, frames);
     unsigned int added = si->m_stream->AddData(&data, 0, frames, 0);
     si->m_framesSent += added;
   }
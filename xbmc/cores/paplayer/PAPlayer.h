@@ -113,6 +113,9 @@ private:
     bool m_fadeOutTriggered;             /* if the stream has been told to fade out */
     int m_seekNextAtFrame;               /* the FF/RR sample to seek at */
     int m_seekFrame;                     /* the exact position to seek too, -1 for none */
+    int m_fadeInFrames;                  /* length of the sample-accurate fade in, 0 for none */
+    int m_fadeOutAtFrame;                /* first frame of the sample-accurate fade out */
+    int m_fadeOutFrames;                 /* length of the sample-accurate fade out, 0 for none */
 
     IAEStream* m_stream;                 /* the playback stream */
     float m_volume;                      /* the initial volume level to set the stream to on creation */
@@ -154,6 +157,10 @@ private:
   int64_t GetTotalTime64();
   void UpdateCrossfadeTime(const CFileItem& file);
   void UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime);
+  void UpdateStreamInfoPrepareNextAtFrame(StreamInfo *si, int64_t streamTotalTime);
+  bool IsSampleFading(const StreamInfo *si) const;
+  void ApplySampleFade(StreamInfo *si, uint8_t *data, unsigned int frames);
+  static bool CanSampleFade(AEDataFormat format);
   void UpdateGUIData(StreamInfo *si);
   int64_t GetTimeInternal();
   void SetTimeInternal(int64_t time);
@@ -202,6 +202,7 @@
 #define MUSICPLAYER_CONTRIBUTORS    239
 #define MUSICPLAYER_CONTRIBUTOR_AND_ROLE 240
 #define MUSICPLAYER_DBID            241
+#define MUSICPLAYER_SPECTRUM        242
 
 #define VIDEOPLAYER_AUDIO_BITRATE     248
 #define VIDEOPLAYER_VIDEO_BITRATE     249
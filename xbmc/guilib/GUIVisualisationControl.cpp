@@ -44,6 +44,7 @@ using namespace ADDON;
 CAudioBuffer::CAudioBuffer(int iSize)
 {
   m_iLen = iSize;
+  m_hasSpectrum = false;
   m_pBuffer = new float[iSize];
 }
 
@@ -72,6 +73,12 @@ void CAudioBuffer::Set(const float* psBuffer, int iSize)
     m_pBuffer[i] = 0;
 }
 
+void CAudioBuffer::SetSpectrum(const AESpectrum& spectrum)
+{
+  m_spectrum = spectrum;
+  m_hasSpectrum = true;
+}
+
 CGUIVisualisationControl::CGUIVisualisationControl(int parentID, int controlID, float posX, float posY, float width, float height)
   : CGUIControl(parentID, controlID, posX, posY, width, height),
     m_callStart(false),
@@ -264,7 +271,15 @@ void CGUIVisualisationControl::OnAudioData(const float* audioData, unsigned int
   // Save our audio data in the buffers
   std::unique_ptr<CAudioBuffer> pBuffer(new CAudioBuffer(audioDataLength));
   pBuffer->Set(audioData, audioDataLength);
-  //m_vecBuffers.push_back(pBuffer.release());
+
+  // the engine analyzes every viz packet once for all consumers, keep the
+  // spectrum with the samples so both reach the addon in sync
+  if (m_wantsFreq)
+  {
+    AESpectrum spectrum;
+    if (CServiceBroker::GetActiveAE().GetSpectrum(spectrum))
+      pBuffer->SetSpectrum(spectrum);
+  }
   m_vecBuffers.emplace_back(std::move(pBuffer));
 
   if (m_vecBuffers.size() < m_numBuffers)
@@ -273,15 +288,12 @@ void CGUIVisualisationControl::OnAudioData(const float* audioData, unsigned int
   std::unique_ptr<CAudioBuffer> ptrAudioBuffer = std::move(m_vecBuffers.front());
   m_vecBuffers.pop_front();
 
-  // Fourier transform the data if the vis wants it...
   if (m_wantsFreq)
   {
     const float *psAudioData = ptrAudioBuffer->Get();
 
-    if (!m_transform)
-      m_transform.reset(new RFFT(AUDIO_BUFFER_SIZE/2, false)); // half due to stereo
-
-    m_transform->calc(psAudioData, m_freq);
+    if (ptrAudioBuffer->HasSpectrum())
+      memcpy(m_freq, ptrAudioBuffer->GetSpectrum().magnitudes, sizeof(AESpectrum::magnitudes));
 
     // Transfer data to our visualisation
     m_instance->AudioData(psAudioData, ptrAudioBuffer->Size(), m_freq, AUDIO_BUFFER_SIZE/2); // half due to complex-conjugate
@@ -473,7 +485,4 @@ void CGUIVisualisationControl::ClearBuffers()
   {
     m_freq[j] = 0.0f;
   }
-
-  if (m_transform)
-    m_transform.reset();
 }
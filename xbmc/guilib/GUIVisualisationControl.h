@@ -22,7 +22,7 @@
 #include "GUIControl.h"
 #include "addons/Visualization.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
-#include "utils/rfft.h"
+#include "cores/AudioEngine/Utils/AESpectrumAnalyzer.h"
 
 #define AUDIO_BUFFER_SIZE 512 // MUST BE A POWER OF 2!!!
 #define MAX_AUDIO_BUFFERS 16
@@ -35,12 +35,20 @@ public:
   const float* Get() const;
   int Size() const;
   void Set(const float* psBuffer, int iSize);
+  /*!
+   \brief Spectrum of the engine at the time the buffer was queued, if any
+   */
+  bool HasSpectrum() const { return m_hasSpectrum; }
+  const AESpectrum& GetSpectrum() const { return m_spectrum; }
+  void SetSpectrum(const AESpectrum& spectrum);
 private:
   CAudioBuffer(const CAudioBuffer&) = delete;
   CAudioBuffer& operator=(const CAudioBuffer&) = delete;
   CAudioBuffer();
   float* m_pBuffer;
   int m_iLen;
+  bool m_hasSpectrum;
+  AESpectrum m_spectrum;
 };
 
 class CGUIVisualisationControl : public CGUIControl, public IAudioCallback
@@ -90,7 +98,6 @@ private:
   bool m_wantsFreq;
   float m_freq[AUDIO_BUFFER_SIZE]; /*!< Frequency data */
   std::vector<std::string> m_presets; /*!< cached preset list */
-  std::unique_ptr<RFFT> m_transform;
 
   /* values set from "OnInitialize" IAudioCallback  */
   int m_channels;
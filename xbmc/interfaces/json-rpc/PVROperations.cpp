@@ -22,6 +22,7 @@
 
 #include "messaging/ApplicationMessenger.h"
 #include "ServiceBroker.h"
+#include "cores/DataCacheCore.h"
 
 #include "pvr/PVRGUIActions.h"
 #include "pvr/PVRManager.h"
@@ -294,6 +295,16 @@ void CPVROperations::FillChannelGroupDetails(const CPVRChannelGroupPtr &channelG
   }
 }
 
+JSONRPC_STATUS CPVROperations::GetChannelSwitchTimings(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (!CServiceBroker::GetPVRManager().IsStarted())
+    return FailedToExecute;
+
+  CServiceBroker::GetDataCacheCore().GetChannelSwitchTiming().Serialize(result);
+
+  return OK;
+}
+
 JSONRPC_STATUS CPVROperations::GetTimers(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   if (!CServiceBroker::GetPVRManager().IsStarted())
@@ -329,6 +340,45 @@ JSONRPC_STATUS CPVROperations::GetTimerDetails(const std::string &method, ITrans
   return OK;
 }
 
+JSONRPC_STATUS CPVROperations::GetTimerConflicts(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (!CServiceBroker::GetPVRManager().IsStarted())
+    return FailedToExecute;
+
+  CPVRTimersPtr timers = CServiceBroker::GetPVRManager().Timers();
+  if (!timers)
+    return FailedToExecute;
+
+  std::vector<CPVRTimerInfoTagPtr> conflicts;
+  int iTimerId = static_cast<int>(parameterObject["timerid"].asInteger());
+  if (iTimerId >= 0)
+  {
+    CPVRTimerInfoTagPtr timer = timers->GetById(iTimerId);
+    if (!timer)
+      return InvalidParams;
+
+    conflicts = timers->GetConflictingTimers(timer);
+  }
+  else
+  {
+    CDateTime start, end;
+    start.SetFromDBDateTime(parameterObject["start"].asString());
+    end.SetFromDBDateTime(parameterObject["end"].asString());
+    if (!start.IsValid() || !end.IsValid() || end < start)
+      return InvalidParams;
+
+    conflicts = timers->GetOverlappingTimers(start, end);
+  }
+
+  CFileItemList timerList;
+  for (const auto &timer : conflicts)
+    timerList.Add(CFileItemPtr(new CFileItem(timer)));
+
+  HandleFileItemList("timerid", false, "timers", timerList, parameterObject, result, true);
+
+  return OK;
+}
+
 JSONRPC_STATUS CPVROperations::AddTimer(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   if (!CServiceBroker::GetPVRManager().IsStarted())
@@ -39,6 +39,9 @@
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/recordings/PVRRecordings.h"
+#include "cores/DataCacheCore.h"
+#include "cores/AudioEngine/Interfaces/AE.h"
+#include "cores/AudioEngine/Utils/AESpectrumAnalyzer.h"
 #include "cores/IPlayer.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "SeekHandler.h"
@@ -260,6 +263,22 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const std::string &method, ITransportL
   return OK;
 }
 
+JSONRPC_STATUS CPlayerOperations::GetFrameTimings(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  switch (GetPlayer(parameterObject["playerid"]))
+  {
+    case Video:
+      CServiceBroker::GetDataCacheCore().GetFrameTiming().Serialize(result);
+      return OK;
+
+    case Audio:
+    case Picture:
+    case None:
+    default:
+      return FailedToExecute;
+  }
+}
+
 JSONRPC_STATUS CPlayerOperations::PlayPause(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
@@ -1730,6 +1749,38 @@ JSONRPC_STATUS CPlayerOperations::GetPropertyValue(PlayerType player, const std:
   }
   else if (property == "live")
     result = IsPVRChannel();
+  else if (property == "spectrum")
+  {
+    switch (player)
+    {
+      case Video:
+      case Audio:
+      {
+        result = CVariant(CVariant::VariantTypeObject);
+        result["samplerate"] = 0;
+        result["left"] = CVariant(CVariant::VariantTypeArray);
+        result["right"] = CVariant(CVariant::VariantTypeArray);
+
+        // polling keeps the engine analyzing, the first call only starts it
+        AESpectrum spectrum;
+        if (CServiceBroker::GetActiveAE().GetSpectrum(spectrum))
+        {
+          result["samplerate"] = spectrum.sampleRate;
+          for (unsigned int i = 0; i < AESpectrum::BINS; i++)
+          {
+            result["left"].append(spectrum.magnitudes[2 * i]);
+            result["right"].append(spectrum.magnitudes[2 * i + 1]);
+          }
+        }
+        break;
+      }
+
+      case Picture:
+      default:
+        result = CVariant(CVariant::VariantTypeNull);
+        break;
+    }
+  }
   else
     return InvalidParams;
 
@@ -49,6 +49,7 @@ namespace XBMCAddon
       unsigned int m_captureId;
       unsigned int m_width;
       unsigned int m_height;
+      unsigned int m_frameId;
       uint8_t *m_buffer;
 
     public:
@@ -58,6 +59,7 @@ namespace XBMCAddon
         m_buffer = nullptr;
         m_width = 0;
         m_height = 0;
+        m_frameId = 0;
       }
       //! @todo Switch to 'override' usage once 14.04 (Trusty) hits EOL. swig <3.0 doesn't understand C++11
       inline virtual ~RenderCapture()
@@ -160,6 +162,33 @@ namespace XBMCAddon
         return XbmcCommons::Buffer(m_buffer, size);
       }
 
+#ifdef DOXYGEN_SHOULD_USE_THIS
+      ///
+      /// \ingroup python_xbmc_RenderCapture
+      /// @brief \python_func{ getLatestImage() }
+      ///-----------------------------------------------------------------------
+      /// Returns the most recent captured image as a bytearray without
+      /// waiting for the renderer.
+      ///
+      /// @return                    Captured image as a bytearray, empty if
+      ///                            no image was captured since the last call
+      ///
+      /// @note The size of the image is m_width * m_height * 4
+      ///-----------------------------------------------------------------------
+      /// @python_v18 New function added.
+      ///
+      getLatestImage()
+#else
+      inline XbmcCommons::Buffer getLatestImage()
+#endif
+      {
+        if (!g_application.GetAppPlayer().RenderCaptureGetLatestPixels(m_captureId, m_buffer, m_width*m_height*4, m_frameId))
+          return XbmcCommons::Buffer(0);
+
+        size_t size = m_width * m_height * 4;
+        return XbmcCommons::Buffer(m_buffer, size);
+      }
+
 #ifdef DOXYGEN_SHOULD_USE_THIS
       ///
       /// \ingroup python_xbmc_RenderCapture
@@ -185,6 +214,7 @@ namespace XBMCAddon
         m_captureId = g_application.GetAppPlayer().RenderCaptureAlloc();
         m_width = width;
         m_height = height;
+        m_frameId = 0;
         m_buffer = new uint8_t[m_width*m_height*4];
         g_application.GetAppPlayer().RenderCapture(m_captureId, m_width, m_height, CAPTUREFLAG_CONTINUOUS);
       }
@@ -181,7 +181,8 @@ void CMusicDatabase::CreateTables()
               " lastplayed varchar(20) default NULL, "
               " rating FLOAT NOT NULL DEFAULT 0, votes INTEGER NOT NULL DEFAULT 0, "
               " userrating INTEGER NOT NULL DEFAULT 0, "
-              " comment text, mood text, strReplayGain text, dateAdded text)");
+              " comment text, mood text, strReplayGain text, dateAdded text, "
+              " bLoudnessFailed INTEGER NOT NULL DEFAULT 0)");
   CLog::Log(LOGINFO, "create song_artist table");
   m_pDS->exec("CREATE TABLE song_artist (idArtist integer, idSong integer, idRole integer, iOrder integer, strArtist text)");
   CLog::Log(LOGINFO, "create song_genre table");
@@ -750,7 +751,8 @@ int CMusicDatabase::UpdateSong(int idSong,
   else
     strSQL += PrepareSQL(", iTimesPlayed = %i, iStartOffset = %i, iEndOffset = %i, lastplayed = NULL, rating = %.1f, userrating = %i, votes = %i, comment = '%s', mood = '%s', strReplayGain = '%s'",
                          iTimesPlayed, iStartOffset, iEndOffset, rating, userrating, votes, strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
-  strSQL += PrepareSQL(" WHERE idSong = %i", idSong);
+  // the file was scanned again, retry the loudness analysis
+  strSQL += PrepareSQL(", bLoudnessFailed = 0 WHERE idSong = %i", idSong);
 
   bool status = ExecuteQuery(strSQL);
 
@@ -5261,6 +5263,11 @@ void CMusicDatabase::UpdateTables(int version)
     // Update all songs iStartOffset and iEndOffset to milliseconds instead of frames (* 1000 / 75)
     m_pDS->exec("UPDATE song SET iStartOffset = iStartOffset * 40 / 3, iEndOffset = iEndOffset * 40 / 3 \n");
   }
+  if (version < 71)
+  {
+    // Remember songs whose loudness could not be measured, so they are not decoded again on every scan
+    m_pDS->exec("ALTER TABLE song ADD bLoudnessFailed INTEGER NOT NULL DEFAULT 0 \n");
+  }
 
   // Set the verion of tag scanning required. 
   // Not every schema change requires the tags to be rescanned, set to the highest schema version 
@@ -5281,7 +5288,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 70;
+  return 71;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -6240,6 +6247,70 @@ bool CMusicDatabase::SetSongVotes(const std::string &filePath, int votes)
   return false;
 }
 
+bool CMusicDatabase::GetSongsWithoutReplayGain(std::vector<CSong>& songs, int idAlbumAfter /* = -1 */)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string sql = PrepareSQL("SELECT * FROM songview "
+                                 "WHERE (strReplayGain IS NULL OR strReplayGain = '') AND idAlbum > %i "
+                                 "AND idSong IN (SELECT idSong FROM song WHERE bLoudnessFailed = 0) "
+                                 "ORDER BY idAlbum, iTrack", idAlbumAfter);
+    if (!m_pDS->query(sql)) return false;
+    while (!m_pDS->eof())
+    {
+      songs.emplace_back(GetSongFromDataset());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CMusicDatabase::SetSongReplayGain(int idSong, const ReplayGain& replayGain)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string sql = PrepareSQL("UPDATE song SET strReplayGain = '%s' WHERE idSong = %i",
+                                 replayGain.Get().c_str(), idSong);
+    m_pDS->exec(sql);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%i) failed", __FUNCTION__, idSong);
+  }
+  return false;
+}
+
+bool CMusicDatabase::SetSongLoudnessFailed(int idSong)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string sql = PrepareSQL("UPDATE song SET bLoudnessFailed = 1 WHERE idSong = %i", idSong);
+    m_pDS->exec(sql);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%i) failed", __FUNCTION__, idSong);
+  }
+  return false;
+}
+
 int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
 {
   // grab the where string to identify the song id
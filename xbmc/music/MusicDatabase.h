@@ -209,6 +209,17 @@ public:
   bool RemoveSongsFromPath(const std::string &path, MAPSONGS& songs, bool exact=true);
   bool SetSongUserrating(const std::string &filePath, int userrating);
   bool SetSongVotes(const std::string &filePath, int votes);
+  /*!
+   \brief Get the songs that have neither album nor track ReplayGain, ordered by album.
+   Songs whose loudness could not be measured are skipped until they are scanned again.
+   \param idAlbumAfter only return songs of albums with a higher id
+   */
+  bool GetSongsWithoutReplayGain(std::vector<CSong>& songs, int idAlbumAfter = -1);
+  bool SetSongReplayGain(int idSong, const ReplayGain& replayGain);
+  /*!
+   \brief Mark a song whose loudness could not be measured, reset when the song is updated
+   */
+  bool SetSongLoudnessFailed(int idSong);
   int  GetSongByArtistAndAlbumAndTitle(const std::string& strArtist, const std::string& strAlbum, const std::string& strTitle);
 
   /////////////////////////////////////////////////
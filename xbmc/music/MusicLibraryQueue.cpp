@@ -22,13 +22,18 @@
 
 #include <utility>
 
+#include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "dialogs/GUIDialogProgress.h"
 #include "guilib/GUIWindowManager.h"
+#include "guilib/LocalizeStrings.h"
 #include "GUIUserMessages.h"
 #include "music/jobs/MusicLibraryCleaningJob.h"
 #include "music/jobs/MusicLibraryExportJob.h"
+#include "music/jobs/MusicLibraryLoudnessJob.h"
 #include "music/jobs/MusicLibraryScanningJob.h"
 #include "music/jobs/MusicLibraryJob.h"
+#include "ServiceBroker.h"
+#include "settings/Settings.h"
 #include "threads/SingleLock.h"
 #include "Util.h"
 #include "utils/Variant.h"
@@ -111,6 +116,28 @@ void CMusicLibraryQueue::StartArtistScan(const std::string& strDirectory, bool r
   AddJob(new CMusicLibraryScanningJob(strDirectory, flags, true));
 }
 
+void CMusicLibraryQueue::AnalyseLoudness(bool showProgress /* = true */, int idAlbumAfter /* = -1 */)
+{
+  if (idAlbumAfter < 0)
+  {
+    CSingleLock lock(m_critical);
+    MusicLibraryJobMap::const_iterator loudnessJobs = m_jobs.find("MusicLibraryLoudnessJob");
+    if (loudnessJobs != m_jobs.end() && !loudnessJobs->second.empty())
+      return;
+  }
+
+  CGUIDialogProgressBarHandle* progress = nullptr;
+  if (showProgress && !CServiceBroker::GetSettings().GetBool(CSettings::SETTING_MUSICLIBRARY_BACKGROUNDUPDATE))
+  {
+    CGUIDialogExtendedProgressBar* dialog =
+      g_windowManager.GetWindow<CGUIDialogExtendedProgressBar>(WINDOW_DIALOG_EXT_PROGRESS);
+    if (dialog)
+      progress = dialog->GetHandle(g_localizeStrings.Get(14253));
+  }
+
+  AddJob(new CMusicLibraryLoudnessJob(progress, idAlbumAfter));
+}
+
 bool CMusicLibraryQueue::IsScanningLibrary() const
 {
   // check if the library is being cleaned synchronously
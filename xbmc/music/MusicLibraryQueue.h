@@ -76,6 +76,14 @@ public:
    */
   void StartArtistScan(const std::string& strDirectory, bool refresh = false);
 
+  /*!
+   \brief Enqueue a job measuring the loudness of songs without ReplayGain.
+   \param[in] showProgress Whether or not to show a progress bar
+   \param[in] idAlbumAfter Only analyse songs of albums with a higher id, -1 for all songs.
+   A request for all songs is ignored while an analysis is queued or running.
+   */
+  void AnalyseLoudness(bool showProgress = true, int idAlbumAfter = -1);
+
   /*!
    \brief Check if a library scan or cleaning is in progress.
    \return True if a scan or clean is in progress, false otherwise
@@ -0,0 +1,304 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MusicLibraryLoudnessJob.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string.h>
+
+#include "FileItem.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "cores/AudioEngine/Utils/AELoudnessMeter.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "cores/paplayer/ICodec.h"
+#include "guilib/LocalizeStrings.h"
+#include "music/MusicDatabase.h"
+#include "music/MusicLibraryQueue.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+// songs analysed by one job, the rest is left to the next job in the queue
+#define LOUDNESS_BATCH_SIZE 100
+
+// bytes read from the codec at a time
+#define LOUDNESS_READ_SIZE (32 * 1024)
+
+namespace
+{
+struct SongResult
+{
+  bool valid = false;
+  double loudness = 0.0;
+  double peak = 0.0;
+  std::vector<double> blocks;
+};
+
+class CLoudnessWorker : public IRunnable
+{
+public:
+  CLoudnessWorker(const std::vector<CSong>& songs, std::vector<SongResult>& results,
+                  std::atomic_uint& next, std::atomic_uint& done, CEvent& doneEvent,
+                  const std::atomic_bool& cancel)
+    : m_songs(songs), m_results(results), m_next(next), m_done(done), m_doneEvent(doneEvent), m_cancel(cancel)
+  { }
+
+  void Run() override
+  {
+    CAELoudnessMeter meter;
+    unsigned int index;
+    while (!m_cancel && (index = m_next++) < m_songs.size())
+    {
+      SongResult& result = m_results[index];
+      if (CMusicLibraryLoudnessJob::Analyse(m_songs[index], meter, m_cancel))
+      {
+        result.loudness = meter.GetIntegratedLoudness();
+        result.peak = meter.GetTruePeak();
+        result.blocks = meter.GetBlocks();
+        result.valid = !std::isinf(result.loudness);
+      }
+      m_done++;
+      m_doneEvent.Set();
+    }
+  }
+
+private:
+  const std::vector<CSong>& m_songs;
+  std::vector<SongResult>& m_results;
+  std::atomic_uint& m_next;
+  std::atomic_uint& m_done;
+  CEvent& m_doneEvent;
+  const std::atomic_bool& m_cancel;
+};
+}
+
+CMusicLibraryLoudnessJob::CMusicLibraryLoudnessJob(CGUIDialogProgressBarHandle* progressBar, int idAlbumAfter)
+  : CMusicLibraryProgressJob(progressBar),
+    m_idAlbumAfter(idAlbumAfter),
+    m_cancel(false)
+{ }
+
+CMusicLibraryLoudnessJob::~CMusicLibraryLoudnessJob() = default;
+
+bool CMusicLibraryLoudnessJob::Cancel()
+{
+  m_cancel = true;
+  return true;
+}
+
+bool CMusicLibraryLoudnessJob::Analyse(const CSong& song, CAELoudnessMeter& meter, const std::atomic_bool& cancel)
+{
+  CFileItem item(song);
+  std::unique_ptr<ICodec> codec(CodecFactory::CreateCodecDemux(item, 0));
+  if (!codec || !codec->Init(item, 0))
+  {
+    CLog::Log(LOGDEBUG, "CMusicLibraryLoudnessJob::Analyse - unable to open %s", song.strFileName.c_str());
+    return false;
+  }
+
+  const AEAudioFormat& format = codec->m_format;
+  unsigned int channels = format.m_channelLayout.Count();
+  switch (format.m_dataFormat)
+  {
+    case AE_FMT_U8:
+    case AE_FMT_S16NE:
+    case AE_FMT_S32NE:
+    case AE_FMT_FLOAT:
+    case AE_FMT_DOUBLE:
+      break;
+    default:
+      CLog::Log(LOGDEBUG, "CMusicLibraryLoudnessJob::Analyse - unsupported format %s for %s",
+                CAEUtil::DataFormatToStr(format.m_dataFormat), song.strFileName.c_str());
+      return false;
+  }
+  if (!meter.Init(format.m_channelLayout, format.m_sampleRate))
+    return false;
+
+  // songs of a cue sheet are a part of the file
+  if (song.iStartOffset && !codec->Seek(song.iStartOffset))
+    return false;
+  int64_t framesLeft = -1;
+  if (song.iEndOffset)
+    framesLeft = (int64_t)(song.iEndOffset - song.iStartOffset) * format.m_sampleRate / 1000;
+
+  unsigned int bytesPerSample = CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3;
+  unsigned int bytesPerFrame = bytesPerSample * channels;
+  std::vector<uint8_t> input(LOUDNESS_READ_SIZE - LOUDNESS_READ_SIZE % bytesPerFrame);
+  std::vector<float> samples(input.size() / bytesPerSample);
+  unsigned int pending = 0;
+
+  while (!cancel && framesLeft != 0)
+  {
+    int size = 0;
+    int result = codec->ReadPCM(input.data() + pending, input.size() - pending, &size);
+    if (result == READ_ERROR)
+      return false;
+
+    // the codec may return partial frames, keep them for the next read
+    size += pending;
+    unsigned int frames = size / bytesPerFrame;
+    if (framesLeft > 0)
+      frames = (unsigned int)std::min<int64_t>(frames, framesLeft);
+    unsigned int count = frames * channels;
+
+    switch (format.m_dataFormat)
+    {
+      case AE_FMT_U8:
+        for (unsigned int i = 0; i < count; i++)
+          samples[i] = (input[i] - 128) * (1.0f / 128.0f);
+        break;
+      case AE_FMT_S16NE:
+        CAEKernels::S16ToFloat(samples.data(), reinterpret_cast<const int16_t*>(input.data()), count);
+        break;
+      case AE_FMT_S32NE:
+        CAEKernels::S32ToFloat(samples.data(), reinterpret_cast<const int32_t*>(input.data()), count);
+        break;
+      case AE_FMT_FLOAT:
+        memcpy(samples.data(), input.data(), count * sizeof(float));
+        break;
+      case AE_FMT_DOUBLE:
+      {
+        const double* src = reinterpret_cast<const double*>(input.data());
+        for (unsigned int i = 0; i < count; i++)
+          samples[i] = static_cast<float>(src[i]);
+        break;
+      }
+      default:
+        break;
+    }
+    meter.AddFrames(samples.data(), frames);
+
+    if (framesLeft > 0)
+      framesLeft -= frames;
+    pending = size - frames * bytesPerFrame;
+    if (pending)
+      memmove(input.data(), input.data() + frames * bytesPerFrame, pending);
+
+    if (result == READ_EOF)
+      break;
+  }
+
+  return !cancel;
+}
+
+bool CMusicLibraryLoudnessJob::Work(CMusicDatabase &db)
+{
+  std::vector<CSong> songs;
+  if (!db.GetSongsWithoutReplayGain(songs, m_idAlbumAfter))
+    return false;
+  if (songs.empty())
+    return true;
+
+  // finish whole albums, the album gain needs all of their songs
+  bool more = false;
+  if (songs.size() > LOUDNESS_BATCH_SIZE)
+  {
+    auto end = songs.begin() + LOUDNESS_BATCH_SIZE;
+    int idAlbum = (end - 1)->idAlbum;
+    while (end != songs.end() && end->idAlbum == idAlbum)
+      ++end;
+    more = end != songs.end();
+    songs.erase(end, songs.end());
+  }
+
+  SetTitle(g_localizeStrings.Get(14253));
+  CLog::Log(LOGDEBUG, "CMusicLibraryLoudnessJob::Work - analysing %u songs", (unsigned int)songs.size());
+
+  std::vector<SongResult> results(songs.size());
+  std::atomic_uint next(0);
+  std::atomic_uint done(0);
+  CEvent doneEvent;
+  unsigned int workers = std::min<unsigned int>(std::max(g_cpuInfo.getCPUCount(), 1), songs.size());
+
+  CLoudnessWorker worker(songs, results, next, done, doneEvent, m_cancel);
+  std::vector<std::unique_ptr<CThread>> threads;
+  for (unsigned int i = 0; i < workers; i++)
+  {
+    threads.emplace_back(new CThread(&worker, "MusicLoudness"));
+    threads.back()->Create();
+    threads.back()->SetPriority(threads.back()->GetMinPriority());
+  }
+
+  while (done < songs.size() && !m_cancel)
+  {
+    doneEvent.WaitMSec(500);
+    if (CProgressJob::ShouldCancel(done, songs.size()))
+      m_cancel = true;
+  }
+  for (auto& thread : threads)
+    thread->StopThread(true);
+
+  if (m_cancel)
+    return false;
+
+  // store track gains, and album gains for albums that were measured completely
+  db.BeginTransaction();
+  for (size_t first = 0; first < songs.size();)
+  {
+    size_t last = first;
+    while (last < songs.size() && songs[last].idAlbum == songs[first].idAlbum)
+      last++;
+
+    bool albumComplete = songs[first].idAlbum > 0 &&
+      db.GetSongsCount(CDatabase::Filter(db.PrepareSQL("songview.idAlbum = %i", songs[first].idAlbum))) == (int)(last - first);
+    std::vector<double> albumBlocks;
+    double albumPeak = 0.0;
+    for (size_t i = first; i < last; i++)
+    {
+      albumComplete &= results[i].valid;
+      albumBlocks.insert(albumBlocks.end(), results[i].blocks.begin(), results[i].blocks.end());
+      albumPeak = std::max(albumPeak, results[i].peak);
+    }
+    double albumLoudness = CAELoudnessMeter::GetIntegratedLoudness(albumBlocks);
+
+    for (size_t i = first; i < last; i++)
+    {
+      if (!results[i].valid)
+      {
+        db.SetSongLoudnessFailed(songs[i].idSong);
+        continue;
+      }
+
+      ReplayGain replayGain;
+      replayGain.SetGain(ReplayGain::TRACK, (float)CAELoudnessMeter::GetReplayGain(results[i].loudness));
+      replayGain.SetPeak(ReplayGain::TRACK, (float)results[i].peak);
+      if (albumComplete && !std::isinf(albumLoudness))
+      {
+        replayGain.SetGain(ReplayGain::ALBUM, (float)CAELoudnessMeter::GetReplayGain(albumLoudness));
+        replayGain.SetPeak(ReplayGain::ALBUM, (float)albumPeak);
+      }
+      db.SetSongReplayGain(songs[i].idSong, replayGain);
+    }
+    first = last;
+  }
+  db.CommitTransaction();
+
+  // continue with the next batch behind whatever else was queued meanwhile,
+  // songs that failed are retried once they are scanned again
+  if (more)
+    CMusicLibraryQueue::GetInstance().AnalyseLoudness(GetProgressBar() != nullptr, songs.back().idAlbum);
+
+  return true;
+}
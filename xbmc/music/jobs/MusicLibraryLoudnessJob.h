@@ -0,0 +1,70 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <vector>
+
+#include "music/jobs/MusicLibraryProgressJob.h"
+
+class CAELoudnessMeter;
+class CSong;
+
+/*!
+ \brief Music library job measuring the loudness of songs without ReplayGain.
+
+ Songs are decoded and measured after EBU R128 on one worker thread per CPU
+ core. The integrated loudness and true peak are stored as track ReplayGain,
+ albums that were measured completely also get album ReplayGain. The job works
+ on batches of songs and queues itself again while songs are left, so that it
+ does not hold up other library jobs for long.
+ */
+class CMusicLibraryLoudnessJob : public CMusicLibraryProgressJob
+{
+public:
+  /*!
+   \brief Creates a new loudness analysis job.
+   \param[in] progressBar Progress bar to be used to display the analysis progress
+   \param[in] idAlbumAfter Only analyse songs of albums with a higher id, used to continue after a batch
+  */
+  CMusicLibraryLoudnessJob(CGUIDialogProgressBarHandle* progressBar, int idAlbumAfter);
+  ~CMusicLibraryLoudnessJob() override;
+
+  // specialization of CJob
+  const char *GetType() const override { return "MusicLibraryLoudnessJob"; }
+
+  // implementation of CMusicLibraryJob
+  bool CanBeCancelled() const override { return true; }
+  bool Cancel() override;
+
+  /*!
+   \brief Decode a song and feed it to the given meter.
+   \return false if the song could not be decoded completely
+   */
+  static bool Analyse(const CSong& song, CAELoudnessMeter& meter, const std::atomic_bool& cancel);
+
+protected:
+  // implementation of CMusicLibraryJob
+  bool Work(CMusicDatabase &db) override;
+
+private:
+  int m_idAlbumAfter;
+  std::atomic_bool m_cancel;
+};
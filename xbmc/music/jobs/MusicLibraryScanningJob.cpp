@@ -20,6 +20,9 @@
 
 #include "MusicLibraryScanningJob.h"
 #include "music/MusicDatabase.h"
+#include "music/MusicLibraryQueue.h"
+#include "ServiceBroker.h"
+#include "settings/Settings.h"
 
 CMusicLibraryScanningJob::CMusicLibraryScanningJob(const std::string& directory, int flags, bool showProgress /* = true */) 
   : m_scanner(),
@@ -62,8 +65,14 @@ bool CMusicLibraryScanningJob::Work(CMusicDatabase &db)
     // Scrape additional artist information
     m_scanner.FetchArtistInfo(m_directory, m_flags & MUSIC_INFO::CMusicInfoScanner::SCAN_RESCAN);
   else
+  {
     // Scan tags from music files, and optionally scrape artist and album info
     m_scanner.Start(m_directory, m_flags);
 
+    // Measure the loudness of songs that came without ReplayGain
+    if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_MUSICLIBRARY_ANALYSELOUDNESS))
+      CMusicLibraryQueue::GetInstance().AnalyseLoudness(m_showProgress);
+  }
+
   return true;
 }
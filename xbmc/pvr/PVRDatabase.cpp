@@ -287,8 +287,7 @@ int CPVRDatabase::Get(CPVRChannelGroup &results, bool bCompressDB)
                                         CPVRChannelNumber(static_cast<unsigned int>(m_pDS->fv("iChannelNumber").get_asInt()),
                                                           static_cast<unsigned int>(m_pDS->fv("iSubChannelNumber").get_asInt())),
                                         0);
-        results.m_sortedMembers.emplace_back(newMember);
-        results.m_members.insert(std::make_pair(channel->StorageId(), newMember));
+        results.AddMember(newMember);
 
         m_pDS->next();
         ++iReturn;
@@ -593,8 +592,7 @@ int CPVRDatabase::Get(CPVRChannelGroup &group, const CPVRChannelGroup &allGroup)
                                           CPVRChannelNumber(static_cast<unsigned int>(m_pDS->fv("iChannelNumber").get_asInt()),
                                                             static_cast<unsigned int>(m_pDS->fv("iSubChannelNumber").get_asInt())),
                                           0);
-          group.m_sortedMembers.emplace_back(newMember);
-          group.m_members.insert(std::make_pair(channel->second->StorageId(), newMember));
+          group.AddMember(newMember);
           ++iReturn;
         }
         else
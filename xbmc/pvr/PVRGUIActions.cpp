@@ -23,6 +23,7 @@
 #include "Application.h"
 #include "FileItem.h"
 #include "ServiceBroker.h"
+#include "cores/DataCacheCore.h"
 #include "dialogs/GUIDialogBusy.h"
 #include "dialogs/GUIDialogKaiToast.h"
 #include "dialogs/GUIDialogNumeric.h"
@@ -650,6 +651,8 @@ namespace PVR
     else
       timer->m_state = PVR_TIMER_STATE_DISABLED;
 
+    CServiceBroker::GetPVRManager().Timers()->TimerStateChanged(timer);
+
     if (CServiceBroker::GetPVRManager().Timers()->UpdateTimer(timer))
       return true;
 
@@ -1163,6 +1166,7 @@ namespace PVR
         }
       }
 
+      CServiceBroker::GetDataCacheCore().GetChannelSwitchTiming().Begin(channel->ChannelName());
       StartPlayback(new CFileItem(channel), bFullscreen);
       return true;
     }
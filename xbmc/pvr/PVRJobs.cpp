@@ -78,6 +78,18 @@ bool CPVRChannelInfoTimeoutJob::DoWork()
   return false;
 }
 
+bool CPVRChannelPreTuneJob::DoWork()
+{
+  for (const auto &channel : m_channels)
+  {
+    if (ShouldCancel(0, 0))
+      return false;
+
+    CServiceBroker::GetPVRManager().PreTuneChannel(channel);
+  }
+  return true;
+}
+
 bool CPVRPlayChannelOnStartupJob::DoWork()
 {
   return CServiceBroker::GetPVRManager().GUIActions()->PlayChannelOnStartup();
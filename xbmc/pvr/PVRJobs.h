@@ -66,6 +66,18 @@ namespace PVR
     XbmcThreads::EndTime m_delayTimer;
   };
 
+  class CPVRChannelPreTuneJob : public CJob
+  {
+  public:
+    explicit CPVRChannelPreTuneJob(const std::vector<CPVRChannelPtr> &channels) : m_channels(channels) {}
+    ~CPVRChannelPreTuneJob() override = default;
+    const char *GetType() const override { return "pvr-channel-pretune"; }
+
+    bool DoWork() override;
+  private:
+    std::vector<CPVRChannelPtr> m_channels;
+  };
+
   class CPVREventlogJob : public CJob
   {
   public:
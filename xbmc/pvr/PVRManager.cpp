@@ -20,14 +20,17 @@
 
 #include "PVRManager.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "ServiceBroker.h"
 #include "guilib/LocalizeStrings.h"
 #include "interfaces/AnnouncementManager.h"
 #include "messaging/ApplicationMessenger.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "threads/SystemClock.h"
+#include "threads/Thread.h"
 #include "utils/JobManager.h"
 #include "utils/Stopwatch.h"
 #include "utils/StringUtils.h"
@@ -51,6 +54,22 @@ using namespace PVR;
 using namespace ANNOUNCEMENT;
 using namespace KODI::MESSAGING;
 
+// stream urls may contain session tokens, keep the properties of pre-tuned channels only for a short while
+static const unsigned int PRETUNE_EXPIRY_MS = 30000;
+
+namespace
+{
+  class CPVRRecordingsLoader : public IRunnable
+  {
+  public:
+    explicit CPVRRecordingsLoader(const CPVRRecordingsPtr &recordings) : m_recordings(recordings) {}
+    void Run() override { m_recordings->Load(); }
+
+  private:
+    CPVRRecordingsPtr m_recordings;
+  };
+}
+
 CPVRManagerJobQueue::CPVRManagerJobQueue()
 : m_triggerEvent(false),
   m_bStopped(true)
@@ -529,6 +548,7 @@ bool CPVRManager::LoadComponents(CPVRGUIProgressHandler* progressHandler)
     return false;
 
   CLog::Log(LOGDEBUG, "PVRManager - %s - active clients found. continue to start", __FUNCTION__);
+  const unsigned int iStart = XbmcThreads::SystemClockMillis();
 
   /* load all channels and groups */
   if (progressHandler)
@@ -540,17 +560,23 @@ bool CPVRManager::LoadComponents(CPVRGUIProgressHandler* progressHandler)
   SetChanged();
   NotifyObservers(ObservableMessageChannelGroupsLoaded);
 
-  /* get timers from the backends */
+  /* get timers and recordings from the backends, a slow timer backend doesn't delay the recordings */
+  CPVRRecordingsLoader recordingsLoader(m_recordings);
+  CThread recordingsThread(&recordingsLoader, "PVRRecordingsLoader");
+  recordingsThread.Create();
+
   if (progressHandler)
     progressHandler->UpdateProgress(g_localizeStrings.Get(19237), 50); // Loading timers from clients
 
   m_timers->Load();
 
-  /* get recordings from the backend */
   if (progressHandler)
     progressHandler->UpdateProgress(g_localizeStrings.Get(19238), 75); // Loading recordings from clients
 
-  m_recordings->Load();
+  recordingsThread.StopThread(true);
+
+  CLog::Log(LOGNOTICE, "PVRManager - %s - channels, timers and recordings loaded in %u ms", __FUNCTION__,
+            XbmcThreads::SystemClockMillis() - iStart);
 
   if (!IsInitialising())
     return false;
@@ -759,6 +785,7 @@ void CPVRManager::OnPlaybackStarted(const CFileItemPtr item)
     m_playingChannel = channel;
     SetPlayingGroup(channel);
     UpdateLastWatched(channel);
+    PreTuneAdjacentChannels(channel);
   }
   else if (item->HasPVRRecordingInfoTag())
   {
@@ -879,7 +906,37 @@ void CPVRManager::SearchMissingChannelIcons(void)
 bool CPVRManager::FillStreamFileItem(CFileItem &fileItem)
 {
   if (fileItem.IsPVRChannel())
+  {
+    CFileItemPtr preTunedItem;
+    {
+      CSingleLock lock(m_preTunedSection);
+      const auto it = m_preTunedItems.find(fileItem.GetPVRChannelInfoTag()->ChannelID());
+      if (it != m_preTunedItems.end())
+      {
+        if (!it->second.second.IsTimePast())
+          preTunedItem = it->second.first;
+        m_preTunedItems.erase(it);
+      }
+    }
+
+    if (preTunedItem)
+    {
+      CLog::Log(LOGDEBUG, "PVRManager - %s - using pre-tuned stream properties of channel '%s'",
+          __FUNCTION__, fileItem.GetPVRChannelInfoTag()->ChannelName().c_str());
+
+      if (preTunedItem->GetDynPath() != preTunedItem->GetPath())
+        fileItem.SetDynPath(preTunedItem->GetDynPath());
+      if (!preTunedItem->GetMimeType().empty())
+      {
+        fileItem.SetMimeType(preTunedItem->GetMimeType());
+        fileItem.SetContentLookup(false);
+      }
+      fileItem.AppendProperties(*preTunedItem);
+      return true;
+    }
+
     return m_addons->FillChannelStreamFileItem(fileItem);
+  }
   else if (fileItem.IsPVRRecording())
     return m_addons->FillRecordingStreamFileItem(fileItem);
   else if (fileItem.IsEPG())
@@ -888,6 +945,47 @@ bool CPVRManager::FillStreamFileItem(CFileItem &fileItem)
     return false;
 }
 
+void CPVRManager::PreTuneChannel(const CPVRChannelPtr &channel)
+{
+  const CFileItemPtr item(new CFileItem(channel));
+  if (!m_addons->FillChannelStreamFileItem(*item))
+    return;
+
+  CSingleLock lock(m_preTunedSection);
+  m_preTunedItems[channel->ChannelID()] = std::make_pair(item, XbmcThreads::EndTime(PRETUNE_EXPIRY_MS));
+}
+
+void CPVRManager::PreTuneAdjacentChannels(const CPVRChannelPtr &channel)
+{
+  {
+    CSingleLock lock(m_preTunedSection);
+    m_preTunedItems.clear();
+  }
+
+  if (!g_advancedSettings.m_bPVRPreTuneChannels)
+    return;
+
+  const CPVRChannelGroupPtr group = GetPlayingGroup(channel->IsRadio());
+  if (!group)
+    return;
+
+  std::vector<CPVRChannelPtr> channels;
+  const CFileItemPtr adjacentItems[] = { group->GetNextChannel(channel), group->GetPreviousChannel(channel) };
+  for (const auto &item : adjacentItems)
+  {
+    if (!item || !item->HasPVRChannelInfoTag())
+      continue;
+
+    const CPVRChannelPtr adjacentChannel = item->GetPVRChannelInfoTag();
+    if (adjacentChannel != channel && !IsParentalLocked(adjacentChannel) &&
+        std::find(channels.begin(), channels.end(), adjacentChannel) == channels.end())
+      channels.push_back(adjacentChannel);
+  }
+
+  if (!channels.empty())
+    CJobManager::GetInstance().AddJob(new CPVRChannelPreTuneJob(channels), nullptr);
+}
+
 void CPVRManager::TriggerEpgsCreate(void)
 {
   m_pendingUpdates.AppendJob(new CPVREpgsCreateJob());
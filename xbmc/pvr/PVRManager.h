@@ -20,6 +20,7 @@
  */
 
 #include <atomic>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -28,6 +29,7 @@
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
 #include "interfaces/IAnnouncer.h"
 #include "threads/Event.h"
+#include "threads/SystemClock.h"
 #include "threads/Thread.h"
 #include "utils/EventStream.h"
 #include "utils/JobManager.h"
@@ -358,6 +360,12 @@ namespace PVR
      */
     bool FillStreamFileItem(CFileItem &fileItem);
 
+    /*!
+     * @brief Obtain the stream properties of a channel ahead of playback. The next FillStreamFileItem call for the channel uses them if they are still fresh.
+     * @param channel The channel.
+     */
+    void PreTuneChannel(const CPVRChannelPtr &channel);
+
     /*!
      * @brief Let the background thread create epg tags for all channels.
      */
@@ -499,6 +507,12 @@ namespace PVR
      */
     void SetPlayingGroup(const CPVRChannelPtr &channel);
 
+    /*!
+     * @brief Pre-tune the channels before and after the given channel in the playing group, if enabled in advancedsettings.xml
+     * @param channel The playing channel
+     */
+    void PreTuneAdjacentChannels(const CPVRChannelPtr &channel);
+
     /*!
      * @brief Executes "pvrpowermanagement.setwakeupcmd"
      */
@@ -585,5 +599,8 @@ namespace PVR
     CPVRChannelPtr m_playingChannel;
     CPVRRecordingPtr m_playingRecording;
     CPVREpgInfoTagPtr m_playingEpgTag;
+
+    CCriticalSection m_preTunedSection;
+    std::map<int, std::pair<CFileItemPtr, XbmcThreads::EndTime>> m_preTunedItems; /*!< stream file items of pre-tuned channels and their expiry, by channel id */
   };
 }
@@ -20,6 +20,8 @@
 
 #include "PVRClients.h"
 
+#include <map>
+#include <memory>
 #include <utility>
 #include <functional>
 
@@ -28,6 +30,7 @@
 #include "addons/BinaryAddonCache.h"
 #include "guilib/LocalizeStrings.h"
 #include "messaging/ApplicationMessenger.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 
 #include "pvr/PVRJobs.h"
@@ -795,11 +798,11 @@ PVR_ERROR CPVRClients::GetTimerTypes(CPVRTimerTypes& results, int iClientId) con
   });
 }
 
-PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings, bool deleted)
+PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings, bool deleted, std::vector<int> &failedClients)
 {
   return ForCreatedClients(__FUNCTION__, [recordings, deleted](const CPVRClientPtr &client) {
     return client->GetRecordings(recordings, deleted);
-  });
+  }, failedClients);
 }
 
 PVR_ERROR CPVRClients::RenameRecording(const CPVRRecording &recording)
@@ -905,13 +908,37 @@ PVR_ERROR CPVRClients::IsPlayable(const CConstPVREpgInfoTagPtr& tag, bool &bIsPl
 
 PVR_ERROR CPVRClients::GetChannels(CPVRChannelGroupInternal *group, std::vector<int> &failedClients)
 {
-  return ForCreatedClients(__FUNCTION__, [group](const CPVRClientPtr &client) {
-    return client->GetChannels(*group, group->IsRadio());
+  /* fetch the channels of all clients at once, each client into a group of its own, so a slow
+     backend doesn't delay the others. merge them in client order afterwards, which numbers the
+     channels the same way as fetching one client after the other did */
+  CCriticalSection critSection;
+  std::map<int, std::shared_ptr<CPVRChannelGroupInternal>> clientChannels;
+
+  PVR_ERROR error = ForCreatedClientsInParallel(__FUNCTION__, [group, &critSection, &clientChannels](const CPVRClientPtr &client) {
+    std::shared_ptr<CPVRChannelGroupInternal> channels(new CPVRChannelGroupInternal(group->IsRadio()));
+    channels->SetPreventSortAndRenumber();
+    {
+      CSingleLock lock(critSection);
+      clientChannels.insert(std::make_pair(client->GetID(), channels));
+    }
+    return client->GetChannels(*channels, group->IsRadio());
   }, failedClients);
+
+  for (const auto &clientEntry : clientChannels)
+  {
+    const CPVRChannelGroup &channels = *clientEntry.second;
+    for (const auto &member : channels.GetMembers())
+      group->UpdateFromClient(member.channel, CPVRChannelNumber());
+  }
+
+  return error;
 }
 
 PVR_ERROR CPVRClients::GetChannelGroups(CPVRChannelGroups *groups, std::vector<int> &failedClients)
 {
+  /* groups and group members are fetched one client after the other: the transfer callbacks
+     persist the groups and look the members up in the channel groups container, both under the
+     lock of the container that is loading */
   return ForCreatedClients(__FUNCTION__, [groups](const CPVRClientPtr &client) {
     return client->GetChannelGroups(groups);
   }, failedClients);
@@ -1124,6 +1151,60 @@ PVR_ERROR CPVRClients::ForCreatedClients(const char* strFunctionName, PVRClientF
   return lastError;
 }
 
+namespace
+{
+  class CPVRClientCall : public IRunnable
+  {
+  public:
+    CPVRClientCall(const CPVRClientPtr &client, const std::function<PVR_ERROR(const CPVRClientPtr&)> &function) :
+      m_client(client), m_function(function) {}
+
+    void Run() override { m_error = m_function(m_client); }
+    PVR_ERROR GetError() const { return m_error; }
+
+  private:
+    const CPVRClientPtr m_client;
+    const std::function<PVR_ERROR(const CPVRClientPtr&)> &m_function;
+    PVR_ERROR m_error = PVR_ERROR_NO_ERROR;
+  };
+}
+
+PVR_ERROR CPVRClients::ForCreatedClientsInParallel(const char* strFunctionName, PVRClientFunction function, std::vector<int> &failedClients) const
+{
+  PVR_ERROR lastError = PVR_ERROR_NO_ERROR;
+
+  CPVRClientMap clients;
+  GetCreatedClients(clients, failedClients);
+
+  std::vector<std::unique_ptr<CPVRClientCall>> calls;
+  std::vector<std::unique_ptr<CThread>> threads;
+  for (const auto &clientEntry : clients)
+  {
+    calls.emplace_back(new CPVRClientCall(clientEntry.second, function));
+    threads.emplace_back(new CThread(calls.back().get(), "PVRClientCall"));
+    threads.back()->Create();
+  }
+
+  for (auto &thread : threads)
+    thread->StopThread(true);
+
+  auto call = calls.begin();
+  for (const auto &clientEntry : clients)
+  {
+    PVR_ERROR currentError = (*call++)->GetError();
+
+    if (currentError != PVR_ERROR_NO_ERROR && currentError != PVR_ERROR_NOT_IMPLEMENTED)
+    {
+      CLog::Log(LOGERROR,
+                "CPVRClients - %s - client '%s' returned an error: %s",
+                strFunctionName, clientEntry.second->GetFriendlyName().c_str(), CPVRClient::ToString(currentError));
+      lastError = currentError;
+      failedClients.emplace_back(clientEntry.first);
+    }
+  }
+  return lastError;
+}
+
 PVR_ERROR CPVRClients::ForCreatedClient(const char* strFunctionName, int iClientId, PVRClientFunction function) const
 {
   PVR_ERROR error = PVR_ERROR_UNKNOWN;
@@ -402,9 +402,10 @@ namespace PVR
      * @brief Get all recordings from clients
      * @param recordings Store the recordings in this container.
      * @param deleted If true, return deleted recordings, return not deleted recordings otherwise.
+     * @param failedClients in case of errors will contain the ids of the clients for which the recordings could not be obtained.
      * @return PVR_ERROR_NO_ERROR if the operation succeeded, the respective PVR_ERROR value otherwise.
      */
-    PVR_ERROR GetRecordings(CPVRRecordings *recordings, bool deleted);
+    PVR_ERROR GetRecordings(CPVRRecordings *recordings, bool deleted, std::vector<int> &failedClients);
 
     /*!
      * @brief Rename a recording on the backend.
@@ -688,6 +689,15 @@ namespace PVR
      */
     PVR_ERROR ForCreatedClients(const char* strFunctionName, PVRClientFunction function, std::vector<int> &failedClients) const;
 
+    /*!
+     * @brief Like ForCreatedClients, but calls every client on a thread of its own and waits for all of them.
+     * @param strFunctionName The function name, for logging purposes.
+     * @param function The function to wrap. It is called concurrently for different clients, so it must only touch data of the client it is called for.
+     * @param failedClients Contains a list of the ids of clients for that the call failed, if any.
+     * @return PVR_ERROR_NO_ERROR on success, any other PVR_ERROR_* value otherwise.
+     */
+    PVR_ERROR ForCreatedClientsInParallel(const char* strFunctionName, PVRClientFunction function, std::vector<int> &failedClients) const;
+
     /*!
      * @brief Wraps a call to a created client in order to do common pre and post function invocation actions.
      * @param strFunctionName The function name, for logging purposes.
@@ -20,6 +20,8 @@
 
 #include "PVRChannel.h"
 
+#include <atomic>
+
 #include "ServiceBroker.h"
 #include "filesystem/File.h"
 #include "guilib/LocalizeStrings.h"
@@ -37,6 +39,8 @@
 
 using namespace PVR;
 
+static std::atomic<unsigned int> iIdChangeCount(0);
+
 bool CPVRChannel::operator==(const CPVRChannel &right) const
 {
   return (m_bIsRadio  == right.m_bIsRadio &&
@@ -178,6 +182,7 @@ bool CPVRChannel::CreateEPG(bool bForce)
       if (epg->EpgID() != m_iEpgId)
       {
         m_iEpgId = epg->EpgID();
+        ++iIdChangeCount;
         m_bChanged = true;
       }
       return true;
@@ -236,6 +241,11 @@ bool CPVRChannel::Persist()
   return false;
 }
 
+unsigned int CPVRChannel::GetIdChangeCount(void)
+{
+  return iIdChangeCount;
+}
+
 bool CPVRChannel::SetChannelID(int iChannelId)
 {
   CSingleLock lock(m_critSection);
@@ -243,6 +253,7 @@ bool CPVRChannel::SetChannelID(int iChannelId)
   {
     /* update the id */
     m_iChannelId = iChannelId;
+    ++iIdChangeCount;
     SetChanged();
     m_bChanged = true;
 
@@ -778,6 +789,7 @@ void CPVRChannel::SetEpgID(int iEpgId)
   if (m_iEpgId != iEpgId)
   {
     m_iEpgId = iEpgId;
+    ++iIdChangeCount;
     SetChanged();
     m_bChanged = true;
   }
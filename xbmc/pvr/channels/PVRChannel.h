@@ -102,6 +102,13 @@ namespace PVR
      */
     bool SetChannelID(int iDatabaseId);
 
+    /*!
+     * @brief Get a counter that is increased whenever the channel ID or the EPG ID of any channel changes.
+     * Used to detect outdated lookup indices.
+     * @return The current counter value.
+     */
+    static unsigned int GetIdChangeCount(void);
+
     /*!
      * @brief Set the channel number for this channel.
      * @param channelNumber The new channel number
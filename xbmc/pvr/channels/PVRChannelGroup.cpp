@@ -186,6 +186,7 @@ void CPVRChannelGroup::Unload(void)
   CSingleLock lock(m_critSection);
   m_sortedMembers.clear();
   m_members.clear();
+  InvalidateLookupIndices();
   m_failedClientsForChannels.clear();
   m_failedClientsForChannelGroupMembers.clear();
 }
@@ -224,6 +225,7 @@ bool CPVRChannelGroup::SetChannelNumber(const CPVRChannelPtr &channel, const CPV
         m_bChanged = true;
         bReturn = true;
         member.channelNumber = channelNumber;
+        InvalidateLookupIndices();
       }
       break;
     }
@@ -324,6 +326,26 @@ struct sortByChannelNumber
   }
 };
 
+/*!
+ * @brief Sort the members, only touching them if they are out of order.
+ * Usually the members are sorted already or only new members were appended, which are merged in linear time.
+ * @return True if the order changed, false otherwise.
+ */
+template<typename Compare>
+static bool SortMembers(PVR_CHANNEL_GROUP_SORTED_MEMBERS &members, Compare compare)
+{
+  const auto unsorted = std::is_sorted_until(members.begin(), members.end(), compare);
+  if (unsorted == members.end())
+    return false;
+
+  if (std::is_sorted(unsorted, members.end(), compare))
+    std::inplace_merge(members.begin(), unsorted, members.end(), compare);
+  else
+    std::sort(members.begin(), members.end(), compare);
+
+  return true;
+}
+
 bool CPVRChannelGroup::SortAndRenumber(void)
 {
   if (PreventSortAndRenumber())
@@ -343,15 +365,55 @@ bool CPVRChannelGroup::SortAndRenumber(void)
 void CPVRChannelGroup::SortByClientChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
-  if (!PreventSortAndRenumber())
-    sort(m_sortedMembers.begin(), m_sortedMembers.end(), sortByClientChannelNumber());
+  if (!PreventSortAndRenumber() && SortMembers(m_sortedMembers, sortByClientChannelNumber()))
+    InvalidateLookupIndices();
 }
 
 void CPVRChannelGroup::SortByChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
-  if (!PreventSortAndRenumber())
-    sort(m_sortedMembers.begin(), m_sortedMembers.end(), sortByChannelNumber());
+  if (!PreventSortAndRenumber() && SortMembers(m_sortedMembers, sortByChannelNumber()))
+    InvalidateLookupIndices();
+}
+
+void CPVRChannelGroup::AddMember(const PVRChannelGroupMember &member)
+{
+  CSingleLock lock(m_critSection);
+  m_sortedMembers.emplace_back(member);
+  m_members.insert(std::make_pair(member.channel->StorageId(), member));
+  InvalidateLookupIndices();
+}
+
+void CPVRChannelGroup::InvalidateLookupIndices(void)
+{
+  CSingleLock lock(m_critSection);
+  m_bLookupIndicesValid = false;
+}
+
+void CPVRChannelGroup::UpdateLookupIndices(void) const
+{
+  CSingleLock lock(m_critSection);
+
+  const unsigned int iIdChangeCount = CPVRChannel::GetIdChangeCount();
+  if (m_bLookupIndicesValid && m_iLookupIndicesIdChangeCount == iIdChangeCount)
+    return;
+
+  m_channelNumberIndex.clear();
+  m_channelIdIndex.clear();
+  m_channelEpgIdIndex.clear();
+
+  // emplace keeps the first member for duplicate keys, matching the order of the former linear searches
+  for (const auto& member : m_sortedMembers)
+    m_channelNumberIndex.emplace(member.channelNumber, member.channel);
+
+  for (const auto& member : m_members)
+  {
+    m_channelIdIndex.emplace(member.second.channel->ChannelID(), member.second.channel);
+    m_channelEpgIdIndex.emplace(member.second.channel->EpgID(), member.second.channel);
+  }
+
+  m_bLookupIndicesValid = true;
+  m_iLookupIndicesIdChangeCount = iIdChangeCount;
 }
 
 bool CPVRChannelGroup::UpdateClientPriorities()
@@ -407,30 +469,20 @@ CPVRChannelPtr CPVRChannelGroup::GetByUniqueID(int iUniqueChannelId, int iClient
 
 CPVRChannelPtr CPVRChannelGroup::GetByChannelID(int iChannelID) const
 {
-  CPVRChannelPtr retval;
   CSingleLock lock(m_critSection);
+  UpdateLookupIndices();
 
-  for (PVR_CHANNEL_GROUP_MEMBERS::const_iterator it = m_members.begin(); !retval && it != m_members.end(); ++it)
-  {
-    if (it->second.channel->ChannelID() == iChannelID)
-      retval = it->second.channel;
-  }
-
-  return retval;
+  const auto it = m_channelIdIndex.find(iChannelID);
+  return it != m_channelIdIndex.end() ? it->second : CPVRChannelPtr();
 }
 
 CPVRChannelPtr CPVRChannelGroup::GetByChannelEpgID(int iEpgID) const
 {
-  CPVRChannelPtr retval;
   CSingleLock lock(m_critSection);
+  UpdateLookupIndices();
 
-  for (PVR_CHANNEL_GROUP_MEMBERS::const_iterator it = m_members.begin(); !retval && it != m_members.end(); ++it)
-  {
-    if (it->second.channel->EpgID() == iEpgID)
-      retval = it->second.channel;
-  }
-
-  return retval;
+  const auto it = m_channelEpgIdIndex.find(iEpgID);
+  return it != m_channelEpgIdIndex.end() ? it->second : CPVRChannelPtr();
 }
 
 CFileItemPtr CPVRChannelGroup::GetLastPlayedChannel(int iCurrentChannel /* = -1 */) const
@@ -462,16 +514,11 @@ CPVRChannelNumber CPVRChannelGroup::GetChannelNumber(const CPVRChannelPtr &chann
 
 CFileItemPtr CPVRChannelGroup::GetByChannelNumber(const CPVRChannelNumber &channelNumber) const
 {
-  CFileItemPtr retval;
   CSingleLock lock(m_critSection);
+  UpdateLookupIndices();
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); !retval && it != m_sortedMembers.end(); ++it)
-  {
-    if ((*it).channelNumber == channelNumber)
-      retval = CFileItemPtr(new CFileItem((*it).channel));
-  }
-
-  return retval;
+  const auto it = m_channelNumberIndex.find(channelNumber);
+  return it != m_channelNumberIndex.end() ? CFileItemPtr(new CFileItem(it->second)) : CFileItemPtr();
 }
 
 CFileItemPtr CPVRChannelGroup::GetNextChannel(const CPVRChannelPtr &channel) const
@@ -658,6 +705,7 @@ bool CPVRChannelGroup::RemoveDeletedChannels(const CPVRChannelGroup &channels)
           __FUNCTION__, m_bRadio ? "radio" : "TV", (*it).channel->ChannelName().c_str(), GroupName().c_str());
 
       m_members.erase((*it).channel->StorageId());
+      InvalidateLookupIndices();
 
       //we need a copy of our iterators data so that we can find it later on
       //if the vector has changed.
@@ -749,6 +797,7 @@ bool CPVRChannelGroup::RemoveFromGroup(const CPVRChannelPtr &channel)
       //! @todo notify observers
       m_members.erase((*it).channel->StorageId());
       it = m_sortedMembers.erase(it);
+      InvalidateLookupIndices();
       bReturn = true;
       m_bChanged = true;
       break;
@@ -789,8 +838,7 @@ bool CPVRChannelGroup::AddToGroup(const CPVRChannelPtr &channel, const CPVRChann
 
       PVRChannelGroupMember newMember(realChannel);
       newMember.channelNumber = CPVRChannelNumber(iChannelNumber, channelNumber.GetSubChannelNumber());
-      m_sortedMembers.push_back(newMember);
-      m_members.insert(std::make_pair(realChannel.channel->StorageId(), newMember));
+      AddMember(newMember);
       m_bChanged = true;
 
       SortAndRenumber();
@@ -811,13 +859,10 @@ bool CPVRChannelGroup::IsGroupMember(const CPVRChannelPtr &channel) const
 
 bool CPVRChannelGroup::IsGroupMember(int iChannelId) const
 {
-  bool bReturn(false);
   CSingleLock lock(m_critSection);
+  UpdateLookupIndices();
 
-  for (PVR_CHANNEL_GROUP_MEMBERS::const_iterator it = m_members.begin(); !bReturn && it != m_members.end(); ++it)
-    bReturn = (iChannelId == it->second.channel->ChannelID());
-
-  return bReturn;
+  return m_channelIdIndex.find(iChannelId) != m_channelIdIndex.end();
 }
 
 bool CPVRChannelGroup::SetGroupName(const std::string &strGroupName, bool bSaveInDb /* = false */)
@@ -915,6 +960,9 @@ bool CPVRChannelGroup::Renumber(void)
     }
   }
 
+  if (bReturn)
+    InvalidateLookupIndices();
+
   SortByChannelNumber();
   ResetChannelNumberCache();
 
@@ -21,6 +21,7 @@
 
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -67,6 +68,7 @@ namespace PVR
   {
     friend class CPVRChannelGroupInternal;
     friend class CPVRDatabase;
+    friend class TestPVRChannelGroupHelper;
 
   public:
     CPVRChannelGroup(void);
@@ -511,6 +513,17 @@ namespace PVR
      */
     void SortByChannelNumber(void);
 
+    /*!
+     * @brief Add a member to both member containers.
+     * @param member The new member.
+     */
+    void AddMember(const PVRChannelGroupMember &member);
+
+    /*!
+     * @brief Mark the lookup indices as outdated. Must be called after members were added or removed or channel numbers changed.
+     */
+    void InvalidateLookupIndices(void);
+
     /*!
      * @brief Update the priority for all members of all channel groups.
      */
@@ -536,6 +549,25 @@ namespace PVR
     std::vector<int> m_failedClientsForChannelGroupMembers;
 
   private:
+    struct ChannelNumberHash
+    {
+      size_t operator()(const CPVRChannelNumber &channelNumber) const
+      {
+        return channelNumber.GetChannelNumber() * 31 + channelNumber.GetSubChannelNumber();
+      }
+    };
+
+    /*!
+     * @brief Rebuild the lookup indices if members, channel numbers or channel ids changed since the last build.
+     */
+    void UpdateLookupIndices(void) const;
+
+    mutable bool m_bLookupIndicesValid = false;           /*!< false if the lookup indices must be rebuilt */
+    mutable unsigned int m_iLookupIndicesIdChangeCount = 0; /*!< CPVRChannel::GetIdChangeCount() at the time the indices were built */
+    mutable std::unordered_map<CPVRChannelNumber, CPVRChannelPtr, ChannelNumberHash> m_channelNumberIndex; /*!< channels by channel number */
+    mutable std::unordered_map<int, CPVRChannelPtr> m_channelIdIndex;    /*!< channels by database id */
+    mutable std::unordered_map<int, CPVRChannelPtr> m_channelEpgIdIndex; /*!< channels by epg id */
+
     CDateTime GetEPGDate(EpgDateType epgDateType) const;
     /*!
      * @brief Get all entries that will be active next.
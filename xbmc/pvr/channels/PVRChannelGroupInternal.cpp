@@ -116,8 +116,7 @@ CPVRChannelPtr CPVRChannelGroupInternal::UpdateFromClient(const CPVRChannelPtr &
 
     PVRChannelGroupMember newMember(channel, CPVRChannelNumber(iChannelNumber, channelNumber.GetSubChannelNumber()), 0);
     channel->UpdatePath(this);
-    m_sortedMembers.push_back(newMember);
-    m_members.insert(std::make_pair(channel->StorageId(), newMember));
+    AddMember(newMember);
     m_bChanged = true;
 
     SortAndRenumber();
@@ -0,0 +1,177 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/channels/PVRChannelGroup.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace PVR
+{
+class TestPVRChannelGroupHelper
+{
+public:
+  static void AddMember(CPVRChannelGroup &group, const CPVRChannelPtr &channel, unsigned int iChannelNumber, int iClientPriority = 0)
+  {
+    group.AddMember(PVRChannelGroupMember(channel, CPVRChannelNumber(iChannelNumber, 0), iClientPriority));
+  }
+
+  static void SortByChannelNumber(CPVRChannelGroup &group) { group.SortByChannelNumber(); }
+  static void SortByClientChannelNumber(CPVRChannelGroup &group) { group.SortByClientChannelNumber(); }
+};
+}
+
+using namespace PVR;
+
+namespace
+{
+/* channels without an epg id, a file item of a channel with one would look up its epg */
+CPVRChannelPtr CreateChannel(int iUniqueId, unsigned int iClientChannelNumber = 0)
+{
+  PVR_CHANNEL data;
+  std::memset(&data, 0, sizeof(data));
+  data.iUniqueId = iUniqueId;
+  data.iChannelNumber = iClientChannelNumber;
+
+  return CPVRChannelPtr(new CPVRChannel(data, 1));
+}
+
+std::vector<int> GetMemberIds(const CPVRChannelGroup &group)
+{
+  std::vector<int> ids;
+  for (const auto &member : group.GetMembers())
+    ids.push_back(member.channel->UniqueID());
+  return ids;
+}
+}
+
+TEST(TestPVRChannelGroup, GetByChannelID)
+{
+  CPVRChannelGroup group(false, 1, "Test");
+  std::vector<CPVRChannelPtr> channels;
+  for (int i = 1; i <= 3; ++i)
+  {
+    channels.emplace_back(CreateChannel(i));
+    channels.back()->SetChannelID(i * 10);
+    TestPVRChannelGroupHelper::AddMember(group, channels.back(), i);
+  }
+
+  EXPECT_EQ(channels[1], group.GetByChannelID(20));
+  EXPECT_TRUE(group.IsGroupMember(30));
+  EXPECT_FALSE(group.GetByChannelID(40));
+  EXPECT_FALSE(group.IsGroupMember(40));
+
+  // ids are assigned after the channel joined the group
+  channels[1]->SetChannelID(25);
+  EXPECT_EQ(channels[1], group.GetByChannelID(25));
+  EXPECT_FALSE(group.GetByChannelID(20));
+
+  const CPVRChannelPtr added(CreateChannel(4));
+  TestPVRChannelGroupHelper::AddMember(group, added, 4);
+  added->SetChannelID(40);
+  EXPECT_TRUE(group.IsGroupMember(40));
+}
+
+TEST(TestPVRChannelGroup, GetByChannelEpgID)
+{
+  CPVRChannelGroup group(false, 1, "Test");
+  const CPVRChannelPtr channel1(CreateChannel(1));
+  const CPVRChannelPtr channel2(CreateChannel(2));
+  channel1->SetEpgID(100);
+  TestPVRChannelGroupHelper::AddMember(group, channel1, 1);
+  TestPVRChannelGroupHelper::AddMember(group, channel2, 2);
+
+  EXPECT_EQ(channel1, group.GetByChannelEpgID(100));
+  EXPECT_FALSE(group.GetByChannelEpgID(200));
+
+  channel2->SetEpgID(200);
+  EXPECT_EQ(channel2, group.GetByChannelEpgID(200));
+}
+
+TEST(TestPVRChannelGroup, GetByChannelNumber)
+{
+  CPVRChannelGroup group(false, 1, "Test");
+  const CPVRChannelPtr channel1(CreateChannel(1));
+  const CPVRChannelPtr channel2(CreateChannel(2));
+  const CPVRChannelPtr channel3(CreateChannel(3));
+  TestPVRChannelGroupHelper::AddMember(group, channel1, 1);
+  TestPVRChannelGroupHelper::AddMember(group, channel2, 2);
+  TestPVRChannelGroupHelper::AddMember(group, channel3, 2);
+
+  CFileItemPtr item(group.GetByChannelNumber(CPVRChannelNumber(1, 0)));
+  ASSERT_TRUE(item);
+  EXPECT_EQ(channel1, item->GetPVRChannelInfoTag());
+
+  // the first member wins for duplicate numbers
+  item = group.GetByChannelNumber(CPVRChannelNumber(2, 0));
+  ASSERT_TRUE(item);
+  EXPECT_EQ(channel2, item->GetPVRChannelInfoTag());
+
+  EXPECT_FALSE(group.GetByChannelNumber(CPVRChannelNumber(3, 0)));
+  EXPECT_TRUE(group.SetChannelNumber(channel3, CPVRChannelNumber(3, 0)));
+  item = group.GetByChannelNumber(CPVRChannelNumber(3, 0));
+  ASSERT_TRUE(item);
+  EXPECT_EQ(channel3, item->GetPVRChannelInfoTag());
+}
+
+TEST(TestPVRChannelGroup, SortByChannelNumber)
+{
+  CPVRChannelGroup group(false, 1, "Test");
+  for (int i : {1, 3, 5})
+    TestPVRChannelGroupHelper::AddMember(group, CreateChannel(i), i);
+
+  TestPVRChannelGroupHelper::SortByChannelNumber(group);
+  EXPECT_EQ((std::vector<int>{1, 3, 5}), GetMemberIds(group));
+
+  // appended members are merged
+  for (int i : {2, 4, 6})
+    TestPVRChannelGroupHelper::AddMember(group, CreateChannel(i), i);
+  TestPVRChannelGroupHelper::SortByChannelNumber(group);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6}), GetMemberIds(group));
+
+  // lookups follow the new order
+  CFileItemPtr item(group.GetByChannelNumber(CPVRChannelNumber(4, 0)));
+  ASSERT_TRUE(item);
+  EXPECT_EQ(4, item->GetPVRChannelInfoTag()->UniqueID());
+
+  // anything else is sorted
+  CPVRChannelGroup unsorted(false, 2, "Unsorted");
+  for (int i : {4, 1, 5, 3, 2})
+    TestPVRChannelGroupHelper::AddMember(unsorted, CreateChannel(i), i);
+  TestPVRChannelGroupHelper::SortByChannelNumber(unsorted);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5}), GetMemberIds(unsorted));
+}
+
+TEST(TestPVRChannelGroup, SortByClientChannelNumber)
+{
+  CPVRChannelGroup group(false, 1, "Test");
+  TestPVRChannelGroupHelper::AddMember(group, CreateChannel(1, 10), 0);
+  TestPVRChannelGroupHelper::AddMember(group, CreateChannel(2, 20), 0);
+  // higher client priority first, then by client channel number
+  TestPVRChannelGroupHelper::AddMember(group, CreateChannel(3, 30), 0, 1);
+  TestPVRChannelGroupHelper::AddMember(group, CreateChannel(4, 15), 0);
+
+  TestPVRChannelGroupHelper::SortByClientChannelNumber(group);
+  EXPECT_EQ((std::vector<int>{3, 1, 4, 2}), GetMemberIds(group));
+}
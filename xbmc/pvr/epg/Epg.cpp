@@ -20,6 +20,9 @@
 
 #include "Epg.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <utility>
 
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_epg_types.h"
@@ -30,6 +33,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 #include "pvr/PVRManager.h"
@@ -39,6 +43,17 @@
 
 using namespace PVR;
 
+namespace
+{
+// tags in this window around the current time are kept in memory, all others
+// are loaded from the database when they are asked for
+const time_t EPG_CURRENT_WINDOW_PAST = 60 * 60;
+const time_t EPG_CURRENT_WINDOW_FUTURE = 12 * 60 * 60;
+
+// ranges are loaded in whole hours, a sliding window doesn't query the database on every call
+const time_t EPG_LOAD_GRANULARITY = 60 * 60;
+}
+
 CPVREpg::CPVREpg(int iEpgID, const std::string &strName /* = "" */, const std::string &strScraperName /* = "" */, bool bLoadedFromDb /* = false */) :
     m_bChanged(!bLoadedFromDb),
     m_bTagsChanged(false),
@@ -47,8 +62,11 @@ CPVREpg::CPVREpg(int iEpgID, const std::string &strName /* = "" */, const std::s
     m_iEpgID(iEpgID),
     m_strName(strName),
     m_strScraperName(strScraperName),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bTransferring(false),
+    m_bTagsRangeValid(false)
 {
+  PublishSnapshot();
 }
 
 CPVREpg::CPVREpg(const CPVRChannelPtr &channel, bool bLoadedFromDb /* = false */) :
@@ -60,8 +78,11 @@ CPVREpg::CPVREpg(const CPVRChannelPtr &channel, bool bLoadedFromDb /* = false */
     m_strName(channel->ChannelName()),
     m_strScraperName(channel->EPGScraper()),
     m_pvrChannel(channel),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bTransferring(false),
+    m_bTagsRangeValid(false)
 {
+  PublishSnapshot();
 }
 
 CPVREpg::CPVREpg(void) :
@@ -70,8 +91,11 @@ CPVREpg::CPVREpg(void) :
     m_bLoaded(false),
     m_bUpdatePending(false),
     m_iEpgID(0),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bTransferring(false),
+    m_bTagsRangeValid(false)
 {
+  PublishSnapshot();
 }
 
 CPVREpg::~CPVREpg(void)
@@ -88,12 +112,12 @@ CPVREpg &CPVREpg::operator =(const CPVREpg &right)
   m_iEpgID            = right.m_iEpgID;
   m_strName           = right.m_strName;
   m_strScraperName    = right.m_strScraperName;
-  m_nowActiveStart    = right.m_nowActiveStart;
   m_lastScanTime      = right.m_lastScanTime;
   m_pvrChannel        = right.m_pvrChannel;
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = right.m_tags.begin(); it != right.m_tags.end(); ++it)
-    m_tags.insert(make_pair(it->first, it->second));
+  m_tags              = right.m_tags;
+  std::atomic_store(&m_nowActiveTag, std::atomic_load(&right.m_nowActiveTag));
+  PublishSnapshot();
 
   return *this;
 }
@@ -131,16 +155,56 @@ void CPVREpg::ForceUpdate(void)
 bool CPVREpg::HasValidEntries(void) const
 {
   CSingleLock lock(m_critSection);
+  LoadTagsRange();
+
+  CDateTime lastEnd(m_lastEnd);
+  if (!m_tags.empty() && (!lastEnd.IsValid() || m_tags.back()->EndAsUTC() > lastEnd))
+    lastEnd = m_tags.back()->EndAsUTC();
 
   return (m_iEpgID > 0 && /* valid EPG ID */
-      !m_tags.empty()  && /* contains at least 1 tag */
-      m_tags.rbegin()->second->EndAsUTC() >= CDateTime::GetCurrentDateTime().GetAsUTCDateTime()); /* the last end time hasn't passed yet */
+      lastEnd.IsValid() && /* contains at least 1 tag */
+      lastEnd >= CDateTime::GetCurrentDateTime().GetAsUTCDateTime()); /* the last end time hasn't passed yet */
 }
 
 void CPVREpg::Clear(void)
 {
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_loadedRanges.clear();
+  PublishSnapshot();
+}
+
+void CPVREpg::Trim(void)
+{
+  CSingleLock lock(m_critSection);
+  if (!m_database || NeedsSave())
+    return;
+
+  time_t iNow;
+  CDateTime::GetUTCDateTime().GetAsTime(iNow);
+  const time_t iStart = iNow - EPG_CURRENT_WINDOW_PAST;
+  const time_t iEnd = iNow + EPG_CURRENT_WINDOW_FUTURE;
+
+  m_tags.erase(std::remove_if(m_tags.begin(), m_tags.end(),
+                              [iStart, iEnd](const CPVREpgInfoTagPtr &tag)
+                              {
+                                time_t iTagStart, iTagEnd;
+                                tag->StartAsUTC().GetAsTime(iTagStart);
+                                tag->EndAsUTC().GetAsTime(iTagEnd);
+                                return (iTagEnd <= iStart || iTagStart >= iEnd) && !tag->HasTimer();
+                              }),
+               m_tags.end());
+
+  /* only the part of the loaded ranges that is inside the window is still complete */
+  std::vector<TimeRange> ranges;
+  for (const auto &range : m_loadedRanges)
+  {
+    const TimeRange clipped(std::max(range.first, iStart), std::min(range.second, iEnd));
+    if (clipped.first < clipped.second)
+      ranges.push_back(clipped);
+  }
+  m_loadedRanges.swap(ranges);
+  PublishSnapshot();
 }
 
 void CPVREpg::Cleanup(void)
@@ -153,32 +217,38 @@ void CPVREpg::Cleanup(void)
 void CPVREpg::Cleanup(const CDateTime &Time)
 {
   CSingleLock lock(m_critSection);
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end();)
-  {
-    if (it->second->EndAsUTC() < Time)
-    {
-      if (m_nowActiveStart == it->first)
-        m_nowActiveStart.SetValid(false);
-
-      it->second->ClearTimer();
-      it->second->ClearRecording();
-      it = m_tags.erase(it);
-    }
-    else
-    {
-      ++it;
-    }
-  }
+  const size_t iSize = m_tags.size();
+  m_tags.erase(std::remove_if(m_tags.begin(), m_tags.end(),
+                              [&Time](const CPVREpgInfoTagPtr &tag)
+                              {
+                                if (tag->EndAsUTC() >= Time)
+                                  return false;
+
+                                tag->ClearTimer();
+                                tag->ClearRecording();
+                                return true;
+                              }),
+               m_tags.end());
+
+  if (m_tags.size() != iSize)
+    PublishSnapshot();
+
+  /* the old entries are removed from the database too, its first start time is not known anymore */
+  if (m_firstStart.IsValid() && m_firstStart < Time)
+    m_bTagsRangeValid = false;
 }
 
 CPVREpgInfoTagPtr CPVREpg::GetTagNow(bool bUpdateIfNeeded /* = true */) const
 {
-  CSingleLock lock(m_critSection);
-  if (m_nowActiveStart.IsValid())
+  const EpgTagsSnapshotPtr snapshot(bUpdateIfNeeded ? GetCurrentSnapshot() : GetSnapshot());
+
+  /* the cached tag might have been removed from the table in the meantime */
+  const CPVREpgInfoTagPtr nowActiveTag(std::atomic_load(&m_nowActiveTag));
+  if (nowActiveTag && nowActiveTag->IsActive())
   {
-    std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.find(m_nowActiveStart);
-    if (it != m_tags.end() && it->second->IsActive())
-      return it->second;
+    const auto it = FindTag(snapshot->tags, nowActiveTag->StartAsUTC());
+    if (it != snapshot->tags.end() && *it == nowActiveTag)
+      return nowActiveTag;
   }
 
   if (bUpdateIfNeeded)
@@ -186,15 +256,15 @@ CPVREpgInfoTagPtr CPVREpg::GetTagNow(bool bUpdateIfNeeded /* = true */) const
     CPVREpgInfoTagPtr lastActiveTag;
 
     /* one of the first items will always match if the list is sorted */
-    for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+    for (const auto &tag : snapshot->tags)
     {
-      if (it->second->IsActive())
+      if (tag->IsActive())
       {
-        m_nowActiveStart = it->first;
-        return it->second;
+        std::atomic_store(&m_nowActiveTag, tag);
+        return tag;
       }
-      else if (it->second->WasActive())
-        lastActiveTag = it->second;
+      else if (tag->WasActive())
+        lastActiveTag = tag;
     }
 
     /* there might be a gap between the last and next event. return the last if found and it ended not more than 5 minutes ago */
@@ -209,20 +279,20 @@ CPVREpgInfoTagPtr CPVREpg::GetTagNow(bool bUpdateIfNeeded /* = true */) const
 CPVREpgInfoTagPtr CPVREpg::GetTagNext() const
 {
   CPVREpgInfoTagPtr nowTag(GetTagNow());
+  const EpgTagsSnapshotPtr snapshot(GetCurrentSnapshot());
   if (nowTag)
   {
-    CSingleLock lock(m_critSection);
-    std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.find(nowTag->StartAsUTC());
-    if (it != m_tags.end() && ++it != m_tags.end())
-      return it->second;
+    auto it = FindTag(snapshot->tags, nowTag->StartAsUTC());
+    if (it != snapshot->tags.end() && ++it != snapshot->tags.end())
+      return *it;
   }
-  else if (Size() > 0)
+  else
   {
     /* return the first event that is in the future */
-    for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+    for (const auto &tag : snapshot->tags)
     {
-      if (it->second->IsUpcoming())
-        return it->second;
+      if (tag->IsUpcoming())
+        return tag;
     }
   }
 
@@ -248,11 +318,19 @@ CPVREpgInfoTagPtr CPVREpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId)
 {
   if (iUniqueBroadcastId != EPG_TAG_INVALID_UID)
   {
-    CSingleLock lock(m_critSection);
-    for (const auto &infoTag : m_tags)
+    const EpgTagsSnapshotPtr snapshot(GetSnapshot());
+    const auto loadedIt = std::find_if(snapshot->tags.begin(), snapshot->tags.end(),
+                                       [iUniqueBroadcastId](const CPVREpgInfoTagPtr &tag) { return tag->UniqueBroadcastID() == iUniqueBroadcastId; });
+    if (loadedIt != snapshot->tags.end())
+      return *loadedIt;
+
+    /* not loaded yet, look it up in the database */
+    if (!snapshot->bComplete)
     {
-      if (infoTag.second->UniqueBroadcastID() == iUniqueBroadcastId)
-        return infoTag.second;
+      CSingleLock lock(m_critSection);
+      const auto it = FindTagByBroadcastId(iUniqueBroadcastId);
+      if (it != m_tags.end())
+        return *it;
     }
   }
   return CPVREpgInfoTagPtr();
@@ -260,11 +338,12 @@ CPVREpgInfoTagPtr CPVREpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId)
 
 CPVREpgInfoTagPtr CPVREpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
-  CSingleLock lock(m_critSection);
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  const EpgTagsSnapshotPtr snapshot(GetSnapshot(beginTime, endTime));
+
+  for (const auto &tag : snapshot->tags)
   {
-    if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
-      return it->second;
+    if (tag->StartAsUTC() >= beginTime && tag->EndAsUTC() <= endTime)
+      return tag;
   }
 
   return CPVREpgInfoTagPtr();
@@ -274,13 +353,14 @@ std::vector<CPVREpgInfoTagPtr> CPVREpg::GetTagsBetween(const CDateTime &beginTim
 {
   std::vector<CPVREpgInfoTagPtr> epgTags;
 
-  CSingleLock lock(m_critSection);
-  for (const auto &infoTag : m_tags)
+  const EpgTagsSnapshotPtr snapshot(GetSnapshot(beginTime, endTime));
+
+  for (const auto &infoTag : snapshot->tags)
   {
-    if (infoTag.second->StartAsUTC() >= beginTime)
+    if (infoTag->StartAsUTC() >= beginTime)
     {
-      if (infoTag.second->EndAsUTC() <= endTime)
-        epgTags.emplace_back(infoTag.second);
+      if (infoTag->EndAsUTC() <= endTime)
+        epgTags.emplace_back(infoTag);
       else
         break; // done.
     }
@@ -289,32 +369,245 @@ std::vector<CPVREpgInfoTagPtr> CPVREpg::GetTagsBetween(const CDateTime &beginTim
   return epgTags;
 }
 
-void CPVREpg::AddEntry(const CPVREpgInfoTag &tag)
+void CPVREpg::PublishSnapshot(void) const
+{
+  std::shared_ptr<EpgTagsSnapshot> snapshot(new EpgTagsSnapshot);
+  snapshot->tags = m_tags;
+  snapshot->loadedRanges = m_loadedRanges;
+  snapshot->bComplete = !m_database;
+  std::atomic_store(&m_snapshot, EpgTagsSnapshotPtr(snapshot));
+}
+
+CPVREpg::EpgTagsSnapshotPtr CPVREpg::GetSnapshot(void) const
+{
+  return std::atomic_load(&m_snapshot);
+}
+
+CPVREpg::EpgTagsSnapshotPtr CPVREpg::GetSnapshot(time_t iStart, time_t iEnd) const
 {
-  CPVREpgInfoTagPtr newTag;
-  CPVRChannelPtr channel;
+  EpgTagsSnapshotPtr snapshot(GetSnapshot());
+  if (snapshot->bComplete || iStart >= iEnd)
+    return snapshot;
+
+  /* loaded ranges are joined, a range that is loaded lies within one of them */
+  for (const auto &range : snapshot->loadedRanges)
   {
-    CSingleLock lock(m_critSection);
-    std::map<CDateTime, CPVREpgInfoTagPtr>::iterator itr = m_tags.find(tag.StartAsUTC());
-    if (itr != m_tags.end())
-      newTag = itr->second;
-    else
+    if (range.first > iStart)
+      break;
+    if (range.second >= iEnd)
+      return snapshot;
+  }
+
+  CSingleLock lock(m_critSection);
+  LoadRange(iStart, iEnd);
+  return GetSnapshot();
+}
+
+CPVREpg::EpgTagsSnapshotPtr CPVREpg::GetSnapshot(const CDateTime &start, const CDateTime &end) const
+{
+  time_t iStart = std::numeric_limits<time_t>::min();
+  time_t iEnd = std::numeric_limits<time_t>::max();
+  if (start.IsValid())
+    start.GetAsTime(iStart);
+  if (end.IsValid())
+    end.GetAsTime(iEnd);
+
+  return GetSnapshot(iStart, iEnd);
+}
+
+CPVREpg::EpgTagsSnapshotPtr CPVREpg::GetCurrentSnapshot(void) const
+{
+  time_t iNow;
+  CDateTime::GetUTCDateTime().GetAsTime(iNow);
+  return GetSnapshot(iNow - EPG_CURRENT_WINDOW_PAST, iNow + EPG_CURRENT_WINDOW_FUTURE);
+}
+
+CPVREpg::EpgTags::const_iterator CPVREpg::FindTag(const EpgTags &tags, const CDateTime &start)
+{
+  auto it = std::lower_bound(tags.begin(), tags.end(), start,
+                             [](const CPVREpgInfoTagPtr &tag, const CDateTime &time) { return tag->m_startTime < time; });
+  if (it != tags.end() && (*it)->m_startTime == start)
+    return it;
+
+  return tags.end();
+}
+
+CPVREpg::EpgTags::iterator CPVREpg::FindTag(const CDateTime &start) const
+{
+  auto it = std::lower_bound(m_tags.begin(), m_tags.end(), start,
+                             [](const CPVREpgInfoTagPtr &tag, const CDateTime &time) { return tag->m_startTime < time; });
+  if (it != m_tags.end() && (*it)->m_startTime == start)
+    return it;
+
+  return m_tags.end();
+}
+
+CPVREpg::EpgTags::iterator CPVREpg::FindTagByBroadcastId(unsigned int iUniqueBroadcastId) const
+{
+  auto it = std::find_if(m_tags.begin(), m_tags.end(),
+                         [iUniqueBroadcastId](const CPVREpgInfoTagPtr &tag) { return tag->UniqueBroadcastID() == iUniqueBroadcastId; });
+  if (it != m_tags.end() || !m_database)
+    return it;
+
+  CPVREpgInfoTagPtr tag;
+  {
+    const int iEpgID = m_iEpgID;
+    CSingleExit exit(m_critSection);
+    tag = m_database->GetEpgTagByUniqueBroadcastID(iEpgID, iUniqueBroadcastId);
+  }
+
+  if (!tag)
+    return m_tags.end();
+
+  if (MergeTags(EpgTags{tag}))
+    PublishSnapshot();
+  return FindTag(tag->StartAsUTC());
+}
+
+CPVREpg::EpgTags::iterator CPVREpg::InsertTag(const CPVREpgInfoTagPtr &tag) const
+{
+  const auto it = std::upper_bound(m_tags.begin(), m_tags.end(), tag->m_startTime,
+                                   [](const CDateTime &time, const CPVREpgInfoTagPtr &tag) { return time < tag->m_startTime; });
+  return m_tags.insert(it, tag);
+}
+
+bool CPVREpg::MergeTags(const EpgTags &tags) const
+{
+  const size_t iLoaded = m_tags.size();
+
+  for (const auto &tag : tags)
+  {
+    /* a loaded tag might have changes that are not persisted yet */
+    if (FindTag(tag->m_startTime) != m_tags.end())
+      continue;
+
+    tag->SetEpg(const_cast<CPVREpg *>(this));
+    tag->SetChannel(m_pvrChannel);
+    tag->SetTimer(CServiceBroker::GetPVRManager().Timers()->GetTimerForEpgTag(tag));
+    tag->SetRecording(CServiceBroker::GetPVRManager().Recordings()->GetRecordingForEpgTag(tag));
+    m_tags.push_back(tag);
+  }
+
+  /* both parts are sorted */
+  std::inplace_merge(m_tags.begin(), m_tags.begin() + iLoaded, m_tags.end(),
+                     [](const CPVREpgInfoTagPtr &left, const CPVREpgInfoTagPtr &right) { return left->m_startTime < right->m_startTime; });
+
+  return m_tags.size() != iLoaded;
+}
+
+void CPVREpg::LoadRange(const CDateTime &start, const CDateTime &end) const
+{
+  time_t iStart = std::numeric_limits<time_t>::min();
+  time_t iEnd = std::numeric_limits<time_t>::max();
+  if (start.IsValid())
+    start.GetAsTime(iStart);
+  if (end.IsValid())
+    end.GetAsTime(iEnd);
+
+  LoadRange(iStart, iEnd);
+}
+
+void CPVREpg::LoadRange(time_t iStart, time_t iEnd) const
+{
+  if (!m_database || iStart >= iEnd)
+    return;
+
+  if (iStart != std::numeric_limits<time_t>::min())
+    iStart -= iStart % EPG_LOAD_GRANULARITY;
+  if (iEnd != std::numeric_limits<time_t>::max() && iEnd % EPG_LOAD_GRANULARITY)
+    iEnd += EPG_LOAD_GRANULARITY - iEnd % EPG_LOAD_GRANULARITY;
+
+  /* collect the parts of the range that are not loaded yet */
+  std::vector<TimeRange> missing;
+  time_t iCursor = iStart;
+  for (const auto &range : m_loadedRanges)
+  {
+    if (range.second <= iCursor)
+      continue;
+    if (range.first >= iEnd)
+      break;
+    if (range.first > iCursor)
+      missing.emplace_back(iCursor, range.first);
+    iCursor = range.second;
+    if (iCursor >= iEnd)
+      break;
+  }
+  if (iCursor < iEnd)
+    missing.emplace_back(iCursor, iEnd);
+
+  if (missing.empty())
+    return;
+
+  EpgTags tags;
+  {
+    /* don't block the table while waiting for the database */
+    const int iEpgID = m_iEpgID;
+    CSingleExit exit(m_critSection);
+    for (const auto &range : missing)
     {
-      newTag.reset(new CPVREpgInfoTag(this, m_pvrChannel, m_strName, m_pvrChannel ? m_pvrChannel->IconPath() : ""));
-      m_tags.insert(make_pair(tag.StartAsUTC(), newTag));
+      const EpgTags rangeTags(m_database->GetEpgTags(iEpgID,
+                                                     range.first == std::numeric_limits<time_t>::min() ? CDateTime() : CDateTime(range.first),
+                                                     range.second == std::numeric_limits<time_t>::max() ? CDateTime() : CDateTime(range.second)));
+      /* ranges are disjoint but a tag can overlap more than one of them */
+      for (const auto &tag : rangeTags)
+      {
+        if (tags.empty() || tags.back()->m_startTime < tag->m_startTime)
+          tags.push_back(tag);
+      }
     }
+  }
+
+  MergeTags(tags);
+
+  /* add the ranges and join the ones that touch */
+  for (const auto &range : missing)
+    m_loadedRanges.push_back(range);
+  std::sort(m_loadedRanges.begin(), m_loadedRanges.end());
 
-    channel = m_pvrChannel;
+  std::vector<TimeRange> joined;
+  for (const auto &range : m_loadedRanges)
+  {
+    if (!joined.empty() && range.first <= joined.back().second)
+      joined.back().second = std::max(joined.back().second, range.second);
+    else
+      joined.push_back(range);
   }
+  m_loadedRanges.swap(joined);
+  PublishSnapshot();
+
+#if EPG_DEBUGGING
+  CLog::Log(LOGDEBUG, "EPG - %s - loaded %d entries for table '%s'", __FUNCTION__, (int) tags.size(), m_strName.c_str());
+#endif
+}
+
+void CPVREpg::LoadCurrent(void) const
+{
+  time_t iNow;
+  CDateTime::GetUTCDateTime().GetAsTime(iNow);
+  LoadRange(iNow - EPG_CURRENT_WINDOW_PAST, iNow + EPG_CURRENT_WINDOW_FUTURE);
+}
 
-  if (newTag)
+void CPVREpg::LoadAll(void) const
+{
+  LoadRange(std::numeric_limits<time_t>::min(), std::numeric_limits<time_t>::max());
+}
+
+void CPVREpg::LoadTagsRange(void) const
+{
+  if (!m_database || m_bTagsRangeValid)
+    return;
+
+  CDateTime firstStart, lastStart, lastEnd;
   {
-    newTag->Update(tag);
-    newTag->SetChannel(channel);
-    newTag->SetEpg(this);
-    newTag->SetTimer(CServiceBroker::GetPVRManager().Timers()->GetTimerForEpgTag(newTag));
-    newTag->SetRecording(CServiceBroker::GetPVRManager().Recordings()->GetRecordingForEpgTag(newTag));
+    const int iEpgID = m_iEpgID;
+    CSingleExit exit(m_critSection);
+    m_database->GetEpgTagsRange(iEpgID, firstStart, lastStart, lastEnd);
   }
+
+  m_firstStart = firstStart;
+  m_lastStart = lastStart;
+  m_lastEnd = lastEnd;
+  m_bTagsRangeValid = true;
 }
 
 bool CPVREpg::Load(void)
@@ -329,8 +622,13 @@ bool CPVREpg::Load(void)
   }
 
   CSingleLock lock(m_critSection);
-  int iEntriesLoaded = database->Get(*this);
-  if (iEntriesLoaded <= 0)
+  m_database = database;
+  m_bTagsRangeValid = false;
+  LoadTagsRange();
+  PublishSnapshot();
+  LoadCurrent();
+
+  if (!m_firstStart.IsValid())
   {
     CLog::Log(LOGDEBUG, "EPG - %s - no database entries found for table '%s'.", __FUNCTION__, m_strName.c_str());
   }
@@ -354,14 +652,24 @@ bool CPVREpg::UpdateEntries(const CPVREpg &epg, bool bStoreInDb /* = true */)
 #if EPG_DEBUGGING
   CLog::Log(LOGDEBUG, "EPG - {0} - {1} entries in memory before merging", __FUNCTION__, m_tags.size());
 #endif
-  /* copy over tags */
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = epg.m_tags.begin(); it != epg.m_tags.end(); ++it)
-    UpdateEntry(it->second, bStoreInDb);
+  /* merge with the stored tags of the incoming range, not with whatever happens to be loaded */
+  if (!epg.m_tags.empty())
+    LoadRange(epg.m_tags.front()->StartAsUTC(), epg.m_tags.back()->EndAsUTC());
+
+  /* copy over tags, the new tags are published once the table is consistent again */
+  for (const auto &tag : epg.m_tags)
+  {
+    CPVREpgInfoTagPtr infoTag;
+    MergeEntry(tag, bStoreInDb, infoTag);
+    infoTag->SetTimer(CServiceBroker::GetPVRManager().Timers()->GetTimerForEpgTag(infoTag));
+    infoTag->SetRecording(CServiceBroker::GetPVRManager().Recordings()->GetRecordingForEpgTag(infoTag));
+  }
 
 #if EPG_DEBUGGING
   CLog::Log(LOGDEBUG, "EPG - {0} - {1} entries in memory after merging and before fixing", __FUNCTION__, m_tags.size());
 #endif
   FixOverlappingEvents(bStoreInDb);
+  PublishSnapshot();
 
 #if EPG_DEBUGGING
   CLog::Log(LOGDEBUG, "EPG - {0} - {1} entries in memory after fixing", __FUNCTION__, m_tags.size());
@@ -416,26 +724,8 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, bool bUpdateDatabase)
 
   {
     CSingleLock lock(m_critSection);
-    std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.find(tag->StartAsUTC());
-    bool bNewTag(false);
-    if (it != m_tags.end())
-    {
-      infoTag = it->second;
-    }
-    else
-    {
-      infoTag.reset(new CPVREpgInfoTag(this, m_pvrChannel, m_strName, m_pvrChannel ? m_pvrChannel->IconPath() : ""));
-      infoTag->SetUniqueBroadcastID(tag->UniqueBroadcastID());
-      m_tags.insert(std::make_pair(tag->StartAsUTC(), infoTag));
-      bNewTag = true;
-    }
-
-    infoTag->Update(*tag, bNewTag);
-    infoTag->SetEpg(this);
-    infoTag->SetChannel(m_pvrChannel);
-
-    if (bUpdateDatabase)
-      m_changedTags.insert(std::make_pair(infoTag->UniqueBroadcastID(), infoTag));
+    if (MergeEntry(tag, bUpdateDatabase, infoTag) && !m_bTransferring)
+      PublishSnapshot();
   }
 
   infoTag->SetTimer(CServiceBroker::GetPVRManager().Timers()->GetTimerForEpgTag(infoTag));
@@ -444,6 +734,67 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, bool bUpdateDatabase)
   return true;
 }
 
+bool CPVREpg::MergeEntry(const CPVREpgInfoTagPtr &tag, bool bUpdateDatabase, CPVREpgInfoTagPtr &infoTag)
+{
+  LoadRange(tag->StartAsUTC(), tag->EndAsUTC());
+
+  const auto it = FindTag(tag->StartAsUTC());
+  bool bNewTag(false);
+  bool bChanged(false);
+  if (it != m_tags.end())
+  {
+    infoTag = *it;
+
+    /* clients resend the whole guide, don't rewrite rows that didn't change */
+    bChanged = !infoTag->PersistedDataEquals(*tag);
+    if (!bChanged &&
+        infoTag->m_strSeriesLink == tag->m_strSeriesLink &&
+        infoTag->m_epg == this &&
+        infoTag->Channel() == m_pvrChannel)
+      return false;
+
+    infoTag = CopyTag(infoTag);
+    *it = infoTag;
+  }
+  else
+  {
+    infoTag.reset(new CPVREpgInfoTag(this, m_pvrChannel, m_strName, m_pvrChannel ? m_pvrChannel->IconPath() : ""));
+    infoTag->SetUniqueBroadcastID(tag->UniqueBroadcastID());
+    infoTag->m_startTime = tag->m_startTime;
+    InsertTag(infoTag);
+    bNewTag = true;
+    bChanged = true;
+  }
+
+  infoTag->Update(*tag, bNewTag);
+  infoTag->SetEpg(this);
+  infoTag->SetChannel(m_pvrChannel);
+
+  /* a pending write of this tag has to use the new instance */
+  if (bUpdateDatabase && bChanged)
+    m_changedTags[infoTag->UniqueBroadcastID()] = infoTag;
+  else
+    ReplaceChangedTag(infoTag);
+
+  return true;
+}
+
+CPVREpgInfoTagPtr CPVREpg::CopyTag(const CPVREpgInfoTagPtr &tag)
+{
+  CPVREpgInfoTagPtr copy(new CPVREpgInfoTag());
+  copy->Update(*tag);
+  copy->SetTimer(tag->Timer());
+  copy->SetRecording(tag->Recording());
+  return copy;
+}
+
+void CPVREpg::ReplaceChangedTag(const CPVREpgInfoTagPtr &tag)
+{
+  auto it = m_changedTags.find(tag->UniqueBroadcastID());
+  if (it != m_changedTags.end())
+    it->second = tag;
+}
+
 bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, EPG_EVENT_STATE newState, bool bUpdateDatabase)
 {
   bool bRet(true);
@@ -457,13 +808,7 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, EPG_EVENT_STATE newState
   {
     CSingleLock lock(m_critSection);
 
-    auto it = m_tags.begin();
-    for (; it != m_tags.end(); ++it)
-    {
-      if (it->second->UniqueBroadcastID() == tag->UniqueBroadcastID())
-        break;
-    }
-
+    const auto it = FindTagByBroadcastId(tag->UniqueBroadcastID());
     if (it == m_tags.end())
     {
       bRet = false;
@@ -473,14 +818,15 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, EPG_EVENT_STATE newState
       // Respect epg linger time.
       int iPastDays = CServiceBroker::GetPVRManager().EpgContainer().GetPastDaysToDisplay();
       const CDateTime cleanupTime(CDateTime::GetUTCDateTime() - CDateTimeSpan(iPastDays, 0, 0, 0));
-      if (it->second->EndAsUTC() < cleanupTime)
+      if ((*it)->EndAsUTC() < cleanupTime)
       {
         if (bUpdateDatabase)
-          m_deletedTags.insert(std::make_pair(it->second->UniqueBroadcastID(), it->second));
+          m_deletedTags.insert(std::make_pair((*it)->UniqueBroadcastID(), *it));
 
-        it->second->ClearTimer();
-        it->second->ClearRecording();
+        (*it)->ClearTimer();
+        (*it)->ClearRecording();
         m_tags.erase(it);
+        PublishSnapshot();
       }
       else
       {
@@ -520,7 +866,7 @@ bool CPVREpg::Update(const time_t start, const time_t end, int iUpdateTime, bool
   CDateTime lastScanTime = GetLastScanTime();
 
   /* enforce advanced settings update interval override for TV Channels with no EPG data */
-  if (m_tags.empty() && !bUpdate && ChannelID() > 0 && !Channel()->IsRadio())
+  if (!GetFirstDate().IsValid() && !bUpdate && ChannelID() > 0 && !Channel()->IsRadio())
     iUpdateTime = g_advancedSettings.m_iEpgUpdateEmptyTagsInterval;
 
   if (!bForceUpdate)
@@ -559,10 +905,10 @@ int CPVREpg::Get(CFileItemList &results) const
 {
   int iInitialSize = results.Size();
 
-  CSingleLock lock(m_critSection);
+  const EpgTagsSnapshotPtr snapshot(GetSnapshot(std::numeric_limits<time_t>::min(), std::numeric_limits<time_t>::max()));
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
-    results.Add(CFileItemPtr(new CFileItem(it->second)));
+  for (const auto &tag : snapshot->tags)
+    results.Add(CFileItemPtr(new CFileItem(tag)));
 
   return results.Size() - iInitialSize;
 }
@@ -574,12 +920,35 @@ int CPVREpg::Get(CFileItemList &results, const CPVREpgSearchFilter &filter) cons
   if (!HasValidEntries())
     return -1;
 
-  CSingleLock lock(m_critSection);
+  const EpgTagsSnapshotPtr snapshot(GetSnapshot(filter.GetStartDateTime().GetAsUTCDateTime(), filter.GetEndDateTime().GetAsUTCDateTime()));
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  for (const auto &tag : snapshot->tags)
   {
-    if (filter.FilterEntry(it->second))
-      results.Add(CFileItemPtr(new CFileItem(it->second)));
+    if (filter.FilterEntry(tag))
+      results.Add(CFileItemPtr(new CFileItem(tag)));
+  }
+
+  return results.Size() - iInitialSize;
+}
+
+int CPVREpg::Get(CFileItemList &results, const CPVREpgSearchFilter &filter, const std::vector<CPVREpgInfoTagPtr> &candidates) const
+{
+  int iInitialSize = results.Size();
+
+  EpgTagsSnapshotPtr snapshot;
+  {
+    CSingleLock lock(m_critSection);
+    if (MergeTags(candidates))
+      PublishSnapshot();
+    snapshot = GetSnapshot();
+  }
+
+  /* filter the loaded instances, they carry the channel, timer and recording */
+  for (const auto &candidate : candidates)
+  {
+    auto it = FindTag(snapshot->tags, candidate->m_startTime);
+    if (it != snapshot->tags.end() && filter.FilterEntry(*it))
+      results.Add(CFileItemPtr(new CFileItem(*it)));
   }
 
   return results.Size() - iInitialSize;
@@ -601,6 +970,10 @@ bool CPVREpg::Persist(void)
     return false;
   }
 
+  std::vector<CPVREpgInfoTagPtr> changedTags;
+  std::vector<CPVREpgInfoTagPtr> persistedTags;
+  std::vector<CPVREpgInfoTagPtr> deletedTags;
+
   database->Lock();
 
   {
@@ -612,11 +985,20 @@ bool CPVREpg::Persist(void)
         m_iEpgID = iId;
     }
 
-    for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); ++it)
-      database->Delete(*it->second);
+    /* the tags are updated under this lock, the database writes copies taken while holding it */
+    changedTags.reserve(m_changedTags.size());
+    persistedTags.reserve(m_changedTags.size());
+    for (const auto &tag : m_changedTags)
+    {
+      CPVREpgInfoTagPtr persistedTag(new CPVREpgInfoTag());
+      persistedTag->Update(*tag.second);
+      changedTags.emplace_back(tag.second);
+      persistedTags.emplace_back(persistedTag);
+    }
 
-    for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); ++it)
-      it->second->Persist(false);
+    deletedTags.reserve(m_deletedTags.size());
+    for (const auto &tag : m_deletedTags)
+      deletedTags.emplace_back(tag.second);
 
     if (m_bUpdateLastScanTime)
       database->PersistLastEpgScanTime(m_iEpgID, true);
@@ -628,7 +1010,39 @@ bool CPVREpg::Persist(void)
     m_bUpdateLastScanTime = false;
   }
 
-  bool bRet = database->CommitInsertQueries();
+  /* write the tags without blocking readers of this table */
+  unsigned int iStart = XbmcThreads::SystemClockMillis();
+  bool bTagsPersisted = database->PersistTags(persistedTags, deletedTags);
+
+  {
+    /* hand the ids of new rows to the loaded tags, which may have been replaced in the meantime */
+    CSingleLock lock(m_critSection);
+    bool bReplaced(false);
+    for (size_t i = 0; i < changedTags.size(); ++i)
+    {
+      const auto it = FindTag(changedTags[i]->StartAsUTC());
+      if (it == m_tags.end() || (*it)->m_iBroadcastId > 0 || persistedTags[i]->m_iBroadcastId <= 0)
+        continue;
+
+      CPVREpgInfoTagPtr tag(CopyTag(*it));
+      tag->m_iBroadcastId = persistedTags[i]->m_iBroadcastId;
+      *it = tag;
+      ReplaceChangedTag(tag);
+      bReplaced = true;
+    }
+    if (bReplaced)
+      PublishSnapshot();
+  }
+
+  if (!changedTags.empty() || !deletedTags.empty())
+  {
+    unsigned int iDuration = XbmcThreads::SystemClockMillis() - iStart;
+    CLog::Log(LOGDEBUG, "EPG - %s - table '%s': wrote %d and deleted %d tags in %u ms (%.0f tags/s)", __FUNCTION__,
+              Name().c_str(), static_cast<int>(changedTags.size()), static_cast<int>(deletedTags.size()), iDuration,
+              (changedTags.size() + deletedTags.size()) * 1000.0 / std::max(iDuration, 1u));
+  }
+
+  bool bRet = database->CommitInsertQueries() && bTagsPersisted;
 
   database->Unlock();
   return bRet;
@@ -639,8 +1053,11 @@ CDateTime CPVREpg::GetFirstDate(void) const
   CDateTime first;
 
   CSingleLock lock(m_critSection);
-  if (!m_tags.empty())
-    first = m_tags.begin()->second->StartAsUTC();
+  LoadTagsRange();
+
+  first = m_firstStart;
+  if (!m_tags.empty() && (!first.IsValid() || m_tags.front()->StartAsUTC() < first))
+    first = m_tags.front()->StartAsUTC();
 
   return first;
 }
@@ -650,8 +1067,11 @@ CDateTime CPVREpg::GetLastDate(void) const
   CDateTime last;
 
   CSingleLock lock(m_critSection);
-  if (!m_tags.empty())
-    last = m_tags.rbegin()->second->StartAsUTC();
+  LoadTagsRange();
+
+  last = m_lastStart;
+  if (!m_tags.empty() && (!last.IsValid() || m_tags.back()->StartAsUTC() > last))
+    last = m_tags.back()->StartAsUTC();
 
   return last;
 }
@@ -666,14 +1086,14 @@ bool CPVREpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
   bool bReturn(true);
   CPVREpgInfoTagPtr previousTag, currentTag;
 
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end(); it != m_tags.end() ? it++ : it)
+  for (auto it = m_tags.begin(); it != m_tags.end();)
   {
     if (!previousTag)
     {
-      previousTag = it->second;
+      previousTag = *it++;
       continue;
     }
-    currentTag = it->second;
+    currentTag = *it;
 
     if (previousTag->EndAsUTC() >= currentTag->EndAsUTC())
     {
@@ -681,24 +1101,25 @@ bool CPVREpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
       if (bUpdateDb)
         m_deletedTags.insert(make_pair(currentTag->UniqueBroadcastID(), currentTag));
 
-      if (m_nowActiveStart == it->first)
-        m_nowActiveStart.SetValid(false);
-
-      it->second->ClearTimer();
-      it->second->ClearRecording();
-      m_tags.erase(it++);
+      currentTag->ClearTimer();
+      currentTag->ClearRecording();
+      it = m_tags.erase(it);
     }
     else if (previousTag->EndAsUTC() > currentTag->StartAsUTC())
     {
+      previousTag = CopyTag(previousTag);
       previousTag->SetEndFromUTC(currentTag->StartAsUTC());
+      *std::prev(it) = previousTag;
       if (bUpdateDb)
-        m_changedTags.insert(make_pair(previousTag->UniqueBroadcastID(), previousTag));
+        m_changedTags[previousTag->UniqueBroadcastID()] = previousTag;
+      else
+        ReplaceChangedTag(previousTag);
 
-      previousTag = it->second;
+      previousTag = *it++;
     }
     else
     {
-      previousTag = it->second;
+      previousTag = *it++;
     }
   }
 
@@ -736,7 +1157,17 @@ bool CPVREpg::UpdateFromScraper(time_t start, time_t end)
     else
     {
       CLog::Log(LOGDEBUG, "EPG - %s - updating EPG for channel '%s' from client '%i'", __FUNCTION__, channel->ChannelName().c_str(), channel->ClientID());
+      /* the client transfers the tags one by one, copying all tags into a new snapshot for each of them is quadratic */
+      {
+        CSingleLock lock(m_critSection);
+        m_bTransferring = true;
+      }
+
       bGrabSuccess = (CServiceBroker::GetPVRManager().Clients()->GetEPGForChannel(channel, this, start, end) == PVR_ERROR_NO_ERROR);
+
+      CSingleLock lock(m_critSection);
+      m_bTransferring = false;
+      PublishSnapshot();
     }
   }
   else if (m_strScraperName.empty()) /* no grabber defined */
@@ -823,10 +1254,11 @@ bool CPVREpg::LoadFromClients(time_t start, time_t end)
 
 CPVREpgInfoTagPtr CPVREpg::GetNextEvent(const CPVREpgInfoTag& tag) const
 {
-  CSingleLock lock(m_critSection);
-  std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.find(tag.StartAsUTC());
-  if (it != m_tags.end() && ++it != m_tags.end())
-    return it->second;
+  const EpgTagsSnapshotPtr snapshot(GetSnapshot(tag.StartAsUTC(), tag.EndAsUTC() + CDateTimeSpan(1, 0, 0, 0)));
+
+  auto it = FindTag(snapshot->tags, tag.StartAsUTC());
+  if (it != snapshot->tags.end() && ++it != snapshot->tags.end())
+    return *it;
 
   CPVREpgInfoTagPtr retVal;
   return retVal;
@@ -855,8 +1287,8 @@ void CPVREpg::SetChannel(const PVR::CPVRChannelPtr &channel)
       channel->SetEpgID(m_iEpgID);
     }
     m_pvrChannel = channel;
-    for (std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end(); ++it)
-      it->second->SetChannel(m_pvrChannel);
+    for (const auto &tag : m_tags)
+      tag->SetChannel(m_pvrChannel);
   }
 }
 
@@ -868,8 +1300,7 @@ bool CPVREpg::UpdatePending(void) const
 
 size_t CPVREpg::Size(void) const
 {
-  CSingleLock lock(m_critSection);
-  return m_tags.size();
+  return GetSnapshot()->tags.size();
 }
 
 bool CPVREpg::NeedsSave(void) const
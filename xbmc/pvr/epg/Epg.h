@@ -20,7 +20,9 @@
  */
 
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "FileItem.h"
@@ -40,6 +42,7 @@ namespace PVR
   class CPVREpg : public Observable
   {
     friend class CPVREpgDatabase;
+    friend class TestEpgSnapshotHelper;
 
   public:
     /*!
@@ -66,8 +69,9 @@ namespace PVR
     CPVREpg &operator =(const CPVREpg &right);
 
     /*!
-     * @brief Load all entries for this table from the database.
-     * @return True if any entries were loaded, false otherwise.
+     * @brief Load the entries around the current time for this table from the database.
+     *        All other entries are loaded on demand, when they are asked for.
+     * @return True if the table has any entries in the database, false otherwise.
      */
     bool Load(void);
 
@@ -150,6 +154,13 @@ namespace PVR
      */
     void Clear(void);
 
+    /*!
+     * @brief Drop the loaded entries that are outside of the window around the current time.
+     *        Entries with timers and tables with unsaved changes are kept, dropped entries are
+     *        loaded from the database again when they are asked for.
+     */
+    void Trim(void);
+
     /*!
      * @brief Get the event that is occurring now
      * @return The current event or NULL if it wasn't found.
@@ -236,6 +247,15 @@ namespace PVR
      */
     int Get(CFileItemList &results, const CPVREpgSearchFilter &filter) const;
 
+    /*!
+     * @brief Apply a filter to EPG entries of this table found in the database's full text index.
+     * @param results The file list to store the results in.
+     * @param filter The filter to apply.
+     * @param candidates The entries of this table returned by the index, sorted by start time.
+     * @return The amount of entries that were added.
+     */
+    int Get(CFileItemList &results, const CPVREpgSearchFilter &filter, const std::vector<CPVREpgInfoTagPtr> &candidates) const;
+
     /*!
      * @brief Persist this table in the database.
      * @return True if the table was persisted, false otherwise.
@@ -302,11 +322,121 @@ namespace PVR
      */
     bool FixOverlappingEvents(bool bUpdateDb = false);
 
+    typedef std::vector<CPVREpgInfoTagPtr> EpgTags;
+    typedef std::pair<time_t, time_t> TimeRange;
+
+    /*!
+     * @brief Immutable copy of the loaded tags. A new version is published whenever the list
+     *        of loaded tags changes, readers use the version they got without locking the table.
+     */
+    struct EpgTagsSnapshot
+    {
+      EpgTags tags;                        /*!< the loaded tags, sorted by start time */
+      std::vector<TimeRange> loadedRanges; /*!< the ranges in which all tags of the database are loaded */
+      bool bComplete = true;               /*!< true if the table isn't backed by the database */
+    };
+    typedef std::shared_ptr<const EpgTagsSnapshot> EpgTagsSnapshotPtr;
+
+    /*!
+     * @brief Publish the loaded tags as a new snapshot. m_critSection must be held.
+     */
+    void PublishSnapshot(void) const;
+
+    /*!
+     * @brief Get the latest snapshot of the loaded tags.
+     */
+    EpgTagsSnapshotPtr GetSnapshot(void) const;
+
+    /*!
+     * @brief Get a snapshot that contains all tags overlapping the given time range.
+     *        The table is only locked if the range has to be loaded from the database first.
+     * @param iStart The start of the range in UTC.
+     * @param iEnd The end of the range in UTC.
+     */
+    EpgTagsSnapshotPtr GetSnapshot(time_t iStart, time_t iEnd) const;
+    EpgTagsSnapshotPtr GetSnapshot(const CDateTime &start, const CDateTime &end) const;
+
+    /*!
+     * @brief Get a snapshot that contains the tags in the window around the current time.
+     */
+    EpgTagsSnapshotPtr GetCurrentSnapshot(void) const;
+
+    /*!
+     * @brief Find the tag with the given start time in a snapshot.
+     * @return The tag or tags.end() if it wasn't found.
+     */
+    static EpgTags::const_iterator FindTag(const EpgTags &tags, const CDateTime &start);
+
+    /*!
+     * @brief Find the loaded tag with the given start time.
+     * @return The tag or m_tags.end() if it wasn't found.
+     */
+    EpgTags::iterator FindTag(const CDateTime &start) const;
+
+    /*!
+     * @brief Find the tag with the given unique broadcast id, loading it from the database if needed.
+     * @return The tag or m_tags.end() if it wasn't found.
+     */
+    EpgTags::iterator FindTagByBroadcastId(unsigned int iUniqueBroadcastId) const;
+
+    /*!
+     * @brief Insert a tag at its position in m_tags.
+     * @return The position of the tag.
+     */
+    EpgTags::iterator InsertTag(const CPVREpgInfoTagPtr &tag) const;
+
+    /*!
+     * @brief Add tags loaded from the database. Tags that are already loaded are kept as they are.
+     * @param tags The tags to add, sorted by start time.
+     * @return True if any tag was added, false otherwise.
+     */
+    bool MergeTags(const EpgTags &tags) const;
+
+    /*!
+     * @brief Merge a tag into the loaded tags without publishing a new snapshot. m_critSection must be held.
+     * @param tag The tag to merge.
+     * @param bUpdateDatabase If set to true, the tag will be persisted in the database if it changed.
+     * @param infoTag Set to the loaded instance of the tag.
+     * @return True if the tag was added or a changed copy replaced the loaded one, false if nothing changed.
+     */
+    bool MergeEntry(const CPVREpgInfoTagPtr &tag, bool bUpdateDatabase, CPVREpgInfoTagPtr &infoTag);
+
+    /*!
+     * @brief Copy a loaded tag. Loaded tags are shared with the published snapshots and are
+     *        never changed in place, a changed copy replaces them instead.
+     * @param tag The tag to copy.
+     * @return The copy, including the timer and recording of the tag.
+     */
+    static CPVREpgInfoTagPtr CopyTag(const CPVREpgInfoTagPtr &tag);
+
+    /*!
+     * @brief Let a pending database write of a tag use the given instance. m_critSection must be held.
+     * @param tag The instance that replaced the loaded tag.
+     */
+    void ReplaceChangedTag(const CPVREpgInfoTagPtr &tag);
+
+    /*!
+     * @brief Make sure that all tags in the database that overlap the given time range are loaded.
+     * @param start The start of the range in UTC.
+     * @param end The end of the range in UTC.
+     */
+    void LoadRange(const CDateTime &start, const CDateTime &end) const;
+    void LoadRange(time_t iStart, time_t iEnd) const;
+
+    /*!
+     * @brief Make sure that the tags in the window around the current time are loaded.
+     */
+    void LoadCurrent(void) const;
+
+    /*!
+     * @brief Make sure that all tags in the database are loaded.
+     */
+    void LoadAll(void) const;
+
     /*!
-     * @brief Add an infotag to this container.
-     * @param tag The tag to add.
+     * @brief Get the time range covered by the tags in the database, if not known yet.
      */
-    void AddEntry(const CPVREpgInfoTag &tag);
+    void LoadTagsRange(void) const;
 
     /*!
      * @brief Load all EPG entries from clients into a temporary table and update this table with the contents of that temporary table.
@@ -324,7 +454,8 @@ namespace PVR
      */
     bool UpdateEntries(const CPVREpg &epg, bool bStoreInDb = true);
 
-    std::map<CDateTime, CPVREpgInfoTagPtr> m_tags;
+    mutable EpgTags                     m_tags;            /*!< the loaded tags, sorted by start time */
+    mutable EpgTagsSnapshotPtr          m_snapshot;        /*!< the latest published version of m_tags, only accessed atomically */
     std::map<int, CPVREpgInfoTagPtr>       m_changedTags;
     std::map<int, CPVREpgInfoTagPtr>       m_deletedTags;
     bool                                m_bChanged;        /*!< true if anything changed that needs to be persisted, false otherwise */
@@ -334,13 +465,21 @@ namespace PVR
     int                                 m_iEpgID;          /*!< the database ID of this table */
     std::string                         m_strName;         /*!< the name of this table */
     std::string                         m_strScraperName;  /*!< the name of the scraper to use */
-    mutable CDateTime                   m_nowActiveStart;  /*!< the start time of the tag that is currently active */
+    mutable CPVREpgInfoTagPtr           m_nowActiveTag;    /*!< the tag that is currently active, only accessed atomically */
 
     CDateTime                           m_lastScanTime;    /*!< the last time the EPG has been updated */
 
     PVR::CPVRChannelPtr                 m_pvrChannel;      /*!< the channel this EPG belongs to */
 
-    CCriticalSection                    m_critSection;     /*!< critical section for changes in this table */
+    mutable CCriticalSection            m_critSection;     /*!< critical section for changes in this table */
     bool                                m_bUpdateLastScanTime;
+    bool                                m_bTransferring;   /*!< true while a client transfers tags, which are published once it is done */
+
+    CPVREpgDatabasePtr                  m_database;        /*!< the database to load tags from on demand, NULL if the table isn't backed by the database */
+    mutable std::vector<TimeRange>      m_loadedRanges;    /*!< sorted, disjoint time ranges in which all tags of the database are loaded */
+    mutable bool                        m_bTagsRangeValid; /*!< true when the time range of the tags in the database is known */
+    mutable CDateTime                   m_firstStart;      /*!< the start time of the first tag in the database */
+    mutable CDateTime                   m_lastStart;       /*!< the start time of the last tag in the database */
+    mutable CDateTime                   m_lastEnd;         /*!< the latest end time of the tags in the database */
   };
 }
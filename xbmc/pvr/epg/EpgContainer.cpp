@@ -24,6 +24,7 @@
 
 #include "Application.h"
 #include "ServiceBroker.h"
+#include "addons/PVRClient.h"
 #include "guilib/LocalizeStrings.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -37,6 +38,8 @@
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/epg/Epg.h"
 #include "pvr/epg/EpgSearchFilter.h"
+#include "pvr/epg/EpgStringPool.h"
+#include "pvr/epg/EpgUpdateScheduler.h"
 #include "pvr/recordings/PVRRecordings.h"
 #include "pvr/timers/PVRTimerInfoTag.h"
 
@@ -586,14 +589,20 @@ bool CPVREpgContainer::RemoveOldEntries(void)
 {
   const CDateTime cleanupTime(CDateTime::GetUTCDateTime() - CDateTimeSpan(GetPastDaysToDisplay(), 0, 0, 0));
 
-  /* call Cleanup() on all known EPG tables */
+  /* call Cleanup() on all known EPG tables and drop the entries outside of the current window from memory */
   for (const auto &epgEntry : m_epgs)
+  {
     epgEntry.second->Cleanup(cleanupTime);
+    epgEntry.second->Trim();
+  }
 
   /* remove the old entries from the database */
   if (!IgnoreDB())
     m_database->DeleteEpgEntries(cleanupTime);
 
+  /* release titles and genres that are not used anymore */
+  CPVREpgStringPool::GetInstance().Purge();
+
   CSingleLock lock(m_critSection);
   CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(m_iLastEpgCleanup);
 
@@ -682,42 +691,57 @@ bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
   if (bShowProgress && !bOnlyPending)
     progressHandler = new CPVRGUIProgressHandler(g_localizeStrings.Get(19004)); // Importing guide from clients
 
-  /* load or update all EPG tables */
-  unsigned int iCounter(0);
-  for (const auto &epgEntry : m_epgs)
+  /* load or update all EPG tables, the tables of different clients in parallel */
+  const unsigned int iUpdateStart = XbmcThreads::SystemClockMillis();
+  CPVREpgUpdateScheduler scheduler(g_advancedSettings.m_iEpgClientRequestInterval, g_advancedSettings.m_iEpgClientUpdateTimeout * 1000);
+  CCriticalSection invalidTablesSection;
+  const int iUpdateTime = m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60;
+
+  // we currently only support update via pvr add-ons. skip update when the pvr manager isn't started
+  if (CServiceBroker::GetPVRManager().IsStarted())
   {
-    if (InterruptUpdate())
+    for (const auto &epgEntry : m_epgs)
     {
-      bInterrupted = true;
-      break;
-    }
-
-    CPVREpgPtr epg = epgEntry.second;
-    if (!epg)
-      continue;
+      CPVREpgPtr epg = epgEntry.second;
+      if (!epg || (bOnlyPending && !epg->UpdatePending()))
+        continue;
 
-    if (bShowProgress && !bOnlyPending)
-      progressHandler->UpdateProgress(epg->Name(), ++iCounter, m_epgs.size());
+      // check the pvr manager when the channel pointer isn't set
+      if (!epg->Channel())
+      {
+        CPVRChannelPtr channel = CServiceBroker::GetPVRManager().ChannelGroups()->GetChannelByEpgId(epg->EpgID());
+        if (channel)
+          epg->SetChannel(channel);
+      }
 
-    // we currently only support update via pvr add-ons. skip update when the pvr manager isn't started
-    if (!CServiceBroker::GetPVRManager().IsStarted())
-      continue;
+      const CPVRChannelPtr channel = epg->Channel();
+      scheduler.Add(channel ? channel->ClientID() : PVR_INVALID_CLIENT_ID, epg->Name(),
+                    [epg, start, end, iUpdateTime, bOnlyPending, &invalidTables, &invalidTablesSection]() {
+        if (epg->Update(start, end, iUpdateTime, bOnlyPending))
+          return true;
 
-    // check the pvr manager when the channel pointer isn't set
-    if (!epg->Channel())
-    {
-      CPVRChannelPtr channel = CServiceBroker::GetPVRManager().ChannelGroups()->GetChannelByEpgId(epg->EpgID());
-      if (channel)
-        epg->SetChannel(channel);
+        if (!epg->IsValid())
+        {
+          CSingleLock lock(invalidTablesSection);
+          invalidTables.push_back(epg);
+        }
+        return false;
+      });
     }
-
-    if ((!bOnlyPending || epg->UpdatePending()) &&
-        epg->Update(start, end, m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60, bOnlyPending))
-      iUpdatedTables++;
-    else if (!epg->IsValid())
-      invalidTables.push_back(epg);
   }
 
+  bInterrupted = !scheduler.Run([progressHandler](const std::string &strName, unsigned int iDone, unsigned int iTotal) {
+    if (progressHandler)
+      progressHandler->UpdateProgress(strName, iDone, iTotal);
+  }, [this]() {
+    return InterruptUpdate();
+  });
+  iUpdatedTables = scheduler.GetUpdatedTables();
+
+  CLog::Log(m_bIsInitialising ? LOGNOTICE : LOGDEBUG, "EPG - %s - %s of %u tables from %d clients finished in %u ms", __FUNCTION__,
+            m_bIsInitialising ? "initial import" : "update", iUpdatedTables, static_cast<int>(scheduler.GetClientCount()),
+            XbmcThreads::SystemClockMillis() - iUpdateStart);
+
   if (bShowProgress && !bOnlyPending)
     progressHandler->DestroyProgress();
 
@@ -793,11 +817,36 @@ int CPVREpgContainer::GetEPGSearch(CFileItemList &results, const CPVREpgSearchFi
 {
   int iInitialSize = results.Size();
 
+  /* let the full text index pick the candidates if the search term allows it */
+  std::map<int, std::vector<CPVREpgInfoTagPtr>> candidates;
+  bool bUseIndex(false);
+  const std::vector<std::string> words = filter.GetFullTextWords();
+  const CPVREpgDatabasePtr database = GetEpgDatabase();
+  if (!words.empty() && !IgnoreDB() && database && database->HasFullTextIndex())
+  {
+    bUseIndex = database->GetEpgTagsByFullText(words,
+                                               filter.GetStartDateTime().GetAsUTCDateTime(),
+                                               filter.GetEndDateTime().GetAsUTCDateTime(),
+                                               filter.GetUniqueBroadcastId(),
+                                               candidates);
+  }
+
   /* get filtered results from all tables */
   {
     CSingleLock lock(m_critSection);
     for (const auto &epgEntry : m_epgs)
-      epgEntry.second->Get(results, filter);
+    {
+      /* tables with unsaved changes are not in sync with the index */
+      if (!bUseIndex || epgEntry.second->NeedsSave())
+      {
+        epgEntry.second->Get(results, filter);
+        continue;
+      }
+
+      const auto it = candidates.find(epgEntry.second->EpgID());
+      if (it != candidates.end())
+        epgEntry.second->Get(results, filter, it->second);
+    }
   }
 
   /* remove duplicate entries */
@@ -20,10 +20,14 @@
 
 #include "EpgDatabase.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <memory>
+#include <set>
 
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
 #include "dbwrappers/dataset.h"
+#include "dbwrappers/sqlitedataset.h"
 #include "settings/AdvancedSettings.h"
 #include "system.h"
 #include "utils/log.h"
@@ -34,10 +38,18 @@
 using namespace dbiplus;
 using namespace PVR;
 
+/* more indexed words than this containing the search words make the index slower than a scan */
+static const size_t FULL_TEXT_MAX_TERMS = 500;
+
 bool CPVREpgDatabase::Open()
 {
   CSingleLock lock(m_critSection);
-  return CDatabase::Open(g_advancedSettings.m_databaseEpg);
+  if (!CDatabase::Open(g_advancedSettings.m_databaseEpg))
+    return false;
+
+  /* the full text index is optional, it needs a sqlite build with fts4 */
+  m_bFullTextIndex = m_sqlite && !GetSingleValue("sqlite_master", "name", "type = 'table' AND name = 'epgtags_fts'").empty();
+  return true;
 }
 
 void CPVREpgDatabase::Close()
@@ -110,6 +122,28 @@ void CPVREpgDatabase::CreateTables(void)
         "sLastScan varchar(20)"
       ")"
   );
+
+  CreateFullTextIndex();
+}
+
+void CPVREpgDatabase::CreateFullTextIndex()
+{
+  if (!m_sqlite)
+    return;
+
+  CLog::Log(LOGDEBUG, "EpgDB - %s - creating table 'epgtags_fts'", __FUNCTION__);
+  try
+  {
+    /* contentless would be smaller, but needs a newer sqlite than we can rely on */
+    m_pDS->exec("CREATE VIRTUAL TABLE epgtags_fts USING fts4(sTitle, sPlotOutline, sPlot, tokenize=unicode61)");
+    m_pDS->exec("INSERT INTO epgtags_fts(docid, sTitle, sPlotOutline, sPlot) SELECT idBroadcast, sTitle, sPlotOutline, sPlot FROM epgtags");
+    /* the words of the index, to find the ones containing a search term */
+    m_pDS->exec("CREATE VIRTUAL TABLE epgtags_fts_terms USING fts4aux(epgtags_fts)");
+  }
+  catch (...)
+  {
+    CLog::Log(LOGNOTICE, "EpgDB - %s - full text search is not available, searching the guide will be slow", __FUNCTION__);
+  }
 }
 
 void CPVREpgDatabase::CreateAnalytics()
@@ -119,6 +153,22 @@ void CPVREpgDatabase::CreateAnalytics()
   CSingleLock lock(m_critSection);
   m_pDS->exec("CREATE UNIQUE INDEX idx_epg_idEpg_iStartTime on epgtags(idEpg, iStartTime desc);");
   m_pDS->exec("CREATE INDEX idx_epg_iEndTime on epgtags(iEndTime);");
+
+  /* keep the full text index in sync with every write to epgtags */
+  if (m_sqlite && !GetSingleValue("sqlite_master", "name", "type = 'table' AND name = 'epgtags_fts'").empty())
+  {
+    CLog::Log(LOGDEBUG, "%s - creating triggers", __FUNCTION__);
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_insert AFTER INSERT ON epgtags FOR EACH ROW BEGIN "
+                "DELETE FROM epgtags_fts WHERE docid = new.idBroadcast; "
+                "INSERT INTO epgtags_fts(docid, sTitle, sPlotOutline, sPlot) VALUES (new.idBroadcast, new.sTitle, new.sPlotOutline, new.sPlot); "
+                "END");
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_update AFTER UPDATE OF sTitle, sPlotOutline, sPlot ON epgtags FOR EACH ROW BEGIN "
+                "UPDATE epgtags_fts SET sTitle = new.sTitle, sPlotOutline = new.sPlotOutline, sPlot = new.sPlot WHERE docid = new.idBroadcast; "
+                "END");
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_delete AFTER DELETE ON epgtags FOR EACH ROW BEGIN "
+                "DELETE FROM epgtags_fts WHERE docid = old.idBroadcast; "
+                "END");
+  }
 }
 
 void CPVREpgDatabase::UpdateTables(int iVersion)
@@ -144,6 +194,11 @@ void CPVREpgDatabase::UpdateTables(int iVersion)
   {
     m_pDS->exec("ALTER TABLE epgtags ADD iFlags integer;");
   }
+
+  if (iVersion < 12)
+    CreateFullTextIndex();
+  else if (iVersion < 13 && m_sqlite && !GetSingleValue("sqlite_master", "name", "type = 'table' AND name = 'epgtags_fts'").empty())
+    m_pDS->exec("CREATE VIRTUAL TABLE epgtags_fts_terms USING fts4aux(epgtags_fts)");
 }
 
 bool CPVREpgDatabase::DeleteEpg(void)
@@ -185,7 +240,14 @@ bool CPVREpgDatabase::DeleteEpgEntries(const CDateTime &maxEndTime)
 
   CSingleLock lock(m_critSection);
   filter.AppendWhere(PrepareSQL("iEndTime < %u", iMaxEndTime));
-  return DeleteValues("epgtags", filter);
+  if (!DeleteValues("epgtags", filter))
+    return false;
+
+  /* rows replaced by a REPLACE on another broadcast id don't fire the delete trigger */
+  if (m_bFullTextIndex)
+    ExecuteQuery("DELETE FROM epgtags_fts WHERE docid NOT IN (SELECT idBroadcast FROM epgtags)");
+
+  return true;
 }
 
 bool CPVREpgDatabase::Delete(const CPVREpgInfoTag &tag)
@@ -234,74 +296,230 @@ int CPVREpgDatabase::Get(CPVREpgContainer &container)
   return iReturn;
 }
 
-int CPVREpgDatabase::Get(CPVREpg &epg)
+std::vector<CPVREpgInfoTagPtr> CPVREpgDatabase::GetEpgTags(int iEpgID, const CDateTime &start, const CDateTime &end)
 {
-  int iReturn(-1);
+  std::vector<CPVREpgInfoTagPtr> tags;
+
+  Filter filter;
+  filter.AppendWhere(PrepareSQL("idEpg = %u", iEpgID));
+  if (start.IsValid())
+  {
+    time_t iStartTime;
+    start.GetAsTime(iStartTime);
+    filter.AppendWhere(PrepareSQL("iEndTime > %u", static_cast<unsigned int>(iStartTime)));
+  }
+  if (end.IsValid())
+  {
+    time_t iEndTime;
+    end.GetAsTime(iEndTime);
+    filter.AppendWhere(PrepareSQL("iStartTime < %u", static_cast<unsigned int>(iEndTime)));
+  }
+
+  filter.AppendOrder("iStartTime");
 
   CSingleLock lock(m_critSection);
-  std::string strQuery = PrepareSQL("SELECT * FROM epgtags WHERE idEpg = %u;", epg.EpgID());
+  std::string strQuery;
+  BuildSQL("SELECT * FROM epgtags", filter, strQuery);
   if (ResultQuery(strQuery))
   {
-    iReturn = 0;
     try
     {
       while (!m_pDS->eof())
       {
-        CPVREpgInfoTagPtr newTag(new CPVREpgInfoTag());
-
-        time_t iStartTime, iEndTime, iFirstAired;
-        iStartTime = (time_t) m_pDS->fv("iStartTime").get_asInt();
-        CDateTime startTime(iStartTime);
-        newTag->m_startTime = startTime;
-
-        iEndTime = (time_t) m_pDS->fv("iEndTime").get_asInt();
-        CDateTime endTime(iEndTime);
-        newTag->m_endTime = endTime;
-
-        iFirstAired = (time_t) m_pDS->fv("iFirstAired").get_asInt();
-        CDateTime firstAired(iFirstAired);
-        newTag->m_firstAired = firstAired;
-
-        int iBroadcastUID = m_pDS->fv("iBroadcastUid").get_asInt();
-        // Compat: null value for broadcast uid changed from numerical -1 to 0 with PVR Addon API v4.0.0
-        newTag->m_iUniqueBroadcastID = iBroadcastUID == -1 ? EPG_TAG_INVALID_UID : iBroadcastUID;
-
-        newTag->m_iBroadcastId       = m_pDS->fv("idBroadcast").get_asInt();
-        newTag->m_strTitle           = m_pDS->fv("sTitle").get_asString().c_str();
-        newTag->m_strPlotOutline     = m_pDS->fv("sPlotOutline").get_asString().c_str();
-        newTag->m_strPlot            = m_pDS->fv("sPlot").get_asString().c_str();
-        newTag->m_strOriginalTitle   = m_pDS->fv("sOriginalTitle").get_asString().c_str();
-        newTag->m_cast               = newTag->Tokenize(m_pDS->fv("sCast").get_asString());
-        newTag->m_directors          = newTag->Tokenize(m_pDS->fv("sDirector").get_asString());
-        newTag->m_writers            = newTag->Tokenize(m_pDS->fv("sWriter").get_asString());
-        newTag->m_iYear              = m_pDS->fv("iYear").get_asInt();
-        newTag->m_strIMDBNumber      = m_pDS->fv("sIMDBNumber").get_asString().c_str();
-        newTag->m_iGenreType         = m_pDS->fv("iGenreType").get_asInt();
-        newTag->m_iGenreSubType      = m_pDS->fv("iGenreSubType").get_asInt();
-        newTag->m_genre              = newTag->Tokenize(m_pDS->fv("sGenre").get_asString());
-        newTag->m_iParentalRating    = m_pDS->fv("iParentalRating").get_asInt();
-        newTag->m_iStarRating        = m_pDS->fv("iStarRating").get_asInt();
-        newTag->m_bNotify            = m_pDS->fv("bNotify").get_asBool();
-        newTag->m_iEpisodeNumber     = m_pDS->fv("iEpisodeId").get_asInt();
-        newTag->m_iEpisodePart       = m_pDS->fv("iEpisodePart").get_asInt();
-        newTag->m_strEpisodeName     = m_pDS->fv("sEpisodeName").get_asString().c_str();
-        newTag->m_iSeriesNumber      = m_pDS->fv("iSeriesId").get_asInt();
-        newTag->m_strIconPath        = m_pDS->fv("sIconPath").get_asString().c_str();
-        newTag->m_iFlags             = m_pDS->fv("iFlags").get_asInt();
-
-        epg.AddEntry(*newTag);
-        ++iReturn;
+        tags.emplace_back(CreateEpgTag());
+        m_pDS->next();
+      }
+      m_pDS->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - couldn't load EPG data from the database", __FUNCTION__);
+    }
+  }
+  return tags;
+}
+
+CPVREpgInfoTagPtr CPVREpgDatabase::GetEpgTagByUniqueBroadcastID(int iEpgID, unsigned int iUniqueBroadcastId)
+{
+  CPVREpgInfoTagPtr tag;
+
+  CSingleLock lock(m_critSection);
+  std::string strQuery = PrepareSQL("SELECT * FROM epgtags WHERE idEpg = %u AND iBroadcastUid = %u;", iEpgID, iUniqueBroadcastId);
+  if (ResultQuery(strQuery))
+  {
+    try
+    {
+      if (!m_pDS->eof())
+        tag = CreateEpgTag();
+      m_pDS->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - couldn't load EPG data from the database", __FUNCTION__);
+    }
+  }
+  return tag;
+}
+
+bool CPVREpgDatabase::GetEpgTagsByFullText(const std::vector<std::string> &words, const CDateTime &start, const CDateTime &end, unsigned int iUniqueBroadcastId,
+                                           std::map<int, std::vector<CPVREpgInfoTagPtr>> &tags)
+{
+  CSingleLock lock(m_critSection);
+  if (!m_bFullTextIndex || words.empty())
+    return false;
+
+  /* the index only matches whole words and word prefixes, look up the indexed words that contain
+     the search words anywhere. That's a scan of the vocabulary, which is a lot smaller than the tags */
+  std::set<std::string> terms;
+  for (const auto &word : words)
+  {
+    if (!ResultQuery(PrepareSQL("SELECT term FROM epgtags_fts_terms WHERE col = '*' AND instr(term, '%s') > 0", word.c_str())))
+      return false;
+
+    try
+    {
+      while (!m_pDS->eof())
+      {
+        terms.insert(m_pDS->fv(0).get_asString());
+        m_pDS->next();
+      }
+      m_pDS->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - couldn't search the EPG words in the database", __FUNCTION__);
+      return false;
+    }
+
+    /* a short word may be contained in most of the vocabulary, the scan is faster then */
+    if (terms.size() > FULL_TEXT_MAX_TERMS)
+      return false;
+  }
+
+  if (terms.empty())
+    return true;
+
+  std::string strMatch;
+  for (const auto &term : terms)
+  {
+    if (!strMatch.empty())
+      strMatch += " OR ";
+    strMatch += "\"" + term + "\"";
+  }
+
+  Filter filter;
+  filter.AppendWhere(PrepareSQL("epgtags_fts MATCH '%s'", strMatch.c_str()));
+  if (start.IsValid())
+  {
+    time_t iStartTime;
+    start.GetAsTime(iStartTime);
+    filter.AppendWhere(PrepareSQL("epgtags.iStartTime >= %u", static_cast<unsigned int>(iStartTime)));
+  }
+  if (end.IsValid())
+  {
+    time_t iEndTime;
+    end.GetAsTime(iEndTime);
+    filter.AppendWhere(PrepareSQL("epgtags.iEndTime <= %u", static_cast<unsigned int>(iEndTime)));
+  }
+  if (iUniqueBroadcastId != EPG_TAG_INVALID_UID)
+    filter.AppendWhere(PrepareSQL("epgtags.iBroadcastUid = %u", iUniqueBroadcastId));
+
+  filter.AppendOrder("epgtags.idEpg, epgtags.iStartTime");
 
+  std::string strQuery;
+  BuildSQL("SELECT epgtags.* FROM epgtags_fts JOIN epgtags ON epgtags.idBroadcast = epgtags_fts.docid", filter, strQuery);
+  if (ResultQuery(strQuery))
+  {
+    try
+    {
+      while (!m_pDS->eof())
+      {
+        tags[m_pDS->fv("idEpg").get_asInt()].emplace_back(CreateEpgTag());
         m_pDS->next();
       }
       m_pDS->close();
     }
     catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - couldn't search the EPG data in the database", __FUNCTION__);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CPVREpgDatabase::GetEpgTagsRange(int iEpgID, CDateTime &firstStart, CDateTime &lastStart, CDateTime &lastEnd)
+{
+  bool bReturn(false);
+
+  CSingleLock lock(m_critSection);
+  std::string strQuery = PrepareSQL("SELECT MIN(iStartTime), MAX(iStartTime), MAX(iEndTime) FROM epgtags WHERE idEpg = %u;", iEpgID);
+  if (ResultQuery(strQuery))
+  {
+    try
+    {
+      if (!m_pDS->eof() && !m_pDS->fv(0).get_isNull())
+      {
+        firstStart = CDateTime(static_cast<time_t>(m_pDS->fv(0).get_asInt()));
+        lastStart = CDateTime(static_cast<time_t>(m_pDS->fv(1).get_asInt()));
+        lastEnd = CDateTime(static_cast<time_t>(m_pDS->fv(2).get_asInt()));
+        bReturn = true;
+      }
+      m_pDS->close();
+    }
+    catch (...)
     {
       CLog::Log(LOGERROR, "%s - couldn't load EPG data from the database", __FUNCTION__);
     }
   }
-  return iReturn;
+  return bReturn;
+}
+
+CPVREpgInfoTagPtr CPVREpgDatabase::CreateEpgTag()
+{
+  CPVREpgInfoTagPtr newTag(new CPVREpgInfoTag());
+
+  time_t iStartTime, iEndTime, iFirstAired;
+  iStartTime = (time_t) m_pDS->fv("iStartTime").get_asInt();
+  CDateTime startTime(iStartTime);
+  newTag->m_startTime = startTime;
+
+  iEndTime = (time_t) m_pDS->fv("iEndTime").get_asInt();
+  CDateTime endTime(iEndTime);
+  newTag->m_endTime = endTime;
+
+  iFirstAired = (time_t) m_pDS->fv("iFirstAired").get_asInt();
+  CDateTime firstAired(iFirstAired);
+  newTag->m_firstAired = firstAired;
+
+  int iBroadcastUID = m_pDS->fv("iBroadcastUid").get_asInt();
+  // Compat: null value for broadcast uid changed from numerical -1 to 0 with PVR Addon API v4.0.0
+  newTag->m_iUniqueBroadcastID = iBroadcastUID == -1 ? EPG_TAG_INVALID_UID : iBroadcastUID;
+
+  newTag->m_iBroadcastId       = m_pDS->fv("idBroadcast").get_asInt();
+  newTag->m_strTitle           = m_pDS->fv("sTitle").get_asString().c_str();
+  newTag->m_strPlotOutline     = m_pDS->fv("sPlotOutline").get_asString().c_str();
+  newTag->m_strPlot            = m_pDS->fv("sPlot").get_asString().c_str();
+  newTag->m_strOriginalTitle   = m_pDS->fv("sOriginalTitle").get_asString().c_str();
+  newTag->m_cast               = newTag->Tokenize(m_pDS->fv("sCast").get_asString());
+  newTag->m_directors          = newTag->Tokenize(m_pDS->fv("sDirector").get_asString());
+  newTag->m_writers            = newTag->Tokenize(m_pDS->fv("sWriter").get_asString());
+  newTag->m_iYear              = m_pDS->fv("iYear").get_asInt();
+  newTag->m_strIMDBNumber      = m_pDS->fv("sIMDBNumber").get_asString().c_str();
+  newTag->m_iGenreType         = m_pDS->fv("iGenreType").get_asInt();
+  newTag->m_iGenreSubType      = m_pDS->fv("iGenreSubType").get_asInt();
+  newTag->m_strGenre           = m_pDS->fv("sGenre").get_asString();
+  newTag->m_iParentalRating    = m_pDS->fv("iParentalRating").get_asInt();
+  newTag->m_iStarRating        = m_pDS->fv("iStarRating").get_asInt();
+  newTag->m_bNotify            = m_pDS->fv("bNotify").get_asBool();
+  newTag->m_iEpisodeNumber     = m_pDS->fv("iEpisodeId").get_asInt();
+  newTag->m_iEpisodePart       = m_pDS->fv("iEpisodePart").get_asInt();
+  newTag->m_strEpisodeName     = m_pDS->fv("sEpisodeName").get_asString().c_str();
+  newTag->m_iSeriesNumber      = m_pDS->fv("iSeriesId").get_asInt();
+  newTag->m_strIconPath        = m_pDS->fv("sIconPath").get_asString().c_str();
+  newTag->m_iFlags             = m_pDS->fv("iFlags").get_asInt();
+
+  return newTag;
 }
 
 bool CPVREpgDatabase::GetLastEpgScanTime(int iEpgId, CDateTime *lastScan)
@@ -392,7 +610,7 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
         "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid) "
         "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
         tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
+        tag.m_strTitle.c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
         tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
         tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
         tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
@@ -408,7 +626,7 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
         "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid, idBroadcast) "
         "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i, %i);",
         tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
+        tag.m_strTitle.c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
         tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
         tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
         tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
@@ -431,6 +649,140 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
   return iReturn;
 }
 
+namespace
+{
+  /* max. number of ids in one DELETE ... IN () statement, sqlite allows 1 MB statements by default */
+  const size_t EPG_DELETE_CHUNK_SIZE = 1000;
+
+  void BindText(sqlite3_stmt *stmt, int iIndex, const std::string &strValue)
+  {
+    sqlite3_bind_text(stmt, iIndex, strValue.c_str(), static_cast<int>(strValue.size()), SQLITE_TRANSIENT);
+  }
+}
+
+bool CPVREpgDatabase::PersistTags(const std::vector<CPVREpgInfoTagPtr> &changedTags, const std::vector<CPVREpgInfoTagPtr> &deletedTags)
+{
+  if (changedTags.empty() && deletedTags.empty())
+    return true;
+
+  CSingleLock lock(m_critSection);
+
+  if (!m_sqlite)
+  {
+    for (const auto &tag : deletedTags)
+      Delete(*tag);
+    for (const auto &tag : changedTags)
+      Persist(*tag, false);
+    return CommitInsertQueries();
+  }
+
+  sqlite3 *db = static_cast<dbiplus::SqliteDatabase*>(m_pDB.get())->getHandle();
+  bool bReturn(true);
+
+  BeginTransaction();
+
+  for (size_t iChunk = 0; bReturn && iChunk < deletedTags.size(); iChunk += EPG_DELETE_CHUNK_SIZE)
+  {
+    std::string strIds;
+    const size_t iChunkEnd = std::min(iChunk + EPG_DELETE_CHUNK_SIZE, deletedTags.size());
+    for (size_t i = iChunk; i < iChunkEnd; ++i)
+    {
+      /* tag without a database ID was not persisted */
+      if (deletedTags[i]->BroadcastId() <= 0)
+        continue;
+
+      if (!strIds.empty())
+        strIds += ",";
+      strIds += StringUtils::Format("%d", deletedTags[i]->BroadcastId());
+    }
+
+    if (!strIds.empty())
+      bReturn = ExecuteQuery("DELETE FROM epgtags WHERE idBroadcast IN (" + strIds + ")");
+  }
+
+  if (bReturn && !changedTags.empty())
+  {
+    std::unique_ptr<sqlite3_stmt, int(*)(sqlite3_stmt*)> stmt(nullptr, sqlite3_finalize);
+    sqlite3_stmt *rawStmt = nullptr;
+    if (sqlite3_prepare_v2(db, "REPLACE INTO epgtags (idEpg, iStartTime, "
+        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
+        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
+        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid, idBroadcast) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", -1, &rawStmt, nullptr) != SQLITE_OK)
+    {
+      CLog::Log(LOGERROR, "EpgDB - %s - failed to prepare statement: %s", __FUNCTION__, sqlite3_errmsg(db));
+      bReturn = false;
+    }
+    stmt.reset(rawStmt);
+
+    for (auto it = changedTags.begin(); bReturn && it != changedTags.end(); ++it)
+    {
+      const CPVREpgInfoTagPtr &tag = *it;
+      if (tag->EpgID() <= 0)
+      {
+        CLog::Log(LOGERROR, "EpgDB - %s - tag '%s' does not have a valid table", __FUNCTION__, tag->Title(true).c_str());
+        continue;
+      }
+
+      time_t iStartTime, iEndTime, iFirstAired;
+      tag->StartAsUTC().GetAsTime(iStartTime);
+      tag->EndAsUTC().GetAsTime(iEndTime);
+      tag->FirstAiredAsUTC().GetAsTime(iFirstAired);
+
+      sqlite3_bind_int(stmt.get(), 1, tag->EpgID());
+      sqlite3_bind_int64(stmt.get(), 2, static_cast<unsigned int>(iStartTime));
+      sqlite3_bind_int64(stmt.get(), 3, static_cast<unsigned int>(iEndTime));
+      BindText(stmt.get(), 4, tag->m_strTitle.str());
+      BindText(stmt.get(), 5, tag->PlotOutline(true));
+      BindText(stmt.get(), 6, tag->Plot(true));
+      BindText(stmt.get(), 7, tag->OriginalTitle(true));
+      BindText(stmt.get(), 8, tag->DeTokenize(tag->Cast()));
+      BindText(stmt.get(), 9, tag->DeTokenize(tag->Directors()));
+      BindText(stmt.get(), 10, tag->DeTokenize(tag->Writers()));
+      sqlite3_bind_int(stmt.get(), 11, tag->Year());
+      BindText(stmt.get(), 12, tag->IMDBNumber());
+      BindText(stmt.get(), 13, tag->Icon());
+      sqlite3_bind_int(stmt.get(), 14, tag->GenreType());
+      sqlite3_bind_int(stmt.get(), 15, tag->GenreSubType());
+      /* Only store the genre string when needed */
+      BindText(stmt.get(), 16, (tag->GenreType() == EPG_GENRE_USE_STRING) ? tag->DeTokenize(tag->Genre()) : "");
+      sqlite3_bind_int64(stmt.get(), 17, static_cast<unsigned int>(iFirstAired));
+      sqlite3_bind_int(stmt.get(), 18, tag->ParentalRating());
+      sqlite3_bind_int(stmt.get(), 19, tag->StarRating());
+      sqlite3_bind_int(stmt.get(), 20, tag->Notify());
+      sqlite3_bind_int(stmt.get(), 21, tag->SeriesNumber());
+      sqlite3_bind_int(stmt.get(), 22, tag->EpisodeNumber());
+      sqlite3_bind_int(stmt.get(), 23, tag->EpisodePart());
+      BindText(stmt.get(), 24, tag->EpisodeName(true));
+      sqlite3_bind_int(stmt.get(), 25, tag->Flags());
+      sqlite3_bind_int(stmt.get(), 26, static_cast<int>(tag->UniqueBroadcastID()));
+      if (tag->BroadcastId() > 0)
+        sqlite3_bind_int(stmt.get(), 27, tag->BroadcastId());
+      else
+        sqlite3_bind_null(stmt.get(), 27);
+
+      if (sqlite3_step(stmt.get()) != SQLITE_DONE)
+      {
+        CLog::Log(LOGERROR, "EpgDB - %s - failed to persist tag '%s': %s", __FUNCTION__, tag->Title(true).c_str(), sqlite3_errmsg(db));
+        bReturn = false;
+      }
+      else if (tag->BroadcastId() <= 0)
+      {
+        tag->m_iBroadcastId = static_cast<int>(sqlite3_last_insert_rowid(db));
+      }
+
+      sqlite3_reset(stmt.get());
+    }
+  }
+
+  if (bReturn)
+    bReturn = CommitTransaction();
+  else
+    RollbackTransaction();
+
+  return bReturn;
+}
+
 int CPVREpgDatabase::GetLastEPGId(void)
 {
   CSingleLock lock(m_critSection);
@@ -19,6 +19,10 @@
  *
  */
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "XBDateTime.h"
 #include "dbwrappers/Database.h"
 #include "threads/CriticalSection.h"
@@ -70,7 +74,7 @@ namespace PVR
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
      */
-    int GetSchemaVersion(void) const override { return 11; }
+    int GetSchemaVersion(void) const override { return 13; }
 
     /*!
      * @brief Get the default sqlite database filename.
@@ -116,11 +120,48 @@ namespace PVR
     int Get(CPVREpgContainer &container);
 
     /*!
-     * @brief Get all EPG entries for a table.
-     * @param epg The EPG table to get the entries for.
-     * @return The amount of entries that was added.
+     * @brief Get the EPG entries of a table that overlap the given time range.
+     * @param iEpgID The table to get the entries for.
+     * @param start The start of the range in UTC. Use an invalid time to get all entries before end.
+     * @param end The end of the range in UTC. Use an invalid time to get all entries after start.
+     * @return The entries, sorted by start time.
+     */
+    std::vector<CPVREpgInfoTagPtr> GetEpgTags(int iEpgID, const CDateTime &start, const CDateTime &end);
+
+    /*!
+     * @brief Get an EPG entry of a table.
+     * @param iEpgID The table to get the entry for.
+     * @param iUniqueBroadcastId The unique broadcast id of the entry.
+     * @return The entry or NULL if it wasn't found.
+     */
+    CPVREpgInfoTagPtr GetEpgTagByUniqueBroadcastID(int iEpgID, unsigned int iUniqueBroadcastId);
+
+    /*!
+     * @brief Get the time range covered by the entries of a table.
+     * @param iEpgID The table.
+     * @param firstStart The start time of the first entry in UTC.
+     * @param lastStart The start time of the last entry in UTC.
+     * @param lastEnd The latest end time of all entries in UTC.
+     * @return True if the table has any entries, false otherwise.
+     */
+    bool GetEpgTagsRange(int iEpgID, CDateTime &firstStart, CDateTime &lastStart, CDateTime &lastEnd);
+
+    /*!
+     * @return True if the database has a full text index on the EPG entries.
      */
-    int Get(CPVREpg &epg);
+    bool HasFullTextIndex(void) const { return m_bFullTextIndex; }
+
+    /*!
+     * @brief Get the EPG entries of all tables with an indexed word containing one of the given words.
+     * @param words The words to look for in title, plot outline and plot, in lower case.
+     * @param start Only get entries that start at or after this time in UTC. Use an invalid time to ignore it.
+     * @param end Only get entries that end at or before this time in UTC. Use an invalid time to ignore it.
+     * @param iUniqueBroadcastId Only get entries with this unique broadcast id. Use EPG_TAG_INVALID_UID to ignore it.
+     * @param tags The entries, grouped by table and sorted by start time.
+     * @return False if the index can't narrow down the entries, e.g. because too many indexed words contain the given ones.
+     */
+    bool GetEpgTagsByFullText(const std::vector<std::string> &words, const CDateTime &start, const CDateTime &end, unsigned int iUniqueBroadcastId,
+                              std::map<int, std::vector<CPVREpgInfoTagPtr>> &tags);
 
     /*!
      * @brief Get the last stored EPG scan time.
@@ -154,6 +195,16 @@ namespace PVR
      */
     int Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate = true);
 
+    /*!
+     * @brief Write and delete EPG entries in one transaction.
+     *
+     * sqlite databases use a single prepared statement for all entries, other databases queue one query per entry.
+     * @param changedTags The entries to persist. Entries without a database ID get the ID of their new row.
+     * @param deletedTags The entries to remove.
+     * @return True if all entries were written, false otherwise.
+     */
+    bool PersistTags(const std::vector<CPVREpgInfoTagPtr> &changedTags, const std::vector<CPVREpgInfoTagPtr> &deletedTags);
+
     /*!
      * @return Last EPG id in the database
      */
@@ -178,8 +229,19 @@ namespace PVR
      */
     void UpdateTables(int version) override;
 
+    /*!
+     * @brief Create and fill the full text index of the EPG entries if sqlite supports it.
+     */
+    void CreateFullTextIndex();
+
     int GetMinSchemaVersion() const override { return 4; }
 
+    /*!
+     * @brief Create an EPG entry from the current row of the dataset.
+     */
+    CPVREpgInfoTagPtr CreateEpgTag();
+
     CCriticalSection m_critSection;
+    bool m_bFullTextIndex = false;
   };
 }
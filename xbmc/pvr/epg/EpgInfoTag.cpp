@@ -166,7 +166,7 @@ bool CPVREpgInfoTag::operator ==(const CPVREpgInfoTag& right) const
           m_writers            == right.m_writers &&
           m_iYear              == right.m_iYear &&
           m_strIMDBNumber      == right.m_strIMDBNumber &&
-          m_genre              == right.m_genre &&
+          m_strGenre           == right.m_strGenre &&
           m_strEpisodeName     == right.m_strEpisodeName &&
           m_strIconPath        == right.m_strIconPath &&
           m_strFileNameAndPath == right.m_strFileNameAndPath &&
@@ -183,6 +183,37 @@ bool CPVREpgInfoTag::operator !=(const CPVREpgInfoTag& right) const
   return !(*this == right);
 }
 
+bool CPVREpgInfoTag::PersistedDataEquals(const CPVREpgInfoTag& right) const
+{
+  if (this == &right) return true;
+
+  return (m_bNotify            == right.m_bNotify &&
+          m_iGenreType         == right.m_iGenreType &&
+          m_iGenreSubType      == right.m_iGenreSubType &&
+          m_iParentalRating    == right.m_iParentalRating &&
+          m_firstAired         == right.m_firstAired &&
+          m_iStarRating        == right.m_iStarRating &&
+          m_iSeriesNumber      == right.m_iSeriesNumber &&
+          m_iEpisodeNumber     == right.m_iEpisodeNumber &&
+          m_iEpisodePart       == right.m_iEpisodePart &&
+          m_iUniqueBroadcastID == right.m_iUniqueBroadcastID &&
+          m_strTitle           == right.m_strTitle &&
+          m_strPlotOutline     == right.m_strPlotOutline &&
+          m_strPlot            == right.m_strPlot &&
+          m_strOriginalTitle   == right.m_strOriginalTitle &&
+          m_cast               == right.m_cast &&
+          m_directors          == right.m_directors &&
+          m_writers            == right.m_writers &&
+          m_iYear              == right.m_iYear &&
+          m_strIMDBNumber      == right.m_strIMDBNumber &&
+          (m_iGenreType != EPG_GENRE_USE_STRING || m_strGenre == right.m_strGenre) &&
+          m_strEpisodeName     == right.m_strEpisodeName &&
+          m_strIconPath        == right.m_strIconPath &&
+          m_startTime          == right.m_startTime &&
+          m_endTime            == right.m_endTime &&
+          m_iFlags             == right.m_iFlags);
+}
+
 void CPVREpgInfoTag::Serialize(CVariant &value) const
 {
   CPVRRecordingPtr recording(Recording());
@@ -190,7 +221,7 @@ void CPVREpgInfoTag::Serialize(CVariant &value) const
   value["channeluid"] = m_iUniqueChannelID;
   value["parentalrating"] = m_iParentalRating;
   value["rating"] = m_iStarRating;
-  value["title"] = m_strTitle;
+  value["title"] = m_strTitle.str();
   value["plotoutline"] = m_strPlotOutline;
   value["plot"] = m_strPlot;
   value["originaltitle"] = m_strOriginalTitle;
@@ -199,7 +230,7 @@ void CPVREpgInfoTag::Serialize(CVariant &value) const
   value["writer"] = DeTokenize(m_writers);
   value["year"] = m_iYear;
   value["imdbnumber"] = m_strIMDBNumber;
-  value["genre"] = m_genre;
+  value["genre"] = Genre();
   value["filenameandpath"] = m_strFileNameAndPath;
   value["starttime"] = m_startTime.IsValid() ? m_startTime.GetAsDBDateTime() : StringUtils::Empty;
   value["endtime"] = m_endTime.IsValid() ? m_endTime.GetAsDBDateTime() : StringUtils::Empty;
@@ -367,7 +398,7 @@ std::string CPVREpgInfoTag::Title(bool bOverrideParental /* = false */) const
   else if (m_strTitle.empty() && !CServiceBroker::GetSettings().GetBool(CSettings::SETTING_EPG_HIDENOINFOAVAILABLE))
     strTitle = g_localizeStrings.Get(19055); // no information available
   else
-    strTitle = m_strTitle;
+    strTitle = m_strTitle.str();
 
   return strTitle;
 }
@@ -439,7 +470,7 @@ const std::string CPVREpgInfoTag::GetWritersLabel() const
 
 const std::string CPVREpgInfoTag::GetGenresLabel() const
 {
-  return StringUtils::Join(m_genre, g_advancedSettings.m_videoItemSeparator);
+  return StringUtils::Join(Genre(), g_advancedSettings.m_videoItemSeparator);
 }
 
 int CPVREpgInfoTag::Year(void) const
@@ -462,12 +493,12 @@ void CPVREpgInfoTag::SetGenre(int iGenreType, int iGenreSubType, const char* str
     {
       /* Type and sub type are not given. No EPG color coding possible
        * Use the provided genre description as backup. */
-      m_genre = Tokenize(strGenre);
+      m_strGenre = strGenre;
     }
     else
     {
-      /* Determine the genre description from the type and subtype IDs */
-      m_genre = StringUtils::Split(CPVREpg::ConvertGenreIdToString(iGenreType, iGenreSubType), g_advancedSettings.m_videoItemSeparator);
+      /* The genre description is determined from the type and subtype IDs on demand */
+      m_strGenre = CPVREpgString();
     }
   }
 }
@@ -484,7 +515,10 @@ int CPVREpgInfoTag::GenreSubType(void) const
 
 const std::vector<std::string> CPVREpgInfoTag::Genre(void) const
 {
-  return m_genre;
+  if (m_iGenreType == EPG_GENRE_USE_STRING)
+    return Tokenize(m_strGenre);
+
+  return StringUtils::Split(CPVREpg::ConvertGenreIdToString(m_iGenreType, m_iGenreSubType), g_advancedSettings.m_videoItemSeparator);
 }
 
 CDateTime CPVREpgInfoTag::FirstAiredAsUTC(void) const
@@ -625,7 +659,7 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag &tag, bool bUpdateBroadcastId /
         m_iUniqueBroadcastID != tag.m_iUniqueBroadcastID ||
         m_iUniqueChannelID   != tag.m_iUniqueChannelID ||
         EpgID()              != tag.EpgID() ||
-        m_genre              != tag.m_genre ||
+        m_strGenre           != tag.m_strGenre ||
         m_strIconPath        != tag.m_strIconPath ||
         m_iFlags             != tag.m_iFlags ||
         m_strSeriesLink      != tag.m_strSeriesLink
@@ -661,16 +695,8 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag &tag, bool bUpdateBroadcastId /
         m_channel          = tag.m_channel;
       }
 
-      if (m_iGenreType == EPG_GENRE_USE_STRING)
-      {
-        /* No type/subtype. Use the provided description */
-        m_genre            = tag.m_genre;
-      }
-      else
-      {
-        /* Determine genre description by type/subtype */
-        m_genre = StringUtils::Split(CPVREpg::ConvertGenreIdToString(tag.m_iGenreType, tag.m_iGenreSubType), g_advancedSettings.m_videoItemSeparator);
-      }
+      /* No type/subtype. Use the provided description, otherwise it is determined by type/subtype */
+      m_strGenre           = m_iGenreType == EPG_GENRE_USE_STRING ? tag.m_strGenre : CPVREpgString();
       m_firstAired         = tag.m_firstAired;
       m_iParentalRating    = tag.m_iParentalRating;
       m_iStarRating        = tag.m_iStarRating;
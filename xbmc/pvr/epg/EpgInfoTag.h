@@ -29,6 +29,7 @@
 
 #include "pvr/PVRTypes.h"
 #include "pvr/channels/PVRChannel.h"
+#include "pvr/epg/EpgStringPool.h"
 #include "pvr/recordings/PVRRecording.h"
 #include "pvr/timers/PVRTimerInfoTag.h"
 
@@ -77,6 +78,13 @@ namespace PVR
     bool operator ==(const CPVREpgInfoTag& right) const;
     bool operator !=(const CPVREpgInfoTag& right) const;
 
+    /*!
+     * @brief Compare only the data that is stored in the EPG database.
+     * @param right The tag to compare with.
+     * @return True if persisting this tag would not change its database row, false otherwise.
+     */
+    bool PersistedDataEquals(const CPVREpgInfoTag& right) const;
+
     void Serialize(CVariant &value) const override;
 
     /*!
@@ -506,7 +514,7 @@ namespace PVR
     int                      m_iEpisodePart;       /*!< episode part number */
     unsigned int             m_iUniqueBroadcastID; /*!< unique broadcast ID */
     unsigned int             m_iUniqueChannelID;   /*!< unique channel ID */
-    std::string              m_strTitle;           /*!< title */
+    CPVREpgString            m_strTitle;           /*!< title, interned */
     std::string              m_strPlotOutline;     /*!< plot outline */
     std::string              m_strPlot;            /*!< plot */
     std::string              m_strOriginalTitle;   /*!< original title */
@@ -515,7 +523,7 @@ namespace PVR
     std::vector<std::string> m_writers;            /*!< writer(s) */
     int                      m_iYear;              /*!< year */
     std::string              m_strIMDBNumber;      /*!< imdb number */
-    std::vector<std::string> m_genre;              /*!< genre */
+    CPVREpgString            m_strGenre;           /*!< genre description if the genre type is EPG_GENRE_USE_STRING, interned */
     std::string              m_strEpisodeName;     /*!< episode name */
     std::string              m_strIconPath;        /*!< the path to the icon */
     std::string              m_strFileNameAndPath; /*!< the filename and path */
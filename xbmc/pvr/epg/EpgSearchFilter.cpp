@@ -20,9 +20,12 @@
 
 #include "EpgSearchFilter.h"
 
+#include <cctype>
+
 #include "FileItem.h"
 #include "ServiceBroker.h"
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
+#include "utils/StringUtils.h"
 #include "utils/TextSearch.h"
 #include "utils/log.h"
 
@@ -125,6 +128,65 @@ bool CPVREpgSearchFilter::MatchSearchTerm(const CPVREpgInfoTagPtr &tag) const
   return bReturn;
 }
 
+namespace
+{
+  /* the longest word of the term in lower case. The tokenizer folds and splits other scripts
+     differently than CTextSearch compares them, so only plain ASCII terms can be looked up */
+  bool GetLongestWord(const std::string &strTerm, std::string &strWord)
+  {
+    strWord.clear();
+    size_t iStart = 0;
+    for (size_t i = 0; i <= strTerm.size(); i++)
+    {
+      if (i < strTerm.size())
+      {
+        const unsigned char c = static_cast<unsigned char>(strTerm[i]);
+        if (c >= 0x80)
+          return false;
+        if (isalnum(c))
+          continue;
+      }
+
+      if (i - iStart > strWord.size())
+        strWord = strTerm.substr(iStart, i - iStart);
+      iStart = i + 1;
+    }
+
+    StringUtils::ToLower(strWord);
+    return true;
+  }
+}
+
+std::vector<std::string> CPVREpgSearchFilter::GetFullTextWords(const std::string &strSearchTerm)
+{
+  CTextSearch search(strSearchTerm, false, SEARCH_DEFAULT_OR);
+  std::string strWord;
+
+  /* a tag has to contain every AND term, the longest word of any of them is enough */
+  std::string strAndWord;
+  for (const auto &term : search.GetAndTerms())
+  {
+    if (GetLongestWord(term, strWord) && strWord.size() > strAndWord.size())
+      strAndWord = strWord;
+  }
+
+  if (!strAndWord.empty())
+    return std::vector<std::string>{strAndWord};
+
+  std::vector<std::string> words;
+  for (const auto &term : search.GetOrTerms())
+  {
+    if (!GetLongestWord(term, strWord) || strWord.empty())
+    {
+      /* this term matches tags the index can't find */
+      return std::vector<std::string>();
+    }
+    words.push_back(strWord);
+  }
+
+  return words;
+}
+
 bool CPVREpgSearchFilter::MatchBroadcastId(const CPVREpgInfoTagPtr &tag) const
 {
   if (m_iUniqueBroadcastId != EPG_TAG_INVALID_UID)
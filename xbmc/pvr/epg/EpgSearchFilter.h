@@ -19,6 +19,9 @@
  *
  */
 
+#include <string>
+#include <vector>
+
 #include "XBDateTime.h"
 
 #include "pvr/PVRTypes.h"
@@ -56,6 +59,24 @@ namespace PVR
      */
     static int RemoveDuplicates(CFileItemList &results);
 
+    /*!
+     * @brief Get the words the full text index can narrow the search down with.
+     * @return The words or an empty list if the search term can't be used to narrow down the tags.
+     */
+    std::vector<std::string> GetFullTextWords() const { return GetFullTextWords(m_strSearchTerm); }
+
+    /*!
+     * @brief Get the words the full text index can narrow the search down with.
+     *
+     * CTextSearch matches anywhere in the text, not only at the start of words. Every tag it
+     * matches has an indexed word that contains one of the returned words, so looking up the
+     * indexed words containing them selects a superset of the matching tags. Apply FilterEntry
+     * to the result.
+     * @param strSearchTerm The search term in CTextSearch syntax.
+     * @return The words in lower case or an empty list if the search term can't be used to narrow down the tags.
+     */
+    static std::vector<std::string> GetFullTextWords(const std::string &strSearchTerm);
+
     const std::string &GetSearchTerm() const { return m_strSearchTerm; }
     void SetSearchTerm(const std::string &strSearchTerm) { m_strSearchTerm = strSearchTerm; }
     void SetSearchPhrase(const std::string &strSearchPhrase);
@@ -0,0 +1,102 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "EpgStringPool.h"
+
+#include "threads/SingleLock.h"
+
+using namespace PVR;
+
+namespace
+{
+const std::shared_ptr<const std::string>& EmptyString()
+{
+  static const std::shared_ptr<const std::string> empty(std::make_shared<const std::string>());
+  return empty;
+}
+}
+
+CPVREpgString::CPVREpgString() :
+  m_str(EmptyString())
+{
+}
+
+CPVREpgString::CPVREpgString(const std::string &str) :
+  m_str(CPVREpgStringPool::GetInstance().Intern(str))
+{
+}
+
+CPVREpgString &CPVREpgString::operator =(const std::string &str)
+{
+  if (str != *m_str)
+    m_str = CPVREpgStringPool::GetInstance().Intern(str);
+  return *this;
+}
+
+CPVREpgStringPool &CPVREpgStringPool::GetInstance()
+{
+  static CPVREpgStringPool pool;
+  return pool;
+}
+
+std::shared_ptr<const std::string> CPVREpgStringPool::Intern(const std::string &str)
+{
+  if (str.empty())
+    return EmptyString();
+
+  // non-owning key for the lookup, no allocation unless the string is new
+  const std::shared_ptr<const std::string> key(std::shared_ptr<const std::string>(), &str);
+
+  CSingleLock lock(m_critSection);
+  const auto it = m_strings.find(key);
+  if (it != m_strings.end())
+    return *it;
+
+  const std::shared_ptr<const std::string> newString(std::make_shared<const std::string>(str));
+  m_strings.insert(newString);
+  return newString;
+}
+
+size_t CPVREpgStringPool::Purge()
+{
+  size_t iRemoved = 0;
+
+  CSingleLock lock(m_critSection);
+  for (auto it = m_strings.begin(); it != m_strings.end();)
+  {
+    // only the pool holds a reference. nobody can take a new one without the lock
+    if (it->use_count() == 1)
+    {
+      it = m_strings.erase(it);
+      ++iRemoved;
+    }
+    else
+      ++it;
+  }
+
+  return iRemoved;
+}
+
+size_t CPVREpgStringPool::Size() const
+{
+  CSingleLock lock(m_critSection);
+  return m_strings.size();
+}
@@ -0,0 +1,100 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "threads/CriticalSection.h"
+
+namespace PVR
+{
+  /*!
+   * @brief Immutable string shared between all EPG tags with the same content.
+   *
+   * Titles and genre descriptions repeat a lot across the guide (daily news,
+   * series, the genre set of a broadcaster). Interned strings share one
+   * allocation and compare by pointer.
+   */
+  class CPVREpgString
+  {
+  public:
+    CPVREpgString();
+    CPVREpgString(const std::string &str);
+
+    CPVREpgString &operator =(const std::string &str);
+
+    bool operator ==(const CPVREpgString &right) const { return m_str == right.m_str; }
+    bool operator !=(const CPVREpgString &right) const { return m_str != right.m_str; }
+
+    operator const std::string &() const { return *m_str; }
+    const std::string &str() const { return *m_str; }
+    const char *c_str() const { return m_str->c_str(); }
+    bool empty() const { return m_str->empty(); }
+
+  private:
+    std::shared_ptr<const std::string> m_str;
+  };
+
+  class CPVREpgStringPool
+  {
+  public:
+    static CPVREpgStringPool &GetInstance();
+
+    /*!
+     * @brief Get the shared instance of a string.
+     * @param str The string to look up.
+     * @return The shared instance, created if it wasn't in the pool yet.
+     */
+    std::shared_ptr<const std::string> Intern(const std::string &str);
+
+    /*!
+     * @brief Drop all strings that are no longer referenced by any tag.
+     * @return The number of strings that were removed.
+     */
+    size_t Purge();
+
+    /*!
+     * @return The number of strings in the pool.
+     */
+    size_t Size() const;
+
+  private:
+    CPVREpgStringPool() = default;
+    CPVREpgStringPool(const CPVREpgStringPool&) = delete;
+    CPVREpgStringPool &operator =(const CPVREpgStringPool&) = delete;
+
+    struct Hash
+    {
+      size_t operator()(const std::shared_ptr<const std::string> &str) const { return std::hash<std::string>()(*str); }
+    };
+
+    struct Equal
+    {
+      bool operator()(const std::shared_ptr<const std::string> &left, const std::shared_ptr<const std::string> &right) const { return *left == *right; }
+    };
+
+    std::unordered_set<std::shared_ptr<const std::string>, Hash, Equal> m_strings;
+    mutable CCriticalSection m_critSection;
+  };
+}
@@ -0,0 +1,183 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "EpgUpdateScheduler.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+using namespace PVR;
+
+class CPVREpgUpdateScheduler::CClientWorker : public IRunnable
+{
+public:
+  CClientWorker(CPVREpgUpdateScheduler &scheduler, int iClientId, const std::vector<Table> &tables) :
+    m_scheduler(scheduler), m_iClientId(iClientId), m_tables(tables) {}
+
+  void Run() override { m_scheduler.UpdateClient(m_iClientId, m_tables); }
+
+private:
+  CPVREpgUpdateScheduler &m_scheduler;
+  const int m_iClientId;
+  const std::vector<Table> &m_tables;
+};
+
+CPVREpgUpdateScheduler::CPVREpgUpdateScheduler(unsigned int iRequestInterval, unsigned int iClientTimeout) :
+  m_iRequestInterval(iRequestInterval),
+  m_iClientTimeout(iClientTimeout)
+{
+}
+
+void CPVREpgUpdateScheduler::Add(int iClientId, const std::string &strName, const UpdateFunction &function)
+{
+  m_clients[iClientId].push_back(Table{strName, function});
+}
+
+unsigned int CPVREpgUpdateScheduler::GetUpdatedTables() const
+{
+  CSingleLock lock(m_critSection);
+  return m_iUpdated;
+}
+
+bool CPVREpgUpdateScheduler::IsInterrupted()
+{
+  {
+    CSingleLock lock(m_critSection);
+    if (m_bInterrupted)
+      return true;
+  }
+
+  if (!m_interrupt || !m_interrupt())
+    return false;
+
+  CSingleLock lock(m_critSection);
+  m_bInterrupted = true;
+  m_condition.notifyAll();
+  return true;
+}
+
+bool CPVREpgUpdateScheduler::Run(const ProgressFunction &progress, const InterruptFunction &interrupt)
+{
+  unsigned int iTotal = 0;
+  for (const auto &client : m_clients)
+    iTotal += client.second.size();
+
+  {
+    CSingleLock lock(m_critSection);
+    m_interrupt = interrupt;
+    m_finishedTables.clear();
+    m_iUpdated = 0;
+    m_iRunningClients = m_clients.size();
+    m_bInterrupted = false;
+    m_bTimedOut = false;
+  }
+
+  /* one thread per client, a slow backend only delays its own tables */
+  std::vector<std::unique_ptr<CClientWorker>> workers;
+  std::vector<std::unique_ptr<CThread>> threads;
+  for (const auto &client : m_clients)
+  {
+    workers.emplace_back(new CClientWorker(*this, client.first, client.second));
+    threads.emplace_back(new CThread(workers.back().get(), "PVREpgClientUpdate"));
+    threads.back()->Create();
+  }
+
+  unsigned int iReported = 0;
+  bool bRunning = !m_clients.empty();
+  while (bRunning)
+  {
+    std::vector<std::string> finishedTables;
+    {
+      CSingleLock lock(m_critSection);
+      if (m_finishedTables.empty() && m_iRunningClients > 0)
+        m_condition.wait(lock, 100);
+
+      finishedTables.swap(m_finishedTables);
+      bRunning = m_iRunningClients > 0;
+    }
+
+    for (const auto &strName : finishedTables)
+    {
+      ++iReported;
+      if (progress)
+        progress(strName, iReported, iTotal);
+    }
+  }
+
+  for (auto &thread : threads)
+    thread->StopThread(true);
+
+  CSingleLock lock(m_critSection);
+  return !m_bInterrupted && !m_bTimedOut;
+}
+
+void CPVREpgUpdateScheduler::UpdateClient(int iClientId, const std::vector<Table> &tables)
+{
+  const unsigned int iStart = XbmcThreads::SystemClockMillis();
+  unsigned int iLastRequest = iStart;
+  unsigned int iProcessed = 0;
+
+  for (const auto &table : tables)
+  {
+    if (IsInterrupted())
+      break;
+
+    if (m_iClientTimeout > 0 && XbmcThreads::SystemClockMillis() - iStart >= m_iClientTimeout)
+    {
+      CLog::Log(LOGWARNING, "EPG - %s - client '%d' timed out, skipping %d tables until the next update", __FUNCTION__,
+                iClientId, static_cast<int>(tables.size() - iProcessed));
+      CSingleLock lock(m_critSection);
+      m_bTimedOut = true;
+      break;
+    }
+
+    /* rate limit the requests to the backend */
+    if (iProcessed > 0 && m_iRequestInterval > 0)
+    {
+      XbmcThreads::EndTime nextRequest(m_iRequestInterval - std::min(m_iRequestInterval, XbmcThreads::SystemClockMillis() - iLastRequest));
+      CSingleLock lock(m_critSection);
+      while (!nextRequest.IsTimePast() && !m_bInterrupted)
+        m_condition.wait(lock, nextRequest.MillisLeft());
+    }
+
+    iLastRequest = XbmcThreads::SystemClockMillis();
+    bool bUpdated = table.function();
+    ++iProcessed;
+
+    CSingleLock lock(m_critSection);
+    if (bUpdated)
+      ++m_iUpdated;
+    m_finishedTables.push_back(table.strName);
+    m_condition.notifyAll();
+  }
+
+  CLog::Log(LOGDEBUG, "EPG - %s - client '%d': processed %u of %d tables in %u ms", __FUNCTION__,
+            iClientId, iProcessed, static_cast<int>(tables.size()), XbmcThreads::SystemClockMillis() - iStart);
+
+  CSingleLock lock(m_critSection);
+  --m_iRunningClients;
+  m_condition.notifyAll();
+}
@@ -0,0 +1,116 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace PVR
+{
+  /** Runs the EPG table updates of all clients concurrently */
+
+  class CPVREpgUpdateScheduler
+  {
+  public:
+    /*!
+     * @brief Update one table.
+     * @return True if the table was updated, false otherwise.
+     */
+    typedef std::function<bool()> UpdateFunction;
+
+    /*!
+     * @brief Report a finished table, called on the thread that runs the scheduler.
+     */
+    typedef std::function<void(const std::string &strName, unsigned int iDone, unsigned int iTotal)> ProgressFunction;
+
+    /*!
+     * @brief Check whether the update has to be aborted.
+     */
+    typedef std::function<bool()> InterruptFunction;
+
+    /*!
+     * @brief Create a new scheduler.
+     * @param iRequestInterval The minimum time in milliseconds between the starts of two updates of the same client.
+     * @param iClientTimeout The time in milliseconds after which the remaining tables of a client are skipped. 0 to disable.
+     */
+    CPVREpgUpdateScheduler(unsigned int iRequestInterval, unsigned int iClientTimeout);
+
+    /*!
+     * @brief Add a table to update.
+     * @param iClientId The client that provides the table. Tables of the same client are updated one after the other.
+     * @param strName The name of the table, used for progress reporting.
+     * @param function The function that updates the table.
+     */
+    void Add(int iClientId, const std::string &strName, const UpdateFunction &function);
+
+    /*!
+     * @brief Update all tables, one thread per client.
+     * @param progress Called for every finished table. May be empty.
+     * @param interrupt Polled before every update. May be empty.
+     * @return True if all tables were processed, false if the update was interrupted or a client timed out.
+     */
+    bool Run(const ProgressFunction &progress, const InterruptFunction &interrupt);
+
+    /*!
+     * @return The number of tables that were updated successfully by the last run.
+     */
+    unsigned int GetUpdatedTables() const;
+
+    /*!
+     * @return The number of clients with tables to update.
+     */
+    size_t GetClientCount() const { return m_clients.size(); }
+
+  private:
+    CPVREpgUpdateScheduler(const CPVREpgUpdateScheduler&) = delete;
+    CPVREpgUpdateScheduler& operator=(const CPVREpgUpdateScheduler&) = delete;
+
+    class CClientWorker;
+
+    struct Table
+    {
+      std::string strName;
+      UpdateFunction function;
+    };
+
+    void UpdateClient(int iClientId, const std::vector<Table> &tables);
+    bool IsInterrupted();
+
+    const unsigned int m_iRequestInterval;
+    const unsigned int m_iClientTimeout;
+    std::map<int, std::vector<Table>> m_clients;
+    InterruptFunction m_interrupt;
+
+    mutable CCriticalSection m_critSection;
+    XbmcThreads::ConditionVariable m_condition;
+    std::vector<std::string> m_finishedTables;
+    unsigned int m_iUpdated = 0;
+    unsigned int m_iRunningClients = 0;
+    bool m_bInterrupted = false;
+    bool m_bTimedOut = false;
+  };
+}
@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/epg/Epg.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "settings/AdvancedSettings.h"
+#include "XBDateTime.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+class TestEpgDatabase : public ::testing::Test
+{
+protected:
+  TestEpgDatabase() : epg(1, "Test", "client", true) {}
+
+  void SetUp() override
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.name = "testepg";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+    ASSERT_TRUE(database.Connect("testepg", settings, true));
+    database.DeleteEpg();
+  }
+
+  void TearDown() override
+  {
+    database.DeleteEpg();
+    database.Close();
+  }
+
+  CPVREpgInfoTagPtr CreateTag(unsigned int iUniqueBroadcastId, time_t iStart, const char *strTitle)
+  {
+    EPG_TAG data;
+    std::memset(&data, 0, sizeof(data));
+    data.iUniqueBroadcastId = iUniqueBroadcastId;
+    data.startTime = iStart;
+    data.endTime = iStart + 3600;
+    data.strTitle = strTitle;
+    data.strPlot = "Plot";
+    data.iGenreType = 0x10;
+
+    CPVREpgInfoTagPtr tag(new CPVREpgInfoTag(data, -1));
+    tag->SetEpg(&epg);
+    return tag;
+  }
+
+  std::vector<CPVREpgInfoTagPtr> Load()
+  {
+    return database.GetEpgTags(epg.EpgID(), CDateTime(), CDateTime());
+  }
+
+  CPVREpg epg;
+  CPVREpgDatabase database;
+};
+
+TEST_F(TestEpgDatabase, PersistTagsWritesBackBroadcastIds)
+{
+  const CPVREpgInfoTagPtr first(CreateTag(1, 3600, "News"));
+  const CPVREpgInfoTagPtr second(CreateTag(2, 7200, "Weather"));
+  EXPECT_GE(0, first->BroadcastId());
+
+  ASSERT_TRUE(database.PersistTags({first, second}, {}));
+  EXPECT_LT(0, first->BroadcastId());
+  EXPECT_LT(0, second->BroadcastId());
+  EXPECT_NE(first->BroadcastId(), second->BroadcastId());
+
+  const std::vector<CPVREpgInfoTagPtr> tags(Load());
+  ASSERT_EQ(2U, tags.size());
+  EXPECT_EQ(first->BroadcastId(), tags[0]->BroadcastId());
+  EXPECT_EQ(second->BroadcastId(), tags[1]->BroadcastId());
+  EXPECT_EQ(1U, tags[0]->UniqueBroadcastID());
+  EXPECT_EQ("News", tags[0]->Title(true));
+  EXPECT_EQ("Plot", tags[0]->Plot(true));
+  EXPECT_EQ(0x10, tags[0]->GenreType());
+  EXPECT_TRUE(first->StartAsUTC() == tags[0]->StartAsUTC());
+  EXPECT_TRUE(first->EndAsUTC() == tags[0]->EndAsUTC());
+  EXPECT_EQ("Weather", tags[1]->Title(true));
+}
+
+TEST_F(TestEpgDatabase, PersistTagsReplacesRows)
+{
+  const CPVREpgInfoTagPtr tag(CreateTag(1, 3600, "News"));
+  ASSERT_TRUE(database.PersistTags({tag}, {}));
+  const int iBroadcastId = tag->BroadcastId();
+
+  // a tag with a database id rewrites its row and keeps the id
+  ASSERT_TRUE(tag->Update(*CreateTag(1, 3600, "Late News"), false));
+  ASSERT_TRUE(database.PersistTags({tag}, {}));
+  EXPECT_EQ(iBroadcastId, tag->BroadcastId());
+
+  const std::vector<CPVREpgInfoTagPtr> tags(Load());
+  ASSERT_EQ(1U, tags.size());
+  EXPECT_EQ(iBroadcastId, tags[0]->BroadcastId());
+  EXPECT_EQ("Late News", tags[0]->Title(true));
+}
+
+TEST_F(TestEpgDatabase, PersistTagsDeletes)
+{
+  const CPVREpgInfoTagPtr first(CreateTag(1, 3600, "News"));
+  const CPVREpgInfoTagPtr second(CreateTag(2, 7200, "Weather"));
+  ASSERT_TRUE(database.PersistTags({first, second}, {}));
+
+  // deleting a tag that was never written is a no-op
+  const CPVREpgInfoTagPtr third(CreateTag(3, 10800, "Sports"));
+  ASSERT_TRUE(database.PersistTags({}, {first, third}));
+
+  const std::vector<CPVREpgInfoTagPtr> tags(Load());
+  ASSERT_EQ(1U, tags.size());
+  EXPECT_EQ(second->BroadcastId(), tags[0]->BroadcastId());
+}
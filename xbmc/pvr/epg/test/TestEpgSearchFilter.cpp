@@ -0,0 +1,51 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "pvr/epg/EpgSearchFilter.h"
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+TEST(TestEpgSearchFilter, FullTextWords)
+{
+  typedef std::vector<std::string> Words;
+
+  EXPECT_EQ(Words{"news"}, CPVREpgSearchFilter::GetFullTextWords("News"));
+  EXPECT_EQ((Words{"news", "weather"}), CPVREpgSearchFilter::GetFullTextWords("news weather"));
+  // the index holds "star" and "wars" as separate words, every match contains a word containing "star"
+  EXPECT_EQ(Words{"star"}, CPVREpgSearchFilter::GetFullTextWords("\"Star Wars\""));
+  // the middle of a word is found as well
+  EXPECT_EQ(Words{"ews"}, CPVREpgSearchFilter::GetFullTextWords("ews"));
+
+  // required terms narrow the result down the most
+  EXPECT_EQ(Words{"weather"}, CPVREpgSearchFilter::GetFullTextWords("news and weather"));
+
+  // a term without words can't be looked up, FilterEntry has to scan all tags
+  EXPECT_EQ(Words{"news"}, CPVREpgSearchFilter::GetFullTextWords("news and ... and news"));
+  EXPECT_EQ(Words(), CPVREpgSearchFilter::GetFullTextWords("news ..."));
+  EXPECT_EQ(Words(), CPVREpgSearchFilter::GetFullTextWords(""));
+
+  // the tokenizer folds and splits other scripts differently, they are scanned
+  EXPECT_EQ(Words(), CPVREpgSearchFilter::GetFullTextWords("caf\xc3\xa9"));
+  EXPECT_EQ(Words(), CPVREpgSearchFilter::GetFullTextWords("\xe6\x96\xb0\xe9\x97\xbb"));
+  EXPECT_EQ(Words{"news"}, CPVREpgSearchFilter::GetFullTextWords("news and \xe6\x96\xb0\xe9\x97\xbb"));
+}
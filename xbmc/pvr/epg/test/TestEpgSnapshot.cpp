@@ -0,0 +1,158 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "pvr/epg/Epg.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+
+#include <cstring>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace PVR
+{
+class TestEpgSnapshotHelper
+{
+public:
+  typedef CPVREpg::EpgTagsSnapshotPtr SnapshotPtr;
+
+  TestEpgSnapshotHelper() : m_epg(1, "Test", "client", true) {}
+
+  CPVREpgInfoTagPtr Merge(unsigned int iUniqueBroadcastId, time_t iStart, time_t iEnd, const char *strTitle, bool &bChanged)
+  {
+    EPG_TAG data;
+    std::memset(&data, 0, sizeof(data));
+    data.iUniqueBroadcastId = iUniqueBroadcastId;
+    data.startTime = iStart;
+    data.endTime = iEnd;
+    data.strTitle = strTitle;
+
+    CPVREpgInfoTagPtr infoTag;
+    CSingleLock lock(m_epg.m_critSection);
+    bChanged = m_epg.MergeEntry(CPVREpgInfoTagPtr(new CPVREpgInfoTag(data, -1)), false, infoTag);
+    m_epg.PublishSnapshot();
+    return infoTag;
+  }
+
+  CPVREpgInfoTagPtr Merge(unsigned int iUniqueBroadcastId, time_t iStart, time_t iEnd, const char *strTitle)
+  {
+    bool bChanged;
+    return Merge(iUniqueBroadcastId, iStart, iEnd, strTitle, bChanged);
+  }
+
+  void FixOverlappingEvents()
+  {
+    CSingleLock lock(m_epg.m_critSection);
+    m_epg.FixOverlappingEvents();
+    m_epg.PublishSnapshot();
+  }
+
+  void Trim()
+  {
+    {
+      /* everything is loaded, trimmed tags would come back from the database */
+      CSingleLock lock(m_epg.m_critSection);
+      m_epg.m_database.reset(new CPVREpgDatabase);
+      m_epg.m_loadedRanges.assign(1, CPVREpg::TimeRange(std::numeric_limits<time_t>::min(), std::numeric_limits<time_t>::max()));
+    }
+    m_epg.Trim();
+  }
+
+  SnapshotPtr GetSnapshot() const { return m_epg.GetSnapshot(); }
+
+private:
+  CPVREpg m_epg;
+};
+}
+
+using namespace PVR;
+
+TEST(TestEpgSnapshot, MergeReplacesChangedTags)
+{
+  TestEpgSnapshotHelper epg;
+  bool bChanged = false;
+  const CPVREpgInfoTagPtr tag(epg.Merge(1, 3600, 7200, "News", bChanged));
+  EXPECT_TRUE(bChanged);
+
+  const TestEpgSnapshotHelper::SnapshotPtr before(epg.GetSnapshot());
+  ASSERT_EQ(1U, before->tags.size());
+  EXPECT_EQ(tag, before->tags.front());
+
+  // an unchanged resend keeps the loaded instance
+  EXPECT_EQ(tag, epg.Merge(1, 3600, 7200, "News", bChanged));
+  EXPECT_FALSE(bChanged);
+
+  // a changed one replaces it, the published instance stays as it was
+  const CPVREpgInfoTagPtr changed(epg.Merge(1, 3600, 7200, "Late News", bChanged));
+  EXPECT_TRUE(bChanged);
+  EXPECT_NE(tag, changed);
+  EXPECT_EQ("News", before->tags.front()->Title(true));
+  EXPECT_EQ("Late News", changed->Title(true));
+
+  const TestEpgSnapshotHelper::SnapshotPtr after(epg.GetSnapshot());
+  ASSERT_EQ(1U, after->tags.size());
+  EXPECT_EQ(changed, after->tags.front());
+}
+
+TEST(TestEpgSnapshot, FixOverlappingEventsReplacesTags)
+{
+  TestEpgSnapshotHelper epg;
+  const CPVREpgInfoTagPtr first(epg.Merge(1, 3600, 10800, "First"));
+  epg.Merge(2, 7200, 14400, "Second");
+
+  const TestEpgSnapshotHelper::SnapshotPtr before(epg.GetSnapshot());
+  epg.FixOverlappingEvents();
+  const TestEpgSnapshotHelper::SnapshotPtr after(epg.GetSnapshot());
+
+  ASSERT_EQ(2U, after->tags.size());
+  EXPECT_NE(first, after->tags.front());
+  EXPECT_EQ(CDateTime(7200), after->tags.front()->EndAsUTC());
+  EXPECT_EQ(CDateTime(10800), first->EndAsUTC());
+  EXPECT_EQ(first, before->tags.front());
+}
+
+TEST(TestEpgSnapshot, Trim)
+{
+  time_t iNow;
+  CDateTime::GetUTCDateTime().GetAsTime(iNow);
+
+  TestEpgSnapshotHelper epg;
+  epg.Merge(1, iNow - 2 * 24 * 60 * 60, iNow - 2 * 24 * 60 * 60 + 1800, "Past");
+  const CPVREpgInfoTagPtr current(epg.Merge(2, iNow - 600, iNow + 600, "Current"));
+  epg.Merge(3, iNow + 2 * 24 * 60 * 60, iNow + 2 * 24 * 60 * 60 + 1800, "Future");
+
+  const TestEpgSnapshotHelper::SnapshotPtr before(epg.GetSnapshot());
+  epg.Trim();
+  const TestEpgSnapshotHelper::SnapshotPtr after(epg.GetSnapshot());
+
+  // readers of the old snapshot still see all tags
+  EXPECT_EQ(3U, before->tags.size());
+  ASSERT_EQ(1U, after->tags.size());
+  EXPECT_EQ(current, after->tags.front());
+
+  // only the window around now is known to be complete
+  EXPECT_FALSE(after->bComplete);
+  ASSERT_EQ(1U, after->loadedRanges.size());
+  EXPECT_LE(after->loadedRanges.front().first, iNow - 600);
+  EXPECT_GE(after->loadedRanges.front().second, iNow + 600);
+  EXPECT_LT(after->loadedRanges.front().second, iNow + 2 * 24 * 60 * 60);
+}
@@ -0,0 +1,62 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "pvr/epg/EpgStringPool.h"
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+TEST(TestEpgStringPool, Intern)
+{
+  CPVREpgString news("Evening News");
+  CPVREpgString repeat(std::string("Evening ") + "News");
+  CPVREpgString other("Weather");
+
+  EXPECT_EQ("Evening News", news.str());
+  EXPECT_TRUE(news == repeat);
+  EXPECT_TRUE(news != other);
+  EXPECT_EQ(news.c_str(), repeat.c_str()); // one shared allocation
+
+  CPVREpgString empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_TRUE(empty == CPVREpgString(""));
+
+  repeat = "Weather";
+  EXPECT_TRUE(repeat == other);
+}
+
+TEST(TestEpgStringPool, Purge)
+{
+  CPVREpgStringPool &pool = CPVREpgStringPool::GetInstance();
+  pool.Purge();
+  const size_t iSize = pool.Size();
+
+  {
+    CPVREpgString title("Purged Title");
+    CPVREpgString copy(title);
+    EXPECT_EQ(iSize + 1, pool.Size());
+    EXPECT_EQ(0U, pool.Purge());
+  }
+
+  EXPECT_EQ(1U, pool.Purge());
+  EXPECT_EQ(iSize, pool.Size());
+}
@@ -0,0 +1,92 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "pvr/epg/EpgUpdateScheduler.h"
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+TEST(TestEpgUpdateScheduler, ClientsRunConcurrently)
+{
+  CPVREpgUpdateScheduler scheduler(0, 0);
+  CEvent fastClientDone;
+
+  // the slow client only finishes once the other client made progress
+  scheduler.Add(1, "slow", [&fastClientDone]() { return fastClientDone.WaitMSec(5000); });
+  scheduler.Add(2, "fast 1", []() { return true; });
+  scheduler.Add(2, "fast 2", [&fastClientDone]() { fastClientDone.Set(); return false; });
+
+  std::vector<std::string> reported;
+  unsigned int iTotal = 0;
+  EXPECT_TRUE(scheduler.Run([&reported, &iTotal](const std::string &strName, unsigned int iDone, unsigned int iTables) {
+    reported.push_back(strName);
+    EXPECT_EQ(reported.size(), iDone);
+    iTotal = iTables;
+  }, CPVREpgUpdateScheduler::InterruptFunction()));
+
+  EXPECT_EQ(2U, scheduler.GetClientCount());
+  EXPECT_EQ(2U, scheduler.GetUpdatedTables());
+  EXPECT_EQ(3U, iTotal);
+  ASSERT_EQ(3U, reported.size());
+  EXPECT_EQ("slow", reported.back());
+}
+
+TEST(TestEpgUpdateScheduler, Interrupt)
+{
+  CPVREpgUpdateScheduler scheduler(0, 0);
+  std::atomic<int> iCalls(0);
+  for (int i = 0; i < 10; i++)
+    scheduler.Add(1, "table", [&iCalls]() { ++iCalls; return true; });
+
+  EXPECT_FALSE(scheduler.Run(CPVREpgUpdateScheduler::ProgressFunction(),
+                             [&iCalls]() { return iCalls >= 3; }));
+  EXPECT_EQ(3, iCalls);
+}
+
+TEST(TestEpgUpdateScheduler, ClientTimeout)
+{
+  CPVREpgUpdateScheduler scheduler(0, 50);
+  std::atomic<int> iCalls(0);
+  CEvent never;
+  scheduler.Add(1, "blocking", [&iCalls, &never]() { ++iCalls; never.WaitMSec(100); return true; });
+  scheduler.Add(1, "skipped", [&iCalls]() { ++iCalls; return true; });
+  scheduler.Add(2, "other", [&iCalls]() { ++iCalls; return true; });
+
+  EXPECT_FALSE(scheduler.Run(CPVREpgUpdateScheduler::ProgressFunction(), CPVREpgUpdateScheduler::InterruptFunction()));
+  EXPECT_EQ(2, iCalls);
+  EXPECT_EQ(2U, scheduler.GetUpdatedTables());
+}
+
+TEST(TestEpgUpdateScheduler, RequestInterval)
+{
+  CPVREpgUpdateScheduler scheduler(30, 0);
+  for (int i = 0; i < 3; i++)
+    scheduler.Add(1, "table", []() { return true; });
+
+  unsigned int iStart = XbmcThreads::SystemClockMillis();
+  EXPECT_TRUE(scheduler.Run(CPVREpgUpdateScheduler::ProgressFunction(), CPVREpgUpdateScheduler::InterruptFunction()));
+  EXPECT_GE(XbmcThreads::SystemClockMillis() - iStart, 60U);
+}
@@ -397,7 +397,12 @@ void CPVRRecording::Update(const CPVRRecording &tag)
   if (m_bIsDeleted)
     OnDelete();
 
+  const std::string strOldPath(m_strFileNameAndPath);
   UpdatePath();
+
+  // the database keeps the play count and resume point by path
+  if (m_strFileNameAndPath != strOldPath)
+    m_bGotMetaData = false;
 }
 
 void CPVRRecording::UpdatePath(void)
@@ -178,6 +178,13 @@ namespace PVR
      */
     CBookmark GetLocalResumePoint() const { return CVideoInfoTag::GetResumePoint(); }
 
+    /*!
+     * @brief Set this recording's resume point without transferring the value to the backend, even if it supports server-side resume points.
+     * @param resumePoint resume point.
+     * @return True if resume point was set successfully, false otherwise.
+     */
+    bool SetLocalResumePoint(const CBookmark &resumePoint) { return CVideoInfoTag::SetResumePoint(resumePoint); }
+
     /*!
      * @brief Retrieve the edit decision list (EDL) of a recording on the backend.
      * @return The edit decision list (empty on error)
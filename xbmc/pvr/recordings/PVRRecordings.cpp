@@ -20,6 +20,7 @@
 
 #include "PVRRecordings.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "FileItem.h"
@@ -48,7 +49,9 @@ CPVRRecordings::CPVRRecordings(void) :
     m_bDeletedTVRecordings(false),
     m_bDeletedRadioRecordings(false),
     m_iTVRecordings(0),
-    m_iRadioRecordings(0)
+    m_iRadioRecordings(0),
+    m_bRecordingsReset(false),
+    m_bRecordingsChanged(false)
 {
 }
 
@@ -61,9 +64,75 @@ CPVRRecordings::~CPVRRecordings()
 void CPVRRecordings::UpdateFromClients(void)
 {
   CSingleLock lock(m_critSection);
-  Unload();
-  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false);
-  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true);
+
+  BeginUpdateFromClients();
+
+  std::vector<int> failedClients;
+  std::vector<int> failedClientsDeleted;
+  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false, failedClients);
+  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true, failedClientsDeleted);
+  failedClients.insert(failedClients.end(), failedClientsDeleted.begin(), failedClientsDeleted.end());
+
+  EndUpdateFromClients(failedClients);
+}
+
+void CPVRRecordings::BeginUpdateFromClients(void)
+{
+  CSingleLock lock(m_critSection);
+
+  // every recording not reported again by its client is removed afterwards
+  m_staleRecordings.clear();
+  for (const auto &recording : m_recordings)
+    m_staleRecordings.insert(recording.first);
+}
+
+void CPVRRecordings::EndUpdateFromClients(const std::vector<int> &failedClients)
+{
+  CSingleLock lock(m_critSection);
+
+  for (const auto &uid : m_staleRecordings)
+  {
+    // keep the recordings of clients we could not get an update from
+    if (std::find(failedClients.begin(), failedClients.end(), uid.m_iClientId) != failedClients.end())
+      continue;
+
+    PVR_RECORDINGMAP_ITR it = m_recordings.find(uid);
+    if (it == m_recordings.end())
+      continue;
+
+    if (!it->second->IsDeleted())
+      it->second->OnDelete();
+
+    m_recordings.erase(it);
+    m_bRecordingsReset = true;
+  }
+  m_staleRecordings.clear();
+
+  UpdateCounters();
+}
+
+void CPVRRecordings::UpdateCounters(void)
+{
+  m_bDeletedTVRecordings = false;
+  m_bDeletedRadioRecordings = false;
+  m_iTVRecordings = 0;
+  m_iRadioRecordings = 0;
+
+  for (const auto &recording : m_recordings)
+  {
+    if (recording.second->IsRadio())
+    {
+      ++m_iRadioRecordings;
+      if (recording.second->IsDeleted())
+        m_bDeletedRadioRecordings = true;
+    }
+    else
+    {
+      ++m_iTVRecordings;
+      if (recording.second->IsDeleted())
+        m_bDeletedTVRecordings = true;
+    }
+  }
 }
 
 std::string CPVRRecordings::TrimSlashes(const std::string &strOrig) const
@@ -167,6 +236,8 @@ void CPVRRecordings::Update(void)
   if (m_bIsUpdating)
     return;
   m_bIsUpdating = true;
+  m_bRecordingsReset = false;
+  m_bRecordingsChanged = false;
   lock.Leave();
 
   CLog::Log(LOGDEBUG, "CPVRRecordings - %s - updating recordings", __FUNCTION__);
@@ -174,10 +245,18 @@ void CPVRRecordings::Update(void)
 
   lock.Enter();
   m_bIsUpdating = false;
+  bool bReset = m_bRecordingsReset;
+  bool bChanged = m_bRecordingsChanged;
   lock.Leave();
 
+  if (!bReset && !bChanged)
+  {
+    CLog::Log(LOGDEBUG, "CPVRRecordings - %s - recordings unchanged", __FUNCTION__);
+    return;
+  }
+
   CServiceBroker::GetPVRManager().SetChanged();
-  CServiceBroker::GetPVRManager().NotifyObservers(ObservableMessageRecordings);
+  CServiceBroker::GetPVRManager().NotifyObservers(bReset ? ObservableMessageRecordings : ObservableMessageRecordingItemUpdate);
   CServiceBroker::GetPVRManager().PublishEvent(RecordingsInvalidated);
 }
 
@@ -324,33 +403,56 @@ bool CPVRRecordings::GetDirectory(const std::string& strPath, CFileItemList &ite
       current->UpdateMetadata(GetVideoDatabase());
 
       CFileItemPtr pFileItem(new CFileItem(current));
-      pFileItem->SetLabel2(current->RecordingTimeAsLocalTime().GetAsLocalizedDateTime(true, false));
-      pFileItem->m_dateTime = current->RecordingTimeAsLocalTime();
-      pFileItem->SetPath(current->m_strFileNameAndPath);
-
-      // Set art
-      if (!current->m_strIconPath.empty())
-      {
-        pFileItem->SetIconImage(current->m_strIconPath);
-        pFileItem->SetArt("icon", current->m_strIconPath);
-      }
+      UpdateFileItem(*pFileItem);
 
-      if (!current->m_strThumbnailPath.empty())
-        pFileItem->SetArt("thumb", current->m_strThumbnailPath);
+      items.Add(pFileItem);
+    }
+  }
 
-      if (!current->m_strFanartPath.empty())
-        pFileItem->SetArt("fanart", current->m_strFanartPath);
+  return recPath.IsValid();
+}
 
-      // Use the channel icon as a fallback when a thumbnail is not available
-      pFileItem->SetArtFallback("thumb", "icon");
+void CPVRRecordings::UpdateFileItem(CFileItem &item)
+{
+  const CPVRRecordingPtr recording(item.GetPVRRecordingInfoTag());
+  if (!recording)
+    return;
 
-      pFileItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, pFileItem->GetPVRRecordingInfoTag()->GetPlayCount() > 0);
+  item.SetLabel2(recording->RecordingTimeAsLocalTime().GetAsLocalizedDateTime(true, false));
+  item.m_dateTime = recording->RecordingTimeAsLocalTime();
+  item.SetPath(recording->m_strFileNameAndPath);
 
-      items.Add(pFileItem);
-    }
+  // Set art
+  if (!recording->m_strIconPath.empty())
+  {
+    item.SetIconImage(recording->m_strIconPath);
+    item.SetArt("icon", recording->m_strIconPath);
   }
 
-  return recPath.IsValid();
+  if (!recording->m_strThumbnailPath.empty())
+    item.SetArt("thumb", recording->m_strThumbnailPath);
+
+  if (!recording->m_strFanartPath.empty())
+    item.SetArt("fanart", recording->m_strFanartPath);
+
+  // Use the channel icon as a fallback when a thumbnail is not available
+  item.SetArtFallback("thumb", "icon");
+
+  item.SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, recording->GetPlayCount() > 0);
+}
+
+void CPVRRecordings::RefreshFileItem(CFileItem &item) const
+{
+  const CPVRRecordingPtr recording(item.GetPVRRecordingInfoTag());
+  if (!recording)
+    return;
+
+  // changed recordings get a new tag, bind the item to the current one
+  const CPVRRecordingPtr current(GetById(recording->m_iClientId, recording->m_strRecordingId));
+  if (current && current != recording)
+    item.UpdateInfo(CFileItem(current), false);
+
+  UpdateFileItem(item);
 }
 
 void CPVRRecordings::GetAll(CFileItemList &items, bool bDeleted)
@@ -365,10 +467,7 @@ void CPVRRecordings::GetAll(CFileItemList &items, bool bDeleted)
     current->UpdateMetadata(GetVideoDatabase());
 
     CFileItemPtr pFileItem(new CFileItem(current));
-    pFileItem->SetLabel2(current->RecordingTimeAsLocalTime().GetAsLocalizedDateTime(true, false));
-    pFileItem->m_dateTime = current->RecordingTimeAsLocalTime();
-    pFileItem->SetPath(current->m_strFileNameAndPath);
-    pFileItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, pFileItem->GetPVRRecordingInfoTag()->GetPlayCount() > 0);
+    UpdateFileItem(*pFileItem);
 
     items.Add(pFileItem);
   }
@@ -426,42 +525,72 @@ CPVRRecordingPtr CPVRRecordings::GetById(int iClientId, const std::string &strRe
 }
 
 void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
+{
+  const CPVRClientCapabilities capabilities(CServiceBroker::GetPVRManager().Clients()->GetClientCapabilities(tag->m_iClientId));
+  UpdateFromClient(tag, capabilities.SupportsRecordingsPlayCount(), capabilities.SupportsRecordingsLastPlayedPosition());
+}
+
+void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag, bool bServerPlayCount, bool bServerResumePoint)
 {
   CSingleLock lock(m_critSection);
 
-  if (tag->IsDeleted())
-  {
-    if (tag->IsRadio())
-      m_bDeletedRadioRecordings = true;
-    else
-      m_bDeletedTVRecordings = true;
-  }
+  const CPVRRecordingUid uid(tag->m_iClientId, tag->m_strRecordingId);
+  m_staleRecordings.erase(uid);
 
-  CPVRRecordingPtr newTag = GetById(tag->m_iClientId, tag->m_strRecordingId);
-  if (newTag)
+  CPVRRecordingPtr existingTag = GetById(tag->m_iClientId, tag->m_strRecordingId);
+  if (existingTag)
   {
+    // compare the merged result, the client tag has neither a path nor a recording id yet
+    CPVRRecordingPtr newTag(new CPVRRecording);
     newTag->Update(*tag);
+    newTag->m_iRecordingId = existingTag->m_iRecordingId;
+
+    bool bPlayCountChanged = bServerPlayCount &&
+                             newTag->GetLocalPlayCount() != existingTag->GetLocalPlayCount();
+    bool bResumePointChanged = bServerResumePoint &&
+                               newTag->GetLocalResumePoint().timeInSeconds != existingTag->GetLocalResumePoint().timeInSeconds;
+
+    if (*newTag == *existingTag && newTag->m_genre == existingTag->m_genre && !bPlayCountChanged && !bResumePointChanged)
+      return;
+
+    // a new path or watched state moves the recording to another folder or filter, everything else only updates the items
+    if (newTag->m_strFileNameAndPath != existingTag->m_strFileNameAndPath || bPlayCountChanged)
+      m_bRecordingsReset = true;
+    else
+      m_bRecordingsChanged = true;
+
+    // the client doesn't know the values read from the database, keep them
+    if (!bServerPlayCount)
+      newTag->SetLocalPlayCount(existingTag->GetLocalPlayCount());
+    if (!bServerResumePoint)
+      newTag->SetLocalResumePoint(existingTag->GetLocalResumePoint());
+
+    // file items read the tag without our lock, replace it instead of changing it
+    m_recordings[uid] = newTag;
+    LinkEpgTag(newTag);
   }
   else
   {
-    newTag = CPVRRecordingPtr(new CPVRRecording);
+    CPVRRecordingPtr newTag(new CPVRRecording);
     newTag->Update(*tag);
-    if (newTag->BroadcastUid() != EPG_TAG_INVALID_UID)
-    {
-      const CPVRChannelPtr channel(newTag->Channel());
-      if (channel)
-      {
-        const CPVREpgInfoTagPtr epgTag = CServiceBroker::GetPVRManager().EpgContainer().GetTagById(channel, newTag->BroadcastUid());
-        if (epgTag)
-          epgTag->SetRecording(newTag);
-      }
-    }
+    LinkEpgTag(newTag);
     newTag->m_iRecordingId = ++m_iLastId;
-    m_recordings.insert(std::make_pair(CPVRRecordingUid(newTag->m_iClientId, newTag->m_strRecordingId), newTag));
-    if (newTag->IsRadio())
-      ++m_iRadioRecordings;
-    else
-      ++m_iTVRecordings;
+    m_recordings.insert(std::make_pair(uid, newTag));
+    m_bRecordingsReset = true;
+  }
+}
+
+void CPVRRecordings::LinkEpgTag(const CPVRRecordingPtr &recording)
+{
+  if (recording->BroadcastUid() == EPG_TAG_INVALID_UID)
+    return;
+
+  const CPVRChannelPtr channel(recording->Channel());
+  if (channel)
+  {
+    const CPVREpgInfoTagPtr epgTag = CServiceBroker::GetPVRManager().EpgContainer().GetTagById(channel, recording->BroadcastUid());
+    if (epgTag)
+      epgTag->SetRecording(recording);
   }
 }
 
@@ -21,6 +21,8 @@
 
 #include <map>
 #include <memory>
+#include <set>
+#include <vector>
 
 #include "FileItem.h"
 #include "video/VideoDatabase.h"
@@ -49,10 +51,35 @@ namespace PVR
      */
     void Unload();
 
+    /**
+     * @brief merge a recording obtained from a client into the list.
+     * Existing recordings are updated in place and keep their id; unchanged recordings are left untouched.
+     * @param tag the recording obtained from the client.
+     */
     void UpdateFromClient(const CPVRRecordingPtr &tag);
 
+    /**
+     * @brief merge a recording obtained from a client into the list.
+     * @param tag the recording obtained from the client.
+     * @param bServerPlayCount true if the client keeps the play count, the one read from the database is kept otherwise.
+     * @param bServerResumePoint true if the client keeps the resume point, the one read from the database is kept otherwise.
+     */
+    void UpdateFromClient(const CPVRRecordingPtr &tag, bool bServerPlayCount, bool bServerResumePoint);
+
+    /**
+     * @brief start merging the recordings of the clients. Every recording is stale until it is passed to UpdateFromClient again.
+     */
+    void BeginUpdateFromClients(void);
+
+    /**
+     * @brief remove the recordings that were not reported again since BeginUpdateFromClients.
+     * @param failedClients the ids of the clients that could not be queried, their recordings are kept.
+     */
+    void EndUpdateFromClients(const std::vector<int> &failedClients);
+
     /**
      * @brief refresh the recordings list from the clients.
+     * Observers are only notified if recordings were added, removed or changed.
      */
     void Update(void);
 
@@ -88,6 +115,18 @@ namespace PVR
     void GetAll(CFileItemList &items, bool bDeleted = false);
     CFileItemPtr GetById(unsigned int iId) const;
 
+    /*!
+     * @brief Refresh the properties of a file item created by GetDirectory from its recording.
+     * @param item The item to refresh.
+     */
+    static void UpdateFileItem(CFileItem &item);
+
+    /*!
+     * @brief Bind a file item created by GetDirectory to the current tag of its recording and refresh its properties.
+     * @param item The item to refresh.
+     */
+    void RefreshFileItem(CFileItem &item) const;
+
     /*!
      * @brief Get the recording for the given epg tag, if any.
      * @param epgTag The epg tag.
@@ -109,8 +148,13 @@ namespace PVR
     bool m_bDeletedRadioRecordings;
     unsigned int m_iTVRecordings;
     unsigned int m_iRadioRecordings;
+    std::set<CPVRRecordingUid> m_staleRecordings;
+    bool m_bRecordingsReset;
+    bool m_bRecordingsChanged;
 
     void UpdateFromClients(void);
+    void UpdateCounters(void);
+    void LinkEpgTag(const CPVRRecordingPtr &recording);
     std::string TrimSlashes(const std::string &strOrig) const;
     bool IsDirectoryMember(const std::string &strDirectory, const std::string &strEntryDirectory, bool bGrouped) const;
     void GetSubDirectories(const CPVRRecordingsPath &recParentPath, CFileItemList *results);
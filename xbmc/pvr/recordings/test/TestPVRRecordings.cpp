@@ -0,0 +1,137 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "pvr/recordings/PVRRecordings.h"
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+namespace
+{
+
+CPVRRecordingPtr CreateRecording(int iClientId, const std::string &strRecordingId, const std::string &strPlot)
+{
+  CPVRRecordingPtr recording(new CPVRRecording);
+  recording->m_iClientId = iClientId;
+  recording->m_strRecordingId = strRecordingId;
+  recording->m_strTitle = "title " + strRecordingId;
+  recording->m_strPlot = strPlot;
+  return recording;
+}
+
+class TestPVRRecordings : public testing::Test
+{
+protected:
+  TestPVRRecordings()
+  {
+    m_recordings.BeginUpdateFromClients();
+    m_recordings.UpdateFromClient(CreateRecording(1, "a", "plot"), false, false);
+    m_recordings.UpdateFromClient(CreateRecording(2, "b", "plot"), false, false);
+    m_recordings.EndUpdateFromClients({});
+  }
+
+  CPVRRecordings m_recordings;
+};
+
+} // namespace
+
+TEST_F(TestPVRRecordings, Unchanged)
+{
+  const CPVRRecordingPtr recording(m_recordings.GetById(1, "a"));
+  ASSERT_TRUE(recording);
+  const unsigned int iRecordingId = recording->m_iRecordingId;
+
+  m_recordings.BeginUpdateFromClients();
+  m_recordings.UpdateFromClient(CreateRecording(1, "a", "plot"), false, false);
+  m_recordings.UpdateFromClient(CreateRecording(2, "b", "plot"), false, false);
+  m_recordings.EndUpdateFromClients({});
+
+  EXPECT_EQ(recording, m_recordings.GetById(1, "a"));
+  EXPECT_EQ(iRecordingId, recording->m_iRecordingId);
+  EXPECT_EQ(2, m_recordings.GetNumTVRecordings());
+}
+
+TEST_F(TestPVRRecordings, Changed)
+{
+  const CPVRRecordingPtr recording(m_recordings.GetById(1, "a"));
+  ASSERT_TRUE(recording);
+  const unsigned int iRecordingId = recording->m_iRecordingId;
+
+  // read from the database, the client doesn't keep them
+  CBookmark resumePoint;
+  resumePoint.timeInSeconds = 60;
+  resumePoint.totalTimeInSeconds = 120;
+  recording->SetLocalPlayCount(1);
+  recording->SetLocalResumePoint(resumePoint);
+
+  m_recordings.BeginUpdateFromClients();
+  m_recordings.UpdateFromClient(CreateRecording(1, "a", "new plot"), false, false);
+  m_recordings.UpdateFromClient(CreateRecording(2, "b", "plot"), false, false);
+  m_recordings.EndUpdateFromClients({});
+
+  // file items may still read the old tag, it is replaced instead of changed
+  const CPVRRecordingPtr changed(m_recordings.GetById(1, "a"));
+  ASSERT_TRUE(changed);
+  EXPECT_NE(recording, changed);
+  EXPECT_EQ("plot", recording->m_strPlot);
+  EXPECT_EQ(iRecordingId, changed->m_iRecordingId);
+  EXPECT_EQ("new plot", changed->m_strPlot);
+  EXPECT_EQ(1, changed->GetLocalPlayCount());
+  EXPECT_EQ(60, changed->GetLocalResumePoint().timeInSeconds);
+
+  // clients keeping them server-side report the current values
+  m_recordings.BeginUpdateFromClients();
+  m_recordings.UpdateFromClient(CreateRecording(1, "a", "plot"), true, true);
+  m_recordings.UpdateFromClient(CreateRecording(2, "b", "plot"), false, false);
+  m_recordings.EndUpdateFromClients({});
+
+  const CPVRRecordingPtr reported(m_recordings.GetById(1, "a"));
+  ASSERT_TRUE(reported);
+  EXPECT_EQ(iRecordingId, reported->m_iRecordingId);
+  EXPECT_EQ("plot", reported->m_strPlot);
+  EXPECT_EQ(0, reported->GetLocalPlayCount());
+  EXPECT_EQ(0, reported->GetLocalResumePoint().timeInSeconds);
+}
+
+TEST_F(TestPVRRecordings, Removed)
+{
+  m_recordings.BeginUpdateFromClients();
+  m_recordings.UpdateFromClient(CreateRecording(1, "a", "plot"), false, false);
+  m_recordings.EndUpdateFromClients({});
+
+  EXPECT_TRUE(m_recordings.GetById(1, "a"));
+  EXPECT_FALSE(m_recordings.GetById(2, "b"));
+  EXPECT_EQ(1, m_recordings.GetNumTVRecordings());
+}
+
+TEST_F(TestPVRRecordings, FailedClient)
+{
+  const CPVRRecordingPtr recording(m_recordings.GetById(2, "b"));
+  ASSERT_TRUE(recording);
+
+  m_recordings.BeginUpdateFromClients();
+  m_recordings.UpdateFromClient(CreateRecording(1, "a", "plot"), false, false);
+  m_recordings.EndUpdateFromClients({2});
+
+  EXPECT_EQ(recording, m_recordings.GetById(2, "b"));
+  EXPECT_EQ(2, m_recordings.GetNumTVRecordings());
+}
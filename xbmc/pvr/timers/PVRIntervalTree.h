@@ -0,0 +1,247 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <ctime>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PVR
+{
+  /*!
+   * @brief Interval tree over half-open [start, end) time spans.
+   *
+   * Implemented as a treap ordered by (start, end, id), where every node knows the
+   * latest end within its subtree. Insert, erase and overlap queries take logarithmic
+   * time on average, plus the number of reported entries.
+   */
+  template<typename T>
+  class CPVRIntervalTree
+  {
+  public:
+    CPVRIntervalTree() : m_iSeed(0x9E3779B9) {}
+
+    /*!
+     * @brief Add an entry, replacing an existing entry with the same id.
+     * @param iId The unique id of the entry.
+     * @param start The start of the time span.
+     * @param end The end of the time span.
+     * @param value The value to store.
+     */
+    void Insert(unsigned int iId, time_t start, time_t end, const T &value)
+    {
+      Erase(iId);
+
+      NodePtr node(new Node(Key(start, end, iId), value, NextPriority()));
+      NodePtr left, right;
+      Split(std::move(m_root), node->key, left, right);
+      m_root = Merge(Merge(std::move(left), std::move(node)), std::move(right));
+      m_keys.insert(std::make_pair(iId, std::make_pair(start, end)));
+    }
+
+    /*!
+     * @brief Remove an entry.
+     * @param iId The id of the entry.
+     * @return True if the entry was found, false otherwise.
+     */
+    bool Erase(unsigned int iId)
+    {
+      const auto it = m_keys.find(iId);
+      if (it == m_keys.end())
+        return false;
+
+      NodePtr left, right;
+      Split(std::move(m_root), Key(it->second.first, it->second.second, iId), left, right);
+      m_root = Merge(std::move(left), EraseMin(std::move(right)));
+      m_keys.erase(it);
+      return true;
+    }
+
+    void Clear() { m_root.reset(); m_keys.clear(); }
+    size_t Size() const { return m_keys.size(); }
+    bool IsEmpty() const { return m_keys.empty(); }
+
+    /*!
+     * @brief Get all entries overlapping the given time span, ordered by start.
+     * @param start The start of the time span.
+     * @param end The end of the time span.
+     * @param results The list to add the values to.
+     */
+    void GetOverlapping(time_t start, time_t end, std::vector<T> &results) const
+    {
+      if (start < end)
+        GetOverlapping(m_root.get(), start, end, results);
+    }
+
+    /*!
+     * @brief Call a function for every entry, ordered by start.
+     * @param function Called with each value, returns false to stop the iteration.
+     * @return False if the iteration was stopped, true otherwise.
+     */
+    template<typename F>
+    bool ForEach(F function) const
+    {
+      return ForEach(m_root.get(), function);
+    }
+
+  private:
+    struct Key
+    {
+      Key(time_t _start, time_t _end, unsigned int _iId) : start(_start), end(_end), iId(_iId) {}
+
+      bool operator <(const Key &right) const
+      {
+        if (start != right.start)
+          return start < right.start;
+        if (end != right.end)
+          return end < right.end;
+        return iId < right.iId;
+      }
+
+      time_t start;
+      time_t end;
+      unsigned int iId;
+    };
+
+    struct Node
+    {
+      Node(const Key &_key, const T &_value, unsigned int _iPriority)
+      : key(_key), value(_value), iPriority(_iPriority), maxEnd(_key.end) {}
+
+      Key key;
+      T value;
+      unsigned int iPriority;
+      time_t maxEnd;
+      std::unique_ptr<Node> left;
+      std::unique_ptr<Node> right;
+    };
+
+    typedef std::unique_ptr<Node> NodePtr;
+
+    unsigned int NextPriority()
+    {
+      // xorshift, no need for anything better to keep the treap balanced
+      m_iSeed ^= m_iSeed << 13;
+      m_iSeed ^= m_iSeed >> 17;
+      m_iSeed ^= m_iSeed << 5;
+      return m_iSeed;
+    }
+
+    static void Update(Node *node)
+    {
+      node->maxEnd = node->key.end;
+      if (node->left && node->left->maxEnd > node->maxEnd)
+        node->maxEnd = node->left->maxEnd;
+      if (node->right && node->right->maxEnd > node->maxEnd)
+        node->maxEnd = node->right->maxEnd;
+    }
+
+    // left gets all keys lower than key, right the rest
+    static void Split(NodePtr node, const Key &key, NodePtr &left, NodePtr &right)
+    {
+      if (!node)
+      {
+        left.reset();
+        right.reset();
+      }
+      else if (node->key < key)
+      {
+        Split(std::move(node->right), key, node->right, right);
+        Update(node.get());
+        left = std::move(node);
+      }
+      else
+      {
+        Split(std::move(node->left), key, left, node->left);
+        Update(node.get());
+        right = std::move(node);
+      }
+    }
+
+    // all keys of left must be lower than the keys of right
+    static NodePtr Merge(NodePtr left, NodePtr right)
+    {
+      if (!left)
+        return right;
+      if (!right)
+        return left;
+
+      if (left->iPriority > right->iPriority)
+      {
+        left->right = Merge(std::move(left->right), std::move(right));
+        Update(left.get());
+        return left;
+      }
+
+      right->left = Merge(std::move(left), std::move(right->left));
+      Update(right.get());
+      return right;
+    }
+
+    static NodePtr EraseMin(NodePtr node)
+    {
+      if (!node)
+        return node;
+      if (!node->left)
+        return std::move(node->right);
+
+      node->left = EraseMin(std::move(node->left));
+      Update(node.get());
+      return node;
+    }
+
+    static void GetOverlapping(const Node *node, time_t start, time_t end, std::vector<T> &results)
+    {
+      // nothing in this subtree ends after start
+      if (!node || node->maxEnd <= start)
+        return;
+
+      GetOverlapping(node->left.get(), start, end, results);
+
+      // this node and its right subtree start at or after end
+      if (node->key.start >= end)
+        return;
+
+      if (node->key.end > start)
+        results.emplace_back(node->value);
+
+      GetOverlapping(node->right.get(), start, end, results);
+    }
+
+    template<typename F>
+    static bool ForEach(const Node *node, F &function)
+    {
+      if (!node)
+        return true;
+
+      return ForEach(node->left.get(), function) &&
+             function(node->value) &&
+             ForEach(node->right.get(), function);
+    }
+
+    NodePtr m_root;
+    std::unordered_map<unsigned int, std::pair<time_t, time_t>> m_keys;
+    unsigned int m_iSeed;
+  };
+}
@@ -20,7 +20,9 @@
 
 #include "PVRTimers.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <limits>
 #include <utility>
 
 #include "FileItem.h"
@@ -40,39 +42,127 @@
 
 using namespace PVR;
 
+/*!
+ * @brief Get the time span a timer occupies its client, including the margins.
+ */
+static void GetRecordingSpan(const CPVRTimerInfoTagPtr &timer, time_t &start, time_t &end)
+{
+  if (timer->m_bStartAnyTime)
+  {
+    start = std::numeric_limits<time_t>::min();
+  }
+  else
+  {
+    timer->StartAsUTC().GetAsTime(start);
+    start -= timer->m_iMarginStart * 60;
+  }
+
+  if (timer->m_bEndAnyTime)
+  {
+    end = std::numeric_limits<time_t>::max();
+  }
+  else
+  {
+    timer->EndAsUTC().GetAsTime(end);
+    end += timer->m_iMarginEnd * 60;
+  }
+}
+
+/*!
+ * @brief Get the start time of a timer as shown to the user, without the margins.
+ */
+static time_t GetStartTime(const CPVRTimerInfoTagPtr &timer)
+{
+  time_t start = std::numeric_limits<time_t>::min();
+  if (!timer->m_bStartAnyTime)
+    timer->StartAsUTC().GetAsTime(start);
+  return start;
+}
+
 bool CPVRTimersContainer::UpdateFromClient(const CPVRTimerInfoTagPtr &timer)
 {
   CSingleLock lock(m_critSection);
   CPVRTimerInfoTagPtr tag = GetByClient(timer->m_iClientId, timer->m_iClientIndex);
   if (!tag)
   {
+    // the indices are keyed by the data of the tag, so fill it before inserting it
     tag.reset(new CPVRTimerInfoTag());
     tag->m_iTimerId = ++m_iLastId;
+    bool bReturn = tag->UpdateEntry(timer);
     InsertTimer(tag);
+    return bReturn;
   }
 
-  return tag->UpdateEntry(timer);
+  bool bReturn = tag->UpdateEntry(timer);
+  UpdateActiveTimerIndex(tag);
+  return bReturn;
 }
 
 CPVRTimerInfoTagPtr CPVRTimersContainer::GetByClient(int iClientId, unsigned int iClientTimerId) const
 {
   CSingleLock lock(m_critSection);
-  for (const auto startDates : m_tags)
+  const auto it = m_timersByClient.find(std::make_pair(iClientId, iClientTimerId));
+  if (it != m_timersByClient.end())
+    return it->second;
+
+  return CPVRTimerInfoTagPtr();
+}
+
+void CPVRTimersContainer::RemoveTimerFromIndices(const CPVRTimerInfoTagPtr &timer)
+{
+  const auto it = m_timersByClient.find(std::make_pair(timer->m_iClientId, timer->m_iClientIndex));
+  if (it != m_timersByClient.end() && it->second == timer)
+    m_timersByClient.erase(it);
+
+  m_timersById.erase(timer->m_iTimerId);
+  EraseActiveTimer(timer->m_iTimerId);
+}
+
+void CPVRTimersContainer::EraseActiveTimer(unsigned int iTimerId)
+{
+  m_activeTimers.Erase(iTimerId);
+
+  const auto it = m_activeTimerStarts.find(iTimerId);
+  if (it != m_activeTimerStarts.end())
   {
-    for (const auto timer : startDates.second)
-    {
-      if (timer->m_iClientId == iClientId && timer->m_iClientIndex == iClientTimerId)
-      {
-        return timer;
-      }
-    }
+    m_activeTimersByStart.erase(std::make_pair(it->second, iTimerId));
+    m_activeTimerStarts.erase(it);
   }
+}
 
-  return CPVRTimerInfoTagPtr();
+void CPVRTimersContainer::UpdateActiveTimerIndex(const CPVRTimerInfoTagPtr &timer)
+{
+  EraseActiveTimer(timer->m_iTimerId);
+
+  if (timer->IsActive() && !timer->IsTimerRule())
+  {
+    // conflicts need the time the client is busy, the user sees the start without the margin
+    time_t start, end;
+    GetRecordingSpan(timer, start, end);
+    m_activeTimers.Insert(timer->m_iTimerId, start, end, timer);
+
+    start = GetStartTime(timer);
+    m_activeTimersByStart.insert(std::make_pair(std::make_pair(start, timer->m_iTimerId), timer));
+    m_activeTimerStarts.insert(std::make_pair(timer->m_iTimerId, start));
+  }
+}
+
+void CPVRTimersContainer::ClearTimers()
+{
+  m_tags.clear();
+  m_timersByClient.clear();
+  m_timersById.clear();
+  m_activeTimers.Clear();
+  m_activeTimersByStart.clear();
+  m_activeTimerStarts.clear();
 }
 
 void CPVRTimersContainer::InsertTimer(const CPVRTimerInfoTagPtr &newTimer)
 {
+  m_timersByClient[std::make_pair(newTimer->m_iClientId, newTimer->m_iClientIndex)] = newTimer;
+  m_timersById[newTimer->m_iTimerId] = newTimer;
+  UpdateActiveTimerIndex(newTimer);
+
   auto it = m_tags.find(newTimer->m_bStartAnyTime ? CDateTime() : newTimer->StartAsUTC());
   if (it == m_tags.end())
   {
@@ -121,7 +211,7 @@ void CPVRTimers::Unload()
 
   // remove all tags
   CSingleLock lock(m_critSection);
-  m_tags.clear();
+  ClearTimers();
 }
 
 bool CPVRTimers::Update(void)
@@ -144,10 +234,12 @@ bool CPVRTimers::IsRecording(void) const
 {
   CSingleLock lock(m_critSection);
 
-  for (MapTags::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
-    for (VecTimerInfoTag::const_iterator timerIt = it->second.begin(); timerIt != it->second.end(); ++timerIt)
-      if ((*timerIt)->IsRecording())
-        return true;
+  // recording timers are active, and timer rules never record themselves
+  for (const auto &timersEntry : m_activeTimersByStart)
+  {
+    if (timersEntry.second->IsRecording())
+      return true;
+  }
 
   return false;
 }
@@ -211,6 +303,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
         if (existingTimer->UpdateEntry(*timerIt))
         {
           SetEpgTagTimer(existingTimer);
+          UpdateActiveTimerIndex(existingTimer);
 
           bChanged = true;
           existingTimer->ResetChildState();
@@ -283,6 +376,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
 
         ClearEpgTagTimer(timer);
 
+        RemoveTimerFromIndices(timer);
         it2 = it->second.erase(it2);
 
         bChanged = true;
@@ -385,17 +479,13 @@ CFileItemPtr CPVRTimers::GetNextActiveTimer(const TimerKind &eKind) const
 {
   CSingleLock lock(m_critSection);
 
-  for (const auto &tagsEntry : m_tags)
+  for (const auto &timersEntry : m_activeTimersByStart)
   {
-    for (const auto &timersEntry : tagsEntry.second)
-    {
-      if (KindMatchesTag(eKind, timersEntry) &&
-          timersEntry->IsActive() &&
-          !timersEntry->IsRecording() &&
-          !timersEntry->IsTimerRule() &&
-          !timersEntry->IsBroken())
-        return CFileItemPtr(new CFileItem(timersEntry));
-    }
+    const CPVRTimerInfoTagPtr &timer = timersEntry.second;
+    if (KindMatchesTag(eKind, timer) &&
+        !timer->IsRecording() &&
+        !timer->IsBroken())
+      return CFileItemPtr(new CFileItem(timer));
   }
 
   return CFileItemPtr();
@@ -421,36 +511,23 @@ std::vector<CFileItemPtr> CPVRTimers::GetActiveTimers(void) const
   std::vector<CFileItemPtr> tags;
   CSingleLock lock(m_critSection);
 
-  for (MapTags::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
-  {
-    for (VecTimerInfoTag::const_iterator timerIt = it->second.begin(); timerIt != it->second.end(); ++timerIt)
-    {
-      CPVRTimerInfoTagPtr current = *timerIt;
-      if (current->IsActive() && !current->IsTimerRule())
-      {
-        CFileItemPtr fileItem(new CFileItem(current));
-        tags.push_back(fileItem);
-      }
-    }
-  }
+  for (const auto &timersEntry : m_activeTimersByStart)
+    tags.emplace_back(new CFileItem(timersEntry.second));
 
   return tags;
 }
 
 int CPVRTimers::AmountActiveTimers(const TimerKind &eKind) const
 {
-  int iReturn = 0;
   CSingleLock lock(m_critSection);
+  if (eKind == TimerKindAny)
+    return static_cast<int>(m_activeTimers.Size());
 
-  for (const auto &tagsEntry : m_tags)
+  int iReturn = 0;
+  for (const auto &timersEntry : m_activeTimersByStart)
   {
-    for (const auto &timersEntry : tagsEntry.second)
-    {
-      if (KindMatchesTag(eKind, timersEntry) &&
-          timersEntry->IsActive() &&
-          !timersEntry->IsTimerRule())
-        ++iReturn;
-    }
+    if (KindMatchesTag(eKind, timersEntry.second))
+      ++iReturn;
   }
 
   return iReturn;
@@ -476,18 +553,10 @@ std::vector<CFileItemPtr> CPVRTimers::GetActiveRecordings(const TimerKind &eKind
   std::vector<CFileItemPtr> tags;
   CSingleLock lock(m_critSection);
 
-  for (const auto &tagsEntry : m_tags)
+  for (const auto &timersEntry : m_activeTimersByStart)
   {
-    for (const auto &timersEntry : tagsEntry.second)
-    {
-      if (KindMatchesTag(eKind, timersEntry) &&
-          timersEntry->IsRecording() &&
-          !timersEntry->IsTimerRule())
-      {
-        CFileItemPtr fileItem(new CFileItem(timersEntry));
-        tags.push_back(fileItem);
-      }
-    }
+    if (KindMatchesTag(eKind, timersEntry.second) && timersEntry.second->IsRecording())
+      tags.emplace_back(new CFileItem(timersEntry.second));
   }
 
   return tags;
@@ -513,15 +582,10 @@ int CPVRTimers::AmountActiveRecordings(const TimerKind &eKind) const
   int iReturn = 0;
   CSingleLock lock(m_critSection);
 
-  for (const auto &tagsEntry : m_tags)
+  for (const auto &timersEntry : m_activeTimersByStart)
   {
-    for (const auto &timersEntry : tagsEntry.second)
-    {
-      if (KindMatchesTag(eKind, timersEntry) &&
-          timersEntry->IsRecording() &&
-          !timersEntry->IsTimerRule())
-        ++iReturn;
-    }
+    if (KindMatchesTag(eKind, timersEntry.second) && timersEntry.second->IsRecording())
+      ++iReturn;
   }
 
   return iReturn;
@@ -545,12 +609,36 @@ int CPVRTimers::AmountActiveRadioRecordings(void) const
 bool CPVRTimers::HasActiveTimers(void) const
 {
   CSingleLock lock(m_critSection);
-  for (MapTags::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
-    for (VecTimerInfoTag::const_iterator timerIt = it->second.begin(); timerIt != it->second.end(); ++timerIt)
-      if ((*timerIt)->IsActive() && !(*timerIt)->IsTimerRule())
-        return true;
+  return !m_activeTimers.IsEmpty();
+}
 
-  return false;
+std::vector<CPVRTimerInfoTagPtr> CPVRTimers::GetOverlappingTimers(const CDateTime &start, const CDateTime &end) const
+{
+  time_t startTime, endTime;
+  start.GetAsTime(startTime);
+  end.GetAsTime(endTime);
+
+  std::vector<CPVRTimerInfoTagPtr> timers;
+  CSingleLock lock(m_critSection);
+  m_activeTimers.GetOverlapping(startTime, endTime, timers);
+  return timers;
+}
+
+std::vector<CPVRTimerInfoTagPtr> CPVRTimers::GetConflictingTimers(const CPVRTimerInfoTagPtr &timer) const
+{
+  time_t start, end;
+  GetRecordingSpan(timer, start, end);
+
+  std::vector<CPVRTimerInfoTagPtr> timers;
+  CSingleLock lock(m_critSection);
+  m_activeTimers.GetOverlapping(start, end, timers);
+
+  // timers of other clients use other tuners
+  timers.erase(std::remove_if(timers.begin(), timers.end(), [&timer](const CPVRTimerInfoTagPtr &other) {
+    return other->m_iClientId != timer->m_iClientId || other->m_iTimerId == timer->m_iTimerId;
+  }), timers.end());
+
+  return timers;
 }
 
 bool CPVRTimers::GetRootDirectory(const CPVRTimersPath &path, CFileItemList &items) const
@@ -711,6 +799,16 @@ bool CPVRTimers::UpdateTimer(const CPVRTimerInfoTagPtr &tag)
   return tag->UpdateOnClient();
 }
 
+void CPVRTimers::TimerStateChanged(const CPVRTimerInfoTagPtr &timer)
+{
+  CSingleLock lock(m_critSection);
+
+  // the tag may belong to a timer list that was replaced in the meantime
+  const auto it = m_timersById.find(timer->m_iTimerId);
+  if (it != m_timersById.end() && it->second == timer)
+    UpdateActiveTimerIndex(timer);
+}
+
 bool CPVRTimers::IsRecordingOnChannel(const CPVRChannel &channel) const
 {
   CSingleLock lock(m_critSection);
@@ -826,17 +924,7 @@ CPVRTimerInfoTagPtr CPVRTimers::GetTimerRule(const CPVRTimerInfoTagPtr &timer) c
     unsigned int iRuleId = timer->GetTimerRuleId();
     if (iRuleId != PVR_TIMER_NO_PARENT)
     {
-      int iClientId = timer->m_iClientId;
-
-      CSingleLock lock(m_critSection);
-      for (const auto &tagsEntry : m_tags)
-      {
-        for (const auto &timersEntry : tagsEntry.second)
-        {
-          if (timersEntry->m_iClientId == iClientId && timersEntry->m_iClientIndex == iRuleId)
-            return timersEntry;
-        }
-      }
+      return GetByClient(timer->m_iClientId, iRuleId);
     }
   }
   return CPVRTimerInfoTagPtr();
@@ -936,17 +1024,12 @@ void CPVRTimers::GetAll(CFileItemList& items) const
 
 CPVRTimerInfoTagPtr CPVRTimers::GetById(unsigned int iTimerId) const
 {
-  CPVRTimerInfoTagPtr item;
   CSingleLock lock(m_critSection);
-  for (MapTags::const_iterator it = m_tags.begin(); !item && it != m_tags.end(); ++it)
-  {
-    for (VecTimerInfoTag::const_iterator timerIt = it->second.begin(); !item && timerIt != it->second.end(); ++timerIt)
-    {
-      if ((*timerIt)->m_iTimerId == iTimerId)
-        item = *timerIt;
-    }
-  }
-  return item;
+  const auto it = m_timersById.find(iTimerId);
+  if (it != m_timersById.end())
+    return it->second;
+
+  return CPVRTimerInfoTagPtr();
 }
 
 
@@ -29,6 +29,7 @@
 
 #include "pvr/PVRSettings.h"
 #include "pvr/PVRTypes.h"
+#include "pvr/timers/PVRIntervalTree.h"
 #include "pvr/timers/PVRTimerInfoTag.h"
 
 class CFileItem;
@@ -72,9 +73,34 @@ namespace PVR
   protected:
     void InsertTimer(const CPVRTimerInfoTagPtr &newTimer);
 
+    /*!
+     * @brief Remove a timer from the lookup indices. The caller must remove it from m_tags.
+     * @param timer The timer tag.
+     */
+    void RemoveTimerFromIndices(const CPVRTimerInfoTagPtr &timer);
+
+    /*!
+     * @brief Add, move or remove a timer in the index of active timers after its state or times changed.
+     * @param timer The timer tag.
+     */
+    void UpdateActiveTimerIndex(const CPVRTimerInfoTagPtr &timer);
+
+    /*!
+     * @brief Remove a timer from the indices of active timers.
+     * @param iTimerId The id of the timer.
+     */
+    void EraseActiveTimer(unsigned int iTimerId);
+
+    void ClearTimers();
+
     CCriticalSection m_critSection;
     unsigned int m_iLastId;
     MapTags m_tags;
+    std::map<std::pair<int, unsigned int>, CPVRTimerInfoTagPtr> m_timersByClient; /*!< all timers, by client id and client timer id */
+    std::map<unsigned int, CPVRTimerInfoTagPtr> m_timersById;                     /*!< all timers, by timer id */
+    CPVRIntervalTree<CPVRTimerInfoTagPtr> m_activeTimers;                          /*!< active timers that are no timer rules, by recording time including the margins */
+    std::map<std::pair<time_t, unsigned int>, CPVRTimerInfoTagPtr> m_activeTimersByStart; /*!< active timers that are no timer rules, by start time and timer id */
+    std::map<unsigned int, time_t> m_activeTimerStarts;                            /*!< start times of m_activeTimersByStart, by timer id */
   };
 
   class CPVRTimers : public CPVRTimersContainer, public Observer
@@ -179,6 +205,12 @@ namespace PVR
      */
     CPVRTimerInfoTagPtr GetActiveTimerForChannel(const CPVRChannelPtr &channel) const;
 
+    /*!
+     * @brief Update the lookup indices after the state of a timer was changed locally.
+     * @param timer The timer tag.
+     */
+    void TimerStateChanged(const CPVRTimerInfoTagPtr &timer);
+
     /*!
      * @return The amount of tv and radio timers that are currently recording
      */
@@ -202,6 +234,21 @@ namespace PVR
      */
     bool GetDirectory(const std::string& strPath, CFileItemList &items) const;
 
+    /*!
+     * @brief Get the active timers whose recording time overlaps the given time span.
+     * @param start The start of the time span.
+     * @param end The end of the time span.
+     * @return The timers, ordered by start time.
+     */
+    std::vector<CPVRTimerInfoTagPtr> GetOverlappingTimers(const CDateTime &start, const CDateTime &end) const;
+
+    /*!
+     * @brief Get the active timers of the same client whose recording time overlaps the one of the given timer.
+     * @param timer The timer to check.
+     * @return The timers, ordered by start time.
+     */
+    std::vector<CPVRTimerInfoTagPtr> GetConflictingTimers(const CPVRTimerInfoTagPtr &timer) const;
+
     /*!
      * @brief Delete all timers on a channel.
      * @param channel The channel to delete the timers for.
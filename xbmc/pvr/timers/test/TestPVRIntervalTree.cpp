@@ -0,0 +1,126 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "pvr/timers/PVRIntervalTree.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+TEST(TestPVRIntervalTree, Overlapping)
+{
+  CPVRIntervalTree<int> tree;
+  tree.Insert(1, 100, 200, 1);
+  tree.Insert(2, 150, 160, 2);
+  tree.Insert(3, 200, 300, 3);
+  tree.Insert(4, 50, 1000, 4);
+  EXPECT_EQ(4U, tree.Size());
+
+  std::vector<int> results;
+  tree.GetOverlapping(155, 156, results);
+  EXPECT_EQ((std::vector<int>{4, 1, 2}), results);
+
+  // spans are half-open, touching spans do not overlap
+  results.clear();
+  tree.GetOverlapping(200, 201, results);
+  EXPECT_EQ((std::vector<int>{4, 3}), results);
+
+  results.clear();
+  tree.GetOverlapping(1000, 2000, results);
+  EXPECT_TRUE(results.empty());
+
+  EXPECT_TRUE(tree.Erase(4));
+  EXPECT_FALSE(tree.Erase(4));
+  results.clear();
+  tree.GetOverlapping(0, 120, results);
+  EXPECT_EQ((std::vector<int>{1}), results);
+}
+
+TEST(TestPVRIntervalTree, InsertReplacesId)
+{
+  CPVRIntervalTree<int> tree;
+  tree.Insert(1, 100, 200, 1);
+  tree.Insert(1, 500, 600, 10);
+  EXPECT_EQ(1U, tree.Size());
+
+  std::vector<int> results;
+  tree.GetOverlapping(0, 1000, results);
+  EXPECT_EQ((std::vector<int>{10}), results);
+}
+
+TEST(TestPVRIntervalTree, ForEachOrderedByStart)
+{
+  CPVRIntervalTree<int> tree;
+  tree.Insert(1, 300, 400, 3);
+  tree.Insert(2, 100, 400, 1);
+  tree.Insert(3, 200, 250, 2);
+
+  std::vector<int> values;
+  EXPECT_TRUE(tree.ForEach([&values](int value) { values.push_back(value); return true; }));
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), values);
+
+  values.clear();
+  EXPECT_FALSE(tree.ForEach([&values](int value) { values.push_back(value); return value < 2; }));
+  EXPECT_EQ((std::vector<int>{1, 2}), values);
+}
+
+TEST(TestPVRIntervalTree, MatchesLinearScan)
+{
+  std::srand(42);
+  CPVRIntervalTree<unsigned int> tree;
+  std::map<unsigned int, std::pair<time_t, time_t>> spans;
+
+  for (int i = 0; i < 5000; ++i)
+  {
+    unsigned int iId = std::rand() % 500;
+    if (std::rand() % 4 == 0)
+    {
+      EXPECT_EQ(spans.erase(iId) == 1, tree.Erase(iId));
+    }
+    else
+    {
+      time_t start = std::rand() % 10000;
+      time_t end = start + std::rand() % 500;
+      tree.Insert(iId, start, end, iId);
+      spans[iId] = std::make_pair(start, end);
+    }
+
+    time_t queryStart = std::rand() % 10000;
+    time_t queryEnd = queryStart + 1 + std::rand() % 300;
+
+    std::vector<unsigned int> expected;
+    for (const auto &span : spans)
+    {
+      if (span.second.first < queryEnd && span.second.second > queryStart)
+        expected.push_back(span.first);
+    }
+
+    std::vector<unsigned int> results;
+    tree.GetOverlapping(queryStart, queryEnd, results);
+    std::sort(results.begin(), results.end());
+    ASSERT_EQ(expected, results);
+    ASSERT_EQ(spans.size(), tree.Size());
+  }
+}
@@ -740,7 +740,8 @@ void CGUIEPGGridContainer::UpdateItems()
   m_lastItem    = nullptr;
   m_lastChannel = nullptr;
 
-  // always use asynchronously precalculated grid data.
+  // always use asynchronously precalculated grid data. rows of unchanged channels can be taken over.
+  m_updatedGridModel->ReuseGridRows(*m_gridModel);
   m_outdatedGridModel = std::move(m_gridModel); // destructing grid data can be very expensive, thus this will be done asynchronously, not here.
   m_gridModel = std::move(m_updatedGridModel);
 
@@ -1981,7 +1982,13 @@ void CGUIEPGGridContainer::HandleChannels(bool bRender, unsigned int currentTime
   {
     // Free memory not used on screen
     if (m_gridModel->ChannelItemsSize() > m_channelsPerPage + cacheBeforeChannel + cacheAfterChannel)
+    {
       m_gridModel->FreeChannelMemory(chanOffset - cacheBeforeChannel, chanOffset + m_channelsPerPage + 1 + cacheAfterChannel);
+
+      // m_item points into the row of the selected channel, which must survive even while scrolling towards it
+      CSingleLock lock(m_critSection);
+      m_gridModel->FreeGridRows(chanOffset - cacheBeforeChannel, chanOffset + m_channelsPerPage + 1 + cacheAfterChannel, m_channelOffset + m_channelCursor);
+    }
   }
 
   CPoint originChannel = CPoint(m_channelPosX, m_channelPosY) + m_renderOffset;
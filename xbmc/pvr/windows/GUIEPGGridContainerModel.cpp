@@ -21,10 +21,15 @@
 #include "GUIEPGGridContainerModel.h"
 
 #include <cmath>
+#include <functional>
+#include <map>
 
 #include "FileItem.h"
 #include "ServiceBroker.h"
 #include "settings/Settings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
 #include "utils/Variant.h"
 
 #include "pvr/PVRManager.h"
@@ -38,6 +43,20 @@ using namespace PVR;
 
 static const unsigned int GRID_START_PADDING = 30; // minutes
 
+CGUIEPGGridContainerModel::CGUIEPGGridContainerModel(const CGUIEPGGridContainerModel &other)
+: m_gridStart(other.m_gridStart),
+  m_gridEnd(other.m_gridEnd),
+  m_programmeItems(other.m_programmeItems),
+  m_channelItems(other.m_channelItems),
+  m_rulerItems(other.m_rulerItems),
+  m_epgItemsPtr(other.m_epgItemsPtr),
+  m_blocks(other.m_blocks),
+  m_fBlockSize(other.m_fBlockSize)
+{
+  CSingleLock lock(other.m_gridSection);
+  m_gridIndex = other.m_gridIndex;
+}
+
 void CGUIEPGGridContainerModel::SetInvalid()
 {
   for (const auto &programme : m_programmeItems)
@@ -50,6 +69,7 @@ void CGUIEPGGridContainerModel::SetInvalid()
 
 void CGUIEPGGridContainerModel::Reset()
 {
+  CSingleLock lock(m_gridSection);
   for (auto &channel : m_gridIndex)
   {
     for (const auto &block : channel)
@@ -61,6 +81,10 @@ void CGUIEPGGridContainerModel::Reset()
   }
   m_gridIndex.clear();
 
+  // programme items of rows that were never computed or already freed
+  for (const auto &programme : m_programmeItems)
+    programme->ClearProperties();
+
   m_channelItems.clear();
   m_programmeItems.clear();
   m_rulerItems.clear();
@@ -69,48 +93,10 @@ void CGUIEPGGridContainerModel::Reset()
 
 void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &items, const CDateTime &gridStart, const CDateTime &gridEnd, int iRulerUnit, int iBlocksPerPage, float fBlockSize)
 {
-  Reset();
-
-  ////////////////////////////////////////////////////////////////////////
-  // Create programme & channel items
-  m_programmeItems.reserve(items->Size());
-  CFileItemPtr fileItem;
-  int iLastChannelID = -1;
-  ItemsPtr itemsPointer;
-  itemsPointer.start = 0;
-  CPVRChannelPtr channel;
-  int j = 0;
-  for (int i = 0; i < items->Size(); ++i)
-  {
-    fileItem = items->Get(i);
-    if (!fileItem->HasEPGInfoTag() || !fileItem->GetEPGInfoTag()->HasChannel())
-      continue;
-
-    m_programmeItems.emplace_back(fileItem);
-
-    channel = fileItem->GetEPGInfoTag()->Channel();
-    if (!channel)
-      continue;
+  const unsigned int iRefreshStart = XbmcThreads::SystemClockMillis();
 
-    int iCurrentChannelID = channel->ChannelID();
-    if (iCurrentChannelID != iLastChannelID)
-    {
-      if (j > 0)
-      {
-        itemsPointer.stop = j - 1;
-        m_epgItemsPtr.emplace_back(itemsPointer);
-        itemsPointer.start = j;
-      }
-      iLastChannelID = iCurrentChannelID;
-      m_channelItems.emplace_back(CFileItemPtr(new CFileItem(channel)));
-    }
-    ++j;
-  }
-  if (!m_programmeItems.empty())
-  {
-    itemsPointer.stop = m_programmeItems.size() - 1;
-    m_epgItemsPtr.emplace_back(itemsPointer);
-  }
+  Reset();
+  CreateItems(items);
 
   /* check for invalid start and end time */
   if (gridStart >= gridEnd)
@@ -155,9 +141,70 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
 
   FreeItemsMemory();
 
+  CreateGrid(iBlocksPerPage, fBlockSize);
+
+  CLog::Log(LOGDEBUG, "CGUIEPGGridContainerModel - refreshed %d channels, %d programmes, %d blocks in %u ms",
+            ChannelItemsSize(), ProgrammeItemsSize(), m_blocks, XbmcThreads::SystemClockMillis() - iRefreshStart);
+}
+
+void CGUIEPGGridContainerModel::CreateItems(const std::unique_ptr<CFileItemList> &items)
+{
   ////////////////////////////////////////////////////////////////////////
-  // Create epg grid
-  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
+  // Create programme & channel items
+  m_programmeItems.reserve(items->Size());
+  CFileItemPtr fileItem;
+  int iLastChannelID = -1;
+  ItemsPtr itemsPointer;
+  itemsPointer.start = 0;
+  itemsPointer.signature = 0;
+  CPVRChannelPtr channel;
+  time_t startTime, endTime;
+  int j = 0;
+  for (int i = 0; i < items->Size(); ++i)
+  {
+    fileItem = items->Get(i);
+    if (!fileItem->HasEPGInfoTag() || !fileItem->GetEPGInfoTag()->HasChannel())
+      continue;
+
+    m_programmeItems.emplace_back(fileItem);
+
+    channel = fileItem->GetEPGInfoTag()->Channel();
+    if (!channel)
+      continue;
+
+    int iCurrentChannelID = channel->ChannelID();
+    if (iCurrentChannelID != iLastChannelID)
+    {
+      if (j > 0)
+      {
+        itemsPointer.stop = j - 1;
+        m_epgItemsPtr.emplace_back(itemsPointer);
+        itemsPointer.start = j;
+        itemsPointer.signature = 0;
+      }
+      iLastChannelID = iCurrentChannelID;
+      m_channelItems.emplace_back(CFileItemPtr(new CFileItem(channel)));
+    }
+
+    const CPVREpgInfoTagPtr tag(fileItem->GetEPGInfoTag());
+    tag->StartAsUTC().GetAsTime(startTime);
+    tag->EndAsUTC().GetAsTime(endTime);
+    itemsPointer.signature = itemsPointer.signature * 31 + std::hash<const void*>()(tag.get());
+    itemsPointer.signature = itemsPointer.signature * 31 + std::hash<time_t>()(startTime);
+    itemsPointer.signature = itemsPointer.signature * 31 + std::hash<time_t>()(endTime);
+    ++j;
+  }
+  if (!m_programmeItems.empty())
+  {
+    itemsPointer.stop = m_programmeItems.size() - 1;
+    m_epgItemsPtr.emplace_back(itemsPointer);
+  }
+}
+
+void CGUIEPGGridContainerModel::CreateGrid(int iBlocksPerPage, float fBlockSize)
+{
+  ////////////////////////////////////////////////////////////////////////
+  // Create epg grid. Rows are computed on demand, see GetGridRow.
   const CDateTimeSpan gridDuration(m_gridEnd - m_gridStart);
   m_blocks = (gridDuration.GetDays() * 24 * 60 + gridDuration.GetHours() * 60 + gridDuration.GetMinutes()) / MINSPERBLOCK;
   if (m_blocks >= MAXBLOCKS)
@@ -165,112 +212,190 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
   else if (m_blocks < iBlocksPerPage)
     m_blocks = iBlocksPerPage;
 
-  m_gridIndex.reserve(m_channelItems.size());
-  const std::vector<GridItem> blocks(m_blocks);
+  m_fBlockSize = fBlockSize;
+  m_gridIndex.resize(m_channelItems.size());
+}
 
-  for (size_t channel = 0; channel < m_channelItems.size(); ++channel)
-  {
-    m_gridIndex.emplace_back(blocks);
+std::vector<GridItem> &CGUIEPGGridContainerModel::GetGridRow(int iChannel) const
+{
+  CSingleLock lock(m_gridSection);
+  if (m_gridIndex[iChannel].empty())
+    CreateGridRow(iChannel);
 
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[channel].start;
-    unsigned long lastIdx = m_epgItemsPtr[channel].stop;
-    int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
-    int itemSize          = 1; // size of the programme in blocks
-    int savedBlock        = 0;
-    CFileItemPtr item;
-    CPVREpgInfoTagPtr tag;
+  return m_gridIndex[iChannel];
+}
 
-    for (int block = 0; block < m_blocks; ++block)
+void CGUIEPGGridContainerModel::CreateGridRow(int iChannel) const
+{
+  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
+  std::vector<GridItem> &row = m_gridIndex[iChannel];
+  row.resize(m_blocks);
+
+  CDateTime gridCursor(m_gridStart); //reset cursor for new channel
+  unsigned long progIdx = m_epgItemsPtr[iChannel].start;
+  unsigned long lastIdx = m_epgItemsPtr[iChannel].stop;
+  int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
+  int itemSize          = 1; // size of the programme in blocks
+  int savedBlock        = 0;
+  CFileItemPtr item;
+  CPVREpgInfoTagPtr tag;
+
+  for (int block = 0; block < m_blocks; ++block)
+  {
+    while (progIdx <= lastIdx)
     {
-      while (progIdx <= lastIdx)
-      {
-        item = m_programmeItems[progIdx];
-        tag = item->GetEPGInfoTag();
-
-        // Note: Start block of an event is start-time-based calculated block + 1,
-        //       unless start times matches exactly the begin of a block.
+      item = m_programmeItems[progIdx];
+      tag = item->GetEPGInfoTag();
 
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break;
+      // Note: Start block of an event is start-time-based calculated block + 1,
+      //       unless start times matches exactly the begin of a block.
 
-        if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[channel][block].item = item;
-          m_gridIndex[channel][block].progIndex = progIdx;
-          break;
-        }
+      if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
+        break;
 
-        progIdx++;
+      if (gridCursor < tag->EndAsUTC())
+      {
+        row[block].item = item;
+        row[block].progIndex = progIdx;
+        break;
       }
 
-      gridCursor += blockDuration;
+      progIdx++;
+    }
 
-      if (block == 0)
-        continue;
+    gridCursor += blockDuration;
+
+    if (block == 0)
+      continue;
 
-      const CFileItemPtr prevItem(m_gridIndex[channel][block - 1].item);
-      const CFileItemPtr currItem(m_gridIndex[channel][block].item);
+    const CFileItemPtr prevItem(row[block - 1].item);
+    const CFileItemPtr currItem(row[block].item);
 
-      if (block == m_blocks - 1 || prevItem != currItem)
+    if (block == m_blocks - 1 || prevItem != currItem)
+    {
+      // special handling for last block.
+      int blockDelta = -1;
+      int sizeDelta = 0;
+      if (block == m_blocks - 1 && prevItem == currItem)
+      {
+        itemSize++;
+        blockDelta = 0;
+        sizeDelta = 1;
+      }
+
+      if (prevItem)
       {
-        // special handling for last block.
-        int blockDelta = -1;
-        int sizeDelta = 0;
-        if (block == m_blocks - 1 && prevItem == currItem)
+        row[savedBlock].item->SetProperty("GenreType", prevItem->GetEPGInfoTag()->GenreType());
+      }
+      else
+      {
+        CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
+        gapTag->SetChannel(m_channelItems[iChannel]->GetPVRChannelInfoTag());
+        CFileItemPtr gapItem(new CFileItem(gapTag));
+        for (int i = block + blockDelta; i >= block - itemSize + sizeDelta; --i)
         {
-          itemSize++;
-          blockDelta = 0;
-          sizeDelta = 1;
+          row[i].item = gapItem;
         }
+      }
+
+      float fItemWidth = itemSize * m_fBlockSize;
+      row[savedBlock].originWidth = fItemWidth;
+      row[savedBlock].width = fItemWidth;
+
+      itemSize = 1;
+      savedBlock = block;
 
-        if (prevItem)
+      // special handling for last block.
+      if (block == m_blocks - 1 && prevItem != currItem)
+      {
+        if (currItem)
         {
-          m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", prevItem->GetEPGInfoTag()->GenreType());
+          row[savedBlock].item->SetProperty("GenreType", currItem->GetEPGInfoTag()->GenreType());
         }
         else
         {
           CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
-          gapTag->SetChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
+          gapTag->SetChannel(m_channelItems[iChannel]->GetPVRChannelInfoTag());
           CFileItemPtr gapItem(new CFileItem(gapTag));
-          for (int i = block + blockDelta; i >= block - itemSize + sizeDelta; --i)
-          {
-            m_gridIndex[channel][i].item = gapItem;
-          }
+          row[block].item = gapItem;
         }
 
-        float fItemWidth = itemSize * fBlockSize;
-        m_gridIndex[channel][savedBlock].originWidth = fItemWidth;
-        m_gridIndex[channel][savedBlock].width = fItemWidth;
+        row[savedBlock].originWidth = m_fBlockSize; // size always 1 block here
+        row[savedBlock].width = m_fBlockSize;
+      }
+    }
+    else
+    {
+      itemSize++;
+    }
+  }
+}
 
-        itemSize = 1;
-        savedBlock = block;
+void CGUIEPGGridContainerModel::ReuseGridRows(const CGUIEPGGridContainerModel &previous)
+{
+  if (m_blocks != previous.m_blocks ||
+      m_fBlockSize != previous.m_fBlockSize ||
+      m_gridStart != previous.m_gridStart ||
+      m_gridEnd != previous.m_gridEnd)
+    return; // geometry changed, all rows must be recomputed
 
-        // special handling for last block.
-        if (block == m_blocks - 1 && prevItem != currItem)
-        {
-          if (currItem)
-          {
-            m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", currItem->GetEPGInfoTag()->GenreType());
-          }
-          else
-          {
-            CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
-            gapTag->SetChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
-            CFileItemPtr gapItem(new CFileItem(gapTag));
-            m_gridIndex[channel][block].item = gapItem;
-          }
+  std::map<int, int> channelIndices;
+  for (int i = 0; i < ChannelItemsSize(); ++i)
+    channelIndices.insert(std::make_pair(m_channelItems[i]->GetPVRChannelInfoTag()->UniqueID(), i));
 
-          m_gridIndex[channel][savedBlock].originWidth = fBlockSize; // size always 1 block here
-          m_gridIndex[channel][savedBlock].width = fBlockSize;
-        }
-      }
-      else
+  CSingleLock previousLock(previous.m_gridSection);
+  CSingleLock lock(m_gridSection);
+
+  int iReused = 0;
+  for (int iPrevious = 0; iPrevious < previous.ChannelItemsSize(); ++iPrevious)
+  {
+    const std::vector<GridItem> &previousRow = previous.m_gridIndex[iPrevious];
+    if (previousRow.empty())
+      continue;
+
+    const auto it = channelIndices.find(previous.m_channelItems[iPrevious]->GetPVRChannelInfoTag()->UniqueID());
+    if (it == channelIndices.end())
+      continue;
+
+    const int iChannel = it->second;
+    const ItemsPtr &items = m_epgItemsPtr[iChannel];
+    const ItemsPtr &previousItems = previous.m_epgItemsPtr[iPrevious];
+    if (!m_gridIndex[iChannel].empty() ||
+        items.signature != previousItems.signature ||
+        items.stop - items.start != previousItems.stop - previousItems.start)
+      continue;
+
+    // same tags with the same times, thus same layout. only the file items need to be replaced.
+    std::vector<GridItem> &row = m_gridIndex[iChannel];
+    row = previousRow;
+
+    CFileItemPtr gapItem;
+    for (int block = 0; block < m_blocks; ++block)
+    {
+      GridItem &gridItem = row[block];
+      if (gridItem.progIndex < 0)
       {
-        itemSize++;
+        // gap items are owned by the previous model, which clears their properties on destruction
+        if (block == 0 || previousRow[block - 1].item != previousRow[block].item)
+        {
+          CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
+          gapTag->SetChannel(m_channelItems[iChannel]->GetPVRChannelInfoTag());
+          gapItem.reset(new CFileItem(gapTag));
+        }
+        gridItem.item = gapItem;
+        continue;
       }
+
+      gridItem.progIndex = items.start + gridItem.progIndex - previousItems.start;
+      gridItem.item = m_programmeItems[gridItem.progIndex];
+      if (block == 0 || previousRow[block - 1].progIndex != previousRow[block].progIndex)
+        gridItem.item->SetProperty("GenreType", gridItem.item->GetEPGInfoTag()->GenreType());
     }
+    iReused++;
   }
+
+  if (iReused > 0)
+    CLog::Log(LOGDEBUG, "CGUIEPGGridContainerModel - reused %d unchanged channel rows", iReused);
 }
 
 void CGUIEPGGridContainerModel::FindChannelAndBlockIndex(int channelUid, unsigned int broadcastUid, int eventOffset, int &newChannelIndex, int &newBlockIndex) const
@@ -353,41 +478,56 @@ void CGUIEPGGridContainerModel::FreeChannelMemory(int keepStart, int keepEnd)
   }
 }
 
+void CGUIEPGGridContainerModel::FreeGridRows(int keepStart, int keepEnd, int keepChannel)
+{
+  if (keepStart >= keepEnd)
+    return;
+
+  CSingleLock lock(m_gridSection);
+  for (int i = 0; i < ChannelItemsSize(); ++i)
+  {
+    if ((i < keepStart || i > keepEnd) && i != keepChannel && !m_gridIndex[i].empty())
+      std::vector<GridItem>().swap(m_gridIndex[i]);
+  }
+}
+
 void CGUIEPGGridContainerModel::FreeProgrammeMemory(int channel, int keepStart, int keepEnd)
 {
   if (keepStart < keepEnd)
   {
+    std::vector<GridItem> &row = GetGridRow(channel);
+
     // remove before keepStart and after keepEnd
     if (keepStart > 0 && keepStart < m_blocks)
     {
       // if item exist and block is not part of visible item
-      CGUIListItemPtr last(m_gridIndex[channel][keepStart].item);
+      CGUIListItemPtr last(row[keepStart].item);
       for (int i = keepStart - 1; i > 0; --i)
       {
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
+        if (row[i].item && row[i].item != last)
         {
-          m_gridIndex[channel][i].item->FreeMemory();
+          row[i].item->FreeMemory();
           // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
           // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
           // to avoid calling FreeMemory() multiple times on item that occupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
+          last = row[i].item;
         }
       }
     }
 
     if (keepEnd > 0 && keepEnd < m_blocks)
     {
-      CGUIListItemPtr last(m_gridIndex[channel][keepEnd].item);
+      CGUIListItemPtr last(row[keepEnd].item);
       for (int i = keepEnd + 1; i < m_blocks; ++i)
       {
         // if item exist and block is not part of visible item
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
+        if (row[i].item && row[i].item != last)
         {
-          m_gridIndex[channel][i].item->FreeMemory();
+          row[i].item->FreeMemory();
           // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
           // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
           // to avoid calling FreeMemory() multiple times on item that occupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
+          last = row[i].item;
         }
       }
     }
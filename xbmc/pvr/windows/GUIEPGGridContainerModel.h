@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "XBDateTime.h"
+#include "threads/CriticalSection.h"
 
 #include "pvr/PVRTypes.h"
 
@@ -45,16 +46,29 @@ namespace PVR
 
   class CGUIEPGGridContainerModel
   {
+    friend class TestEPGGridContainerModelHelper;
+
   public:
     static const int MINSPERBLOCK = 5; // minutes
     static const int MAXBLOCKS = 33 * 24 * 60 / MINSPERBLOCK; //! 33 days of 5 minute blocks (31 days for upcoming data + 1 day for past data + 1 day for fillers)
 
-    CGUIEPGGridContainerModel() : m_blocks(0) {}
+    CGUIEPGGridContainerModel() : m_blocks(0), m_fBlockSize(0.0f) {}
+    CGUIEPGGridContainerModel(const CGUIEPGGridContainerModel &other);
     virtual ~CGUIEPGGridContainerModel() { Reset(); }
 
+    /*!
+     * @brief Set the programmes, channels and time frame of the grid.
+     * The blocks of a channel row are not computed here, but on first access to the row.
+     */
     void Refresh(const std::unique_ptr<CFileItemList> &items, const CDateTime &gridStart, const CDateTime &gridEnd, int iRulerUnit, int iBlocksPerPage, float fBlockSize);
     void SetInvalid();
 
+    /*!
+     * @brief Take over the computed rows of another model for all channels whose programmes did not change.
+     * @param previous The model this model replaces.
+     */
+    void ReuseGridRows(const CGUIEPGGridContainerModel &previous);
+
     static const int INVALID_INDEX = -1;
     void FindChannelAndBlockIndex(int channelUid, unsigned int broadcastUid, int eventOffset, int &newChannelIndex, int &newBlockIndex) const;
 
@@ -62,6 +76,14 @@ namespace PVR
     void FreeProgrammeMemory(int channel, int keepStart, int keepEnd);
     void FreeRulerMemory(int keepStart, int keepEnd);
 
+    /*!
+     * @brief Drop the computed rows of all channels outside the given range. Dropped rows get recomputed on next access.
+     * @param keepStart The first channel to keep.
+     * @param keepEnd The last channel to keep.
+     * @param keepChannel A channel to keep regardless of the range, e.g. the selected one.
+     */
+    void FreeGridRows(int keepStart, int keepEnd, int keepChannel);
+
     CFileItemPtr GetProgrammeItem(int iIndex) const { return m_programmeItems[iIndex]; }
     bool HasProgrammeItems() const { return !m_programmeItems.empty(); }
     int ProgrammeItemsSize() const { return static_cast<int>(m_programmeItems.size()); }
@@ -75,12 +97,12 @@ namespace PVR
 
     int GetBlockCount() const { return m_blocks; }
     bool HasGridItems() const { return !m_gridIndex.empty(); }
-    GridItem *GetGridItemPtr(int iChannel, int iBlock) { return &m_gridIndex[iChannel][iBlock]; }
-    CFileItemPtr GetGridItem(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].item; }
-    float GetGridItemWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].width; }
-    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].originWidth; }
-    int GetGridItemIndex(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].progIndex; }
-    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { m_gridIndex[iChannel][iBlock].width = fWidth; }
+    GridItem *GetGridItemPtr(int iChannel, int iBlock) { return &GetGridRow(iChannel)[iBlock]; }
+    CFileItemPtr GetGridItem(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].item; }
+    float GetGridItemWidth(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].width; }
+    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].originWidth; }
+    int GetGridItemIndex(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].progIndex; }
+    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { GetGridRow(iChannel)[iBlock].width = fWidth; }
 
     bool IsZeroGridDuration() const { return (m_gridEnd - m_gridStart) == CDateTimeSpan(0, 0, 0, 0); }
     const CDateTime &GetGridStart() const { return m_gridStart; }
@@ -99,10 +121,24 @@ namespace PVR
     void FreeItemsMemory();
     void Reset();
 
+    /*!
+     * @brief Create the programme and channel items and the programme range of every channel.
+     */
+    void CreateItems(const std::unique_ptr<CFileItemList> &items);
+
+    /*!
+     * @brief Set the block count and size for the current time frame and create the empty channel rows.
+     */
+    void CreateGrid(int iBlocksPerPage, float fBlockSize);
+
+    std::vector<GridItem> &GetGridRow(int iChannel) const;
+    void CreateGridRow(int iChannel) const;
+
     struct ItemsPtr
     {
       long start;
       long stop;
+      size_t signature; // hash over the tags and their times, to detect changed channels
     };
 
     CDateTime m_gridStart;
@@ -112,8 +148,11 @@ namespace PVR
     std::vector<CFileItemPtr> m_channelItems;
     std::vector<CFileItemPtr> m_rulerItems;
     std::vector<ItemsPtr> m_epgItemsPtr;
-    std::vector<std::vector<GridItem> > m_gridIndex;
+    // one row per channel, empty until first access
+    mutable std::vector<std::vector<GridItem> > m_gridIndex;
+    mutable CCriticalSection m_gridSection;
 
     int m_blocks;
+    float m_fBlockSize;
   };
 }
@@ -198,6 +198,7 @@ bool CGUIWindowPVRChannelsBase::OnMessage(CGUIMessage& message)
         case ObservableMessageEpgActiveItem:
         case ObservableMessageCurrentItem:
         case ObservableMessageRecordings:
+        case ObservableMessageRecordingItemUpdate:
         {
           SetInvalid();
           break;
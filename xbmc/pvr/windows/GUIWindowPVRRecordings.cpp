@@ -312,6 +312,15 @@ bool CGUIWindowPVRRecordingsBase::OnMessage(CGUIMessage &message)
           SetInvalid();
           break;
         }
+        case ObservableMessageRecordingItemUpdate:
+        {
+          // the recordings kept their place in the list, only the items need a refresh
+          const CPVRRecordingsPtr recordings(CServiceBroker::GetPVRManager().Recordings());
+          for (int i = 0; i < m_vecItems->Size(); i++)
+            recordings->RefreshFileItem(*m_vecItems->Get(i));
+          SetInvalid();
+          break;
+        }
         case ObservableMessageRecordings:
         case ObservableMessageTimersReset:
         {
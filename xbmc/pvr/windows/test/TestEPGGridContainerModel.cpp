@@ -0,0 +1,190 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/windows/GUIEPGGridContainerModel.h"
+#include "threads/SingleLock.h"
+#include "XBDateTime.h"
+
+#include <cstring>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace PVR
+{
+class TestEPGGridContainerModelHelper
+{
+public:
+  static const int BLOCKS = 24; // two hours
+  static constexpr float BLOCK_SIZE = 10.0f;
+
+  /* Refresh without the ruler and the time frame adjustment, both need the PVR manager */
+  static void Refresh(CGUIEPGGridContainerModel &model, const std::unique_ptr<CFileItemList> &items, const CDateTime &gridStart)
+  {
+    model.Reset();
+    model.CreateItems(items);
+    model.m_gridStart = gridStart;
+    model.m_gridEnd = gridStart + CDateTimeSpan(0, 0, BLOCKS * CGUIEPGGridContainerModel::MINSPERBLOCK, 0);
+    model.CreateGrid(BLOCKS, BLOCK_SIZE);
+  }
+
+  static bool HasGridRow(const CGUIEPGGridContainerModel &model, int iChannel)
+  {
+    CSingleLock lock(model.m_gridSection);
+    return !model.m_gridIndex[iChannel].empty();
+  }
+};
+
+constexpr float TestEPGGridContainerModelHelper::BLOCK_SIZE;
+}
+
+using namespace PVR;
+
+namespace
+{
+const CDateTime GRID_START(2018, 1, 1, 20, 0, 0);
+
+CPVRChannelPtr CreateChannel(int iChannelId)
+{
+  PVR_CHANNEL data;
+  std::memset(&data, 0, sizeof(data));
+  data.iUniqueId = iChannelId;
+
+  CPVRChannelPtr channel(new CPVRChannel(data, 1));
+  channel->SetChannelID(iChannelId);
+  return channel;
+}
+
+CFileItemPtr CreateItem(const CPVREpgInfoTagPtr &tag)
+{
+  CFileItemPtr item(new CFileItem);
+  item->SetEPGInfoTag(tag);
+  return item;
+}
+
+CPVREpgInfoTagPtr CreateTag(const CPVRChannelPtr &channel, unsigned int iUniqueBroadcastId, int iStartMinutes, int iMinutes)
+{
+  time_t gridStart;
+  GRID_START.GetAsTime(gridStart);
+
+  EPG_TAG data;
+  std::memset(&data, 0, sizeof(data));
+  data.iUniqueBroadcastId = iUniqueBroadcastId;
+  data.startTime = gridStart + iStartMinutes * 60;
+  data.endTime = data.startTime + iMinutes * 60;
+  data.strTitle = "Programme";
+
+  CPVREpgInfoTagPtr tag(new CPVREpgInfoTag(data, 1));
+  tag->SetChannel(channel);
+  return tag;
+}
+
+/* two programmes per channel that cover the whole grid, 6 and 18 blocks */
+void AddProgrammes(CFileItemList &items, const CPVRChannelPtr &channel)
+{
+  items.Add(CreateItem(CreateTag(channel, 1, 0, 30)));
+  items.Add(CreateItem(CreateTag(channel, 2, 30, 120)));
+}
+}
+
+TEST(TestEPGGridContainerModel, RowsAreComputedOnAccess)
+{
+  std::unique_ptr<CFileItemList> items(new CFileItemList);
+  for (int i = 1; i <= 3; ++i)
+    AddProgrammes(*items, CreateChannel(i));
+
+  CGUIEPGGridContainerModel model;
+  TestEPGGridContainerModelHelper::Refresh(model, items, GRID_START);
+  ASSERT_EQ(3, model.ChannelItemsSize());
+  ASSERT_EQ(TestEPGGridContainerModelHelper::BLOCKS, model.GetBlockCount());
+  for (int i = 0; i < 3; ++i)
+    EXPECT_FALSE(TestEPGGridContainerModelHelper::HasGridRow(model, i));
+
+  EXPECT_EQ(items->Get(0), model.GetGridItem(0, 0));
+  EXPECT_TRUE(TestEPGGridContainerModelHelper::HasGridRow(model, 0));
+  EXPECT_FALSE(TestEPGGridContainerModelHelper::HasGridRow(model, 1));
+  EXPECT_FALSE(TestEPGGridContainerModelHelper::HasGridRow(model, 2));
+
+  EXPECT_EQ(0, model.GetGridItemIndex(0, 5));
+  EXPECT_EQ(1, model.GetGridItemIndex(0, 6));
+  EXPECT_EQ(1, model.GetGridItemIndex(0, 23));
+  EXPECT_EQ(6 * TestEPGGridContainerModelHelper::BLOCK_SIZE, model.GetGridItemOriginWidth(0, 0));
+  EXPECT_EQ(18 * TestEPGGridContainerModelHelper::BLOCK_SIZE, model.GetGridItemOriginWidth(0, 6));
+  EXPECT_EQ(5, model.GetGridItemIndex(2, 6));
+  EXPECT_EQ(items->Get(5), model.GetGridItem(2, 6));
+
+  // rows outside the range are dropped, unless it is the kept channel
+  model.FreeGridRows(0, 1, 2);
+  EXPECT_TRUE(TestEPGGridContainerModelHelper::HasGridRow(model, 0));
+  EXPECT_TRUE(TestEPGGridContainerModelHelper::HasGridRow(model, 2));
+  model.FreeGridRows(1, 2, -1);
+  EXPECT_FALSE(TestEPGGridContainerModelHelper::HasGridRow(model, 0));
+  EXPECT_TRUE(TestEPGGridContainerModelHelper::HasGridRow(model, 2));
+
+  // and computed again on next access
+  EXPECT_EQ(6 * TestEPGGridContainerModelHelper::BLOCK_SIZE, model.GetGridItemWidth(0, 0));
+  EXPECT_EQ(1, model.GetGridItemIndex(0, 6));
+}
+
+TEST(TestEPGGridContainerModel, ReuseGridRows)
+{
+  const CPVRChannelPtr channel1(CreateChannel(1));
+  const CPVRChannelPtr channel2(CreateChannel(2));
+  std::unique_ptr<CFileItemList> previousItems(new CFileItemList);
+  AddProgrammes(*previousItems, channel1);
+  AddProgrammes(*previousItems, channel2);
+
+  CGUIEPGGridContainerModel previous;
+  TestEPGGridContainerModelHelper::Refresh(previous, previousItems, GRID_START);
+  previous.GetGridItem(0, 0);
+  previous.GetGridItem(1, 0);
+
+  // a new channel in front, the same tags for channel 1, a changed tag for channel 2
+  std::unique_ptr<CFileItemList> items(new CFileItemList);
+  AddProgrammes(*items, CreateChannel(3));
+  items->Add(CreateItem(previousItems->Get(0)->GetEPGInfoTag()));
+  items->Add(CreateItem(previousItems->Get(1)->GetEPGInfoTag()));
+  items->Add(CreateItem(previousItems->Get(2)->GetEPGInfoTag()));
+  items->Add(CreateItem(CreateTag(channel2, 2, 30, 120)));
+
+  CGUIEPGGridContainerModel model;
+  TestEPGGridContainerModelHelper::Refresh(model, items, GRID_START);
+  model.ReuseGridRows(previous);
+  EXPECT_FALSE(TestEPGGridContainerModelHelper::HasGridRow(model, 0));
+  EXPECT_TRUE(TestEPGGridContainerModelHelper::HasGridRow(model, 1));
+  EXPECT_FALSE(TestEPGGridContainerModelHelper::HasGridRow(model, 2));
+
+  // the reused row points to the items of the new model
+  EXPECT_EQ(2, model.GetGridItemIndex(1, 0));
+  EXPECT_EQ(3, model.GetGridItemIndex(1, 6));
+  EXPECT_EQ(items->Get(2), model.GetGridItem(1, 0));
+  EXPECT_EQ(items->Get(3), model.GetGridItem(1, 23));
+  EXPECT_EQ(6 * TestEPGGridContainerModelHelper::BLOCK_SIZE, model.GetGridItemOriginWidth(1, 0));
+  EXPECT_EQ(18 * TestEPGGridContainerModelHelper::BLOCK_SIZE, model.GetGridItemOriginWidth(1, 6));
+
+  // a different time frame reuses nothing
+  CGUIEPGGridContainerModel moved;
+  TestEPGGridContainerModelHelper::Refresh(moved, items, GRID_START + CDateTimeSpan(0, 0, 30, 0));
+  moved.ReuseGridRows(previous);
+  EXPECT_FALSE(TestEPGGridContainerModelHelper::HasGridRow(moved, 1));
+}
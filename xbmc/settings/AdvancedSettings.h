@@ -174,6 +174,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_videoIgnoreSecondsAtStart;
     float m_videoIgnorePercentAtEnd;
     float m_audioApplyDrc;
+    bool m_audioAdaptiveSinkBuffer;
     bool m_useFfmpegVda;
 
     int   m_videoVDPAUScaling;
@@ -185,6 +186,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     std::vector<RefreshVideoLatency> m_videoRefreshLatency;
     float m_videoDefaultLatency;
     int  m_videoCaptureUseOcclusionQuery;
+    std::string m_videoFrameTimingTrace;
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
     bool m_DXVAForceProcessorRenderer;
@@ -285,6 +287,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iEpgUpdateEmptyTagsInterval; // seconds
     bool m_bEpgDisplayUpdatePopup;
     bool m_bEpgDisplayIncrementalUpdatePopup;
+    unsigned int m_iEpgClientRequestInterval; // milliseconds
+    unsigned int m_iEpgClientUpdateTimeout; // seconds
 
     // EDL Commercial Break
     bool m_bEdlMergeShortCommBreaks;
@@ -331,6 +335,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bPVRChannelIconsAutoScan; /*!< @brief automatically scan user defined folder for channel icons when loading internal channel groups */
     bool m_bPVRAutoScanIconsUserSet; /*!< @brief mark channel icons populated by auto scan as "user set" */
     int m_iPVRNumericChannelSwitchTimeout; /*!< @brief time in ms before the numeric dialog auto closes when confirmchannelswitch is disabled */
+    bool m_bPVRPreTuneChannels; /*!< @brief obtain the stream properties of the channels next to the playing channel ahead of a channel switch. defaults to false. */
 
     DatabaseSettings m_databaseMusic; // advanced music database setup
     DatabaseSettings m_databaseVideo; // advanced video database setup
@@ -264,6 +264,7 @@ const std::string CSettings::SETTING_MUSICLIBRARY_OVERRIDETAGS = "musiclibrary.o
 const std::string CSettings::SETTING_MUSICLIBRARY_SHOWALLITEMS = "musiclibrary.showallitems";
 const std::string CSettings::SETTING_MUSICLIBRARY_UPDATEONSTARTUP = "musiclibrary.updateonstartup";
 const std::string CSettings::SETTING_MUSICLIBRARY_BACKGROUNDUPDATE = "musiclibrary.backgroundupdate";
+const std::string CSettings::SETTING_MUSICLIBRARY_ANALYSELOUDNESS = "musiclibrary.analyseloudness";
 const std::string CSettings::SETTING_MUSICLIBRARY_CLEANUP = "musiclibrary.cleanup";
 const std::string CSettings::SETTING_MUSICLIBRARY_EXPORT = "musiclibrary.export";
 const std::string CSettings::SETTING_MUSICLIBRARY_EXPORT_FILETYPE = "musiclibrary.exportfiletype";
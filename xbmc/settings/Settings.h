@@ -215,6 +215,7 @@ public:
   static const std::string SETTING_MUSICLIBRARY_SHOWALLITEMS;
   static const std::string SETTING_MUSICLIBRARY_UPDATEONSTARTUP;
   static const std::string SETTING_MUSICLIBRARY_BACKGROUNDUPDATE;
+  static const std::string SETTING_MUSICLIBRARY_ANALYSELOUDNESS;
   static const std::string SETTING_MUSICLIBRARY_CLEANUP;
   static const std::string SETTING_MUSICLIBRARY_EXPORT;
   static const std::string SETTING_MUSICLIBRARY_EXPORT_FILETYPE;
@@ -22,6 +22,19 @@
 
 using namespace Actor;
 
+// messages are allocated in blocks, in flight messages rarely exceed one block
+#define MSG_BLOCK_SIZE 32
+
+void Message::SetData(void *payload, int size)
+{
+  if (size > MSG_INTERNAL_BUFFER_SIZE)
+    data = new uint8_t[size];
+  else
+    data = buffer;
+  memcpy(data, payload, size);
+  payloadSize = size;
+}
+
 void Message::Release()
 {
   bool skip;
@@ -37,9 +50,7 @@ void Message::Release()
   if (data != buffer)
     delete [] data;
 
-  // delete event in case of sync message
-  if (event)
-    delete event;
+  payloadObj.reset();
 
   origin->ReturnMessage(this);
 }
@@ -63,13 +74,7 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
     msg->isOut = !isOut;
     replyMessage = msg;
     if (data)
-    {
-      if (size > MSG_INTERNAL_BUFFER_SIZE)
-        msg->data = new uint8_t[size];
-      else
-        msg->data = msg->buffer;
-      memcpy(msg->data, data, size);
-    }
+      msg->SetData(data, size);
   }
 
   origin->Unlock();
@@ -80,16 +85,72 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
   return true;
 }
 
-Protocol::~Protocol()
+bool Message::Reply(int sig, CPayloadWrapBase *payload)
 {
-  Message *msg;
-  Purge();
-  while (!freeMessageQueue.empty())
+  std::unique_ptr<CPayloadWrapBase> payloadObj(payload);
+
+  if (!isSync)
+  {
+    if (isOut)
+      return origin->SendInMessage(sig, payloadObj.release());
+    else
+      return origin->SendOutMessage(sig, payloadObj.release());
+  }
+
+  origin->Lock();
+
+  if (!isSyncTimeout)
+  {
+    Message *msg = origin->GetMessage();
+    msg->signal = sig;
+    msg->isOut = !isOut;
+    msg->payloadObj = std::move(payloadObj);
+    replyMessage = msg;
+  }
+
+  origin->Unlock();
+
+  if (event)
+    event->Set();
+
+  return true;
+}
+
+void Protocol::MessageQueue::Push(Message *msg)
+{
+  msg->next = nullptr;
+  if (tail)
+    tail->next = msg;
+  else
+    head = msg;
+  tail = msg;
+}
+
+Message *Protocol::MessageQueue::Pop()
+{
+  Message *msg = head;
+  if (msg)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
-    delete msg;
+    head = msg->next;
+    if (!head)
+      tail = nullptr;
+    msg->next = nullptr;
   }
+  return msg;
+}
+
+Protocol::Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
+  : portName(name), inDefered(false), outDefered(false)
+{
+  containerInEvent = inEvent;
+  containerOutEvent = outEvent;
+  freeMessages = nullptr;
+}
+
+Protocol::~Protocol()
+{
+  Purge();
+  // messages are owned by the blocks
 }
 
 Message *Protocol::GetMessage()
@@ -98,14 +159,21 @@ Message *Protocol::GetMessage()
 
   CSingleLock lock(criticalSection);
 
-  if (!freeMessageQueue.empty())
+  if (!freeMessages)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    Message *block = new Message[MSG_BLOCK_SIZE];
+    messageBlocks.emplace_back(block);
+    for (int i = 0; i < MSG_BLOCK_SIZE; i++)
+    {
+      block[i].next = freeMessages;
+      freeMessages = &block[i];
+    }
   }
-  else
-    msg = new Message();
 
+  msg = freeMessages;
+  freeMessages = msg->next;
+
+  msg->next = nullptr;
   msg->isSync = false;
   msg->isSyncFini = false;
   msg->isSyncTimeout = false;
@@ -122,7 +190,30 @@ void Protocol::ReturnMessage(Message *msg)
 {
   CSingleLock lock(criticalSection);
 
-  freeMessageQueue.push(msg);
+  msg->next = freeMessages;
+  freeMessages = msg;
+}
+
+void Protocol::QueueMessage(MessageQueue &queue, Message *msg, CEvent *event)
+{
+  { CSingleLock lock(criticalSection);
+    queue.Push(msg);
+  }
+
+  if (event)
+    event->Set();
+}
+
+bool Protocol::DequeueMessage(MessageQueue &queue, bool defered, Message **msg)
+{
+  CSingleLock lock(criticalSection);
+
+  if (!queue.head || defered)
+    return false;
+
+  *msg = queue.Pop();
+
+  return true;
 }
 
 bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* = 0 */, Message *outMsg /* = NULL */)
@@ -137,19 +228,26 @@ bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = true;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetData(data, size);
 
-  { CSingleLock lock(criticalSection);
-    outMessages.push(msg);
-  }
-  if (containerOutEvent)
-    containerOutEvent->Set();
+  QueueMessage(outMessages, msg, containerOutEvent);
+
+  return true;
+}
+
+bool Protocol::SendOutMessage(int signal, CPayloadWrapBase *payload, Message *outMsg /* = NULL */)
+{
+  Message *msg;
+  if (outMsg)
+    msg = outMsg;
+  else
+    msg = GetMessage();
+
+  msg->signal = signal;
+  msg->isOut = true;
+  msg->payloadObj.reset(payload);
+
+  QueueMessage(outMessages, msg, containerOutEvent);
 
   return true;
 }
@@ -166,32 +264,57 @@ bool Protocol::SendInMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = false;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetData(data, size);
 
-  { CSingleLock lock(criticalSection);
-    inMessages.push(msg);
-  }
-  if (containerInEvent)
-    containerInEvent->Set();
+  QueueMessage(inMessages, msg, containerInEvent);
 
   return true;
 }
 
+bool Protocol::SendInMessage(int signal, CPayloadWrapBase *payload, Message *outMsg /* = NULL */)
+{
+  Message *msg;
+  if (outMsg)
+    msg = outMsg;
+  else
+    msg = GetMessage();
+
+  msg->signal = signal;
+  msg->isOut = false;
+  msg->payloadObj.reset(payload);
+
+  QueueMessage(inMessages, msg, containerInEvent);
+
+  return true;
+}
 
 bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, void *data /* = NULL */, int size /* = 0 */)
 {
   Message *msg = GetMessage();
+  if (data)
+    msg->SetData(data, size);
+  return SendMessageSync(signal, retMsg, timeout, msg);
+}
+
+bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, CPayloadWrapBase *payload)
+{
+  Message *msg = GetMessage();
+  msg->payloadObj.reset(payload);
+  return SendMessageSync(signal, retMsg, timeout, msg);
+}
+
+bool Protocol::SendMessageSync(int signal, Message **retMsg, int timeout, Message *msg)
+{
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  // the event lives with the message, a late reply to a timed out message
+  // still finds it because the message is only recycled after both sides
+  // released it
+  msg->event = &msg->syncEvent;
   msg->event->Reset();
-  SendOutMessage(signal, data, size, msg);
+
+  msg->signal = signal;
+  QueueMessage(outMessages, msg, containerOutEvent);
 
   if (!msg->event->WaitMSec(timeout))
   {
@@ -218,28 +341,12 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
 
 bool Protocol::ReceiveOutMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (outMessages.empty() || outDefered)
-    return false;
-
-  *msg = outMessages.front();
-  outMessages.pop();
-
-  return true;
+  return DequeueMessage(outMessages, outDefered, msg);
 }
 
 bool Protocol::ReceiveInMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (inMessages.empty() || inDefered)
-    return false;
-
-  *msg = inMessages.front();
-  inMessages.pop();
-
-  return true;
+  return DequeueMessage(inMessages, inDefered, msg);
 }
 
 
@@ -254,46 +361,36 @@ void Protocol::Purge()
     msg->Release();
 }
 
-void Protocol::PurgeIn(int signal)
+void Protocol::PurgeQueue(MessageQueue &queue, int signal)
 {
+  MessageQueue msgs;
+  MessageQueue purged;
   Message *msg;
-  std::queue<Message*> msgs;
 
-  CSingleLock lock(criticalSection);
-
-  while (!inMessages.empty())
-  {
-    msg = inMessages.front();
-    inMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    inMessages.push(msg);
+  { CSingleLock lock(criticalSection);
+    while ((msg = queue.Pop()))
+    {
+      if (msg->signal != signal)
+        msgs.Push(msg);
+      else
+        purged.Push(msg);
+    }
+    queue.head = msgs.head;
+    queue.tail = msgs.tail;
   }
+
+  // this releases the receiver side of sync messages, they go back to the
+  // pool once the sender released them as well
+  while ((msg = purged.Pop()))
+    msg->Release();
 }
 
-void Protocol::PurgeOut(int signal)
+void Protocol::PurgeIn(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
-
-  CSingleLock lock(criticalSection);
+  PurgeQueue(inMessages, signal);
+}
 
-  while (!outMessages.empty())
-  {
-    msg = outMessages.front();
-    outMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    outMessages.push(msg);
-  }
+void Protocol::PurgeOut(int signal)
+{
+  PurgeQueue(outMessages, signal);
 }
@@ -21,14 +21,39 @@
 #pragma once
 
 #include "threads/Thread.h"
-#include <queue>
+#include <memory>
+#include <string>
+#include <vector>
 #include "memory.h"
 
-#define MSG_INTERNAL_BUFFER_SIZE 32
+#define MSG_INTERNAL_BUFFER_SIZE 128
 
 namespace Actor
 {
 
+/**
+ * Owns a payload object of a message. Use it for payloads that cannot be
+ * copied byte wise, the object is moved into the message and destroyed when
+ * the message is released.
+ */
+class CPayloadWrapBase
+{
+public:
+  virtual ~CPayloadWrapBase() = default;
+};
+
+template<typename Payload>
+class CPayloadWrap : public CPayloadWrapBase
+{
+public:
+  explicit CPayloadWrap(Payload *data) : m_pPayload(data) {}
+  explicit CPayloadWrap(Payload &&data) : m_pPayload(new Payload(std::move(data))) {}
+  Payload *GetPayload() { return m_pPayload.get(); }
+
+protected:
+  std::unique_ptr<Payload> m_pPayload;
+};
+
 class Protocol;
 
 class Message
@@ -43,30 +68,46 @@ public:
   int payloadSize;
   uint8_t buffer[MSG_INTERNAL_BUFFER_SIZE];
   uint8_t *data;
+  std::unique_ptr<CPayloadWrapBase> payloadObj;
   Message *replyMessage;
   Protocol *origin;
   CEvent *event;
 
   void Release();
   bool Reply(int sig, void *data = NULL, int size = 0);
+  bool Reply(int sig, CPayloadWrapBase *payload);
 
 private:
-  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL;};
+  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL; next = NULL;};
+  void SetData(void *data, int size);
+
+  Message *next;
+  CEvent syncEvent;
 };
 
+/**
+ * Messages come from a pool owned by the port which only grows while more
+ * messages are in flight than ever before, in steady state sending does not
+ * allocate. Payloads up to MSG_INTERNAL_BUFFER_SIZE bytes are stored inline.
+ *
+ * The container events are signalled for every queued message, so receivers
+ * may take one message per wakeup.
+ */
 class Protocol
 {
 public:
-  Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
-    : portName(name), inDefered(false), outDefered(false) {containerInEvent = inEvent; containerOutEvent = outEvent;};
+  Protocol(std::string name, CEvent* inEvent, CEvent *outEvent);
   Protocol(std::string name)
     : Protocol(name, nullptr, nullptr) {}
   virtual ~Protocol();
   Message *GetMessage();
   void ReturnMessage(Message *msg);
   bool SendOutMessage(int signal, void *data = NULL, int size = 0, Message *outMsg = NULL);
+  bool SendOutMessage(int signal, CPayloadWrapBase *payload, Message *outMsg = NULL);
   bool SendInMessage(int signal, void *data = NULL, int size = 0, Message *outMsg = NULL);
+  bool SendInMessage(int signal, CPayloadWrapBase *payload, Message *outMsg = NULL);
   bool SendOutMessageSync(int signal, Message **retMsg, int timeout, void *data = NULL, int size = 0);
+  bool SendOutMessageSync(int signal, Message **retMsg, int timeout, CPayloadWrapBase *payload);
   bool ReceiveOutMessage(Message **msg);
   bool ReceiveInMessage(Message **msg);
   void Purge();
@@ -79,11 +120,26 @@ public:
   std::string portName;
 
 protected:
+  // intrusive fifo of messages, linked through Message::next
+  struct MessageQueue
+  {
+    Message *head = nullptr;
+    Message *tail = nullptr;
+    void Push(Message *msg);
+    Message *Pop();
+  };
+
+  void QueueMessage(MessageQueue &queue, Message *msg, CEvent *event);
+  bool DequeueMessage(MessageQueue &queue, bool defered, Message **msg);
+  void PurgeQueue(MessageQueue &queue, int signal);
+  bool SendMessageSync(int signal, Message **retMsg, int timeout, Message *msg);
+
   CEvent *containerInEvent, *containerOutEvent;
   CCriticalSection criticalSection;
-  std::queue<Message*> outMessages;
-  std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
+  MessageQueue outMessages;
+  MessageQueue inMessages;
+  Message *freeMessages;
+  std::vector<std::unique_ptr<Message[]>> messageBlocks;
   bool inDefered, outDefered;
 };
 
@@ -70,6 +70,7 @@
 // Defines to help with calls to CPUID
 #define CPUID_INFOTYPE_STANDARD 0x00000001
 #define CPUID_INFOTYPE_EXTENDED 0x80000001
+#define CPUID_INFOTYPE_EXTENDED_FEATURES 0x00000007
 
 // Standard Features
 // Bitmasks for the values returned by a call to cpuid with eax=0x00000001
@@ -77,11 +78,20 @@
 #define CPUID_00000001_ECX_SSSE3 (1<<9)
 #define CPUID_00000001_ECX_SSE4  (1<<19)
 #define CPUID_00000001_ECX_SSE42 (1<<20)
+#define CPUID_00000001_ECX_OSXSAVE (1<<27)
+#define CPUID_00000001_ECX_AVX   (1<<28)
 
 #define CPUID_00000001_EDX_MMX   (1<<23)
 #define CPUID_00000001_EDX_SSE   (1<<25)
 #define CPUID_00000001_EDX_SSE2  (1<<26)
 
+// Structured Extended Features
+// Bitmasks for the values returned by a call to cpuid with eax=0x00000007, ecx=0
+#define CPUID_00000007_EBX_AVX2  (1<<5)
+
+// Bitmask for the state components enabled in XCR0, the OS saves the xmm and ymm registers
+#define XCR0_SSE_AVX_STATE (0x6)
+
 // Extended Features
 // Bitmasks for the values returned by a call to cpuid with eax=0x80000001
 #define CPUID_80000001_EDX_MMX2     (1<<22)
@@ -412,6 +422,10 @@ CCPUInfo::CCPUInfo(void)
               m_cpuFeatures |= CPU_FEATURE_SSE4;
             else if (0 == strcmp(tok, "sse4_2"))
               m_cpuFeatures |= CPU_FEATURE_SSE42;
+            else if (0 == strcmp(tok, "avx"))
+              m_cpuFeatures |= CPU_FEATURE_AVX;
+            else if (0 == strcmp(tok, "avx2"))
+              m_cpuFeatures |= CPU_FEATURE_AVX2;
             else if (0 == strcmp(tok, "3dnow"))
               m_cpuFeatures |= CPU_FEATURE_3DNOW;
             else if (0 == strcmp(tok, "3dnowext"))
@@ -886,9 +900,14 @@ void CCPUInfo::ReadCPUFeatures()
   __cpuid(CPUInfo, 0);
   int MaxStdInfoType = CPUInfo[0];
 
+  // AVX instructions fault unless the OS saves the ymm registers on context switches
+  bool bOSSupportsAVX = false;
+
   if (MaxStdInfoType >= CPUID_INFOTYPE_STANDARD)
   {
     __cpuid(CPUInfo, CPUID_INFOTYPE_STANDARD);
+    if (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_OSXSAVE)
+      bOSSupportsAVX = (_xgetbv(0) & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE;
     if (CPUInfo[CPUINFO_EDX] & CPUID_00000001_EDX_MMX)
       m_cpuFeatures |= CPU_FEATURE_MMX;
     if (CPUInfo[CPUINFO_EDX] & CPUID_00000001_EDX_SSE)
@@ -903,6 +922,15 @@ void CCPUInfo::ReadCPUFeatures()
       m_cpuFeatures |= CPU_FEATURE_SSE4;
     if (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+    if ((CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_AVX) && bOSSupportsAVX)
+      m_cpuFeatures |= CPU_FEATURE_AVX;
+  }
+
+  if (MaxStdInfoType >= CPUID_INFOTYPE_EXTENDED_FEATURES && bOSSupportsAVX)
+  {
+    __cpuidex(CPUInfo, CPUID_INFOTYPE_EXTENDED_FEATURES, 0);
+    if (CPUInfo[CPUINFO_EBX] & CPUID_00000007_EBX_AVX2)
+      m_cpuFeatures |= CPU_FEATURE_AVX2;
   }
 
   __cpuid(CPUInfo, 0x80000000);
@@ -949,6 +977,8 @@ void CCPUInfo::ReadCPUFeatures()
         m_cpuFeatures |= CPU_FEATURE_SSE4;
       if (strstr(buffer,"SSE4.2 "))
         m_cpuFeatures |= CPU_FEATURE_SSE42;
+      if (strstr(buffer,"AVX1.0 "))
+        m_cpuFeatures |= CPU_FEATURE_AVX;
       if (strstr(buffer,"3DNOW "))
         m_cpuFeatures |= CPU_FEATURE_3DNOW;
       if (strstr(buffer,"3DNOWEXT "))
@@ -956,6 +986,15 @@ void CCPUInfo::ReadCPUFeatures()
     }
     else
       m_cpuFeatures |= CPU_FEATURE_MMX;
+
+    len = 512 - 1;
+    memset(buffer, 0, sizeof(buffer));
+    if (sysctlbyname("machdep.cpu.leaf7_features", &buffer, &len, NULL, 0) == 0)
+    {
+      strcat(buffer, " ");
+      if (strstr(buffer,"AVX2 "))
+        m_cpuFeatures |= CPU_FEATURE_AVX2;
+    }
   #endif
 #elif defined(LINUX)
 // empty on purpose, the implementation is in the constructor
@@ -41,6 +41,7 @@ typedef enum
   ObservableMessageTimers,
   ObservableMessageTimersReset,
   ObservableMessageRecordings,
+  ObservableMessageRecordingItemUpdate,
   ObservableMessagePeripheralsChanged,
   ObservableMessageChannelGroupsLoaded,
   ObservableMessageManagerStopped,
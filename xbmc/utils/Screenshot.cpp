@@ -29,6 +29,7 @@
 #include "URL.h"
 
 #include "pictures/Picture.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderCaptureConvert.h"
 
 #ifdef TARGET_RASPBERRY_PI
 #include "platform/linux/RBP.h"
@@ -161,14 +162,11 @@ bool CScreenshotSurface::capture()
   for (int y = 0; y < m_height; y++)
   {
 #ifdef HAS_GLES
-    // we need to save in BGRA order so XOR Swap RGBA -> BGRA
-    unsigned char* swap_pixels = surface + (m_height - y - 1) * m_stride;
-    for (int x = 0; x < m_width; x++, swap_pixels+=4)
-    {
-      std::swap(swap_pixels[0], swap_pixels[2]);
-    }
-#endif
+    // we need to save in BGRA order so swap RGBA -> BGRA while copying
+    CRenderCaptureConvert::SwapRedBlue(m_buffer + y * m_stride, surface + (m_height - y - 1) * m_stride, m_width);
+#else
     memcpy(m_buffer + y * m_stride, surface + (m_height - y - 1) *m_stride, m_stride);
+#endif
   }
 
   delete [] surface;
@@ -199,12 +197,7 @@ void CScreenShot::TakeScreenshot(const std::string &filename, bool sync)
   CLog::Log(LOGDEBUG, "Saving screenshot %s", CURL::GetRedacted(filename).c_str());
 
   //set alpha byte to 0xFF
-  for (int y = 0; y < surface.m_height; y++)
-  {
-    unsigned char* alphaptr = surface.m_buffer - 1 + y * surface.m_stride;
-    for (int x = 0; x < surface.m_width; x++)
-      *(alphaptr += 4) = 0xFF;
-  }
+  CRenderCaptureConvert::SetOpaque(surface.m_buffer, surface.m_width, surface.m_height, surface.m_stride);
 
   //if sync is true, the png file needs to be completely written when this function returns
   if (sync)
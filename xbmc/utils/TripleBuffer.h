@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <type_traits>
+
+/*!
+ * \brief Lock-free triple buffer with one writer and any number of readers
+ *
+ * The writer fills the slot that was published the least recently and
+ * publishes it with a single store, it never waits. Readers copy the latest
+ * published slot and validate the copy against the sequence number of the
+ * slot, so a reader only retries if the writer wrapped around onto the slot
+ * it was reading, i.e. after two more publishes.
+ *
+ * T must be trivially copyable, readers copy it while the writer might be
+ * modifying it.
+ */
+template<typename T>
+class CTripleBuffer
+{
+  static_assert(std::is_trivially_copyable<T>::value, "CTripleBuffer needs a trivially copyable type");
+
+public:
+  CTripleBuffer() : m_latest(-1), m_published(0), m_writing(0)
+  {
+    for (auto& slot : m_slots)
+      slot.sequence = 0;
+  }
+
+  /*!
+   * \brief Get the slot to fill, only one thread may write at a time
+   */
+  T& BeginWrite()
+  {
+    int latest = m_latest.load(std::memory_order_relaxed);
+    m_writing = latest < 0 ? 0 : (latest + 1) % SLOTS;
+
+    Slot& slot = m_slots[m_writing];
+    slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot.data;
+  }
+
+  /*!
+   * \brief Publish the slot returned by the last BeginWrite
+   */
+  void Publish()
+  {
+    Slot& slot = m_slots[m_writing];
+    slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    m_latest.store(m_writing, std::memory_order_release);
+    m_published.fetch_add(1, std::memory_order_release);
+  }
+
+  /*!
+   * \brief Copy the latest published data
+   * \return false if nothing was published yet
+   */
+  bool Read(T& data) const
+  {
+    while (true)
+    {
+      int latest = m_latest.load(std::memory_order_acquire);
+      if (latest < 0)
+        return false;
+
+      const Slot& slot = m_slots[latest];
+      uint64_t before = slot.sequence.load(std::memory_order_acquire);
+      if (before & 1)
+        continue;
+      data = slot.data;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) == before)
+        return true;
+    }
+  }
+
+  /*!
+   * \brief Number of publishes so far, lets readers skip unchanged data
+   */
+  uint64_t GetPublished() const { return m_published.load(std::memory_order_acquire); }
+
+private:
+  static const int SLOTS = 3;
+
+  struct Slot
+  {
+    // odd while the writer modifies the slot
+    std::atomic<uint64_t> sequence;
+    T data;
+  };
+
+  Slot m_slots[SLOTS];
+  std::atomic_int m_latest;
+  std::atomic<uint64_t> m_published;
+  int m_writing;
+};
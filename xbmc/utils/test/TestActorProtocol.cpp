@@ -0,0 +1,248 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/ActorProtocol.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace Actor;
+
+namespace
+{
+class CTestProtocol : public Protocol
+{
+public:
+  using Protocol::Protocol;
+  size_t GetBlockCount() const { return messageBlocks.size(); }
+};
+}
+
+TEST(TestActorProtocol, Async)
+{
+  CEvent inEvent, outEvent;
+  Protocol port("test", &inEvent, &outEvent);
+
+  int value = 42;
+  port.SendOutMessage(1, &value, sizeof(value));
+  port.SendOutMessage(2);
+  EXPECT_TRUE(outEvent.WaitMSec(0));
+
+  Message *msg;
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(1, msg->signal);
+  EXPECT_EQ(42, *reinterpret_cast<int*>(msg->data));
+  msg->Reply(3);
+  msg->Release();
+
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(2, msg->signal);
+  EXPECT_EQ(nullptr, msg->data);
+  msg->Release();
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+
+  EXPECT_TRUE(inEvent.WaitMSec(0));
+  ASSERT_TRUE(port.ReceiveInMessage(&msg));
+  EXPECT_EQ(3, msg->signal);
+  msg->Release();
+}
+
+TEST(TestActorProtocol, Wakeup)
+{
+  CEvent inEvent, outEvent;
+  Protocol port("test", &inEvent, &outEvent);
+
+  // a receiver that takes one message per wakeup must be woken again for a
+  // message that arrived while it was busy with the previous one
+  port.SendOutMessage(1);
+  EXPECT_TRUE(outEvent.WaitMSec(0));
+  port.SendOutMessage(2);
+
+  Message *msg;
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(1, msg->signal);
+  msg->Release();
+
+  EXPECT_TRUE(outEvent.WaitMSec(0));
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(2, msg->signal);
+  msg->Release();
+}
+
+TEST(TestActorProtocol, Payload)
+{
+  Protocol port("test");
+
+  // larger than the inline buffer
+  uint8_t big[MSG_INTERNAL_BUFFER_SIZE * 2];
+  for (size_t i = 0; i < sizeof(big); i++)
+    big[i] = static_cast<uint8_t>(i);
+  port.SendOutMessage(1, big, sizeof(big));
+
+  // move-only payload
+  std::unique_ptr<int> owned(new int(7));
+  port.SendOutMessage(2, new CPayloadWrap<std::unique_ptr<int>>(std::move(owned)));
+
+  Message *msg;
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(0, memcmp(big, msg->data, sizeof(big)));
+  msg->Release();
+
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  auto payload = static_cast<CPayloadWrap<std::unique_ptr<int>>*>(msg->payloadObj.get());
+  ASSERT_NE(nullptr, payload);
+  EXPECT_EQ(7, **payload->GetPayload());
+  msg->Release();
+  EXPECT_EQ(nullptr, msg->payloadObj.get());
+}
+
+TEST(TestActorProtocol, PurgeAndDefer)
+{
+  Protocol port("test");
+  Message *msg;
+
+  port.SendOutMessage(1);
+  port.SendOutMessage(2);
+  port.SendOutMessage(1);
+  port.PurgeOut(1);
+
+  port.DeferOut(true);
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+  port.DeferOut(false);
+
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(2, msg->signal);
+  msg->Release();
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+}
+
+TEST(TestActorProtocol, Sync)
+{
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent);
+  std::atomic<bool> stop(false);
+
+  std::thread receiver([&]()
+  {
+    Message *msg;
+    while (!stop)
+    {
+      if (port.ReceiveOutMessage(&msg))
+      {
+        // signal 0 is left unanswered
+        if (msg->signal == 1)
+        {
+          int value = *reinterpret_cast<int*>(msg->data) + 1;
+          msg->Reply(2, &value, sizeof(value));
+        }
+        msg->Release();
+      }
+      else
+        outEvent.WaitMSec(10);
+    }
+  });
+
+  Message *reply;
+  int value = 41;
+  ASSERT_TRUE(port.SendOutMessageSync(1, &reply, 1000, &value, sizeof(value)));
+  EXPECT_EQ(2, reply->signal);
+  EXPECT_EQ(42, *reinterpret_cast<int*>(reply->data));
+  reply->Release();
+
+  EXPECT_FALSE(port.SendOutMessageSync(0, &reply, 20));
+  EXPECT_EQ(nullptr, reply);
+
+  stop = true;
+  receiver.join();
+}
+
+TEST(TestActorProtocol, PurgeSync)
+{
+  CEvent outEvent;
+  CTestProtocol port("test", nullptr, &outEvent);
+  std::atomic<bool> stop(false);
+
+  std::thread purger([&]()
+  {
+    while (!stop)
+    {
+      outEvent.WaitMSec(10);
+      port.PurgeOut(1);
+    }
+  });
+
+  // purged sync messages time out and have to go back to the pool
+  for (int i = 0; i < 100; i++)
+  {
+    Message *reply;
+    EXPECT_FALSE(port.SendOutMessageSync(1, &reply, 1));
+  }
+
+  stop = true;
+  purger.join();
+  port.PurgeOut(1);
+
+  EXPECT_EQ(1U, port.GetBlockCount());
+}
+
+/*
+ * Round trip latency of SendOutMessageSync with the receiver on another
+ * thread. Run with --gtest_also_run_disabled_tests
+ */
+TEST(TestActorProtocol, DISABLED_Benchmark)
+{
+  CEvent outEvent;
+  Protocol port("benchmark", nullptr, &outEvent);
+  std::atomic<bool> stop(false);
+
+  std::thread receiver([&]()
+  {
+    Message *msg;
+    while (!stop)
+    {
+      if (port.ReceiveOutMessage(&msg))
+      {
+        msg->Reply(1);
+        msg->Release();
+      }
+      else
+        outEvent.WaitMSec(10);
+    }
+  });
+
+  const int rounds = 100000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++)
+  {
+    Message *reply;
+    ASSERT_TRUE(port.SendOutMessageSync(0, &reply, 1000, &i, sizeof(i)));
+    reply->Release();
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "SendOutMessageSync round trip: "
+            << std::chrono::duration<double, std::micro>(end - start).count() / rounds << " us" << std::endl;
+
+  stop = true;
+  receiver.join();
+}
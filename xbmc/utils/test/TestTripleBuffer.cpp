@@ -0,0 +1,106 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "utils/TripleBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Block
+{
+  uint64_t values[64];
+};
+}
+
+TEST(TestTripleBuffer, Publish)
+{
+  CTripleBuffer<int> buffer;
+  int value = 0;
+  EXPECT_FALSE(buffer.Read(value));
+
+  for (int i = 1; i <= 5; i++)
+  {
+    buffer.BeginWrite() = i;
+    // unpublished data is not visible
+    if (i > 1)
+    {
+      EXPECT_TRUE(buffer.Read(value));
+      EXPECT_EQ(i - 1, value);
+    }
+    buffer.Publish();
+    EXPECT_TRUE(buffer.Read(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_EQ(5U, buffer.GetPublished());
+}
+
+TEST(TestTripleBuffer, Concurrent)
+{
+  CTripleBuffer<Block> buffer;
+  std::atomic_bool done(false);
+
+  std::thread writer([&]()
+  {
+    for (uint64_t i = 1; i <= 100000; i++)
+    {
+      Block& block = buffer.BeginWrite();
+      for (auto& v : block.values)
+        v = i;
+      buffer.Publish();
+    }
+    done = true;
+  });
+
+  // readers never see a torn block and never go back in time
+  std::vector<std::thread> readers;
+  std::atomic_int failures(0);
+  for (int r = 0; r < 3; r++)
+  {
+    readers.emplace_back([&]()
+    {
+      uint64_t last = 0;
+      Block block;
+      while (!done)
+      {
+        if (!buffer.Read(block))
+          continue;
+        for (auto v : block.values)
+        {
+          if (v != block.values[0])
+            failures++;
+        }
+        if (block.values[0] < last)
+          failures++;
+        last = block.values[0];
+      }
+    });
+  }
+
+  writer.join();
+  for (auto& reader : readers)
+    reader.join();
+  EXPECT_EQ(0, failures);
+}